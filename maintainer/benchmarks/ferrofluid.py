@@ -19,6 +19,7 @@
 
 import espressomd
 import espressomd.magnetostatics
+import espressomd.shapes
 import benchmarks
 import numpy as np
 import argparse
@@ -35,6 +36,12 @@ parser.add_argument("--volume_fraction", metavar="FRAC", action="store",
 parser.add_argument("--dipole_moment", metavar="FRAC", action="store",
                     type=float, default=2**0.5, required=False,
                     help="Magnitude of the dipole moment (same for all particles)")
+parser.add_argument("--open_boundaries", action="store_true",
+                    help="Confine the particles between walls in a non-periodic "
+                    "box and use the Barnes-Hut solver, default: false")
+parser.add_argument("--theta", metavar="THETA", action="store",
+                    type=float, default=0.2, required=False,
+                    help="Opening angle of the Barnes-Hut solver (default: 0.2)")
 group = parser.add_mutually_exclusive_group()
 group.add_argument("--output", metavar="FILEPATH", action="store",
                    type=str, required=False, default="benchmarks.csv",
@@ -51,6 +58,7 @@ assert args.volume_fraction > 0, "volume_fraction must be a positive number"
 assert args.volume_fraction < np.pi / (3 * np.sqrt(2)), \
     "volume_fraction exceeds the physical limit of sphere packing (~0.74)"
 assert args.dipole_moment > 0
+assert args.theta >= 0, "theta must be a non-negative number"
 if not args.visualizer:
     assert measurement_steps >= 100, \
         f"{measurement_steps} steps per tick are too short"
@@ -81,6 +89,8 @@ box_l = (n_part * 4. / 3. * np.pi * (lj_sig / 2.)**3
 # System
 #############################################################
 system.box_l = 3 * (box_l,)
+if args.open_boundaries:
+    system.periodicity = [False, False, False]
 
 # Integration parameters
 #############################################################
@@ -93,10 +103,26 @@ system.thermostat.turn_off()
 system.non_bonded_inter[0, 0].lennard_jones.set_params(
     epsilon=lj_eps, sigma=lj_sig, cutoff=lj_cut, shift="auto")
 
+if args.open_boundaries:
+    # purely repulsive walls on all faces of the box
+    system.non_bonded_inter[0, 1].lennard_jones.set_params(
+        epsilon=lj_eps, sigma=lj_sig / 2., cutoff=lj_cut / 2., shift="auto")
+    for axis in range(3):
+        normal = np.zeros(3)
+        normal[axis] = 1.
+        system.constraints.add(shape=espressomd.shapes.Wall(
+            normal=normal, dist=0.), particle_type=1)
+        system.constraints.add(shape=espressomd.shapes.Wall(
+            normal=-normal, dist=-box_l), particle_type=1)
+
 # Particle setup
 #############################################################
+if args.open_boundaries:
+    pos = lj_sig + np.random.random((n_part, 3)) * (box_l - 2. * lj_sig)
+else:
+    pos = np.random.random((n_part, 3)) * system.box_l
 system.part.add(
-    pos=np.random.random((n_part, 3)) * system.box_l,
+    pos=pos,
     rotation=n_part * [(1, 1, 1)],
     dipm=n_part * [args.dipole_moment])
 
@@ -113,10 +139,14 @@ system.thermostat.set_langevin(kT=1.0, gamma=1.0, seed=42)
 min_skin = 0.2
 max_skin = 1.0
 dp3m_params = {'prefactor': 1, 'accuracy': 1e-4}
+bh_params = {'prefactor': 1, 'theta': args.theta}
 print("Equilibration")
 system.integrator.run(min(5 * measurement_steps, 60000))
-dp3m = espressomd.magnetostatics.DipolarP3M(**dp3m_params)
-system.actors.add(dp3m)
+if args.open_boundaries:
+    solver = espressomd.magnetostatics.DipolarBarnesHutCpu(**bh_params)
+else:
+    solver = espressomd.magnetostatics.DipolarP3M(**dp3m_params)
+system.actors.add(solver)
 print("Tune skin: {:.3f}".format(system.cell_system.tune_skin(
     min_skin=min_skin, max_skin=max_skin, tol=0.05, int_steps=100)))
 print("Equilibration")
@@ -0,0 +1,110 @@
+#
+# Copyright (C) 2022 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""
+Microbenchmark of the short-range force loop. Compare the throughput
+of the particle storage (array-of-structures) with the one of the
+structure-of-arrays mirror.
+"""
+
+import espressomd
+import benchmarks
+import numpy as np
+import argparse
+import time
+
+parser = argparse.ArgumentParser(description="Benchmark the LJ force loop "
+                                 "with both particle data layouts. "
+                                 "Save the results to a CSV file.")
+parser.add_argument("--particles_per_core", metavar="N", action="store",
+                    type=int, default=100000, required=False,
+                    help="Number of particles in the simulation box")
+parser.add_argument("--volume_fraction", metavar="FRAC", action="store",
+                    type=float, default=0.30, required=False,
+                    help="Fraction of the simulation box volume occupied by "
+                    "particles (range: [0.01-0.50], default: 0.30)")
+parser.add_argument("--output", metavar="FILEPATH", action="store",
+                    type=str, required=False, default="benchmarks.csv",
+                    help="Output file (default: benchmarks.csv)")
+
+args = parser.parse_args()
+
+# process and check arguments
+n_iterations = 20
+n_steps = max(1, int(np.round(2e6 / args.particles_per_core)))
+assert args.volume_fraction > 0, "volume_fraction must be a positive number"
+assert args.volume_fraction < np.pi / 6, \
+    "volume_fraction exceeds the limit of a simple cubic lattice (~0.52)"
+
+required_features = ["LENNARD_JONES"]
+espressomd.assert_features(required_features)
+
+# make simulation deterministic
+np.random.seed(42)
+
+# System
+#############################################################
+system = espressomd.System(box_l=[1, 1, 1])
+
+lj_eps = 1.0  # LJ epsilon
+lj_sig = 1.0  # particle diameter
+lj_cut = 2.5 * lj_sig  # cutoff distance
+
+n_proc = system.cell_system.get_state()['n_nodes']
+n_part = n_proc * args.particles_per_core
+# volume of N spheres with radius r: N * (4/3*pi*r^3)
+box_l = (n_part * 4. / 3. * np.pi * (lj_sig / 2.)**3
+         / args.volume_fraction)**(1. / 3.)
+system.box_l = 3 * (box_l,)
+system.time_step = 0.01
+system.cell_system.skin = 0.4
+
+system.non_bonded_inter[0, 0].lennard_jones.set_params(
+    epsilon=lj_eps, sigma=lj_sig, cutoff=lj_cut, shift="auto")
+
+# particles on a jittered simple cubic lattice, no warmup needed
+n_per_side = int(np.ceil(n_part**(1. / 3.)))
+spacing = box_l / n_per_side
+grid = np.stack(np.meshgrid(*(3 * (np.arange(n_per_side),)),
+                            indexing="ij"), axis=-1).reshape((-1, 3))
+pos = (grid[:n_part] + 0.5) * spacing
+pos += (np.random.random((n_part, 3)) - 0.5) * 0.1 * (spacing - lj_sig)
+system.part.add(pos=pos)
+
+
+def time_force_loop(use_soa):
+    system.cell_system.use_soa = use_soa
+    system.integrator.run(0, recalc_forces=True)
+    timings = []
+    for _ in range(n_iterations):
+        tick = time.time()
+        for _ in range(n_steps):
+            system.integrator.run(0, recalc_forces=True)
+        tock = time.time()
+        timings.append((tock - tick) / n_steps)
+    return np.array(timings)
+
+
+for label, use_soa in (("aos", False), ("soa", True)):
+    timings = time_force_loop(use_soa)
+    avg, ci = benchmarks.get_average_time(timings)
+    print(f"{label}: {avg:.3e} +/- {ci:.3e} (95% C.I.) per force calculation, "
+          f"{args.particles_per_core / avg:.3e} particles/s per rank")
+    benchmarks.write_report(args.output, n_proc, timings, n_steps,
+                            label=f"layout={label}")
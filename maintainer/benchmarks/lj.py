@@ -21,6 +21,7 @@ import espressomd
 import benchmarks
 import numpy as np
 import argparse
+import os
 
 parser = argparse.ArgumentParser(description="Benchmark LJ simulations. "
                                  "Save the results to a CSV file.")
@@ -75,6 +76,10 @@ lj_cut = lj_sig * 2**(1. / 6.)  # cutoff distance
 #############################################################
 
 n_proc = system.cell_system.get_state()['n_nodes']
+# the short-range loop is distributed over OpenMP threads in each MPI rank
+n_threads = 1
+if espressomd.has_features("OPENMP"):
+    n_threads = int(os.environ.get("OMP_NUM_THREADS", n_threads))
 n_part = n_proc * args.particles_per_core
 # volume of N spheres with radius r: N * (4/3*pi*r^3)
 box_l = (n_part * 4. / 3. * np.pi * (lj_sig / 2.)**3
@@ -154,7 +159,9 @@ timings = benchmarks.get_timings(system, measurement_steps, n_iterations)
 
 # average time
 avg, ci = benchmarks.get_average_time(timings)
-print(f"average: {avg:.3e} +/- {ci:.3e} (95% C.I.)")
+print(f"average: {avg:.3e} +/- {ci:.3e} (95% C.I.) "
+      f"with {n_threads} thread(s) per rank")
 
 # write report
-benchmarks.write_report(args.output, n_proc, timings, measurement_steps)
+benchmarks.write_report(args.output, n_proc, timings, measurement_steps,
+                        label=f"threads={n_threads}")
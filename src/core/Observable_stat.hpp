@@ -68,6 +68,13 @@ public:
     boost::transform(m_data, m_data.begin(), [fac](auto e) { return e * fac; });
   }
 
+  /** Add the values of an observable with the same layout */
+  Observable_stat &operator+=(Observable_stat const &other) {
+    assert(m_data.size() == other.m_data.size());
+    boost::transform(m_data, other.m_data, m_data.begin(), std::plus<>{});
+    return *this;
+  }
+
   /** Contribution from linear and angular kinetic energy (accumulated). */
   Utils::Span<double> kinetic;
   /** Contribution(s) from bonded interactions. */
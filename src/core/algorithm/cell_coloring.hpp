@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ALGORITHM_CELL_COLORING_HPP
+#define ALGORITHM_CELL_COLORING_HPP
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Algorithm {
+
+/**
+ * @brief Partition cells into colors for conflict-free parallel pair loops.
+ *
+ * A pair loop over a cell (see @ref link_cell) writes to the particles
+ * of the cell itself and of its red neighbors. Two cells are given
+ * different colors whenever these write sets overlap, so that all cells
+ * of one color can be processed concurrently. The colors are found by
+ * a greedy first-fit coloring in the order of the input range.
+ *
+ * @param first Iterator to the first cell.
+ * @param last  Iterator past the last cell.
+ * @return Cells grouped by color.
+ */
+template <typename CellIterator>
+auto color_cells(CellIterator first, CellIterator last) {
+  using CellPtr = decltype(std::addressof(*first));
+  std::vector<std::vector<CellPtr>> colors;
+  /* colors of the cells that write to a given cell */
+  std::unordered_map<CellPtr, std::vector<std::size_t>> touched_by;
+
+  for (; first != last; ++first) {
+    auto const cell = std::addressof(*first);
+
+    std::vector<CellPtr> write_set = {cell};
+    for (auto &neighbor : first->neighbors().red()) {
+      write_set.push_back(std::addressof(*neighbor));
+    }
+
+    std::vector<bool> forbidden(colors.size(), false);
+    for (auto const c : write_set) {
+      auto const it = touched_by.find(c);
+      if (it != touched_by.end()) {
+        for (auto const color : it->second) {
+          forbidden[color] = true;
+        }
+      }
+    }
+
+    std::size_t color = 0;
+    while (color < forbidden.size() and forbidden[color]) {
+      ++color;
+    }
+    if (color == colors.size()) {
+      colors.emplace_back();
+    }
+    colors[color].push_back(cell);
+
+    for (auto const c : write_set) {
+      touched_by[c].push_back(color);
+    }
+  }
+
+  return colors;
+}
+
+/**
+ * @brief Run a kernel on every cell, color by color.
+ *
+ * Cells of the same color are distributed over the OpenMP thread team,
+ * if available. The colors are processed one after the other.
+ *
+ * @param colors      Cells grouped by color, see @ref color_cells.
+ * @param cell_kernel Callable with signature <tt>void(Cell &)</tt>.
+ */
+template <typename Colors, typename CellKernel>
+void for_each_colored_cell(Colors const &colors, CellKernel &&cell_kernel) {
+  for (auto const &color : colors) {
+    auto const n_cells = static_cast<long>(color.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (long i = 0; i < n_cells; ++i) {
+      cell_kernel(*color[static_cast<std::size_t>(i)]);
+    }
+  }
+}
+} // namespace Algorithm
+
+#endif
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cell_system/BalancedDecomposition.hpp"
+
+#include "cell_system/Cell.hpp"
+#include "cell_system/RegularDecomposition.hpp"
+
+#include "BoxGeometry.hpp"
+#include "LocalBox.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/mpi/cart_comm.hpp>
+
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/operations.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+BalancedDecomposition::BalancedDecomposition(
+    boost::mpi::communicator comm, double range, BoxGeometry const &box_geo,
+    LocalBox<double> const &local_geo, LoadBalancingParameters const &params,
+    bool morton_order, boost::optional<CellPartition> const &partition)
+    : m_comm(std::move(comm)), m_box(box_geo), m_range(range),
+      m_params(params), m_regular_decomposition(m_comm, range, box_geo,
+                                                local_geo, partition,
+                                                morton_order) {}
+
+std::vector<double> BalancedDecomposition::cell_loads() const {
+  auto const cells = m_regular_decomposition.get_local_cells();
+  std::vector<double> loads(cells.size());
+  std::transform(cells.begin(), cells.end(), loads.begin(), [this](Cell *c) {
+    auto const n = static_cast<double>(c->particles().size());
+    if (m_params.metric == LoadMetric::PARTICLES) {
+      return n;
+    }
+    /* pairs within the cell and with the half shell of neighbors */
+    auto n_neighbors = 0.;
+    for (auto const neighbor : c->neighbors().red()) {
+      n_neighbors += static_cast<double>(neighbor->particles().size());
+    }
+    return 0.5 * n * (n - 1.) + n * n_neighbors;
+  });
+  return loads;
+}
+
+namespace {
+double max_to_mean_ratio(boost::mpi::communicator const &comm,
+                         std::vector<double> const &loads) {
+  auto const local = std::accumulate(loads.begin(), loads.end(), 0.);
+  auto const max = boost::mpi::all_reduce(comm, local,
+                                          boost::mpi::maximum<double>());
+  auto const total = boost::mpi::all_reduce(comm, local, std::plus<>());
+  if (total <= 0.) {
+    return 1.;
+  }
+  return max * comm.size() / total;
+}
+} // namespace
+
+double BalancedDecomposition::load_imbalance() const {
+  return max_to_mean_ratio(m_comm, cell_loads());
+}
+
+CellPartition BalancedDecomposition::balanced_partition(
+    std::vector<double> const &loads) const {
+  auto const &rd = m_regular_decomposition;
+  auto const dims = Utils::Mpi::cart_get<3>(m_comm).dims;
+
+  /* project the load of the local cells on the planes of the global grid */
+  std::array<std::vector<double>, 3> plane_loads;
+  for (int d = 0; d < 3; d++) {
+    plane_loads[d].assign(rd.global_cell_grid[d], 0.);
+  }
+  /* the ghost cell grid starts one cell before the local cells */
+  auto const halo = Utils::Vector3i{1, 1, 1};
+  auto const cells = rd.get_local_cells();
+  assert(cells.size() == loads.size());
+  for (std::size_t i = 0; i < cells.size(); i++) {
+    auto const n = rd.cell_index(cells[i]) - halo + rd.cell_offset;
+    for (int d = 0; d < 3; d++) {
+      plane_loads[d][n[d]] += loads[i];
+    }
+  }
+
+  CellPartition partition;
+  partition.global_cell_grid = rd.global_cell_grid;
+  for (int d = 0; d < 3; d++) {
+    if (dims[d] == 1) {
+      partition.cuts[d] = {0, rd.global_cell_grid[d]};
+      continue;
+    }
+    std::vector<double> global_loads(plane_loads[d].size());
+    boost::mpi::all_reduce(m_comm, plane_loads[d].data(),
+                           static_cast<int>(plane_loads[d].size()),
+                           global_loads.data(), std::plus<>());
+    partition.cuts[d] = detail::balanced_cuts(global_loads, dims[d]);
+  }
+
+  return partition;
+}
+
+std::unique_ptr<BalancedDecomposition> BalancedDecomposition::rebalance() {
+  if (++m_resorts_since_evaluation < m_params.rebalance_interval) {
+    return {};
+  }
+  m_resorts_since_evaluation = 0;
+
+  auto const loads = cell_loads();
+  m_imbalance = max_to_mean_ratio(m_comm, loads);
+  if (m_imbalance <= m_params.imbalance_threshold) {
+    return {};
+  }
+
+  auto const partition = balanced_partition(loads);
+  if (partition.cuts == get_partition().cuts) {
+    return {};
+  }
+
+  auto decomposition = std::make_unique<BalancedDecomposition>(
+      m_comm, m_range, m_box, get_local_box(), m_params,
+      m_regular_decomposition.morton_order(), partition);
+  decomposition->m_n_rebalances = m_n_rebalances + 1;
+  decomposition->m_imbalance = m_imbalance;
+
+  return decomposition;
+}
+
+namespace detail {
+std::vector<int> balanced_cuts(std::vector<double> const &plane_loads,
+                               int n_slabs) {
+  auto const n_planes = static_cast<int>(plane_loads.size());
+  assert(n_slabs >= 1 and n_slabs <= n_planes);
+
+  /* cumulative load in front of each plane */
+  std::vector<double> prefix(plane_loads.size() + 1u, 0.);
+  std::partial_sum(plane_loads.begin(), plane_loads.end(),
+                   std::next(prefix.begin()));
+  auto const total = prefix.back();
+
+  std::vector<int> cuts(n_slabs + 1);
+  cuts[0] = 0;
+  cuts[n_slabs] = n_planes;
+  for (int p = 1; p < n_slabs; p++) {
+    int cut;
+    if (total > 0.) {
+      auto const target = total * p / n_slabs;
+      cut = static_cast<int>(std::distance(
+          prefix.begin(),
+          std::lower_bound(prefix.begin(), prefix.end(), target)));
+      if (cut > 0 and target - prefix[cut - 1] < prefix[cut] - target) {
+        cut--;
+      }
+    } else {
+      cut = (n_planes * p) / n_slabs;
+    }
+    /* leave at least one plane to this and all following slabs */
+    cuts[p] = std::max(cuts[p - 1] + 1, std::min(cut, n_planes - n_slabs + p));
+  }
+
+  return cuts;
+}
+} // namespace detail
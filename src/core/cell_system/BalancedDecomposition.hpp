@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESPRESSO_SRC_CORE_CELL_SYSTEM_BALANCED_DECOMPOSITION_HPP
+#define ESPRESSO_SRC_CORE_CELL_SYSTEM_BALANCED_DECOMPOSITION_HPP
+
+#include "cell_system/ParticleDecomposition.hpp"
+#include "cell_system/RegularDecomposition.hpp"
+
+#include "cell_system/Cell.hpp"
+
+#include "BoxGeometry.hpp"
+#include "LocalBox.hpp"
+#include "Particle.hpp"
+#include "ghosts.hpp"
+
+#include <utils/Span.hpp>
+#include <utils/Vector.hpp>
+
+#include <boost/mpi/communicator.hpp>
+#include <boost/optional.hpp>
+
+#include <memory>
+#include <vector>
+
+/** @brief Estimate of the work caused by the particles of a cell. */
+enum class LoadMetric : int {
+  /** number of particles */
+  PARTICLES = 0,
+  /** number of particle pairs in the cell and its red neighbors */
+  PAIRS = 1
+};
+
+/** @brief Parameters of the @ref BalancedDecomposition. */
+struct LoadBalancingParameters {
+  /** Number of particle resorts between two load evaluations. */
+  int rebalance_interval = 10;
+  /** Ratio of the largest to the mean node load above which the
+   *  node domains are rebuilt. */
+  double imbalance_threshold = 1.1;
+  /** Load estimate. */
+  LoadMetric metric = LoadMetric::PAIRS;
+};
+
+/**
+ * @brief Load-balanced regular decomposition cell system.
+ *
+ * The particles are stored in a @ref RegularDecomposition whose node
+ * domains follow a @ref CellPartition of a global cell grid, instead of
+ * having the same size on every node. Every
+ * @ref LoadBalancingParameters::rebalance_interval "rebalance_interval"
+ * particle resorts, i.e. Verlet list rebuilds, the load of the cells is
+ * measured. When the load of the busiest node exceeds the mean load by
+ * more than the threshold, the cut planes are moved such that the load
+ * projected on every direction is split evenly between the nodes, and the
+ * particles migrate to their new nodes in the following global resort.
+ *
+ * The cell size is the same as in a regular decomposition on the same
+ * node grid and does not change when balancing; only the number of cell
+ * planes owned by the nodes does.
+ */
+class BalancedDecomposition : public ParticleDecomposition {
+  boost::mpi::communicator m_comm;
+  BoxGeometry const &m_box;
+  double m_range;
+  LoadBalancingParameters m_params;
+  RegularDecomposition m_regular_decomposition;
+
+  /** Number of resorts since the last load evaluation. */
+  int m_resorts_since_evaluation = 0;
+  /** Number of times the node domains have been rebuilt. */
+  int m_n_rebalances = 0;
+  /** Load imbalance at the last evaluation. */
+  double m_imbalance = 1.;
+
+public:
+  /**
+   * @param comm Cartesian communicator to use.
+   * @param range Interaction range.
+   * @param box_geo Box geometry.
+   * @param local_geo Geometry of the equal-size local box.
+   * @param params Load balancing parameters.
+   * @param morton_order Order the local cells along a Morton curve.
+   * @param partition Node domains, equal-size domains by default.
+   */
+  BalancedDecomposition(boost::mpi::communicator comm, double range,
+                        BoxGeometry const &box_geo,
+                        LocalBox<double> const &local_geo,
+                        LoadBalancingParameters const &params,
+                        bool morton_order = false,
+                        boost::optional<CellPartition> const &partition = {});
+
+  GhostCommunicator const &exchange_ghosts_comm() const override {
+    return m_regular_decomposition.exchange_ghosts_comm();
+  }
+  GhostCommunicator const &collect_ghost_force_comm() const override {
+    return m_regular_decomposition.collect_ghost_force_comm();
+  }
+
+  Utils::Span<Cell *> local_cells() override {
+    return m_regular_decomposition.local_cells();
+  }
+  Utils::Span<Cell *> ghost_cells() override {
+    return m_regular_decomposition.ghost_cells();
+  }
+
+  Cell *particle_to_cell(Particle const &p) override {
+    return m_regular_decomposition.particle_to_cell(p);
+  }
+
+  void resort(bool global, std::vector<ParticleChange> &diff) override {
+    m_regular_decomposition.resort(global, diff);
+  }
+
+  Utils::Vector3d max_cutoff() const override {
+    return m_regular_decomposition.max_cutoff();
+  }
+  Utils::Vector3d max_range() const override {
+    return m_regular_decomposition.max_range();
+  }
+
+  boost::optional<BoxGeometry> minimum_image_distance() const override {
+    return m_regular_decomposition.minimum_image_distance();
+  }
+
+  BoxGeometry const &box() const override { return m_box; };
+
+  Utils::Vector3i get_cell_grid() const {
+    return m_regular_decomposition.cell_grid;
+  }
+  Utils::Vector3d get_cell_size() const {
+    return m_regular_decomposition.cell_size;
+  }
+  CellPartition const &get_partition() const {
+    return m_regular_decomposition.partition();
+  }
+  LocalBox<double> const &get_local_box() const {
+    return m_regular_decomposition.local_box();
+  }
+  LoadBalancingParameters const &get_parameters() const { return m_params; }
+  double get_range() const { return m_range; }
+  int get_n_rebalances() const { return m_n_rebalances; }
+  double get_imbalance() const { return m_imbalance; }
+
+  /**
+   * @brief Ratio of the largest to the mean node load.
+   *
+   * Collective call.
+   */
+  double load_imbalance() const;
+
+  /**
+   * @brief Count a particle resort and rebalance if due.
+   *
+   * Collective call, to be made before each resort. Every
+   * @ref LoadBalancingParameters::rebalance_interval "rebalance_interval"
+   * calls, the load imbalance is measured, and if it is above the threshold,
+   * a decomposition with balanced node domains is returned. The particles
+   * are not moved, the caller has to transfer them.
+   *
+   * @return The new decomposition, or nullptr if the node domains are kept.
+   */
+  std::unique_ptr<BalancedDecomposition> rebalance();
+
+private:
+  /** @brief Load of the local cells, in local cell order. */
+  std::vector<double> cell_loads() const;
+  /** @brief Partition with balanced node domains for given cell loads. */
+  CellPartition balanced_partition(std::vector<double> const &loads) const;
+};
+
+namespace detail {
+/**
+ * @brief Split a sequence of planes into contiguous, balanced slabs.
+ *
+ * The slab boundaries are placed where the cumulative load is closest to
+ * an equal share of the total load. Every slab has at least one plane.
+ * Without any load, the planes are split evenly.
+ *
+ * @param plane_loads Load of every plane.
+ * @param n_slabs Number of slabs, at most the number of planes.
+ * @return The @p n_slabs + 1 slab boundaries, from 0 to the number of planes.
+ */
+std::vector<int> balanced_cuts(std::vector<double> const &plane_loads,
+                               int n_slabs);
+} // namespace detail
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_SRC_CORE_CELL_SYSTEM_BOND_TABLE_HPP
+#define ESPRESSO_SRC_CORE_CELL_SYSTEM_BOND_TABLE_HPP
+
+#include "Particle.hpp"
+
+#include <utils/Span.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Bonds of the local particles with resolved partners.
+ *
+ * The bonds are grouped by bond id, and the particles of the bonds
+ * of a group are stored as one flat array of particle pointers. The
+ * table is only valid as long as the particles stay in place in memory,
+ * i.e. until the next particle resort, and as long as no bonds are
+ * added or removed.
+ */
+class BondTable {
+public:
+  /** @brief Bonds with the same bond id. */
+  struct Group {
+    Group(int bond_id, int n_partners)
+        : bond_id(bond_id), n_partners(n_partners) {}
+
+    /** Bond id */
+    int bond_id;
+    /** Number of partners of the bonds */
+    int n_partners;
+    /** For every bond, the particle that stores the bond
+     *  followed by its partners */
+    std::vector<Particle *> particles;
+
+    /** @brief Number of bonds. */
+    std::size_t size() const {
+      return particles.size() / static_cast<std::size_t>(n_partners + 1);
+    }
+
+    /** @brief The particle storing bond @p i. */
+    Particle &particle(std::size_t i) const {
+      return *particles[i * static_cast<std::size_t>(n_partners + 1)];
+    }
+
+    /** @brief The partners of bond @p i. */
+    Utils::Span<Particle *> partners(std::size_t i) {
+      return {particles.data() + i * static_cast<std::size_t>(n_partners + 1) +
+                  1,
+              static_cast<std::size_t>(n_partners)};
+    }
+  };
+
+  /** @brief Bond with partners which are not available on this node. */
+  struct UnresolvedBond {
+    int particle_id;
+    std::vector<int> partner_ids;
+  };
+
+  void clear() {
+    m_groups.clear();
+    m_group_index.clear();
+    m_unresolved.clear();
+  }
+
+  /**
+   * @brief Add a bond.
+   *
+   * @param p Particle storing the bond.
+   * @param bond_id Bond id.
+   * @param partners Resolved bond partners.
+   */
+  void add(Particle &p, int bond_id, Utils::Span<Particle *const> partners) {
+    auto const n_partners = static_cast<int>(partners.size());
+    auto it = m_group_index.find(bond_id);
+    if (it == m_group_index.end()) {
+      it = m_group_index.emplace(bond_id, m_groups.size()).first;
+      m_groups.emplace_back(bond_id, n_partners);
+    }
+    auto &group = m_groups[it->second];
+    assert(group.n_partners == n_partners);
+    group.particles.push_back(&p);
+    group.particles.insert(group.particles.end(), partners.begin(),
+                           partners.end());
+  }
+
+  /**
+   * @brief Add a bond whose partners could not be resolved.
+   *
+   * @param id Id of the particle storing the bond.
+   * @param partner_ids Ids of the bond partners.
+   */
+  void add_unresolved(int id, Utils::Span<const int> partner_ids) {
+    m_unresolved.push_back(
+        {id, std::vector<int>(partner_ids.begin(), partner_ids.end())});
+  }
+
+  std::vector<Group> &groups() { return m_groups; }
+  std::vector<UnresolvedBond> const &unresolved() const { return m_unresolved; }
+
+private:
+  std::vector<Group> m_groups;
+  /** Position of the group of a bond id in @ref m_groups */
+  std::unordered_map<int, std::size_t> m_group_index;
+  std::vector<UnresolvedBond> m_unresolved;
+};
+
+#endif
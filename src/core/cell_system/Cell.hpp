@@ -21,12 +21,14 @@
 
 #include "Particle.hpp"
 #include "ParticleList.hpp"
+#include "cell_system/VerletListCSR.hpp"
 
 #include <utils/Span.hpp>
 
 #include <boost/range/iterator_range.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <utility>
 #include <vector>
 
@@ -110,6 +112,14 @@ public:
   /** Interaction pairs */
   std::vector<std::pair<Particle *, Particle *>> m_verlet_list;
 
+  /** Index of the first particle of the cell in the
+   *  structure-of-arrays mirror, see @ref ParticleSoA */
+  std::size_t soa_offset = 0;
+
+  /** Interaction partners of the particles of the cell, as indices
+   *  into the structure-of-arrays mirror */
+  VerletListCSR m_soa_verlet_list;
+
   /**
    * @brief All neighbors of the cell.
    */
@@ -22,6 +22,7 @@
 #include "cell_system/CellStructure.hpp"
 
 #include "cell_system/AtomDecomposition.hpp"
+#include "cell_system/BalancedDecomposition.hpp"
 #include "cell_system/HybridDecomposition.hpp"
 #include "cell_system/ParticleDecomposition.hpp"
 #include "cell_system/RegularDecomposition.hpp"
@@ -30,12 +31,18 @@
 #include "grid.hpp"
 #include "lees_edwards/lees_edwards.hpp"
 
+#include <utils/Vector.hpp>
 #include <utils/contains.hpp>
+#include <utils/index.hpp>
 
+#include <boost/container/static_vector.hpp>
 #include <boost/mpi/communicator.hpp>
+#include <boost/optional.hpp>
 #include <boost/variant.hpp>
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <set>
@@ -45,7 +52,9 @@
 #include <vector>
 
 CellStructure::CellStructure(BoxGeometry const &box)
-    : m_decomposition{std::make_unique<AtomDecomposition>(box)} {}
+    : m_decomposition{std::make_unique<AtomDecomposition>(box)} {
+  update_cell_colors();
+}
 
 void CellStructure::check_particle_index() {
   auto const max_id = get_max_local_particle_id();
@@ -64,14 +73,12 @@ void CellStructure::check_particle_index() {
 
   /* checks: local particle id */
   int local_part_cnt = 0;
-  for (int n = 0; n < get_max_local_particle_id() + 1; n++) {
-    if (get_local_particle(n) != nullptr) {
-      local_part_cnt++;
-      if (get_local_particle(n)->id() != n) {
-        throw std::runtime_error("local_particles part has corrupted id.");
-      }
+  m_particle_index.for_each([&local_part_cnt](int id, Particle const *p) {
+    local_part_cnt++;
+    if (p->id() != id) {
+      throw std::runtime_error("local_particles part has corrupted id.");
     }
-  }
+  });
 
   if (local_part_cnt != local_particles().size()) {
     throw std::runtime_error(
@@ -148,10 +155,7 @@ Particle *CellStructure::add_particle(Particle &&p) {
 }
 
 int CellStructure::get_max_local_particle_id() const {
-  auto it = std::find_if(m_particle_index.rbegin(), m_particle_index.rend(),
-                         [](const Particle *p) { return p != nullptr; });
-
-  return (it != m_particle_index.rend()) ? (*it)->id() : -1;
+  return m_particle_index.max_id();
 }
 
 void CellStructure::remove_all_particles() {
@@ -170,7 +174,7 @@ unsigned map_data_parts(unsigned data_parts) {
   /* clang-format off */
   return GHOSTTRANS_NONE
          | ((DATA_PART_PROPERTIES & data_parts) ? GHOSTTRANS_PROPRTS : 0u)
-         | ((DATA_PART_POSITION & data_parts) ? GHOSTTRANS_POSITION : 0u)
+         | ((DATA_PART_POSITION & data_parts) ? GHOSTTRANS_POSITION_ALL : 0u)
          | ((DATA_PART_MOMENTUM & data_parts) ? GHOSTTRANS_MOMENTUM : 0u)
          | ((DATA_PART_FORCE & data_parts) ? GHOSTTRANS_FORCE : 0u)
 #ifdef BOND_CONSTRAINT
@@ -180,22 +184,68 @@ unsigned map_data_parts(unsigned data_parts) {
   /* clang-format on */
 }
 
+void CellStructure::ghost_communication(GhostCommunicator const &gcr,
+                                        unsigned int data_parts) {
+  ghosts_update_end();
+  if (use_ghost_overlap) {
+    m_ghost_update.start(gcr, data_parts);
+    m_ghost_update.wait();
+  } else {
+    ghost_communicator(gcr, data_parts);
+  }
+}
+
+unsigned CellStructure::ghost_update_parts(unsigned data_parts) const {
+  auto const ghost_parts = map_data_parts(data_parts);
+  if (data_parts & Cells::DATA_PART_PROPERTIES) {
+    return ghost_parts;
+  }
+  return ghost_parts & (~GHOSTTRANS_POSITION_ALL | m_ghost_position_parts);
+}
+
+void CellStructure::set_ghost_position_parts(bool orientations,
+                                             bool last_positions) {
+  m_ghost_position_parts = GHOSTTRANS_POSITION;
+#ifdef ROTATION
+  if (orientations)
+    m_ghost_position_parts |= GHOSTTRANS_ORIENTATION;
+#endif
+#ifdef BOND_CONSTRAINT
+  if (last_positions)
+    m_ghost_position_parts |= GHOSTTRANS_LAST_POSITION;
+#endif
+}
+
 void CellStructure::ghosts_count() {
-  ghost_communicator(decomposition().exchange_ghosts_comm(),
-                     GHOSTTRANS_PARTNUM);
+  ghost_communication(decomposition().exchange_ghosts_comm(),
+                      GHOSTTRANS_PARTNUM);
 }
 void CellStructure::ghosts_update(unsigned data_parts) {
-  ghost_communicator(decomposition().exchange_ghosts_comm(),
-                     map_data_parts(data_parts));
+  ghost_communication(decomposition().exchange_ghosts_comm(),
+                      ghost_update_parts(data_parts));
+}
+void CellStructure::ghosts_update_begin(unsigned data_parts) {
+  /* data parts that can be received while the forces are calculated */
+  auto constexpr background_parts =
+      Cells::DATA_PART_POSITION | Cells::DATA_PART_MOMENTUM;
+
+  if (not use_ghost_overlap or (data_parts & ~background_parts)) {
+    ghosts_update(data_parts);
+    return;
+  }
+
+  ghosts_update_end();
+  m_ghost_update.start(decomposition().exchange_ghosts_comm(),
+                       ghost_update_parts(data_parts));
 }
 void CellStructure::ghosts_reduce_forces() {
-  ghost_communicator(decomposition().collect_ghost_force_comm(),
-                     GHOSTTRANS_FORCE);
+  ghost_communication(decomposition().collect_ghost_force_comm(),
+                      GHOSTTRANS_FORCE);
 }
 #ifdef BOND_CONSTRAINT
 void CellStructure::ghosts_reduce_rattle_correction() {
-  ghost_communicator(decomposition().collect_ghost_force_comm(),
-                     GHOSTTRANS_RATTLE);
+  ghost_communication(decomposition().collect_ghost_force_comm(),
+                      GHOSTTRANS_RATTLE);
 }
 #endif
 
@@ -203,6 +253,71 @@ Utils::Span<Cell *> CellStructure::local_cells() {
   return decomposition().local_cells();
 }
 
+void CellStructure::update_soa() {
+  if (not m_rebuild_soa) {
+    m_soa.update(0, ghosts_update_pending() ? m_soa_n_local : m_soa.size());
+    return;
+  }
+
+  auto const push_back_cells = [this](Utils::Span<Cell *> cells) {
+    for (auto cell : cells) {
+      cell->soa_offset = m_soa.size();
+      for (auto &p : cell->particles()) {
+        m_soa.push_back(p);
+      }
+    }
+  };
+
+  ghosts_update_end();
+  m_soa.clear();
+  push_back_cells(decomposition().local_cells());
+  m_soa_n_local = m_soa.size();
+  push_back_cells(decomposition().ghost_cells());
+  m_rebuild_soa = false;
+}
+
+void CellStructure::build_soa_verlet_lists(double verlet_cutoff) {
+  auto const &box = decomposition().box();
+  auto const verlet_cutoff2 = verlet_cutoff * verlet_cutoff;
+  auto const local_cells = decomposition().local_cells();
+  auto const n_cells = static_cast<long>(local_cells.size());
+
+  /* Each cell only writes its own list, so the cells can be processed
+   * in any order. */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (long c = 0; c < n_cells; ++c) {
+    auto &cell = *local_cells[static_cast<std::size_t>(c)];
+    auto &verlet_list = cell.m_soa_verlet_list;
+    verlet_list.clear();
+
+    auto const add_partners = [&](std::size_t i, std::size_t first,
+                                  std::size_t last) {
+      auto const pos_i = Utils::Vector3d{m_soa.pos[0][i], m_soa.pos[1][i],
+                                         m_soa.pos[2][i]};
+      for (auto j = first; j < last; ++j) {
+        auto const pos_j = Utils::Vector3d{m_soa.pos[0][j], m_soa.pos[1][j],
+                                           m_soa.pos[2][j]};
+        if (box.get_mi_vector(pos_i, pos_j).norm2() <= verlet_cutoff2) {
+          verlet_list.add_partner(j);
+        }
+      }
+    };
+
+    auto const first = cell.soa_offset;
+    auto const last = first + cell.particles().size();
+    for (auto i = first; i < last; ++i) {
+      add_partners(i, i + 1, last);
+      for (auto const neighbor : cell.neighbors().red()) {
+        add_partners(i, neighbor->soa_offset,
+                     neighbor->soa_offset + neighbor->particles().size());
+      }
+      verlet_list.next_particle();
+    }
+  }
+}
+
 ParticleRange CellStructure::local_particles() {
   return Cells::particles(decomposition().local_cells());
 }
@@ -233,7 +348,63 @@ struct UpdateParticleIndexVisitor {
 };
 } // namespace
 
+bool CellStructure::rebalance_decomposition() {
+  if (m_type != CellStructureType::CELL_STRUCTURE_BALANCED) {
+    return false;
+  }
+
+  auto decomposition =
+      dynamic_cast<BalancedDecomposition &>(*m_decomposition).rebalance();
+  if (not decomposition) {
+    return false;
+  }
+
+  set_particle_decomposition(std::move(decomposition));
+  return true;
+}
+
+void CellStructure::sort_particles_in_cells(BoxGeometry const &box,
+                                            std::vector<ParticleChange> &diff) {
+  auto constexpr n_grid_points = 1 << 21;
+  auto const key = [&box](Particle const &p) {
+    Utils::Vector3i ind;
+    for (int i = 0; i < 3; i++) {
+      auto const x = static_cast<int>(p.pos()[i] * box.length_inv()[i] *
+                                      static_cast<double>(n_grid_points));
+      ind[i] = std::min(std::max(x, 0), n_grid_points - 1);
+    }
+    return Utils::morton_index(ind);
+  };
+
+  std::vector<std::pair<uint64_t, std::size_t>> keys;
+  std::vector<Particle> sorted;
+  for (auto cell : local_cells()) {
+    auto &particles = cell->particles();
+    keys.clear();
+    for (auto it = particles.begin(); it != particles.end(); ++it) {
+      keys.emplace_back(key(*it), std::distance(particles.begin(), it));
+    }
+    if (std::is_sorted(keys.begin(), keys.end())) {
+      continue;
+    }
+    std::sort(keys.begin(), keys.end());
+
+    sorted.clear();
+    sorted.reserve(keys.size());
+    for (auto const &k : keys) {
+      sorted.emplace_back(std::move(particles.begin()[k.second]));
+    }
+    std::move(sorted.begin(), sorted.end(), particles.begin());
+    diff.emplace_back(ModifiedList{particles});
+  }
+}
+
 void CellStructure::resort_particles(bool global_flag, BoxGeometry const &box) {
+  /* particles leave their old node domain when it changes */
+  if (rebalance_decomposition()) {
+    global_flag = true;
+  }
+
   invalidate_ghosts();
 
   static std::vector<ParticleChange> diff;
@@ -241,11 +412,19 @@ void CellStructure::resort_particles(bool global_flag, BoxGeometry const &box) {
 
   m_decomposition->resort(global_flag, diff);
 
+  if (particle_sort_interval > 0 and
+      ++m_resorts_since_particle_sort >= particle_sort_interval) {
+    m_resorts_since_particle_sort = 0;
+    sort_particles_in_cells(box, diff);
+  }
+
   for (auto d : diff) {
     boost::apply_visitor(UpdateParticleIndexVisitor{this}, d);
   }
 
   m_rebuild_verlet_list = true;
+  m_rebuild_soa = true;
+  m_rebuild_bond_table = true;
   m_le_pos_offset_at_last_resort = box.lees_edwards_bc().pos_offset;
 
 #ifdef ADDITIONAL_CHECKS
@@ -254,6 +433,25 @@ void CellStructure::resort_particles(bool global_flag, BoxGeometry const &box) {
 #endif
 }
 
+void CellStructure::build_bond_table() {
+  m_bond_table.clear();
+  boost::container::static_vector<Particle *, 4> partners;
+  for (auto &p : local_particles()) {
+    for (BondView const bond : p.bonds()) {
+      auto const partner_ids = bond.partner_ids();
+      partners.clear();
+      get_local_particles(partner_ids, std::back_inserter(partners));
+      if (std::any_of(partners.begin(), partners.end(),
+                      [](Particle const *partner) { return not partner; })) {
+        m_bond_table.add_unresolved(p.id(), partner_ids);
+      } else {
+        m_bond_table.add(p, bond.bond_id(), Utils::make_span(partners));
+      }
+    }
+  }
+  m_rebuild_bond_table = false;
+}
+
 void CellStructure::set_atom_decomposition(boost::mpi::communicator const &comm,
                                            BoxGeometry const &box,
                                            LocalBox<double> &local_geo) {
@@ -265,8 +463,8 @@ void CellStructure::set_atom_decomposition(boost::mpi::communicator const &comm,
 void CellStructure::set_regular_decomposition(
     boost::mpi::communicator const &comm, double range, BoxGeometry const &box,
     LocalBox<double> &local_geo) {
-  set_particle_decomposition(
-      std::make_unique<RegularDecomposition>(comm, range, box, local_geo));
+  set_particle_decomposition(std::make_unique<RegularDecomposition>(
+      comm, range, box, local_geo, boost::none, use_morton_order));
   m_type = CellStructureType::CELL_STRUCTURE_REGULAR;
   local_geo.set_cell_structure_type(m_type);
 }
@@ -276,7 +474,16 @@ void CellStructure::set_hybrid_decomposition(
     BoxGeometry const &box, LocalBox<double> &local_geo,
     std::set<int> n_square_types) {
   set_particle_decomposition(std::make_unique<HybridDecomposition>(
-      comm, cutoff_regular, box, local_geo, n_square_types));
+      comm, cutoff_regular, box, local_geo, n_square_types, use_morton_order));
   m_type = CellStructureType::CELL_STRUCTURE_HYBRID;
   local_geo.set_cell_structure_type(m_type);
 }
+
+void CellStructure::set_balanced_decomposition(
+    boost::mpi::communicator const &comm, double range, BoxGeometry const &box,
+    LocalBox<double> &local_geo, LoadBalancingParameters const &params) {
+  set_particle_decomposition(std::make_unique<BalancedDecomposition>(
+      comm, range, box, local_geo, params, use_morton_order));
+  m_type = CellStructureType::CELL_STRUCTURE_BALANCED;
+  local_geo.set_cell_structure_type(m_type);
+}
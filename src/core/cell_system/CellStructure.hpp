@@ -29,11 +29,16 @@
 #include "Particle.hpp"
 #include "ParticleList.hpp"
 #include "ParticleRange.hpp"
+#include "algorithm/cell_coloring.hpp"
 #include "algorithm/link_cell.hpp"
 #include "bond_error.hpp"
+#include "cell_system/BondTable.hpp"
 #include "cell_system/Cell.hpp"
 #include "cell_system/CellStructureType.hpp"
+#include "cell_system/ParticleIndex.hpp"
+#include "cell_system/ParticleSoA.hpp"
 #include "ghosts.hpp"
+#include "threads.hpp"
 
 #include <utils/math/sqr.hpp>
 
@@ -50,6 +55,7 @@
 #include <memory>
 #include <set>
 #include <stdexcept>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -125,6 +131,8 @@ struct EuclidianDistance {
 };
 } // namespace detail
 
+struct LoadBalancingParameters;
+
 /** Describes a cell structure / cell system. Contains information
  *  about the communication of cell contents (particles, ghosts, ...)
  *  between different nodes and the relation between particle
@@ -135,7 +143,7 @@ struct EuclidianDistance {
 struct CellStructure {
 private:
   /** The local id-to-particle index */
-  std::vector<Particle *> m_particle_index;
+  ParticleIndex m_particle_index;
   /** Implementation of the primary particle decomposition */
   std::unique_ptr<ParticleDecomposition> m_decomposition;
   /** Active type in m_decomposition */
@@ -145,12 +153,69 @@ private:
   unsigned m_resort_particles = Cells::RESORT_NONE;
   bool m_rebuild_verlet_list = true;
   std::vector<std::pair<Particle *, Particle *>> m_verlet_list;
+  /** Storage of the Verlet list built after the last resort */
+  enum class VerletListLayout {
+    /** No valid Verlet list */
+    NONE,
+    /** Pairs in @ref m_verlet_list */
+    GLOBAL,
+    /** Pairs in the lists of the cells, for the threaded pair loop */
+    PER_CELL,
+    /** Partner indices in the lists of the cells, for the
+     *  structure-of-arrays pair loop */
+    SOA
+  };
+  /** A Verlet list can only be built right after a resort, when
+   *  @ref m_rebuild_verlet_list is set. Pair loops that need a layout
+   *  other than the one built since then fall back to the link cell
+   *  algorithm until the next resort. */
+  VerletListLayout m_verlet_list_layout = VerletListLayout::NONE;
+  /** Local cells grouped by colors for the threaded pair loop */
+  std::vector<std::vector<Cell *>> m_cell_colors;
+  /** Local cells without ghost cells among their red neighbors,
+   *  grouped by colors */
+  std::vector<std::vector<Cell *>> m_interior_cell_colors;
+  /** Local cells with ghost cells among their red neighbors,
+   *  grouped by colors */
+  std::vector<std::vector<Cell *>> m_boundary_cell_colors;
+  /** Ghost update in flight, see @ref ghosts_update_begin */
+  GhostCommunicationRequest m_ghost_update;
+  /** Parts of @ref ParticlePosition sent by ghost updates between
+   *  resorts, see @ref set_ghost_position_parts */
+  unsigned m_ghost_position_parts = GHOSTTRANS_POSITION_ALL;
+  /** Structure-of-arrays mirror of the local and ghost particles */
+  ParticleSoA m_soa;
+  /** Number of local particles in @ref m_soa, which precede the ghosts */
+  std::size_t m_soa_n_local = 0;
+  /** Whether the particles have to be copied into @ref m_soa again */
+  bool m_rebuild_soa = true;
+  /** Number of resorts since the particles were last sorted in their
+   *  cells, see @ref particle_sort_interval */
+  int m_resorts_since_particle_sort = 0;
+  /** Bonds of the local particles with resolved partners */
+  BondTable m_bond_table;
+  /** Whether @ref m_bond_table has to be built again */
+  bool m_rebuild_bond_table = true;
   double m_le_pos_offset_at_last_resort = 0.;
 
 public:
   CellStructure(BoxGeometry const &box);
 
   bool use_verlet_list = true;
+  /** Whether the force loop runs on the structure-of-arrays mirror
+   *  of the particle data, see @ref soa_non_bonded_loop */
+  bool use_soa = false;
+  /** Whether the ghosts are communicated with non-blocking calls, and
+   *  the pair loop overlaps with the ghost update of the integration
+   *  step, see @ref ghosts_update_begin */
+  bool use_ghost_overlap = false;
+  /** Whether the local cells of the regular, hybrid and balanced
+   *  decompositions are ordered along a Morton curve. Takes effect when
+   *  the particle decomposition is set up the next time. */
+  bool use_morton_order = false;
+  /** Number of particle resorts between two sorts of the particles of
+   *  each cell along a Morton curve, 0 to keep the insertion order */
+  int particle_sort_interval = 0;
 
   /**
    * @brief Update local particle index.
@@ -166,10 +231,7 @@ public:
     // cppcheck-suppress assertWithSideEffect
     assert(not p or p->id() == id);
 
-    if (id >= m_particle_index.size())
-      m_particle_index.resize(id + 1);
-
-    m_particle_index[id] = p;
+    m_particle_index.set(id, p);
   }
 
   /**
@@ -234,20 +296,14 @@ public:
   Particle *get_local_particle(int id) {
     assert(id >= 0);
 
-    if (id >= m_particle_index.size())
-      return nullptr;
-
-    return m_particle_index[id];
+    return m_particle_index.find(id);
   }
 
   /** @overload */
   const Particle *get_local_particle(int id) const {
     assert(id >= 0);
 
-    if (id >= m_particle_index.size())
-      return nullptr;
-
-    return m_particle_index[id];
+    return m_particle_index.find(id);
   }
 
   template <class InputRange, class OutputIterator>
@@ -414,6 +470,48 @@ public:
    */
   void ghosts_update(unsigned data_parts);
 
+  /**
+   * @brief Start the update of the ghost particles.
+   *
+   * If @ref use_ghost_overlap is set, the ghost data is communicated
+   * in the background. Until @ref ghosts_update_end is called, only
+   * local particles and the non-communicated parts of the ghosts may
+   * be accessed. The threaded and structure-of-arrays pair loops
+   * process the cells without ghost neighbors in the meantime, and
+   * complete the update before the remaining cells. All other loops,
+   * as well as ghost communications and resorts, complete the update
+   * first.
+   *
+   * Only positions and momenta are communicated in the background,
+   * other data parts are updated right away.
+   *
+   * @param data_parts Particle parts to update, combination of @ref
+   * Cells::DataPart
+   */
+  void ghosts_update_begin(unsigned data_parts);
+
+  /** @brief Complete the ghost update started by @ref ghosts_update_begin.
+   */
+  void ghosts_update_end() { m_ghost_update.wait(); }
+
+  /** @brief Whether a ghost update is in flight. */
+  bool ghosts_update_pending() const { return m_ghost_update.pending(); }
+
+  /**
+   * @brief Select the position data sent by ghost updates between resorts.
+   *
+   * Ghost updates that include @ref Cells::DATA_PART_PROPERTIES, i.e.
+   * those that set up new ghosts after a resort, always send the complete
+   * @ref ParticlePosition. Later updates only send the positions, plus
+   * the parts enabled here.
+   *
+   * @param orientations   Whether particle orientations change between
+   *                       resorts, i.e. whether any particle rotates.
+   * @param last_positions Whether the positions of the previous time
+   *                       step are needed, i.e. whether RATTLE is used.
+   */
+  void set_ghost_position_parts(bool orientations, bool last_positions);
+
   /**
    * @brief Add forces from ghost particles to real particles.
    */
@@ -426,6 +524,19 @@ public:
 #endif
 
 private:
+  /**
+   * @brief Map the data parts of a ghost update to transfer classes,
+   * leaving out the position data that is not needed between resorts.
+   */
+  unsigned ghost_update_parts(unsigned data_parts) const;
+
+  /**
+   * @brief Run a ghost communication, with non-blocking calls if
+   * @ref use_ghost_overlap is set.
+   */
+  void ghost_communication(GhostCommunicator const &gcr,
+                           unsigned int data_parts);
+
   /**
    * @brief Resolve ids to particles.
    *
@@ -484,6 +595,7 @@ private:
    * local particle index.
    */
   void invalidate_ghosts() {
+    ghosts_update_end();
     for (auto const &p : ghost_particles()) {
       if (get_local_particle(p.id()) == &p) {
         update_particle_index(p.id(), nullptr);
@@ -498,9 +610,32 @@ public:
   void resort_particles(bool global_flag, BoxGeometry const &box);
 
 private:
+  /**
+   * @brief Rebuild the node domains of a @ref BalancedDecomposition
+   * if it is due.
+   *
+   * @return Whether the particle decomposition was replaced, in which
+   * case the particles have to be resorted globally.
+   */
+  bool rebalance_decomposition();
+
+  /**
+   * @brief Sort the particles of each local cell along a Morton curve.
+   *
+   * The key of a particle is the Morton index of its folded position on
+   * a grid of @f$ 2^{21} @f$ points per box length, hence particles which
+   * are close in space end up close in memory.
+   *
+   * @param box Box geometry.
+   * @param[out] diff Cells whose particles were reordered.
+   */
+  void sort_particles_in_cells(BoxGeometry const &box,
+                               std::vector<ParticleChange> &diff);
+
   /** @brief Set the particle decomposition, keeping the particles. */
   void set_particle_decomposition(
       std::unique_ptr<ParticleDecomposition> &&decomposition) {
+    ghosts_update_end();
     clear_particle_index();
 
     /* Swap in new cell system */
@@ -510,6 +645,68 @@ private:
     for (auto &p : Cells::particles(decomposition->local_cells())) {
       add_particle(std::move(p));
     }
+
+    update_cell_colors();
+    m_verlet_list_layout = VerletListLayout::NONE;
+    m_rebuild_verlet_list = true;
+    m_rebuild_soa = true;
+    m_rebuild_bond_table = true;
+  }
+
+  /** @brief Group the local cells by colors for the threaded pair loop. */
+  void update_cell_colors() {
+    auto const cells = local_cells();
+    m_cell_colors =
+        Algorithm::color_cells(boost::make_indirect_iterator(cells.begin()),
+                               boost::make_indirect_iterator(cells.end()));
+
+    auto const ghost_cells = decomposition().ghost_cells();
+    std::unordered_set<Cell const *> const ghosts(ghost_cells.begin(),
+                                                  ghost_cells.end());
+    m_interior_cell_colors.clear();
+    m_boundary_cell_colors.clear();
+    for (auto const &color : m_cell_colors) {
+      m_interior_cell_colors.emplace_back();
+      m_boundary_cell_colors.emplace_back();
+      auto &interior = m_interior_cell_colors.back();
+      auto &boundary = m_boundary_cell_colors.back();
+      for (auto const cell : color) {
+        auto const red = cell->neighbors().red();
+        auto const has_ghosts =
+            std::any_of(red.begin(), red.end(), [&ghosts](Cell const *c) {
+              return ghosts.count(c) != 0;
+            });
+        (has_ghosts ? boundary : interior).push_back(cell);
+      }
+    }
+  }
+
+  /**
+   * @brief Run a kernel on the local cells, color by color.
+   *
+   * If a ghost update is in flight, the interior cells are processed
+   * first, then the update is completed and @p ghosts_ready is called,
+   * and the boundary cells are processed last.
+   *
+   * @param cell_kernel Callable with signature <tt>void(Cell &)</tt>.
+   * @param ghosts_ready Callable with signature <tt>void()</tt>.
+   */
+  template <class CellKernel, class GhostsReady>
+  void for_each_colored_cell(CellKernel const &cell_kernel,
+                             GhostsReady const &ghosts_ready) {
+    if (ghosts_update_pending()) {
+      Algorithm::for_each_colored_cell(m_interior_cell_colors, cell_kernel);
+      ghosts_update_end();
+      ghosts_ready();
+      Algorithm::for_each_colored_cell(m_boundary_cell_colors, cell_kernel);
+    } else {
+      Algorithm::for_each_colored_cell(m_cell_colors, cell_kernel);
+    }
+  }
+
+  template <class CellKernel>
+  void for_each_colored_cell(CellKernel const &cell_kernel) {
+    for_each_colored_cell(cell_kernel, []() {});
   }
 
 public:
@@ -550,14 +747,62 @@ public:
                                 LocalBox<double> &local_geo,
                                 std::set<int> n_square_types);
 
+  /**
+   * @brief Set the particle decomposition to @ref BalancedDecomposition.
+   *
+   * @param comm Cartesian communicator to use.
+   * @param range Interaction range.
+   * @param box Box geometry.
+   * @param local_geo Geometry of the local box.
+   * @param params Load balancing parameters.
+   */
+  void set_balanced_decomposition(boost::mpi::communicator const &comm,
+                                  double range, BoxGeometry const &box,
+                                  LocalBox<double> &local_geo,
+                                  LoadBalancingParameters const &params);
+
 public:
   template <class BondKernel> void bond_loop(BondKernel const &bond_kernel) {
+    ghosts_update_end();
     for (auto &p : local_particles()) {
       execute_bond_handler(p, bond_kernel);
     }
   }
 
+  /**
+   * @brief Run a kernel on the bonds of the local particles, one group
+   * of bonds with the same bond id at a time.
+   *
+   * Same as @ref bond_loop, except that the bond partners are resolved
+   * only once after each particle resort, and kept in a @ref BondTable.
+   * Bonds with partners which are not available are reported as broken.
+   *
+   * @tparam GroupKernel Callable with (BondTable::Group &), which has
+   *                     to report broken bonds itself.
+   */
+  template <class GroupKernel>
+  void bond_table_loop(GroupKernel const &group_kernel) {
+    ghosts_update_end();
+    if (m_rebuild_bond_table) {
+      build_bond_table();
+    }
+    for (auto &group : m_bond_table.groups()) {
+      group_kernel(group);
+    }
+    for (auto const &bond : m_bond_table.unresolved()) {
+      bond_broken_error(bond.particle_id, Utils::make_span(bond.partner_ids));
+    }
+  }
+
+  /**
+   * @brief Announce that bonds were added or removed without a resort.
+   */
+  void invalidate_bond_table() { m_rebuild_bond_table = true; }
+
 private:
+  /** @brief Resolve the bond partners of all local particles. */
+  void build_bond_table();
+
   /**
    * @brief Run link_cell algorithm for local cells.
    *
@@ -565,6 +810,7 @@ private:
    * @param kernel Pair kernel functor.
    */
   template <class Kernel> void link_cell(Kernel kernel) {
+    ghosts_update_end();
     auto const maybe_box = decomposition().minimum_image_distance();
     auto const first = boost::make_indirect_iterator(local_cells().begin());
     auto const last = boost::make_indirect_iterator(local_cells().end());
@@ -595,6 +841,7 @@ private:
   template <class PairKernel, class VerletCriterion>
   void verlet_list_loop(PairKernel pair_kernel,
                         const VerletCriterion &verlet_criterion) {
+    ghosts_update_end();
     /* In this case the verlet list update is attached to
      * the pair kernel, and the verlet list is rebuilt as
      * we go. */
@@ -609,6 +856,13 @@ private:
       });
 
       m_rebuild_verlet_list = false;
+      m_verlet_list_layout = VerletListLayout::GLOBAL;
+    } else if (m_verlet_list_layout != VerletListLayout::GLOBAL) {
+      link_cell([&](Particle &p1, Particle &p2, Distance const &d) {
+        if (verlet_criterion(p1, p2, d)) {
+          pair_kernel(p1, p2, d);
+        }
+      });
     } else {
       auto const maybe_box = decomposition().minimum_image_distance();
       /* In this case the pair kernel is just run over the verlet list. */
@@ -629,6 +883,91 @@ private:
     }
   }
 
+  /**
+   * @brief Call a functor with the distance function of the decomposition.
+   *
+   * @tparam F Needs to be callable with the distance function.
+   * @param f Functor.
+   */
+  template <class F> void with_distance_function(F f) {
+    auto const maybe_box = decomposition().minimum_image_distance();
+
+    if (maybe_box) {
+      f(detail::MinimalImageDistance{decomposition().box()});
+    } else {
+      if (decomposition().box().type() != BoxType::CUBOID) {
+        throw std::runtime_error("Non-cuboid box type is not compatible with a "
+                                 "particle decomposition that relies on "
+                                 "EuclideanDistance for distance calculation.");
+      }
+      f(detail::EuclidianDistance{});
+    }
+  }
+
+  /**
+   * @brief Run link_cell algorithm for local cells on the thread team.
+   *
+   * @tparam Kernel Needs to be callable with (Particle, Particle, Distance)
+   *                concurrently for disjoint pairs of cells.
+   * @param kernel Pair kernel functor.
+   */
+  template <class Kernel> void threaded_link_cell(Kernel const &kernel) {
+    with_distance_function([&](auto const &df) {
+      for_each_colored_cell([&](Cell &cell) {
+        Algorithm::link_cell(&cell, &cell + 1,
+                             [&](Particle &p1, Particle &p2) {
+                               kernel(p1, p2, df(p1, p2));
+                             });
+      });
+    });
+  }
+
+  /** Non-bonded pair loop with verlet lists on the thread team.
+   *
+   * The Verlet list is stored in the cell it was built from, such
+   * that it can be traversed with the same coloring.
+   *
+   * @param pair_kernel Kernel to apply
+   * @param verlet_criterion Filter for verlet lists.
+   */
+  template <class PairKernel, class VerletCriterion>
+  void threaded_verlet_list_loop(PairKernel const &pair_kernel,
+                                 const VerletCriterion &verlet_criterion) {
+    if (m_rebuild_verlet_list) {
+      with_distance_function([&](auto const &df) {
+        for_each_colored_cell([&](Cell &cell) {
+          cell.m_verlet_list.clear();
+          Algorithm::link_cell(
+              &cell, &cell + 1, [&](Particle &p1, Particle &p2) {
+                auto const d = df(p1, p2);
+                if (verlet_criterion(p1, p2, d)) {
+                  cell.m_verlet_list.emplace_back(&p1, &p2);
+                  pair_kernel(p1, p2, d);
+                }
+              });
+        });
+      });
+
+      m_rebuild_verlet_list = false;
+      m_verlet_list_layout = VerletListLayout::PER_CELL;
+    } else if (m_verlet_list_layout != VerletListLayout::PER_CELL) {
+      threaded_link_cell([&](Particle &p1, Particle &p2, Distance const &d) {
+        if (verlet_criterion(p1, p2, d)) {
+          pair_kernel(p1, p2, d);
+        }
+      });
+    } else {
+      with_distance_function([&](auto const &df) {
+        for_each_colored_cell([&](Cell &cell) {
+          for (auto &pair : cell.m_verlet_list) {
+            pair_kernel(*pair.first, *pair.second,
+                        df(*pair.first, *pair.second));
+          }
+        });
+      });
+    }
+  }
+
 public:
   /** Non-bonded pair loop.
    * @param pair_kernel Kernel to apply
@@ -653,7 +992,138 @@ public:
     }
   }
 
+  /** Non-bonded pair loop with potential use of verlet lists,
+   * distributed over the OpenMP thread team.
+   *
+   * The local cells are processed color by color (see
+   * @ref Algorithm::color_cells), so that concurrent kernel calls never
+   * write to the same particle. The pair kernel has to be safe to call
+   * concurrently under this condition, i.e. it may only modify the
+   * two particles it is handed, or thread-local data. Falls back to
+   * @ref non_bonded_loop when only one thread is available.
+   *
+   * @param pair_kernel Kernel to apply
+   * @param verlet_criterion Filter for verlet lists.
+   */
+  template <class PairKernel, class VerletCriterion>
+  void threaded_non_bonded_loop(PairKernel pair_kernel,
+                                const VerletCriterion &verlet_criterion) {
+    if (Threads::max_threads() == 1 and not use_ghost_overlap) {
+      non_bonded_loop(pair_kernel, verlet_criterion);
+    } else if (use_verlet_list) {
+      threaded_verlet_list_loop(pair_kernel, verlet_criterion);
+    } else {
+      threaded_link_cell(pair_kernel);
+    }
+  }
+
+  /**
+   * @brief Whether @ref soa_non_bonded_loop can be used.
+   *
+   * This is the case if it is enabled by @ref use_soa, and if the
+   * box is cuboid, i.e. without Lees-Edwards boundary conditions.
+   */
+  bool soa_loop_available() const {
+    return use_soa and decomposition().box().type() == BoxType::CUBOID;
+  }
+
+  /** Non-bonded pair loop on the structure-of-arrays mirror.
+   *
+   * The local and ghost particles are copied into the mirror before the
+   * loop, and the forces accumulated in it are added to the particles
+   * afterwards. For each particle of a local cell, the kernel is called
+   * with its interaction partners: the particles after it in the same
+   * cell and the particles of the red neighbor cells. Cells are
+   * processed color by color as in @ref threaded_non_bonded_loop, the
+   * kernel has to be safe to call concurrently under the same
+   * conditions.
+   *
+   * If @ref use_verlet_list is set, the partners closer than
+   * @p verlet_cutoff are stored as index lists in the cells after each
+   * resort (see @ref VerletListCSR), and only those are passed to the
+   * kernel until the next resort.
+   *
+   * @param kernel Kernel with signature
+   *        <tt>void(ParticleSoA &soa, std::size_t i, Partners const &)</tt>,
+   *        which computes the interactions of the particle @c i with
+   *        the partners, either a @ref SoAIndexRange or a span of
+   *        indices.
+   * @param verlet_cutoff Cutoff of the Verlet lists, including the skin.
+   */
+  template <class SoAKernel>
+  void soa_non_bonded_loop(SoAKernel const &kernel, double verlet_cutoff) {
+    assert(soa_loop_available());
+    update_soa();
+    auto const update_soa_ghosts = [this]() {
+      m_soa.update(m_soa_n_local, m_soa.size());
+    };
+
+    if (use_verlet_list and m_rebuild_verlet_list) {
+      if (ghosts_update_pending()) {
+        ghosts_update_end();
+        update_soa_ghosts();
+      }
+      build_soa_verlet_lists(verlet_cutoff);
+      m_rebuild_verlet_list = false;
+      m_verlet_list_layout = VerletListLayout::SOA;
+    }
+
+    if (use_verlet_list and m_verlet_list_layout == VerletListLayout::SOA) {
+      for_each_colored_cell(
+          [&](Cell &cell) {
+            auto const &verlet_list = cell.m_soa_verlet_list;
+            for (std::size_t k = 0; k < verlet_list.n_particles(); ++k) {
+              kernel(m_soa, cell.soa_offset + k, verlet_list.partners(k));
+            }
+          },
+          update_soa_ghosts);
+    } else {
+      for_each_colored_cell(
+          [&](Cell &cell) {
+            auto const first = cell.soa_offset;
+            auto const last = first + cell.particles().size();
+            for (auto i = first; i < last; ++i) {
+              kernel(m_soa, i, SoAIndexRange{i + 1, last});
+              for (auto const neighbor : cell.neighbors().red()) {
+                kernel(m_soa, i,
+                       SoAIndexRange{neighbor->soa_offset,
+                                     neighbor->soa_offset +
+                                         neighbor->particles().size()});
+              }
+            }
+          },
+          update_soa_ghosts);
+
+      /* The positions changed since the last resort, so no Verlet
+       * list can be built before the next one. */
+      if (m_rebuild_verlet_list) {
+        m_rebuild_verlet_list = false;
+        m_verlet_list_layout = VerletListLayout::NONE;
+      }
+    }
+
+    m_soa.add_forces_to_particles();
+  }
+
 private:
+  /**
+   * @brief Copy the local and ghost particles into @ref m_soa.
+   *
+   * After a resort, all particles are copied cell by cell, otherwise
+   * only positions and charges are updated. While a ghost update is in
+   * flight, only the local particles are updated.
+   */
+  void update_soa();
+
+  /**
+   * @brief Build the Verlet lists of the structure-of-arrays pair loop.
+   *
+   * The cells are processed concurrently on the thread team.
+   *
+   * @param verlet_cutoff Cutoff of the Verlet lists, including the skin.
+   */
+  void build_soa_verlet_lists(double verlet_cutoff);
+
   /**
    * @brief Check that particle index is commensurate with particles.
    *
@@ -29,7 +29,9 @@ enum class CellStructureType : int {
   /** cell structure n square */
   CELL_STRUCTURE_NSQUARE = 2,
   /** cell structure hybrid */
-  CELL_STRUCTURE_HYBRID = 3
+  CELL_STRUCTURE_HYBRID = 3,
+  /** cell structure load-balanced regular decomposition */
+  CELL_STRUCTURE_BALANCED = 4
 };
 
 #endif // ESPRESSO_CELLSTRUCTURETYPE_HPP
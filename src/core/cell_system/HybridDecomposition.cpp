@@ -44,10 +44,12 @@ HybridDecomposition::HybridDecomposition(boost::mpi::communicator comm,
                                          double cutoff_regular,
                                          BoxGeometry const &box_geo,
                                          LocalBox<double> const &local_box,
-                                         std::set<int> n_square_types)
+                                         std::set<int> n_square_types,
+                                         bool morton_order)
     : m_comm(std::move(comm)), m_box(box_geo), m_cutoff_regular(cutoff_regular),
-      m_regular_decomposition(RegularDecomposition(
-          m_comm, cutoff_regular + skin, m_box, local_box)),
+      m_regular_decomposition(
+          RegularDecomposition(m_comm, cutoff_regular + skin, m_box, local_box,
+                               {}, morton_order)),
       m_n_square(AtomDecomposition(m_comm, m_box)),
       m_n_square_types(std::move(n_square_types)) {
 
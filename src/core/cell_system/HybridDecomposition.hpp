@@ -79,7 +79,7 @@ public:
   HybridDecomposition(boost::mpi::communicator comm, double cutoff_regular,
                       BoxGeometry const &box_geo,
                       LocalBox<double> const &local_box,
-                      std::set<int> n_square_types);
+                      std::set<int> n_square_types, bool morton_order = false);
 
   Utils::Vector3i get_cell_grid() const {
     return m_regular_decomposition.cell_grid;
@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_SRC_CORE_CELL_SYSTEM_PARTICLE_INDEX_HPP
+#define ESPRESSO_SRC_CORE_CELL_SYSTEM_PARTICLE_INDEX_HPP
+
+#include "Particle.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Map from particle id to particle.
+ *
+ * Ids below the size of a dense array are looked up directly in that
+ * array, all other ids in an open-addressing hash table with linear
+ * probing. The dense array only grows as long as at least half of
+ * it would be occupied, so that the memory needed by the index
+ * is proportional to the number of entries, no matter how large
+ * or sparse the particle ids are. Dense ids starting at zero, as
+ * in most simulations, never go to the hash table.
+ */
+class ParticleIndex {
+  /** Entry of the hash table, empty if the id is negative. */
+  struct Slot {
+    int id = -1;
+    Particle *p = nullptr;
+  };
+
+  /** Size up to which the dense array may grow regardless of occupancy */
+  static constexpr std::size_t min_dense_size = 1024u;
+  /** Minimal number of slots of the hash table */
+  static constexpr std::size_t min_slots = 16u;
+
+  std::vector<Particle *> m_dense;
+  /** Number of entries in @ref m_dense */
+  std::size_t m_n_dense = 0;
+  /** Hash table, the number of slots is a power of two */
+  std::vector<Slot> m_slots;
+  /** Number of entries in @ref m_slots */
+  std::size_t m_n_sparse = 0;
+  /** Shift of the hash function, 64 - log2 of the number of slots */
+  unsigned m_shift = 64u;
+
+  /** Fibonacci hashing, maps consecutive ids to distant slots. */
+  std::size_t home_slot(int id) const {
+    return static_cast<std::size_t>(
+        (static_cast<std::uint64_t>(id) * UINT64_C(11400714819323198485)) >>
+        m_shift);
+  }
+
+  std::size_t next_slot(std::size_t slot) const {
+    return (slot + 1u) & (m_slots.size() - 1u);
+  }
+
+  /** Slot of an id, or of the empty slot where it would be inserted. */
+  std::size_t find_slot(int id) const {
+    assert(not m_slots.empty());
+    auto slot = home_slot(id);
+    while (m_slots[slot].id >= 0 and m_slots[slot].id != id) {
+      slot = next_slot(slot);
+    }
+    return slot;
+  }
+
+  Particle *find_sparse(int id) const {
+    if (m_n_sparse == 0u) {
+      return nullptr;
+    }
+    return m_slots[find_slot(id)].p;
+  }
+
+  void rehash(std::size_t n_slots) {
+    auto old_slots = std::move(m_slots);
+    m_slots.assign(n_slots, Slot{});
+    m_shift = 64u;
+    for (auto n = n_slots; n > 1u; n >>= 1u) {
+      --m_shift;
+    }
+    m_n_sparse = 0;
+    for (auto const &slot : old_slots) {
+      if (slot.id >= 0) {
+        insert_sparse(slot.id, slot.p);
+      }
+    }
+  }
+
+  void insert_sparse(int id, Particle *p) {
+    if (2u * (m_n_sparse + 1u) > m_slots.size()) {
+      rehash(std::max(std::size_t{min_slots}, 2u * m_slots.size()));
+    }
+    auto &slot = m_slots[find_slot(id)];
+    if (slot.id < 0) {
+      slot.id = id;
+      ++m_n_sparse;
+    }
+    slot.p = p;
+  }
+
+  /** Remove an entry, moving up the following entries of its probe
+   *  sequence to keep the table free of tombstones. */
+  void erase_sparse(int id) {
+    if (m_n_sparse == 0u) {
+      return;
+    }
+    auto hole = find_slot(id);
+    if (m_slots[hole].id < 0) {
+      return;
+    }
+    --m_n_sparse;
+    for (auto slot = next_slot(hole); m_slots[slot].id >= 0;
+         slot = next_slot(slot)) {
+      auto const home = home_slot(m_slots[slot].id);
+      /* the entry can fill the hole if its home slot is not
+       * cyclically between the hole and its current slot */
+      auto const movable = (hole <= slot) ? (home <= hole or home > slot)
+                                          : (home <= hole and home > slot);
+      if (movable) {
+        m_slots[hole] = m_slots[slot];
+        hole = slot;
+      }
+    }
+    m_slots[hole] = Slot{};
+  }
+
+  /** Grow the dense array to hold @p id, if it stays half occupied. */
+  bool grow_dense(int id) {
+    auto const new_size =
+        std::max(static_cast<std::size_t>(id) + 1u, 2u * m_dense.size());
+    if (new_size > std::max(std::size_t{min_dense_size}, 2u * (size() + 1u))) {
+      return false;
+    }
+    m_dense.resize(new_size, nullptr);
+    /* move the entries now covered by the dense array */
+    if (m_n_sparse != 0u) {
+      auto const old_slots = std::move(m_slots);
+      m_slots.clear();
+      m_n_sparse = 0;
+      m_shift = 64u;
+      for (auto const &slot : old_slots) {
+        if (slot.id < 0) {
+          continue;
+        }
+        if (static_cast<std::size_t>(slot.id) < m_dense.size()) {
+          m_dense[slot.id] = slot.p;
+          ++m_n_dense;
+        } else {
+          insert_sparse(slot.id, slot.p);
+        }
+      }
+    }
+    return true;
+  }
+
+public:
+  /**
+   * @brief Look up a particle.
+   *
+   * @param id Particle id.
+   * @return Pointer to the particle, or nullptr if it is not in the index.
+   */
+  Particle *find(int id) const {
+    assert(id >= 0);
+    if (static_cast<std::size_t>(id) < m_dense.size()) {
+      return m_dense[id];
+    }
+    return find_sparse(id);
+  }
+
+  /**
+   * @brief Set or remove the entry of a particle.
+   *
+   * @param id Particle id.
+   * @param p Pointer to the particle, or nullptr to remove the entry.
+   */
+  void set(int id, Particle *p) {
+    assert(id >= 0);
+    if (static_cast<std::size_t>(id) >= m_dense.size()) {
+      if (not p) {
+        erase_sparse(id);
+        return;
+      }
+      if (not grow_dense(id)) {
+        insert_sparse(id, p);
+        return;
+      }
+    }
+    auto &entry = m_dense[id];
+    m_n_dense += static_cast<std::size_t>(p != nullptr) -
+                 static_cast<std::size_t>(entry != nullptr);
+    entry = p;
+  }
+
+  /** @brief Remove all entries and release the memory. */
+  void clear() {
+    m_dense = {};
+    m_n_dense = 0;
+    m_slots = {};
+    m_n_sparse = 0;
+    m_shift = 64u;
+  }
+
+  /** @brief Number of entries. */
+  std::size_t size() const { return m_n_dense + m_n_sparse; }
+
+  /** @brief Number of allocated entries of both tables. */
+  std::size_t capacity() const { return m_dense.size() + m_slots.size(); }
+
+  /** @brief Largest id in the index, or -1 if it is empty. */
+  int max_id() const {
+    auto max_id = -1;
+    for (auto const &slot : m_slots) {
+      max_id = std::max(max_id, slot.id);
+    }
+    if (max_id >= 0) {
+      return max_id;
+    }
+    auto const it = std::find_if(m_dense.rbegin(), m_dense.rend(),
+                                 [](Particle const *p) { return p; });
+    return static_cast<int>(std::distance(it, m_dense.rend())) - 1;
+  }
+
+  /**
+   * @brief Call a function on all entries, in no particular order.
+   *
+   * @tparam F Callable with (int, Particle *).
+   */
+  template <class F> void for_each(F &&f) const {
+    for (std::size_t id = 0; id < m_dense.size(); ++id) {
+      if (m_dense[id]) {
+        f(static_cast<int>(id), m_dense[id]);
+      }
+    }
+    for (auto const &slot : m_slots) {
+      if (slot.id >= 0) {
+        f(slot.id, slot.p);
+      }
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_SRC_CORE_CELL_SYSTEM_PARTICLE_SOA_HPP
+#define ESPRESSO_SRC_CORE_CELL_SYSTEM_PARTICLE_SOA_HPP
+
+/** @file
+ *  Structure-of-arrays mirror of the particle data needed by the
+ *  short-range force kernels.
+ *
+ *  The particles of all local and ghost cells are stored back to back,
+ *  cell by cell (see @ref Cell::soa_offset), so that the partners of a
+ *  particle in a cell pair are a contiguous index range. Forces are
+ *  accumulated in the mirror and added to the particles afterwards.
+ */
+
+#include "config.hpp"
+
+#include "Particle.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/** @brief Contiguous range of indices into the mirror. */
+struct SoAIndexRange {
+  std::size_t first;
+  std::size_t last;
+
+  std::size_t size() const { return last - first; }
+  std::size_t operator[](std::size_t k) const { return first + k; }
+};
+
+class ParticleSoA {
+public:
+  /** Positions, one array per Cartesian component */
+  std::array<std::vector<double>, 3> pos;
+  /** Forces, one array per Cartesian component */
+  std::array<std::vector<double>, 3> force;
+  /** Types */
+  std::vector<int> type;
+#ifdef ELECTROSTATICS
+  /** Charges */
+  std::vector<double> q;
+#endif
+#ifdef EXCLUSIONS
+  /** Whether the particle has non-bonded exclusions */
+  std::vector<char> has_exclusions;
+#endif
+  /** Particles the entries are mirrored from */
+  std::vector<Particle *> particles;
+
+  std::size_t size() const { return particles.size(); }
+
+  void clear() {
+    for (auto &v : pos)
+      v.clear();
+    for (auto &v : force)
+      v.clear();
+    type.clear();
+#ifdef ELECTROSTATICS
+    q.clear();
+#endif
+#ifdef EXCLUSIONS
+    has_exclusions.clear();
+#endif
+    particles.clear();
+  }
+
+  /** @brief Append a particle, with zero force. */
+  void push_back(Particle &p) {
+    for (unsigned int i = 0; i < 3; ++i) {
+      pos[i].push_back(p.pos()[i]);
+      force[i].push_back(0.);
+    }
+    type.push_back(p.type());
+#ifdef ELECTROSTATICS
+    q.push_back(p.q());
+#endif
+#ifdef EXCLUSIONS
+    has_exclusions.push_back(not p.exclusions().empty());
+#endif
+    particles.push_back(&p);
+  }
+
+  /**
+   * @brief Refresh the positions and charges from the particles,
+   * and reset the forces.
+   *
+   * The particles have to be the same as at the last @ref push_back,
+   * i.e. no resort may have happened in between.
+   */
+  void update() { update(0, size()); }
+
+  /** @brief Same as @ref update, for the particles in [first, last). */
+  void update(std::size_t first, std::size_t last) {
+    for (std::size_t j = first; j < last; ++j) {
+      auto const &p = *particles[j];
+      for (unsigned int i = 0; i < 3; ++i) {
+        pos[i][j] = p.pos()[i];
+      }
+#ifdef ELECTROSTATICS
+      q[j] = p.q();
+#endif
+    }
+    for (auto &v : force) {
+      std::fill(v.begin() + static_cast<long>(first),
+                v.begin() + static_cast<long>(last), 0.);
+    }
+  }
+
+  /** @brief Add the forces accumulated in the mirror to the particles. */
+  void add_forces_to_particles() const {
+    auto const n = size();
+    for (std::size_t j = 0; j < n; ++j) {
+      auto &f = particles[j]->force();
+      for (unsigned int i = 0; i < 3; ++i) {
+        f[i] += force[i][j];
+      }
+    }
+  }
+};
+
+#endif
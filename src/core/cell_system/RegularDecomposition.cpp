@@ -23,10 +23,12 @@
 
 #include "cell_system/Cell.hpp"
 
+#include "LocalBox.hpp"
 #include "error_handling/RuntimeErrorStream.hpp"
 #include "errorhandling.hpp"
 #include "grid.hpp"
 
+#include <utils/Array.hpp>
 #include <utils/Vector.hpp>
 #include <utils/index.hpp>
 #include <utils/mpi/cart_comm.hpp>
@@ -40,6 +42,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <functional>
@@ -103,13 +106,18 @@ void RegularDecomposition::move_left_or_right(ParticleList &src,
                                               ParticleList &right,
                                               int dir) const {
   for (auto it = src.begin(); it != src.end();) {
-    if ((m_box.get_mi_coord(it->pos()[dir], m_local_box.my_left()[dir], dir) <
-         0.0) and
+    auto const to_left =
+        m_box.get_mi_coord(it->pos()[dir], m_local_box.my_left()[dir], dir);
+    auto const to_right =
+        m_box.get_mi_coord(it->pos()[dir], m_local_box.my_right()[dir], dir);
+    /* On domains wider than half the box, a particle can be in the
+     * minimum image of both boundaries. It goes to the closer one. */
+    auto const closer_to_left = to_right < 0.0 or -to_left <= to_right;
+    if ((to_left < 0.0 and closer_to_left) and
         (m_box.periodic(dir) || (m_local_box.boundary()[2 * dir] == 0))) {
       left.insert(std::move(*it));
       it = src.erase(it);
-    } else if ((m_box.get_mi_coord(it->pos()[dir], m_local_box.my_right()[dir],
-                                   dir) >= 0.0) and
+    } else if ((to_right >= 0.0) and
                (m_box.periodic(dir) ||
                 (m_local_box.boundary()[2 * dir + 1] == 0))) {
       right.insert(std::move(*it));
@@ -253,6 +261,21 @@ void RegularDecomposition::mark_cells() {
         else
           m_ghost_cells.push_back(&cells.at(cnt_c++));
       }
+
+  if (m_morton_order) {
+    auto const key = [this](Cell const *cell) {
+      return Utils::morton_index(cell_index(cell));
+    };
+    std::sort(m_local_cells.begin(), m_local_cells.end(),
+              [&key](Cell const *a, Cell const *b) { return key(a) < key(b); });
+  }
+}
+
+Utils::Vector3i RegularDecomposition::cell_index(Cell const *cell) const {
+  assert(cell >= cells.data() and cell < cells.data() + cells.size());
+  auto const i = static_cast<int>(std::distance(cells.data(), cell));
+  return {i % ghost_cell_grid[0], (i / ghost_cell_grid[0]) % ghost_cell_grid[1],
+          i / (ghost_cell_grid[0] * ghost_cell_grid[1])};
 }
 
 void RegularDecomposition::fill_comm_cell_lists(ParticleList **part_lists,
@@ -268,7 +291,16 @@ void RegularDecomposition::fill_comm_cell_lists(ParticleList **part_lists,
 }
 Utils::Vector3d RegularDecomposition::max_cutoff() const {
   auto dir_max_range = [this](int i) {
-    return std::min(0.5 * m_box.length()[i], m_local_box.length()[i]);
+    /* the thinnest node domain limits the range */
+    auto const &cuts = m_partition.cuts[i];
+    auto n_planes = cell_grid[i];
+    for (std::size_t p = 1; p < cuts.size(); ++p) {
+      n_planes = std::min(n_planes, cuts[p] - cuts[p - 1]);
+    }
+    auto const min_local_box_l = (n_planes == cell_grid[i])
+                                     ? m_local_box.length()[i]
+                                     : n_planes * cell_size[i];
+    return std::min(0.5 * m_box.length()[i], min_local_box_l);
   };
 
   return {dir_max_range(0), dir_max_range(1), dir_max_range(2)};
@@ -369,14 +401,73 @@ void RegularDecomposition::create_cell_grid(double range) {
   auto const node_pos = cart_info.coords;
 
   /* now set all dependent variables */
-  int new_cells = 1;
   for (int i = 0; i < 3; i++) {
     ghost_cell_grid[i] = cell_grid[i] + 2;
-    new_cells *= ghost_cell_grid[i];
     cell_size[i] = m_local_box.length()[i] / static_cast<double>(cell_grid[i]);
     inv_cell_size[i] = 1.0 / cell_size[i];
     cell_offset[i] = node_pos[i] * cell_grid[i];
+    global_cell_grid[i] = cart_info.dims[i] * cell_grid[i];
+
+    /* all nodes have the same number of cells */
+    m_partition.cuts[i].resize(cart_info.dims[i] + 1);
+    for (int p = 0; p <= cart_info.dims[i]; p++) {
+      m_partition.cuts[i][p] = p * cell_grid[i];
+    }
   }
+  m_partition.global_cell_grid = global_cell_grid;
+
+  allocate_cells();
+}
+
+void RegularDecomposition::create_cell_grid(double range,
+                                            CellPartition const &partition) {
+  auto const cart_info = Utils::Mpi::cart_get<3>(m_comm);
+  auto const node_pos = cart_info.coords;
+
+  Utils::Vector3d my_left{};
+  Utils::Vector3d local_box_l{};
+  Utils::Array<int, 6> boundaries{};
+  for (int i = 0; i < 3; i++) {
+    auto const &cuts = partition.cuts[i];
+    assert(cuts.size() == static_cast<std::size_t>(cart_info.dims[i] + 1));
+    global_cell_grid[i] = partition.global_cell_grid[i];
+    cell_offset[i] = cuts[node_pos[i]];
+    cell_grid[i] = cuts[node_pos[i] + 1] - cuts[node_pos[i]];
+    ghost_cell_grid[i] = cell_grid[i] + 2;
+    cell_size[i] =
+        m_box.length()[i] / static_cast<double>(global_cell_grid[i]);
+    inv_cell_size[i] = 1.0 / cell_size[i];
+
+    if (cell_grid[i] < 1) {
+      runtimeErrorMsg() << "empty node domain in direction " << i;
+      cell_grid[i] = 1;
+      ghost_cell_grid[i] = 3;
+    }
+    if (cell_size[i] < range) {
+      runtimeErrorMsg() << "interaction range " << range << " in direction "
+                        << i << " is larger than the cell size "
+                        << cell_size[i];
+    }
+
+    /* the last node ends exactly at the box boundary */
+    my_left[i] = cell_offset[i] * cell_size[i];
+    local_box_l[i] = (node_pos[i] == cart_info.dims[i] - 1)
+                         ? m_box.length()[i] - my_left[i]
+                         : cell_grid[i] * cell_size[i];
+    boundaries[2 * i] = (node_pos[i] == 0);
+    boundaries[2 * i + 1] = -(node_pos[i] == cart_info.dims[i] - 1);
+  }
+
+  m_local_box = LocalBox<double>(my_left, local_box_l, boundaries,
+                                 m_local_box.cell_structure_type());
+  m_partition = partition;
+
+  allocate_cells();
+}
+
+void RegularDecomposition::allocate_cells() {
+  auto const n_local_cells = Utils::product(cell_grid);
+  auto const new_cells = Utils::product(ghost_cell_grid);
 
   /* allocate cell array and cell pointer arrays */
   cells.clear();
@@ -393,10 +484,8 @@ template <class K, class Comparator> auto make_flat_set(Comparator &&comp) {
 void RegularDecomposition::init_cell_interactions() {
 
   auto const halo = Utils::Vector3i{1, 1, 1};
-  auto const cart_info = Utils::Mpi::cart_get<3>(m_comm);
-  auto const node_pos = cart_info.coords;
-  auto const global_halo_offset = hadamard_product(node_pos, cell_grid) - halo;
-  auto const global_size = hadamard_product(node_grid, cell_grid);
+  auto const global_halo_offset = cell_offset - halo;
+  auto const global_size = global_cell_grid;
 
   /* Tanslate a node local index (relative to the origin of the local grid)
    * to a global index. */
@@ -629,13 +718,18 @@ GhostCommunicator RegularDecomposition::prepare_comm() {
   return ghost_comm;
 }
 
-RegularDecomposition::RegularDecomposition(boost::mpi::communicator comm,
-                                           double range,
-                                           BoxGeometry const &box_geo,
-                                           LocalBox<double> const &local_geo)
-    : m_comm(std::move(comm)), m_box(box_geo), m_local_box(local_geo) {
+RegularDecomposition::RegularDecomposition(
+    boost::mpi::communicator comm, double range, BoxGeometry const &box_geo,
+    LocalBox<double> const &local_geo,
+    boost::optional<CellPartition> const &partition, bool morton_order)
+    : m_comm(std::move(comm)), m_box(box_geo), m_local_box(local_geo),
+      m_morton_order(morton_order) {
   /* set up new regular decomposition cell structure */
-  create_cell_grid(range);
+  if (partition) {
+    create_cell_grid(range, *partition);
+  } else {
+    create_cell_grid(range);
+  }
 
   /* setup cell neighbors */
   init_cell_interactions();
@@ -38,8 +38,24 @@
 #include <boost/mpi/communicator.hpp>
 #include <boost/optional.hpp>
 
+#include <array>
 #include <vector>
 
+/**
+ * @brief Rectilinear partition of a global cell grid over the node grid.
+ *
+ * Along direction @c d, the node at Cartesian position @c p owns the
+ * cell planes <tt>[cuts[d][p], cuts[d][p + 1])</tt> of the global cell
+ * grid. All nodes use the same cuts, hence the domains of neighboring
+ * nodes share complete faces and the ghost layers match.
+ */
+struct CellPartition {
+  /** Number of cells per direction in the whole box. */
+  Utils::Vector3i global_cell_grid = {};
+  /** Domain boundaries per direction, in units of cells. */
+  std::array<std::vector<int>, 3> cuts;
+};
+
 /**
  * @brief Regular decomposition cell system.
  *
@@ -72,6 +88,8 @@ struct RegularDecomposition : public ParticleDecomposition {
   Utils::Vector3d cell_size = {};
   /** Offset in global grid */
   Utils::Vector3i cell_offset = {};
+  /** Grid dimensions of the whole box. */
+  Utils::Vector3i global_cell_grid = {};
   /** linked cell grid with ghost frame. */
   Utils::Vector3i ghost_cell_grid = {};
   /** inverse @ref RegularDecomposition::cell_size "cell_size". */
@@ -80,6 +98,9 @@ struct RegularDecomposition : public ParticleDecomposition {
   boost::mpi::communicator m_comm;
   BoxGeometry const &m_box;
   LocalBox<double> m_local_box;
+  CellPartition m_partition;
+  /** Whether the local cells are ordered along a Morton curve. */
+  bool m_morton_order;
   std::vector<Cell> cells;
   std::vector<Cell *> m_local_cells;
   std::vector<Cell *> m_ghost_cells;
@@ -87,9 +108,31 @@ struct RegularDecomposition : public ParticleDecomposition {
   GhostCommunicator m_collect_ghost_force_comm;
 
 public:
+  /**
+   * @brief Set up the cell grid.
+   *
+   * By default, every node gets a domain of the same size, which is the
+   * local box @p local_geo. When a @p partition is given, the node domains
+   * are instead made of the cell planes it assigns to the node, and the
+   * local box is derived from it.
+   *
+   * The local cells are stored in column-major order of the cell grid,
+   * or in the order of a Morton curve if @p morton_order is set. Cells
+   * which are neighbors in space are then mostly close in the local cell
+   * list, and so are their particles in the loops over the cells.
+   *
+   * @param comm Cartesian communicator to use.
+   * @param range Interaction range.
+   * @param box_geo Box geometry.
+   * @param local_geo Geometry of the equal-size local box.
+   * @param partition Optional partition of the global cell grid.
+   * @param morton_order Order the local cells along a Morton curve.
+   */
   RegularDecomposition(boost::mpi::communicator comm, double range,
                        BoxGeometry const &box_geo,
-                       LocalBox<double> const &local_geo);
+                       LocalBox<double> const &local_geo,
+                       boost::optional<CellPartition> const &partition = {},
+                       bool morton_order = false);
 
   GhostCommunicator const &exchange_ghosts_comm() const override {
     return m_exchange_ghosts_comm;
@@ -123,6 +166,18 @@ public:
 
   BoxGeometry const &box() const override { return m_box; };
 
+  /** @brief Partition of the global cell grid over the nodes. */
+  CellPartition const &partition() const { return m_partition; }
+
+  /** @brief Geometry of the domain of this node. */
+  LocalBox<double> const &local_box() const { return m_local_box; }
+
+  /** @brief Whether the local cells are ordered along a Morton curve. */
+  bool morton_order() const { return m_morton_order; }
+
+  /** @brief Position of a cell in the ghost cell grid. */
+  Utils::Vector3i cell_index(Cell const *cell) const;
+
 private:
   /** Fill @c m_local_cells list and @c m_ghost_cells list for use with regular
    *  decomposition.
@@ -202,6 +257,21 @@ private:
    */
   void create_cell_grid(double range);
 
+  /**
+   *  @brief Take over the cell grid of a partition.
+   *
+   *  Sets the same variables as @ref create_cell_grid(double), and
+   *  the local box.
+   *
+   *  @param range interaction range. The cells have to be at least
+   *               as large.
+   *  @param partition partition of the global cell grid.
+   */
+  void create_cell_grid(double range, CellPartition const &partition);
+
+  /** Allocate the cell array and cell pointer arrays. */
+  void allocate_cells();
+
   /** Init cell interactions for cell system regular decomposition.
    *  Initializes the interacting neighbor cell list of a cell.
    *  This list of interacting neighbor cells is used by the Verlet
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_SRC_CORE_CELL_SYSTEM_VERLET_LIST_CSR_HPP
+#define ESPRESSO_SRC_CORE_CELL_SYSTEM_VERLET_LIST_CSR_HPP
+
+/** @file
+ *  Verlet list in compressed sparse row format.
+ *
+ *  The interaction partners of consecutive particles are stored back to
+ *  back as 32-bit indices, and the partners of a particle are found from
+ *  the offset of its first and past its last partner. Compared to a list
+ *  of particle pointer pairs, this needs a quarter of the memory per
+ *  pair, and the partners of a particle can be traversed as a contiguous
+ *  range of indices.
+ */
+
+#include <utils/Span.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class VerletListCSR {
+public:
+  using index_type = std::uint32_t;
+
+private:
+  /** Offset of the first partner of each particle,
+   *  followed by the total number of partners */
+  std::vector<index_type> m_offsets = {0u};
+  /** Partner indices */
+  std::vector<index_type> m_partners;
+
+public:
+  /** @brief Remove all particles, keeping the allocated memory. */
+  void clear() {
+    m_offsets.resize(1);
+    m_partners.clear();
+  }
+
+  /** @brief Add a partner to the particle that is currently filled. */
+  void add_partner(std::size_t index) {
+    assert(index <= std::numeric_limits<index_type>::max());
+    m_partners.push_back(static_cast<index_type>(index));
+  }
+
+  /** @brief Close the partners of the current particle, and start
+   *  filling the partners of the next one. */
+  void next_particle() {
+    assert(m_partners.size() <= std::numeric_limits<index_type>::max());
+    m_offsets.push_back(static_cast<index_type>(m_partners.size()));
+  }
+
+  /** @brief Number of closed particles. */
+  std::size_t n_particles() const { return m_offsets.size() - 1u; }
+
+  /** @brief Total number of partners. */
+  std::size_t n_pairs() const { return m_partners.size(); }
+
+  /** @brief Partners of the @p k-th particle. */
+  Utils::Span<const index_type> partners(std::size_t k) const {
+    assert(k < n_particles());
+    return {m_partners.data() + m_offsets[k],
+            static_cast<std::size_t>(m_offsets[k + 1] - m_offsets[k])};
+  }
+
+  /** @brief Allocated memory in bytes. */
+  std::size_t memory_size() const {
+    return (m_offsets.capacity() + m_partners.capacity()) *
+           sizeof(index_type);
+  }
+};
+
+#endif
@@ -27,12 +27,14 @@
 
 #include "cells.hpp"
 
+#include "cell_system/BalancedDecomposition.hpp"
 #include "cell_system/Cell.hpp"
 #include "cell_system/CellStructure.hpp"
 #include "cell_system/CellStructureType.hpp"
 #include "cell_system/HybridDecomposition.hpp"
 
 #include "Particle.hpp"
+#include "bonded_interactions/rigid_bond.hpp"
 #include "communication.hpp"
 #include "errorhandling.hpp"
 #include "event.hpp"
@@ -200,6 +202,12 @@ void set_hybrid_decomposition(std::set<int> n_square_types,
   on_cell_structure_change();
 }
 
+void set_balanced_decomposition(LoadBalancingParameters const &params) {
+  cell_structure.set_balanced_decomposition(comm_cart, interaction_range(),
+                                            box_geo, local_geo, params);
+  on_cell_structure_change();
+}
+
 void cells_re_init(CellStructureType new_cs) {
   switch (new_cs) {
   case CellStructureType::CELL_STRUCTURE_REGULAR:
@@ -219,6 +227,16 @@ void cells_re_init(CellStructureType new_cs) {
         local_geo, current_hybrid_decomposition.get_n_square_types());
     break;
   }
+  case CellStructureType::CELL_STRUCTURE_BALANCED: {
+    /* the node domains start over from equal sizes */
+    auto const &current_balanced_decomposition =
+        dynamic_cast<BalancedDecomposition const &>(
+            Utils::as_const(cell_structure).decomposition());
+    cell_structure.set_balanced_decomposition(
+        comm_cart, interaction_range(), box_geo, local_geo,
+        current_balanced_decomposition.get_parameters());
+    break;
+  }
   default:
     throw std::runtime_error("Unknown cell system type");
   }
@@ -235,7 +253,7 @@ void check_resort_particles() {
   cell_structure.set_resort_particles(level);
 }
 
-void cells_update_ghosts(unsigned data_parts) {
+static void cells_update_ghosts(unsigned data_parts, bool background) {
   /* data parts that are only updated on resort */
   auto constexpr resort_only_parts =
       Cells::DATA_PART_PROPERTIES | Cells::DATA_PART_BONDS;
@@ -251,6 +269,18 @@ void cells_update_ghosts(unsigned data_parts) {
 
     /* Resort cell system */
     cell_structure.resort_particles(global, box_geo);
+
+    /* Orientations only change between resorts by integration or for
+     * virtual sites, positions of the last time step are only needed
+     * for RATTLE. Leave them out of the ghost updates otherwise. */
+    auto const local_rotation = std::any_of(
+        cell_structure.local_particles().begin(),
+        cell_structure.local_particles().end(),
+        [](Particle const &p) { return p.can_rotate() or p.is_virtual(); });
+    auto const rotation = boost::mpi::all_reduce(comm_cart, local_rotation,
+                                                 std::logical_or<bool>());
+    cell_structure.set_ghost_position_parts(rotation, n_rigidbonds > 0);
+
     cell_structure.ghosts_count();
     cell_structure.ghosts_update(data_parts);
 
@@ -264,12 +294,23 @@ void cells_update_ghosts(unsigned data_parts) {
 
     /* Particles are now sorted */
     cell_structure.clear_resort_particles();
+  } else if (background) {
+    /* Communication step: ghost information, completed later */
+    cell_structure.ghosts_update_begin(data_parts & ~resort_only_parts);
   } else {
     /* Communication step: ghost information */
     cell_structure.ghosts_update(data_parts & ~resort_only_parts);
   }
 }
 
+void cells_update_ghosts(unsigned data_parts) {
+  cells_update_ghosts(data_parts, false);
+}
+
+void cells_update_ghosts_begin(unsigned data_parts) {
+  cells_update_ghosts(data_parts, true);
+}
+
 Cell *find_current_cell(Particle const &p) {
   return cell_structure.find_current_cell(p);
 }
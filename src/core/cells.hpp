@@ -45,11 +45,16 @@
  *   particles with short-range interactions mixed with a few large
  *   particles with long-range interactions. There, the large particles
  *   should be treated using N-square.
+ * - balanced decomposition: A regular decomposition whose node domains
+ *   are resized during the simulation to even out the load of the nodes
+ *   (see @ref BalancedDecomposition.hpp). This is suitable for
+ *   inhomogeneous systems with short-range interactions.
  */
 
 #ifndef ESPRESSO_SRC_CORE_CELLS_HPP
 #define ESPRESSO_SRC_CORE_CELLS_HPP
 
+#include "cell_system/BalancedDecomposition.hpp"
 #include "cell_system/Cell.hpp"
 #include "cell_system/CellStructure.hpp"
 #include "cell_system/CellStructureType.hpp"
@@ -82,6 +87,11 @@ extern CellStructure cell_structure;
 void set_hybrid_decomposition(std::set<int> n_square_types,
                               double cutoff_regular);
 
+/** Initialize cell structure @ref BalancedDecomposition
+ *  @param params   Load balancing parameters.
+ */
+void set_balanced_decomposition(LoadBalancingParameters const &params);
+
 /** Reinitialize the cell structures.
  *  @param new_cs The new topology to use afterwards.
  */
@@ -92,6 +102,13 @@ void cells_re_init(CellStructureType new_cs);
  */
 void cells_update_ghosts(unsigned data_parts);
 
+/** Start the update of the ghost information. Same as
+ *  @ref cells_update_ghosts, except that without resort, the update
+ *  may still be in flight on return, see
+ *  @ref CellStructure::ghosts_update_begin.
+ */
+void cells_update_ghosts_begin(unsigned data_parts);
+
 /**
  * @brief Get pairs closer than @p distance from the cells.
  *
@@ -480,7 +480,11 @@ void handle_collisions() {
   // but does so later in the process. This is needed to guarantee that
   // a particle can only be glued once, even if queued twice in a single
   // time step
+  // Bonds may be added on any node that takes part in a collision, the
+  // bond table of the force calculation has to be rebuilt there.
+  auto bonds_added = false;
   if (bind_centers()) {
+    bonds_added |= not local_collision_queue.empty();
     for (auto &c : local_collision_queue) {
       // put the bond to the non-ghost particle; at least one partner always is
       if (cell_structure.get_local_particle(c.pp1)->is_ghost()) {
@@ -637,6 +641,7 @@ void handle_collisions() {
 #endif
 
     // If any node had a collision, all nodes need to resort
+    bonds_added |= not gathered_queue.empty();
     if (!gathered_queue.empty()) {
       cell_structure.set_resort_particles(Cells::RESORT_GLOBAL);
       cells_update_ghosts(Cells::DATA_PART_PROPERTIES | Cells::DATA_PART_BONDS);
@@ -648,8 +653,13 @@ void handle_collisions() {
   if (collision_params.mode == CollisionModeType::BIND_THREE_PARTICLES) {
     auto gathered_queue = gather_global_collision_queue();
     three_particle_binding_domain_decomposition(gathered_queue);
+    bonds_added |= not gathered_queue.empty();
   } // if TPB
 
+  if (bonds_added) {
+    cell_structure.invalidate_bond_table();
+  }
+
   local_collision_queue.clear();
 }
 
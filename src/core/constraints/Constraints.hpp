@@ -72,6 +72,7 @@ public:
   iterator end() { return m_constraints.end(); }
   const_iterator begin() const { return m_constraints.begin(); }
   const_iterator end() const { return m_constraints.end(); }
+  bool empty() const { return m_constraints.empty(); }
 
   void add_forces(ParticleRange &particles, double t) const {
     if (m_constraints.empty())
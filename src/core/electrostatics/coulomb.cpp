@@ -321,6 +321,115 @@ double calc_energy_long_range(ParticleRange const &particles) {
   return 0.;
 }
 
+struct IsShortRange : public boost::static_visitor<bool> {
+  template <typename T>
+  bool operator()(std::shared_ptr<T> const &) const {
+    return traits::is_short_range<T>::value;
+  }
+};
+
+bool is_short_range() {
+  if (electrostatics_actor) {
+    return boost::apply_visitor(IsShortRange{}, *electrostatics_actor);
+  }
+  return true;
+}
+
+struct HasLongRangeEnergyChange : public boost::static_visitor<bool> {
+  template <typename T>
+  bool operator()(std::shared_ptr<T> const &) const {
+    return false;
+  }
+#ifdef P3M
+  bool operator()(std::shared_ptr<CoulombP3M> const &actor) const {
+    return actor->p3m.params.epsilon == P3M_EPSILON_METALLIC;
+  }
+#endif // P3M
+};
+
+bool has_long_range_energy_change() {
+  if (electrostatics_actor and not electrostatics_extension) {
+    return boost::apply_visitor(HasLongRangeEnergyChange{},
+                                *electrostatics_actor);
+  }
+  return false;
+}
+
+struct SetLongRangeEnergyReference : public boost::static_visitor<void> {
+  explicit SetLongRangeEnergyReference(ParticleRange const &particles)
+      : m_particles(particles) {}
+
+  template <typename T> void operator()(std::shared_ptr<T> const &) const {}
+#ifdef P3M
+  void operator()(std::shared_ptr<CoulombP3M> const &actor) const {
+    actor->set_kspace_energy_reference(m_particles);
+  }
+#endif // P3M
+
+private:
+  ParticleRange const &m_particles;
+};
+
+void set_long_range_energy_reference(ParticleRange const &particles) {
+  if (has_long_range_energy_change()) {
+    boost::apply_visitor(SetLongRangeEnergyReference{particles},
+                         *electrostatics_actor);
+  }
+}
+
+struct LongRangeEnergyChange : public boost::static_visitor<double> {
+  LongRangeEnergyChange(PointCharges const &removed, PointCharges const &added)
+      : m_removed(removed), m_added(added) {}
+
+  template <typename T>
+  double operator()(std::shared_ptr<T> const &) const {
+    return 0.;
+  }
+#ifdef P3M
+  double operator()(std::shared_ptr<CoulombP3M> const &actor) const {
+    return actor->kspace_energy_change(m_removed, m_added);
+  }
+#endif // P3M
+
+private:
+  PointCharges const &m_removed;
+  PointCharges const &m_added;
+};
+
+double long_range_energy_change(PointCharges const &removed,
+                                PointCharges const &added) {
+  if (has_long_range_energy_change()) {
+    return boost::apply_visitor(LongRangeEnergyChange{removed, added},
+                                *electrostatics_actor);
+  }
+  return 0.;
+}
+
+struct UpdateLongRangeEnergyReference : public boost::static_visitor<void> {
+  UpdateLongRangeEnergyReference(PointCharges const &removed,
+                                 PointCharges const &added)
+      : m_removed(removed), m_added(added) {}
+
+  template <typename T> void operator()(std::shared_ptr<T> const &) const {}
+#ifdef P3M
+  void operator()(std::shared_ptr<CoulombP3M> const &actor) const {
+    actor->update_kspace_energy_reference(m_removed, m_added);
+  }
+#endif // P3M
+
+private:
+  PointCharges const &m_removed;
+  PointCharges const &m_added;
+};
+
+void update_long_range_energy_reference(PointCharges const &removed,
+                                        PointCharges const &added) {
+  if (has_long_range_energy_change()) {
+    boost::apply_visitor(UpdateLongRangeEnergyReference{removed, added},
+                         *electrostatics_actor);
+  }
+}
+
 /** @brief Compute the net charge rescaled by the smallest non-zero charge. */
 static auto calc_charge_excess_ratio(std::vector<double> const &charges) {
   using namespace boost::accumulators;
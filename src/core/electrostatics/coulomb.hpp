@@ -46,6 +46,8 @@
 #include <functional>
 #include <memory>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 using ElectrostaticsActor =
     boost::variant<std::shared_ptr<DebyeHueckel>,
@@ -112,6 +114,11 @@ template <> struct has_pressure<CoulombScafacos> : std::false_type {};
 #endif // SCAFACOS
 template <> struct has_pressure<CoulombMMM1D> : std::false_type {};
 
+/** @brief The electrostatic energy is a sum of short-range pair energies. */
+template <class T> struct is_short_range : std::false_type {};
+template <> struct is_short_range<DebyeHueckel> : std::true_type {};
+template <> struct is_short_range<ReactionField> : std::true_type {};
+
 } // namespace traits
 
 /** @brief Check if the system is charge-neutral. */
@@ -132,6 +139,39 @@ void on_cell_structure_change();
 void calc_long_range_force(ParticleRange const &particles);
 double calc_energy_long_range(ParticleRange const &particles);
 
+/**
+ * @brief Whether the energy of the active method is a sum of short-range
+ * pair energies, which is also the case if no method is active.
+ */
+bool is_short_range();
+
+/** @brief Positions and values of point charges. */
+using PointCharges = std::vector<std::pair<Utils::Vector3d, double>>;
+
+/**
+ * @brief Whether the change of the long-range energy can be computed
+ * from the changed charges alone, see @ref long_range_energy_change.
+ *
+ * This is the case for P3M with metallic boundary conditions.
+ */
+bool has_long_range_energy_change();
+/** @brief Store the current charges as the reference state of
+ *  @ref long_range_energy_change.
+ */
+void set_long_range_energy_reference(ParticleRange const &particles);
+/**
+ * @brief Local contribution to the change of the long-range energy
+ * relative to the reference state, when the charges @p removed are
+ * replaced by the charges @p added.
+ */
+double long_range_energy_change(PointCharges const &removed,
+                                PointCharges const &added);
+/** @brief Apply a charge change to the reference state of
+ *  @ref long_range_energy_change.
+ */
+void update_long_range_energy_reference(PointCharges const &removed,
+                                        PointCharges const &added);
+
 namespace detail {
 bool flag_all_reduce(bool flag);
 } // namespace detail
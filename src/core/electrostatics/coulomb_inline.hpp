@@ -101,6 +101,50 @@ inline ShortRangeForceKernel::result_type pair_force_kernel() {
   return {};
 }
 
+/** @brief Parameters of the real-space P3M pair force. */
+struct RealSpaceErfcParameters {
+  double prefactor;
+  double alpha;
+  double r_cut;
+};
+
+/**
+ * @brief Real-space parameters of the solvers whose pair force can be
+ * evaluated by the batched force kernel (see @ref forces_batched.hpp).
+ */
+struct ShortRangeErfcParameters
+    : public boost::static_visitor<boost::optional<RealSpaceErfcParameters>> {
+
+  template <typename T>
+  result_type operator()(std::shared_ptr<T> const &) const {
+    return {};
+  }
+
+#ifdef P3M
+  result_type operator()(std::shared_ptr<CoulombP3M> const &ptr) const {
+    return RealSpaceErfcParameters{ptr->prefactor, ptr->p3m.params.alpha,
+                                   ptr->p3m.params.r_cut};
+  }
+
+#ifdef CUDA
+  result_type operator()(std::shared_ptr<CoulombP3MGPU> const &ptr) const {
+    return RealSpaceErfcParameters{ptr->prefactor, ptr->p3m.params.alpha,
+                                   ptr->p3m.params.r_cut};
+  }
+#endif // CUDA
+#endif // P3M
+};
+
+inline ShortRangeErfcParameters::result_type pair_force_erfc_parameters() {
+#ifdef ELECTROSTATICS
+  if (electrostatics_actor) {
+    auto const visitor = ShortRangeErfcParameters{};
+    return boost::apply_visitor(visitor, *electrostatics_actor);
+  }
+#endif // ELECTROSTATICS
+  return {};
+}
+
 struct ShortRangePressureKernel
     : public boost::static_visitor<boost::optional<std::function<Utils::Matrix<
           double, 3, 3>(double, Utils::Vector3d const &, double)>>> {
@@ -54,6 +54,7 @@
 #include <utils/Vector.hpp>
 #include <utils/constants.hpp>
 #include <utils/integral_parameter.hpp>
+#include <utils/math/bspline.hpp>
 #include <utils/math/int_pow.hpp>
 #include <utils/math/sinc.hpp>
 #include <utils/math/sqr.hpp>
@@ -73,6 +74,8 @@
 #include <functional>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 void CoulombP3M::count_charged_particles() {
   auto local_n = 0;
@@ -101,14 +104,20 @@ void CoulombP3M::count_charged_particles() {
  *
  *  See also: @cite hockney88a eq. 8-22 (p. 275). Note the somewhat
  *  different convention for the prefactors, which is described in
- *  @cite deserno98a @cite deserno98b.
+ *  @cite deserno98a @cite deserno98b. With the analytical differentiation,
+ *  the influence function of @cite ballenegger12a is used instead.
  */
 void CoulombP3M::calc_influence_function_force() {
   auto const start = Utils::Vector3i{p3m.fft.plan[3].start};
   auto const size = Utils::Vector3i{p3m.fft.plan[3].new_mesh};
 
-  p3m.g_force = grid_influence_function<1>(p3m.params, start, start + size,
-                                           box_geo.length());
+  if (p3m.differentiation == P3MDifferentiation::ad) {
+    p3m.g_force = grid_influence_function_ad<P3M_BRILLOUIN + 1>(
+        p3m.params, start, start + size, box_geo.length());
+  } else {
+    p3m.g_force = grid_influence_function<1>(p3m.params, start, start + size,
+                                             box_geo.length());
+  }
 }
 
 /** Calculate the influence function optimized for the energy and the
@@ -156,6 +165,44 @@ static void p3m_tune_aliasing_sums(int nx, int ny, int nz,
   }
 }
 
+/** Aliasing sums used by @ref p3m_k_space_error for the analytical
+ *  differentiation. The sum over @f$ \tilde{U}^2 \vec{k}_m^2 @f$ converges
+ *  slowly, hence one more Brillouin zone is taken into account.
+ */
+static void p3m_tune_aliasing_sums_ad(int nx, int ny, int nz,
+                                      Utils::Vector3i const &mesh,
+                                      Utils::Vector3d const &mesh_i, int cao,
+                                      double alpha_L_i, double *alias1,
+                                      double *alias3, double *alias4) {
+  using Utils::sinc;
+
+  auto constexpr limit = P3M_BRILLOUIN + 1;
+  auto const factor1 = Utils::sqr(Utils::pi() * alpha_L_i);
+
+  *alias1 = *alias3 = *alias4 = 0.0;
+  for (int mx = -limit; mx <= limit; mx++) {
+    auto const nmx = nx + mx * mesh[0];
+    auto const fnmx = mesh_i[0] * nmx;
+    for (int my = -limit; my <= limit; my++) {
+      auto const nmy = ny + my * mesh[1];
+      auto const fnmy = mesh_i[1] * nmy;
+      for (int mz = -limit; mz <= limit; mz++) {
+        auto const nmz = nz + mz * mesh[2];
+        auto const fnmz = mesh_i[2] * nmz;
+
+        auto const nm2 = Utils::sqr(nmx) + Utils::sqr(nmy) + Utils::sqr(nmz);
+        auto const ex = exp(-factor1 * nm2);
+
+        auto const U2 = pow(sinc(fnmx) * sinc(fnmy) * sinc(fnmz), 2.0 * cao);
+
+        *alias1 += Utils::sqr(ex) / nm2;
+        *alias3 += U2 * ex;
+        *alias4 += U2 * nm2;
+      }
+    }
+  }
+}
+
 /** Calculate the real space contribution to the rms error in the force (as
  *  described by Kolafa and Perram).
  *  \param pref       Prefactor of Coulomb interaction.
@@ -176,17 +223,22 @@ static double p3m_real_space_error(double pref, double r_cut_iL, int n_c_part,
  *  P3M method in @cite hockney88a (eq. 8-23 p. 275) in
  *  order to obtain the rms error in the force for a system of N
  *  randomly distributed particles in a cubic box (k-space part).
+ *  For the analytical differentiation, the optimal error of
+ *  @cite ballenegger12a is used instead, which assumes that the
+ *  self-force is subtracted from the forces.
  *  \param pref     Prefactor of Coulomb interaction.
  *  \param mesh     number of mesh points in one direction.
  *  \param cao      charge assignment order.
  *  \param n_c_part number of charged particles in the system.
  *  \param sum_q2   sum of square of charges in the system
  *  \param alpha_L  rescaled Ewald splitting parameter.
+ *  \param differentiation differentiation scheme.
  *  \return reciprocal (k) space error
  */
 static double p3m_k_space_error(double pref, Utils::Vector3i const &mesh,
                                 int cao, int n_c_part, double sum_q2,
-                                double alpha_L) {
+                                double alpha_L,
+                                P3MDifferentiation differentiation) {
   auto const mesh_i =
       Utils::hadamard_division(Utils::Vector3d::broadcast(1.), mesh);
   auto const alpha_L_i = 1. / alpha_L;
@@ -202,11 +254,17 @@ static double p3m_k_space_error(double pref, Utils::Vector3i const &mesh,
           auto const n2 = Utils::sqr(nx) + Utils::sqr(ny) + Utils::sqr(nz);
           auto const cs =
               p3m_analytic_cotangent_sum(nz, mesh_i[2], cao) * ctan_y;
-          double alias1, alias2;
-          p3m_tune_aliasing_sums(nx, ny, nz, mesh, mesh_i, cao, alpha_L_i,
-                                 &alias1, &alias2);
-
-          auto const d = alias1 - Utils::sqr(alias2 / cs) / n2;
+          double d;
+          double alias1, alias2, alias3, alias4;
+          if (differentiation == P3MDifferentiation::ad) {
+            p3m_tune_aliasing_sums_ad(nx, ny, nz, mesh, mesh_i, cao, alpha_L_i,
+                                      &alias1, &alias3, &alias4);
+            d = alias1 - Utils::sqr(alias3) / (cs * alias4);
+          } else {
+            p3m_tune_aliasing_sums(nx, ny, nz, mesh, mesh_i, cao, alpha_L_i,
+                                   &alias1, &alias2);
+            d = alias1 - Utils::sqr(alias2 / cs) / n2;
+          }
           /* at high precision, d can become negative due to extinction;
              also, don't take values that have no significant digits left*/
           if (d > 0 && (fabs(d / alias1) > ROUND_ERROR_PREC))
@@ -257,8 +315,11 @@ void CoulombP3M::init() {
                p3m.params.mesh_off, p3m.ks_pnum, p3m.fft, node_grid, comm_cart);
   p3m.rs_mesh.resize(ca_mesh_size);
 
-  for (auto &e : p3m.E_mesh) {
-    e.resize(ca_mesh_size);
+  /* the analytical differentiation only needs the potential mesh */
+  auto const n_E_meshes =
+      (p3m.differentiation == P3MDifferentiation::ad) ? 1u : 3u;
+  for (std::size_t d = 0; d < p3m.E_mesh.size(); d++) {
+    p3m.E_mesh[d].resize((d < n_E_meshes) ? ca_mesh_size : 0);
   }
 
   p3m.calc_differential_operator();
@@ -270,10 +331,18 @@ void CoulombP3M::init() {
 }
 
 CoulombP3M::CoulombP3M(P3MParameters &&parameters, double prefactor,
-                       int tune_timings, bool tune_verbose)
+                       int tune_timings, bool tune_verbose,
+                       P3MDifferentiation differentiation,
+                       bool tune_differentiation)
     : p3m{std::move(parameters)}, tune_timings{tune_timings},
-      tune_verbose{tune_verbose} {
+      tune_verbose{tune_verbose}, tune_differentiation{tune_differentiation} {
 
+  if (tune_differentiation and not p3m.params.tuning) {
+    throw std::invalid_argument(
+        "CoulombP3M: the differentiation scheme can only be tuned when "
+        "tuning is enabled");
+  }
+  p3m.differentiation = differentiation;
   m_is_tuned = !p3m.params.tuning;
   p3m.params.tuning = false;
   set_prefactor(prefactor);
@@ -365,6 +434,43 @@ template <std::size_t cao> struct AssignForces {
   }
 };
 
+template <std::size_t cao> struct AssignForcesAD {
+  void operator()(p3m_data_struct &p3m, double force_prefac,
+                  ParticleRange const &particles) const {
+    auto const &phi_mesh = p3m.E_mesh[0];
+    auto const pos_shift = std::floor((cao - 1) / 2.0) - (cao % 2) / 2.0;
+
+    for (auto &p : particles) {
+      if (p.q() != 0.0) {
+        auto const pref = p.q() * force_prefac;
+        auto const w = p3m_calculate_interpolation_gradient_weights<cao>(
+            p.pos(), p3m.params.ai, p3m.local_mesh);
+
+        Utils::Vector3d grad_phi{};
+        p3m_interpolate_gradient(
+            p3m.local_mesh, w,
+            [&grad_phi, &phi_mesh](int ind, Utils::Vector3d const &dw) {
+              grad_phi += phi_mesh[ind] * dw;
+            });
+
+        /* remove the field of the particle's own charge */
+        for (int d = 0; d < 3; d++) {
+          auto const pos = p.pos()[d] * p3m.params.ai[d] -
+                           p3m.params.mesh_off[d] - pos_shift;
+          auto const dist = (pos - std::floor(pos)) - 0.5;
+          for (std::size_t s = 0; s < p3m.ad_self_force.size(); s++) {
+            grad_phi[d] -= p.q() * p3m.ad_self_force[s][d] *
+                           std::sin(2. * Utils::pi() *
+                                    static_cast<double>(s + 1) * dist);
+          }
+        }
+
+        p.force() -= pref * grad_phi;
+      }
+    }
+  }
+};
+
 auto dipole_moment(Particle const &p, BoxGeometry const &box) {
   return p.q() * unfolded_position(p.pos(), p.image_box(), box.length());
 }
@@ -415,8 +521,9 @@ Utils::Vector9d CoulombP3M::p3m_calc_kspace_pressure_tensor() {
 
           if (sqk != 0.) {
             auto const node_k_space_energy =
-                p3m.g_energy[ind] * (Utils::sqr(p3m.rs_mesh[2 * ind]) +
-                                     Utils::sqr(p3m.rs_mesh[2 * ind + 1]));
+                p3m.fft.hermitian_weight(ind) * p3m.g_energy[ind] *
+                (Utils::sqr(p3m.rs_mesh[2 * ind]) +
+                 Utils::sqr(p3m.rs_mesh[2 * ind + 1]));
             auto const vterm = -2. * (1. / sqk + half_alpha_inv_sq);
             auto const pref = node_k_space_energy * vterm;
             node_k_space_pressure_tensor[0] += pref * kx * kx; /* sigma_xx */
@@ -460,7 +567,22 @@ double CoulombP3M::long_range_kernel(bool force_flag, bool energy_flag,
   auto const pref = 4. * Utils::pi() / volume / (2. * p3m.params.epsilon + 1.);
 
   /* === k-space force calculation  === */
-  if (force_flag) {
+  if (force_flag and p3m.differentiation == P3MDifferentiation::ad) {
+    /* potential mesh, differentiated in real space */
+    auto &phi_mesh = p3m.E_mesh[0];
+    for (int ind = 0; ind < p3m.fft.plan[3].new_size; ind++) {
+      phi_mesh[2 * ind + 0] = p3m.g_force[ind] * p3m.rs_mesh[2 * ind + 0];
+      phi_mesh[2 * ind + 1] = p3m.g_force[ind] * p3m.rs_mesh[2 * ind + 1];
+    }
+
+    /* Back FFT and redistribute the potential mesh */
+    fft_perform_back(phi_mesh.data(), p3m.fft, comm_cart);
+    p3m.sm.spread_grid(phi_mesh.data(), comm_cart, p3m.local_mesh.dim);
+
+    auto const force_prefac = prefactor / volume;
+    Utils::integral_parameter<AssignForcesAD, 1, 7>(p3m.params.cao, p3m,
+                                                    force_prefac, particles);
+  } else if (force_flag) {
     /* sqrt(-1)*k differentiation */
     int j[3];
     int ind = 0;
@@ -489,28 +611,25 @@ double CoulombP3M::long_range_kernel(bool force_flag, bool energy_flag,
       }
     }
 
-    /* Back FFT force component mesh */
-    auto const check_complex = !p3m.params.tuning;
-    for (int d = 0; d < 3; d++) {
-      fft_perform_back(p3m.E_mesh[d].data(), check_complex, p3m.fft, comm_cart);
-    }
-
-    /* redistribute force component mesh */
+    /* Back FFT force component meshes */
     std::array<double *, 3> E_fields = {
         {p3m.E_mesh[0].data(), p3m.E_mesh[1].data(), p3m.E_mesh[2].data()}};
+    fft_perform_back(Utils::make_span(E_fields), p3m.fft, comm_cart);
+
+    /* redistribute force component mesh */
     p3m.sm.spread_grid(Utils::make_span(E_fields), comm_cart,
                        p3m.local_mesh.dim);
 
     auto const force_prefac = prefactor / volume;
     Utils::integral_parameter<AssignForces, 1, 7>(p3m.params.cao, p3m,
                                                   force_prefac, particles);
+  }
 
-    // add dipole forces
-    if (p3m.params.epsilon != P3M_EPSILON_METALLIC) {
-      auto const dm = prefactor * pref * box_dipole.value();
-      for (auto &p : particles) {
-        p.force() -= p.q() * dm;
-      }
+  // add dipole forces
+  if (force_flag and p3m.params.epsilon != P3M_EPSILON_METALLIC) {
+    auto const dm = prefactor * pref * box_dipole.value();
+    for (auto &p : particles) {
+      p.force() -= p.q() * dm;
     }
   }
 
@@ -519,8 +638,9 @@ double CoulombP3M::long_range_kernel(bool force_flag, bool energy_flag,
     auto node_energy = 0.;
     for (int i = 0; i < p3m.fft.plan[3].new_size; i++) {
       // Use the energy optimized influence function for energy!
-      node_energy += p3m.g_energy[i] * (Utils::sqr(p3m.rs_mesh[2 * i]) +
-                                        Utils::sqr(p3m.rs_mesh[2 * i + 1]));
+      node_energy += p3m.fft.hermitian_weight(i) * p3m.g_energy[i] *
+                     (Utils::sqr(p3m.rs_mesh[2 * i]) +
+                      Utils::sqr(p3m.rs_mesh[2 * i + 1]));
     }
     node_energy /= 2. * volume;
 
@@ -543,16 +663,243 @@ double CoulombP3M::long_range_kernel(bool force_flag, bool energy_flag,
   return 0.;
 }
 
+namespace {
+/** @brief Fourier transform of the charge assignment weights along one
+ *  direction, on the frequencies of the local k-space mesh.
+ *  @param[in]  p3m     P3M data
+ *  @param[in]  d       direction in k-space
+ *  @param[in]  first   global index of the first mesh point
+ *  @param[in]  weight  weight of the i-th mesh point
+ *  @param[out] phase   Fourier transform of the weights
+ */
+template <std::size_t cao, class WeightFunction>
+void assignment_phases(p3m_data_struct const &p3m, int d, int first,
+                       WeightFunction weight,
+                       std::vector<std::complex<double>> &phase) {
+  auto const &plan = p3m.fft.plan[3];
+  auto const mesh = p3m.params.mesh[(d + p3m.ks_pnum) % 3];
+  phase.assign(plan.new_mesh[d], {});
+  for (int i = 0; i < static_cast<int>(cao); i++) {
+    auto const w = weight(i);
+    auto const g = ((first + i) % mesh + mesh) % mesh;
+    for (int j = 0; j < plan.new_mesh[d]; j++) {
+      auto const n = j + plan.start[d];
+      auto const arg = 2. * Utils::pi() * ((n * g) % mesh) / mesh;
+      phase[j] += w * std::polar(1., -arg);
+    }
+  }
+}
+
+/** @brief Self-force of the analytical differentiation.
+ *  The self-force along a direction is sampled over one mesh spacing and
+ *  expanded in a sine series @cite ballenegger12a. Its dependence on the
+ *  other directions is averaged out.
+ */
+template <std::size_t cao> struct CalcADSelfForce {
+  void operator()(p3m_data_struct &p3m) const {
+    auto constexpr n_samples = 8;
+    auto const &plan = p3m.fft.plan[3];
+
+    /* Fourier transforms of the weights and of their derivatives at the
+     * sampled distances, and the mean squared transform of the weights */
+    std::array<std::array<std::vector<std::complex<double>>, n_samples>, 3>
+        w_hat, dw_hat;
+    std::array<std::vector<double>, 3> w_hat_sqr;
+    for (int d = 0; d < 3; d++) {
+      auto const ai = p3m.params.ai[(d + p3m.ks_pnum) % 3];
+      w_hat_sqr[d].assign(plan.new_mesh[d], 0.);
+      for (int j = 0; j < n_samples; j++) {
+        auto const dist = j / static_cast<double>(n_samples) - 0.5;
+        assignment_phases<cao>(
+            p3m, d, 0, [dist](int i) { return Utils::bspline<cao>(i, dist); },
+            w_hat[d][j]);
+        assignment_phases<cao>(
+            p3m, d, 0,
+            [dist, ai](int i) { return ai * Utils::bspline_d<cao>(i, dist); },
+            dw_hat[d][j]);
+        for (int n = 0; n < plan.new_mesh[d]; n++) {
+          w_hat_sqr[d][n] += std::norm(w_hat[d][j][n]) / n_samples;
+        }
+      }
+    }
+
+    /* gradient of the potential of a unit charge at its own position */
+    std::array<double, 3 * n_samples> local_self_force{};
+    int ind = 0;
+    int n[3];
+    for (n[0] = 0; n[0] < plan.new_mesh[0]; n[0]++) {
+      for (n[1] = 0; n[1] < plan.new_mesh[1]; n[1]++) {
+        for (n[2] = 0; n[2] < plan.new_mesh[2]; n[2]++) {
+          auto const g = p3m.fft.hermitian_weight(ind) * p3m.g_force[ind];
+          for (int d = 0; d < 3; d++) {
+            auto const d1 = (d + 1) % 3;
+            auto const d2 = (d + 2) % 3;
+            auto const pref = g * w_hat_sqr[d1][n[d1]] * w_hat_sqr[d2][n[d2]];
+            for (int j = 0; j < n_samples; j++) {
+              local_self_force[d * n_samples + j] +=
+                  pref * std::real(w_hat[d][j][n[d]] *
+                                   std::conj(dw_hat[d][j][n[d]]));
+            }
+          }
+          ind++;
+        }
+      }
+    }
+    std::array<double, 3 * n_samples> self_force;
+    boost::mpi::all_reduce(comm_cart, local_self_force.data(),
+                           static_cast<int>(local_self_force.size()),
+                           self_force.data(), std::plus<>());
+
+    for (int d = 0; d < 3; d++) {
+      /* direction in r-space: */
+      auto const d_rs = (d + p3m.ks_pnum) % 3;
+      for (std::size_t s = 0; s < p3m.ad_self_force.size(); s++) {
+        auto coefficient = 0.;
+        for (int j = 0; j < n_samples; j++) {
+          auto const dist = j / static_cast<double>(n_samples) - 0.5;
+          coefficient +=
+              self_force[d * n_samples + j] *
+              std::sin(2. * Utils::pi() * static_cast<double>(s + 1) * dist);
+        }
+        p3m.ad_self_force[s][d_rs] = 2. * coefficient / n_samples;
+      }
+    }
+  }
+};
+
+/** @brief Add the k-space charge mesh of point charges to a local
+ *  k-space mesh, with the charge assignment of @ref AssignCharge.
+ */
+template <std::size_t cao> struct AssignKSpaceCharges {
+  void
+  operator()(p3m_data_struct const &p3m,
+             std::vector<std::pair<Utils::Vector3d, double>> const &charges,
+             double sign, std::vector<std::complex<double>> &rho_hat) const {
+    auto const &plan = p3m.fft.plan[3];
+    auto const pos_shift = std::floor((cao - 1) / 2.0) - (cao % 2) / 2.0;
+    assert(rho_hat.size() == static_cast<std::size_t>(plan.new_size));
+
+    /* the structure factor of a single charge factorizes
+     * into the Fourier transforms of its weights along each direction */
+    std::array<std::vector<std::complex<double>>, 3> phases;
+    for (auto const &charge : charges) {
+      for (int d = 0; d < 3; d++) {
+        /* direction in r-space: */
+        auto const d_rs = (d + p3m.ks_pnum) % 3;
+        auto const pos = charge.first[d_rs] * p3m.params.ai[d_rs] -
+                         p3m.params.mesh_off[d_rs] - pos_shift;
+        auto const first = static_cast<int>(std::floor(pos));
+        auto const dist = (pos - first) - 0.5;
+        assignment_phases<cao>(
+            p3m, d, first,
+            [dist](int i) { return Utils::bspline<cao>(i, dist); },
+            phases[d]);
+      }
+
+      auto const q = sign * charge.second;
+      int ind = 0;
+      for (int j0 = 0; j0 < plan.new_mesh[0]; j0++) {
+        for (int j1 = 0; j1 < plan.new_mesh[1]; j1++) {
+          auto const phase_01 = q * phases[0][j0] * phases[1][j1];
+          for (int j2 = 0; j2 < plan.new_mesh[2]; j2++) {
+            rho_hat[ind++] += phase_01 * phases[2][j2];
+          }
+        }
+      }
+    }
+  }
+};
+} // namespace
+
+void CoulombP3M::calc_ad_self_force() {
+  Utils::integral_parameter<CalcADSelfForce, 1, 7>(p3m.params.cao, p3m);
+}
+
+void CoulombP3M::set_kspace_energy_reference(ParticleRange const &particles) {
+  assert(p3m.params.epsilon == P3M_EPSILON_METALLIC);
+  charge_assign(particles);
+  p3m.sm.gather_grid(p3m.rs_mesh.data(), comm_cart, p3m.local_mesh.dim);
+  fft_perform_forw(p3m.rs_mesh.data(), p3m.fft, comm_cart);
+
+  p3m.ks_reference.resize(p3m.fft.plan[3].new_size);
+  for (std::size_t i = 0; i < p3m.ks_reference.size(); i++) {
+    p3m.ks_reference[i] = {p3m.rs_mesh[2 * i], p3m.rs_mesh[2 * i + 1]};
+  }
+
+  auto const local_q = boost::accumulate(
+      particles, 0., [](double q, Particle const &p) { return q + p.q(); });
+  boost::mpi::all_reduce(comm_cart, local_q, p3m.ks_reference_sum_q,
+                         std::plus<>());
+}
+
+double CoulombP3M::kspace_energy_change(
+    std::vector<std::pair<Utils::Vector3d, double>> const &removed,
+    std::vector<std::pair<Utils::Vector3d, double>> const &added) const {
+  std::vector<std::complex<double>> rho_hat(p3m.ks_reference.size());
+  Utils::integral_parameter<AssignKSpaceCharges, 1, 7>(p3m.params.cao, p3m,
+                                                       removed, -1., rho_hat);
+  Utils::integral_parameter<AssignKSpaceCharges, 1, 7>(p3m.params.cao, p3m,
+                                                       added, +1., rho_hat);
+
+  auto node_energy = 0.;
+  for (std::size_t i = 0; i < rho_hat.size(); i++) {
+    auto const &rho_ref = p3m.ks_reference[i];
+    node_energy += p3m.fft.hermitian_weight(static_cast<int>(i)) *
+                   p3m.g_energy[i] *
+                   (std::norm(rho_ref + rho_hat[i]) - std::norm(rho_ref));
+  }
+  auto const volume = box_geo.volume();
+  auto energy = node_energy / (2. * volume);
+
+  if (this_node == 0) {
+    auto delta_q = 0.;
+    auto delta_q2 = 0.;
+    for (auto const &charge : removed) {
+      delta_q -= charge.second;
+      delta_q2 -= Utils::sqr(charge.second);
+    }
+    for (auto const &charge : added) {
+      delta_q += charge.second;
+      delta_q2 += Utils::sqr(charge.second);
+    }
+    /* self energy correction */
+    energy -= delta_q2 * p3m.params.alpha * Utils::sqrt_pi_i();
+    /* net charge correction */
+    energy -= (Utils::sqr(p3m.ks_reference_sum_q + delta_q) -
+               Utils::sqr(p3m.ks_reference_sum_q)) *
+              Utils::pi() / (2. * volume * Utils::sqr(p3m.params.alpha));
+  }
+  return prefactor * energy;
+}
+
+void CoulombP3M::update_kspace_energy_reference(
+    std::vector<std::pair<Utils::Vector3d, double>> const &removed,
+    std::vector<std::pair<Utils::Vector3d, double>> const &added) {
+  Utils::integral_parameter<AssignKSpaceCharges, 1, 7>(
+      p3m.params.cao, p3m, removed, -1., p3m.ks_reference);
+  Utils::integral_parameter<AssignKSpaceCharges, 1, 7>(
+      p3m.params.cao, p3m, added, +1., p3m.ks_reference);
+  for (auto const &charge : removed) {
+    p3m.ks_reference_sum_q -= charge.second;
+  }
+  for (auto const &charge : added) {
+    p3m.ks_reference_sum_q += charge.second;
+  }
+}
+
 class CoulombTuningAlgorithm : public TuningAlgorithm {
   p3m_data_struct &p3m;
   double m_mesh_density_min = -1., m_mesh_density_max = -1.;
   // indicates if mesh should be tuned
   bool m_tune_mesh = false;
+  // indicates if the differentiation scheme should be tuned
+  bool m_tune_differentiation;
 
 public:
   CoulombTuningAlgorithm(p3m_data_struct &input_p3m, double prefactor,
-                         int timings)
-      : TuningAlgorithm{prefactor, timings}, p3m{input_p3m} {}
+                         int timings, bool tune_differentiation)
+      : TuningAlgorithm{prefactor, timings}, p3m{input_p3m},
+        m_tune_differentiation{tune_differentiation} {}
 
   P3MParameters &get_params() override { return p3m.params; }
 
@@ -612,7 +959,7 @@ public:
     } else
 #endif
       ks_err = p3m_k_space_error(m_prefactor, mesh, cao, p3m.sum_qpart,
-                                 p3m.sum_q2, alpha_L);
+                                 p3m.sum_q2, alpha_L, p3m.differentiation);
 
     return {Utils::Vector2d{rs_err, ks_err}.norm(), rs_err, ks_err, alpha_L};
   }
@@ -650,6 +997,37 @@ public:
   }
 
   TuningAlgorithm::Parameters get_time() override {
+    if (not m_tune_differentiation) {
+      return get_mesh_time();
+    }
+    /* time both differentiation schemes, each starting from the
+       same real-space cutoff limit */
+    auto const r_cut_iL_max = m_r_cut_iL_max;
+    auto r_cut_iL_max_tuned = m_r_cut_iL_max;
+    auto tuned_params = TuningAlgorithm::Parameters{};
+    auto tuned_differentiation = P3MDifferentiation::ik;
+    for (auto const differentiation :
+         {P3MDifferentiation::ik, P3MDifferentiation::ad}) {
+      p3m.differentiation = differentiation;
+      m_logger->report_differentiation(
+          (differentiation == P3MDifferentiation::ad) ? "ad" : "ik");
+      m_r_cut_iL_max = r_cut_iL_max;
+      reset_n_trials();
+      auto const trial_params = get_mesh_time();
+      if (trial_params.time < tuned_params.time) {
+        tuned_params = trial_params;
+        tuned_differentiation = differentiation;
+        r_cut_iL_max_tuned = m_r_cut_iL_max;
+      }
+    }
+    p3m.differentiation = tuned_differentiation;
+    m_r_cut_iL_max = r_cut_iL_max_tuned;
+    return tuned_params;
+  }
+
+private:
+  /** @brief Find the fastest mesh for the current differentiation scheme. */
+  TuningAlgorithm::Parameters get_mesh_time() {
     auto tuned_params = TuningAlgorithm::Parameters{};
     auto time_best = time_sentinel;
     for (auto mesh_density = m_mesh_density_min;
@@ -710,7 +1088,8 @@ void CoulombP3M::tune() {
           "CoulombP3M: no charged particles in the system");
     }
     try {
-      CoulombTuningAlgorithm parameters(p3m, prefactor, tune_timings);
+      CoulombTuningAlgorithm parameters(p3m, prefactor, tune_timings,
+                                        tune_differentiation);
       parameters.setup_logger(tune_verbose);
       // parameter ranges
       parameters.determine_mesh_limits();
@@ -785,6 +1164,9 @@ void CoulombP3M::scaleby_box_l() {
   sanity_checks_boxl();
   calc_influence_function_force();
   calc_influence_function_energy();
+  if (p3m.differentiation == P3MDifferentiation::ad) {
+    calc_ad_self_force();
+  }
 }
 
 #endif // P3M
@@ -55,6 +55,18 @@
 
 #include <array>
 #include <cmath>
+#include <complex>
+#include <utility>
+#include <vector>
+
+/** @brief Differentiation scheme of the P3M forces. */
+enum class P3MDifferentiation {
+  /** @brief Differentiate in k-space (three back-transforms). */
+  ik,
+  /** @brief Differentiate the charge assignment function in real space
+   *  (one back-transform). */
+  ad
+};
 
 struct p3m_data_struct : public p3m_data_struct_base {
   explicit p3m_data_struct(P3MParameters &&parameters)
@@ -64,9 +76,17 @@ struct p3m_data_struct : public p3m_data_struct_base {
   P3MLocalMesh local_mesh;
   /** real space mesh (local) for CA/FFT. */
   fft_vector<double> rs_mesh;
-  /** mesh (local) for the electric field. */
+  /** mesh (local) for the electric field, or for the electrostatic
+   *  potential in the first component with @ref P3MDifferentiation::ad. */
   std::array<fft_vector<double>, 3> E_mesh;
 
+  /** differentiation scheme of the forces. */
+  P3MDifferentiation differentiation = P3MDifferentiation::ik;
+  /** Fourier coefficients of the self-force of a unit charge with
+   *  @ref P3MDifferentiation::ad, in the distance of the charge to the
+   *  nearest mesh point (one sine term per row). */
+  std::array<Utils::Vector3d, 3> ad_self_force{};
+
   /** number of charged particles (only on head node). */
   int sum_qpart = 0;
   /** Sum of square of charges (only on head node). */
@@ -76,6 +96,12 @@ struct p3m_data_struct : public p3m_data_struct_base {
 
   p3m_interpolation_cache inter_weights;
 
+  /** k-space charge mesh (local) of the reference state of
+   *  @ref CoulombP3M::kspace_energy_change. */
+  std::vector<std::complex<double>> ks_reference;
+  /** net charge of the reference state. */
+  double ks_reference_sum_q = 0.;
+
   /** send/recv mesh sizes */
   p3m_send_mesh sm;
 
@@ -89,13 +115,17 @@ struct CoulombP3M : public Coulomb::Actor<CoulombP3M> {
 
   int tune_timings;
   bool tune_verbose;
+  /** Whether the tuning also chooses the differentiation scheme. */
+  bool tune_differentiation;
 
 private:
   bool m_is_tuned;
 
 public:
   CoulombP3M(P3MParameters &&parameters, double prefactor, int tune_timings,
-             bool tune_verbose);
+             bool tune_verbose,
+             P3MDifferentiation differentiation = P3MDifferentiation::ik,
+             bool tune_differentiation = false);
 
   bool is_tuned() const { return m_is_tuned; }
 
@@ -140,6 +170,8 @@ public:
    * @ref P3MParameters::r_cut_iL "r_cut_iL" and
    * @ref P3MParameters::alpha_L "alpha_L" are tuned to obtain the target
    * @ref P3MParameters::accuracy "accuracy" in optimal time.
+   * If @ref tune_differentiation is set, both differentiation schemes
+   * are timed and the fastest one is kept.
    * These parameters are stored in the @ref p3m object.
    *
    * The function utilizes the analytic expression of the error estimate
@@ -233,9 +265,43 @@ public:
   double long_range_kernel(bool force_flag, bool energy_flag,
                            ParticleRange const &particles);
 
+  /**
+   * @brief Store the k-space charge mesh of the current charges as the
+   * reference state of @ref kspace_energy_change.
+   *
+   * Only valid with metallic boundary conditions.
+   */
+  void set_kspace_energy_reference(ParticleRange const &particles);
+
+  /**
+   * @brief Change of the k-space energy when the point charges
+   * @p removed are replaced by the point charges @p added.
+   *
+   * The change of the structure factor is computed from the charge
+   * assignment of the changed charges only, and includes the self
+   * energy and net charge corrections. Each node only sums over its
+   * local k-space mesh, the results have to be added up over all nodes.
+   *
+   * @param removed   Positions and charges before the change
+   * @param added     Positions and charges after the change
+   * @return Local contribution to the energy change.
+   */
+  double kspace_energy_change(
+      std::vector<std::pair<Utils::Vector3d, double>> const &removed,
+      std::vector<std::pair<Utils::Vector3d, double>> const &added) const;
+
+  /** @brief Apply a charge change to the reference state of
+   *  @ref kspace_energy_change.
+   */
+  void update_kspace_energy_reference(
+      std::vector<std::pair<Utils::Vector3d, double>> const &removed,
+      std::vector<std::pair<Utils::Vector3d, double>> const &added);
+
 private:
   void calc_influence_function_force();
   void calc_influence_function_energy();
+  /** Calculate @ref p3m_data_struct::ad_self_force. */
+  void calc_ad_self_force();
 
   /** Checks for correctness of the k-space cutoff. */
   void sanity_checks_boxl() const;
@@ -24,24 +24,37 @@
 
 #include "EspressoSystemInterface.hpp"
 #include "Observable_stat.hpp"
+#include "cell_system/CellStructureType.hpp"
 #include "communication.hpp"
 #include "constraints.hpp"
 #include "cuda_interface.hpp"
 #include "energy_inline.hpp"
 #include "event.hpp"
 #include "forces.hpp"
+#include "grid.hpp"
 #include "integrate.hpp"
 #include "interactions.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "particle_node.hpp"
+#include "virtual_sites.hpp"
+#include "virtual_sites/VirtualSitesRelative.hpp"
 
 #include "short_range_loop.hpp"
+#include "threads.hpp"
 
 #include "electrostatics/coulomb.hpp"
 #include "magnetostatics/dipoles.hpp"
 
 #include <utils/Span.hpp>
+#include <utils/contains.hpp>
 
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <functional>
 #include <memory>
+#include <utility>
+#include <vector>
 
 static std::shared_ptr<Observable_stat> calculate_energy_local() {
 
@@ -70,6 +83,7 @@ static std::shared_ptr<Observable_stat> calculate_energy_local() {
 
   auto const coulomb_kernel = Coulomb::pair_energy_kernel();
   auto const dipoles_kernel = Dipoles::pair_energy_kernel();
+  Threads::PerThread<Observable_stat> obs_energy_threads(1);
 
   short_range_loop(
       [&obs_energy, coulomb_kernel_ptr = coulomb_kernel.get_ptr()](
@@ -83,14 +97,18 @@ static std::shared_ptr<Observable_stat> calculate_energy_local() {
         }
         return true;
       },
-      [&obs_energy, coulomb_kernel_ptr = coulomb_kernel.get_ptr(),
+      [&obs_energy_threads, coulomb_kernel_ptr = coulomb_kernel.get_ptr(),
        dipoles_kernel_ptr = dipoles_kernel.get_ptr()](
           Particle const &p1, Particle const &p2, Distance const &d) {
         add_non_bonded_pair_energy(p1, p2, d.vec21, sqrt(d.dist2), d.dist2,
                                    coulomb_kernel_ptr, dipoles_kernel_ptr,
-                                   obs_energy);
+                                   obs_energy_threads.local());
       },
-      maximal_cutoff(n_nodes), maximal_cutoff_bonded());
+      maximal_cutoff(n_nodes), maximal_cutoff_bonded(), detail::True{},
+      PairLoopPolicy::THREADED);
+
+  obs_energy_threads.for_each(
+      [&obs_energy](Observable_stat const &obs) { obs_energy += obs; });
 
 #ifdef ELECTROSTATICS
   /* calculate k-space part of electrostatic interaction. */
@@ -128,6 +146,10 @@ double calculate_current_potential_energy_of_system() {
   return obs_energy->accumulate(-obs_energy->kinetic[0]);
 }
 
+double calculate_total_energy_local() {
+  return calculate_energy_local()->accumulate(0);
+}
+
 double observable_compute_energy() {
   auto const obs_energy = calculate_energy();
   return obs_energy->accumulate(0);
@@ -166,3 +188,172 @@ double particle_short_range_energy_contribution(int pid) {
   return mpi_call(Communication::Result::reduction, std::plus<double>(),
                   particle_short_range_energy_contribution_local, pid);
 }
+
+static double particles_energy_contribution_local(std::vector<int> pids,
+                                                  std::vector<int> skip_pids) {
+  double ret = 0.0;
+
+  if (cell_structure.get_resort_particles()) {
+    cells_update_ghosts(global_ghost_flags());
+    /* particles may have changed rank, the particle index is outdated */
+    clear_particle_node();
+  }
+
+  auto const coulomb_kernel = Coulomb::pair_energy_kernel();
+  auto const coulomb_kernel_ptr = coulomb_kernel.get_ptr();
+
+  /* non-bonded and short-range electrostatic energies */
+  auto kernel = [&](Particle const &p1, Particle const &p2,
+                    Utils::Vector3d const &vec) {
+    if (p1.id() == p2.id() or Utils::contains(skip_pids, p2.id()))
+      return;
+    auto const dist = vec.norm();
+    auto energy = 0.;
+#ifdef EXCLUSIONS
+    if (do_nonbonded(p1, p2))
+#endif
+      energy += calc_non_bonded_pair_energy(
+          p1, p2, *get_ia_param(p1.type(), p2.type()), vec, dist,
+          coulomb_kernel_ptr);
+#ifdef ELECTROSTATICS
+    if (coulomb_kernel_ptr != nullptr) {
+      energy += (*coulomb_kernel_ptr)(p1, p2, p1.q() * p2.q(), vec, dist);
+    }
+#endif
+    /* pairs within the set are visited from both particles */
+    ret += (Utils::contains(pids, p2.id())) ? 0.5 * energy : energy;
+  };
+
+  for (auto const pid : pids) {
+    auto const p = cell_structure.get_local_particle(pid);
+    if (p != nullptr and not p->is_ghost()) {
+      cell_structure.run_on_particle_short_range_neighbors(*p, kernel);
+    }
+  }
+
+  /* bonded energies, each bond is stored on exactly one particle */
+  if (not bonded_ia_params.empty()) {
+    cell_structure.bond_loop([&](Particle const &p1, int bond_id,
+                                 Utils::Span<Particle *> partners) {
+      auto involved = Utils::contains(pids, p1.id());
+      auto skipped = Utils::contains(skip_pids, p1.id());
+      for (auto const partner : partners) {
+        involved |= Utils::contains(pids, partner->id());
+        skipped |= Utils::contains(skip_pids, partner->id());
+      }
+      if (not involved or skipped) {
+        return false;
+      }
+      auto const &iaparams = *bonded_ia_params.at(bond_id);
+      auto const result =
+          calc_bonded_energy(iaparams, p1, partners, coulomb_kernel_ptr);
+      if (result) {
+        ret += result.get();
+        return false;
+      }
+      return true;
+    });
+  }
+
+  /* constraint energies */
+  if (not Constraints::constraints.empty()) {
+    Observable_stat obs_energy(1);
+    for (auto const pid : pids) {
+      auto const p = cell_structure.get_local_particle(pid);
+      if (p != nullptr and not p->is_ghost()) {
+        auto const pos = folded_position(p->pos(), box_geo);
+        for (auto const &constraint : Constraints::constraints) {
+          constraint->add_energy(*p, pos, get_sim_time(), obs_energy);
+        }
+      }
+    }
+    ret += obs_energy.accumulate(0.);
+  }
+
+  return ret;
+}
+
+REGISTER_CALLBACK_REDUCTION(particles_energy_contribution_local,
+                            std::plus<double>())
+
+double particles_energy_contribution(std::vector<int> const &pids,
+                                     std::vector<int> const &skip_pids) {
+  return mpi_call(Communication::Result::reduction, std::plus<double>(),
+                  particles_energy_contribution_local, pids, skip_pids);
+}
+
+bool particles_energy_contribution_available() {
+#ifdef ELECTROSTATICS
+  if (not Coulomb::is_short_range() and
+      not Coulomb::has_long_range_energy_change()) {
+    return false;
+  }
+#endif
+#ifdef DIPOLES
+  if (magnetostatics_actor) {
+    return false;
+  }
+#endif
+#ifdef VIRTUAL_SITES_RELATIVE
+  if (std::dynamic_pointer_cast<VirtualSitesRelative>(virtual_sites())) {
+    return false;
+  }
+#endif
+  return cell_structure.decomposition_type() !=
+         CellStructureType::CELL_STRUCTURE_HYBRID;
+}
+
+static void set_long_range_energy_reference_local() {
+  on_observable_calc();
+#ifdef ELECTROSTATICS
+  Coulomb::set_long_range_energy_reference(cell_structure.local_particles());
+#endif
+}
+
+REGISTER_CALLBACK(set_long_range_energy_reference_local)
+
+void set_long_range_energy_reference() {
+  mpi_call_all(set_long_range_energy_reference_local);
+}
+
+static double long_range_energy_change_local(
+    std::vector<std::pair<Utils::Vector3d, double>> removed,
+    std::vector<std::pair<Utils::Vector3d, double>> added) {
+#ifdef ELECTROSTATICS
+  return Coulomb::long_range_energy_change(removed, added);
+#else
+  return 0.;
+#endif
+}
+
+REGISTER_CALLBACK_REDUCTION(long_range_energy_change_local,
+                            std::plus<double>())
+
+double long_range_energy_change(
+    std::vector<std::pair<Utils::Vector3d, double>> const &removed,
+    std::vector<std::pair<Utils::Vector3d, double>> const &added) {
+  if (removed.empty() and added.empty()) {
+    return 0.;
+  }
+  return mpi_call(Communication::Result::reduction, std::plus<double>(),
+                  long_range_energy_change_local, removed, added);
+}
+
+static void update_long_range_energy_reference_local(
+    std::vector<std::pair<Utils::Vector3d, double>> const &removed,
+    std::vector<std::pair<Utils::Vector3d, double>> const &added) {
+#ifdef ELECTROSTATICS
+  Coulomb::update_long_range_energy_reference(removed, added);
+#endif
+}
+
+REGISTER_CALLBACK(update_long_range_energy_reference_local)
+
+void update_long_range_energy_reference(
+    std::vector<std::pair<Utils::Vector3d, double>> const &removed,
+    std::vector<std::pair<Utils::Vector3d, double>> const &added) {
+  if (removed.empty() and added.empty()) {
+    return;
+  }
+  mpi_call_all(update_long_range_energy_reference_local, removed, added);
+}
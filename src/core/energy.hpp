@@ -28,7 +28,11 @@
 
 #include "Observable_stat.hpp"
 
+#include <utils/Vector.hpp>
+
 #include <memory>
+#include <utility>
+#include <vector>
 
 /** Parallel energy calculation. */
 std::shared_ptr<Observable_stat> calculate_energy();
@@ -36,6 +40,12 @@ std::shared_ptr<Observable_stat> calculate_energy();
 /** Calculate the total energy of the system. */
 double calculate_current_potential_energy_of_system();
 
+/** Calculate the total energy of the system on all nodes, without
+ *  going through the MPI callbacks. The result is only valid on the
+ *  head node.
+ */
+double calculate_total_energy_local();
+
 /** Helper function for @ref Observables::Energy. */
 double observable_compute_energy();
 
@@ -50,4 +60,75 @@ double observable_compute_energy();
  */
 double particle_short_range_energy_contribution(int pid);
 
+/**
+ * @brief Compute the potential energy of all interactions of a set of
+ * particles.
+ *
+ * Sums the short-range non-bonded and electrostatic pair energies, the
+ * bonded energies and the constraint energies that involve at least one
+ * of the particles in @p pids. Interactions within the set are counted
+ * once, interactions with a particle in @p skip_pids are left out.
+ * Particles that do not exist do not contribute.
+ *
+ * The difference of this value before and after a change to the particles
+ * in @p pids is the change of the total potential energy, if
+ * @ref particles_energy_contribution_available returns true. This only
+ * takes the neighborhood of the particles into account, except for the
+ * bonded energies, which need a pass over the bond lists.
+ *
+ * @param pids        Particle ids
+ * @param skip_pids   Particle ids of interaction partners to leave out
+ * @return Potential energy of the particles.
+ */
+double particles_energy_contribution(std::vector<int> const &pids,
+                                     std::vector<int> const &skip_pids);
+
+/**
+ * @brief Whether @ref particles_energy_contribution and
+ * @ref long_range_energy_change capture all changes of the potential
+ * energy.
+ *
+ * This is not the case with long-range electrostatic methods other than
+ * P3M with metallic boundary conditions, magnetostatic methods, virtual
+ * sites that follow other particles, or the hybrid decomposition cell
+ * system.
+ */
+bool particles_energy_contribution_available();
+
+/**
+ * @brief Store the current charges as the reference state of
+ * @ref long_range_energy_change.
+ *
+ * This is a full long-range calculation without the forces.
+ */
+void set_long_range_energy_reference();
+
+/**
+ * @brief Compute the change of the long-range electrostatic energy
+ * relative to the reference state, when the point charges @p removed are
+ * replaced by the point charges @p added.
+ *
+ * Only the structure factor terms of the changed charges are computed.
+ * Charges that did not change since the last call to
+ * @ref set_long_range_energy_reference or
+ * @ref update_long_range_energy_reference should not be passed.
+ * The short-range part of the electrostatic energy is part of
+ * @ref particles_energy_contribution.
+ *
+ * @param removed   Positions and charges before the change
+ * @param added     Positions and charges after the change
+ * @return Change of the long-range energy.
+ */
+double long_range_energy_change(
+    std::vector<std::pair<Utils::Vector3d, double>> const &removed,
+    std::vector<std::pair<Utils::Vector3d, double>> const &added);
+
+/**
+ * @brief Apply an accepted charge change to the reference state of
+ * @ref long_range_energy_change.
+ */
+void update_long_range_energy_reference(
+    std::vector<std::pair<Utils::Vector3d, double>> const &removed,
+    std::vector<std::pair<Utils::Vector3d, double>> const &added);
+
 #endif
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "error_handling/DeferredErrorCheck.hpp"
+
+#include <boost/mpi/communicator.hpp>
+
+#include <mpi.h>
+
+#include <utility>
+
+namespace ErrorHandling {
+
+DeferredErrorCheck::DeferredErrorCheck(boost::mpi::communicator comm)
+    : m_comm(std::move(comm)) {}
+
+DeferredErrorCheck::~DeferredErrorCheck() { wait(); }
+
+void DeferredErrorCheck::start(int local_count) {
+  wait();
+  m_local_count = local_count;
+  MPI_Iallreduce(&m_local_count, &m_global_count, 1, MPI_INT, MPI_SUM, m_comm,
+                 &m_request);
+  ++m_n_started;
+}
+
+int DeferredErrorCheck::wait() {
+  if (not pending()) {
+    return 0;
+  }
+  MPI_Wait(&m_request, MPI_STATUS_IGNORE);
+  return m_global_count;
+}
+
+} // namespace ErrorHandling
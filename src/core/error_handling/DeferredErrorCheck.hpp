@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESPRESSO_SRC_CORE_ERROR_HANDLING_DEFERRED_ERROR_CHECK_HPP
+#define ESPRESSO_SRC_CORE_ERROR_HANDLING_DEFERRED_ERROR_CHECK_HPP
+
+#include <boost/mpi/communicator.hpp>
+
+#include <mpi.h>
+
+namespace ErrorHandling {
+
+/**
+ * @brief Count errors on all nodes without waiting for the result.
+ *
+ * The local error counts are summed up with a non-blocking all-reduce,
+ * whose result is only collected by the next call of @ref wait. Work
+ * done in between hides the latency of the reduction. Since all nodes
+ * collect the result in the same call, they stay in lockstep and can
+ * take the same decision based on it.
+ */
+class DeferredErrorCheck {
+  boost::mpi::communicator m_comm;
+  MPI_Request m_request = MPI_REQUEST_NULL;
+  int m_local_count = 0;
+  int m_global_count = 0;
+  /** Number of reductions started so far */
+  int m_n_started = 0;
+
+public:
+  explicit DeferredErrorCheck(boost::mpi::communicator comm);
+  ~DeferredErrorCheck();
+
+  DeferredErrorCheck(DeferredErrorCheck const &) = delete;
+  DeferredErrorCheck &operator=(DeferredErrorCheck const &) = delete;
+
+  /**
+   * @brief Start summing up the local error counts of all nodes.
+   *
+   * Collective call. A reduction which is still in flight is
+   * completed first, and its result is discarded.
+   *
+   * @param local_count Number of errors on this node.
+   */
+  void start(int local_count);
+
+  /**
+   * @brief Wait for the result of the last call of @ref start.
+   *
+   * Collective call.
+   *
+   * @return Number of errors on all nodes, 0 if no reduction is in flight.
+   */
+  int wait();
+
+  /** @brief Whether a reduction is in flight. */
+  bool pending() const { return m_request != MPI_REQUEST_NULL; }
+
+  /** @brief Number of reductions started so far. */
+  int n_started() const { return m_n_started; }
+};
+
+} // namespace ErrorHandling
+
+#endif
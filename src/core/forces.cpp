@@ -36,12 +36,14 @@
 #include "electrostatics/icc.hpp"
 #include "electrostatics/p3m_gpu.hpp"
 #include "forcecap.hpp"
+#include "forces_batched.hpp"
 #include "forces_inline.hpp"
 #include "grid_based_algorithms/electrokinetics.hpp"
 #include "grid_based_algorithms/lb_interface.hpp"
 #include "grid_based_algorithms/lb_particle_coupling.hpp"
 #include "immersed_boundaries.hpp"
 #include "integrate.hpp"
+#include "integrators/respa.hpp"
 #include "interactions.hpp"
 #include "magnetostatics/dipoles.hpp"
 #include "nonbonded_interactions/VerletCriterion.hpp"
@@ -53,11 +55,15 @@
 #include "thermostats/langevin_inline.hpp"
 #include "virtual_sites.hpp"
 
+#include <utils/math/sqr.hpp>
+
 #include <boost/variant.hpp>
 
 #include <profiler/profiler.hpp>
 
 #include <cassert>
+#include <cstddef>
+#include <vector>
 
 /** Initialize the forces for a ghost particle */
 inline ParticleForce init_ghost_force(Particle const &) { return {}; }
@@ -141,6 +147,37 @@ void init_forces_ghosts(const ParticleRange &particles) {
   }
 }
 
+/** Add the long-range forces. In the multiple time step scheme, they are
+ *  only evaluated every few time steps and applied as a scaled impulse.
+ */
+static void add_long_range_forces(const ParticleRange &particles) {
+  if (not respa_active()) {
+    calc_long_range_forces(particles);
+    return;
+  }
+  if (not respa_long_range_step()) {
+    return;
+  }
+  /* The long-range solvers add to the particle forces, which are
+   * set aside to compute the long-range forces on their own. */
+  std::vector<ParticleForce> short_range_forces;
+  short_range_forces.reserve(particles.size());
+  for (auto &p : particles) {
+    short_range_forces.emplace_back(p.f);
+    p.f = ParticleForce{};
+  }
+  calc_long_range_forces(particles);
+  auto const scale = respa_long_range_scale();
+  auto f = short_range_forces.begin();
+  for (auto &p : particles) {
+#ifdef ROTATION
+    p.f = *f++ + ParticleForce{scale * p.force(), scale * p.torque()};
+#else
+    p.f = *f++ + ParticleForce{scale * p.force()};
+#endif
+  }
+}
+
 void force_calc(CellStructure &cell_structure, double time_step, double kT) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
 
@@ -151,10 +188,15 @@ void force_calc(CellStructure &cell_structure, double time_step, double kT) {
   prepare_local_collision_queue();
 #endif
   BondBreakage::clear_queue();
+  /* The ghost positions may still be in flight (see
+   * cells_update_ghosts_begin). The short-range loop completes the
+   * update if it has a pair or bond cutoff, otherwise it is completed
+   * right after the loop, before the ghosts are accessed. */
   auto particles = cell_structure.local_particles();
   auto ghost_particles = cell_structure.ghost_particles();
 #ifdef ELECTROSTATICS
   if (electrostatics_extension) {
+    cell_structure.ghosts_update_end();
     if (auto icc = boost::get<std::shared_ptr<ICCStar>>(
             electrostatics_extension.get_ptr())) {
       (**icc).iteration(cell_structure, particles, ghost_particles);
@@ -163,7 +205,7 @@ void force_calc(CellStructure &cell_structure, double time_step, double kT) {
 #endif
   init_forces(particles, ghost_particles, time_step, kT);
 
-  calc_long_range_forces(particles);
+  add_long_range_forces(particles);
 
   auto const elc_kernel = Coulomb::pair_force_elc_kernel();
   auto const coulomb_kernel = Coulomb::pair_force_kernel();
@@ -181,26 +223,79 @@ void force_calc(CellStructure &cell_structure, double time_step, double kT) {
   auto const dipole_cutoff = INACTIVE_CUTOFF;
 #endif
 
-  short_range_loop(
-      [coulomb_kernel_ptr = coulomb_kernel.get_ptr()](
-          Particle &p1, int bond_id, Utils::Span<Particle *> partners) {
-        return add_bonded_force(p1, bond_id, partners, coulomb_kernel_ptr);
-      },
-      [coulomb_kernel_ptr = coulomb_kernel.get_ptr(),
-       dipoles_kernel_ptr = dipoles_kernel.get_ptr(),
-       elc_kernel_ptr = elc_kernel.get_ptr()](Particle &p1, Particle &p2,
-                                              Distance const &d) {
-        add_non_bonded_pair_force(p1, p2, d.vec21, sqrt(d.dist2), d.dist2,
-                                  coulomb_kernel_ptr, dipoles_kernel_ptr,
-                                  elc_kernel_ptr);
+  /* The pair kernel can only be run on the thread team if it has
+   * no side effects beyond the forces on the two particles. */
+  auto pair_loop_policy = PairLoopPolicy::THREADED;
 #ifdef COLLISION_DETECTION
-        if (collision_params.mode != CollisionModeType::OFF)
-          detect_collision(p1, p2, d.dist2);
+  if (collision_params.mode != CollisionModeType::OFF)
+    pair_loop_policy = PairLoopPolicy::SERIAL;
+#endif
+#ifdef NPT
+  if (integ_switch == INTEG_METHOD_NPT_ISO)
+    pair_loop_policy = PairLoopPolicy::SERIAL;
 #endif
-      },
-      maximal_cutoff(n_nodes), maximal_cutoff_bonded(),
-      VerletCriterion<>{skin, interaction_range(), coulomb_cutoff,
-                        dipole_cutoff, collision_detection_cutoff()});
+
+  auto const bond_kernel = make_bond_group_kernel(
+      [coulomb_kernel_ptr = coulomb_kernel.get_ptr()](BondTable::Group &group) {
+        add_bonded_group_forces(group, coulomb_kernel_ptr);
+      });
+  auto const pair_cutoff = maximal_cutoff(n_nodes);
+
+  /* The structure-of-arrays kernels run on the thread team as well, and
+   * have no support for short-range magnetostatics and ELC. The batched
+   * kernel only knows the real-space part of P3M. */
+  auto const soa_loop = cell_structure.soa_loop_available() and
+                        pair_loop_policy == PairLoopPolicy::THREADED and
+                        not dipoles_kernel and not elc_kernel;
+  auto const erfc_params = Coulomb::pair_force_erfc_parameters();
+  if (soa_loop and (erfc_params or not coulomb_kernel)) {
+    soa_short_range_loop(
+        bond_kernel,
+        [coulomb_kernel_ptr = coulomb_kernel.get_ptr(),
+         erfc_params_ptr = erfc_params.get_ptr(),
+         cutoff2 = Utils::sqr(pair_cutoff),
+         pair_table = BatchedPairTable{}](ParticleSoA &soa, std::size_t i,
+                                          auto const &partners) {
+          add_non_bonded_pair_forces_batched(soa, i, partners, box_geo,
+                                             cutoff2, pair_table,
+                                             erfc_params_ptr,
+                                             coulomb_kernel_ptr);
+        },
+        pair_cutoff, maximal_cutoff_bonded(), pair_cutoff + skin);
+  } else if (soa_loop) {
+    soa_short_range_loop(
+        bond_kernel,
+        [coulomb_kernel_ptr = coulomb_kernel.get_ptr(),
+         cutoff2 = Utils::sqr(pair_cutoff)](ParticleSoA &soa, std::size_t i,
+                                            auto const &partners) {
+          add_non_bonded_pair_forces_soa(soa, i, partners, box_geo, cutoff2,
+                                         coulomb_kernel_ptr);
+        },
+        pair_cutoff, maximal_cutoff_bonded(), pair_cutoff + skin);
+  } else {
+    short_range_loop(
+        bond_kernel,
+        [coulomb_kernel_ptr = coulomb_kernel.get_ptr(),
+         dipoles_kernel_ptr = dipoles_kernel.get_ptr(),
+         elc_kernel_ptr = elc_kernel.get_ptr()](Particle &p1, Particle &p2,
+                                                Distance const &d) {
+          add_non_bonded_pair_force(p1, p2, d.vec21, sqrt(d.dist2), d.dist2,
+                                    coulomb_kernel_ptr, dipoles_kernel_ptr,
+                                    elc_kernel_ptr);
+#ifdef COLLISION_DETECTION
+          if (collision_params.mode != CollisionModeType::OFF)
+            detect_collision(p1, p2, d.dist2);
+#endif
+        },
+        pair_cutoff, maximal_cutoff_bonded(),
+        VerletCriterion<>{skin, interaction_range(), coulomb_cutoff,
+                          dipole_cutoff, collision_detection_cutoff()},
+        pair_loop_policy);
+  }
+
+  /* the loops above do not touch the ghosts if there are no short-range
+   * interactions, while the couplings below read them */
+  cell_structure.ghosts_update_end();
 
   Constraints::constraints.add_forces(particles, get_sim_time());
 
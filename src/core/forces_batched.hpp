@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_SRC_CORE_FORCES_BATCHED_HPP
+#define ESPRESSO_SRC_CORE_FORCES_BATCHED_HPP
+
+/** @file
+ *  Batched short-range force kernel.
+ *
+ *  One particle of the structure-of-arrays mirror is evaluated against
+ *  a contiguous range of partners in batches of @ref batch_size. The
+ *  inner loop has no branches and no indirect parameter lookups other
+ *  than a gather from a flat table of the type pair parameters, so that
+ *  the compiler can map it to SIMD instructions. Lennard-Jones, WCA and
+ *  the real-space part of P3M are supported; all other pairs are handed
+ *  to @ref add_non_bonded_pair_forces_soa.
+ */
+
+#include "config.hpp"
+
+#include "BoxGeometry.hpp"
+#include "cell_system/ParticleSoA.hpp"
+#include "electrostatics/coulomb_inline.hpp"
+#include "forces_inline.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <utils/constants.hpp>
+#include <utils/math/AS_erfc_part.hpp>
+#include <utils/math/int_pow.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/** @brief Parameters of a type pair, as used by the batched kernel. */
+struct BatchedPairParameters {
+  /** Whether the pair only interacts via the supported potentials */
+  bool batched = false;
+  double lj_eps = 0.;
+  double lj_sig = 0.;
+  /** Lennard-Jones cutoff, including the offset */
+  double lj_cut = INACTIVE_CUTOFF;
+  /** Lennard-Jones minimal distance, including the offset */
+  double lj_min = 0.;
+  double lj_offset = 0.;
+  double wca_eps = 0.;
+  double wca_sig = 0.;
+  double wca_cut = INACTIVE_CUTOFF;
+};
+
+/**
+ * @brief Dense table of the type pair parameters.
+ *
+ * Unlike @ref nonbonded_ia_params, which only stores the upper triangle,
+ * every type has a full row, so that the parameters of the partners of
+ * a particle are found by their type alone.
+ */
+class BatchedPairTable {
+  int m_n_types;
+  std::vector<BatchedPairParameters> m_params;
+
+public:
+  /** @brief Tabulate the current interaction parameters. */
+  BatchedPairTable()
+      : m_n_types(max_seen_particle_type),
+        m_params(static_cast<std::size_t>(m_n_types * m_n_types)) {
+    for (int i = 0; i < m_n_types; ++i) {
+      for (int j = 0; j < m_n_types; ++j) {
+        auto const &ia_params = *get_ia_param(i, j);
+        auto &params = m_params[i * m_n_types + j];
+        params.batched = ia_params.lj_wca_only;
+#ifdef LENNARD_JONES
+        params.lj_eps = ia_params.lj.eps;
+        params.lj_sig = ia_params.lj.sig;
+        params.lj_cut = ia_params.lj.cut + ia_params.lj.offset;
+        params.lj_min = ia_params.lj.min + ia_params.lj.offset;
+        params.lj_offset = ia_params.lj.offset;
+#endif
+#ifdef WCA
+        params.wca_eps = ia_params.wca.eps;
+        params.wca_sig = ia_params.wca.sig;
+        params.wca_cut = ia_params.wca.cut;
+#endif
+      }
+    }
+  }
+
+  /** @brief Parameters of the pairs of type @p type with all types. */
+  BatchedPairParameters const *row(int type) const {
+    return m_params.data() + type * m_n_types;
+  }
+};
+
+namespace detail {
+/**
+ * @brief Minimum image of a coordinate difference, without branches.
+ *
+ * Equivalent to @ref BoxGeometry::get_mi_coord for
+ * <tt>|dx| < 1.5 box_length</tt>, which holds in the force calculation
+ * since positions are folded on resort and move less than the skin
+ * between two resorts.
+ *
+ * @param dx                 Coordinate difference.
+ * @param periodic_length    Box length, or zero if not periodic.
+ * @param box_length_half    Half box length.
+ */
+inline double batched_mi_coord(double dx, double periodic_length,
+                               double box_length_half) {
+  auto const shift = (dx > box_length_half)
+                         ? periodic_length
+                         : ((dx < -box_length_half) ? -periodic_length : 0.);
+  return dx - shift;
+}
+} // namespace detail
+
+/** Calculate non-bonded forces between a particle and its partners in
+ *  the structure-of-arrays mirror in batches, and update their forces
+ *  in the mirror. Gives the same forces as
+ *  @ref add_non_bonded_pair_forces_soa, which the pairs not supported
+ *  by the batched loop are handed to.
+ *  @param soa             Particle data.
+ *  @param i               Index of the first particle.
+ *  @param partners        Indices of the partner particles, a
+ *                         @ref SoAIndexRange or a span of indices.
+ *  @param box             Box geometry, for the minimum image convention.
+ *  @param cutoff2         Squared pair cutoff.
+ *  @param table           Type pair parameters.
+ *  @param erfc_params     Real-space P3M parameters, if P3M is active.
+ *  @param coulomb_kernel  Coulomb force kernel, for the pairs not batched.
+ */
+template <class Partners>
+void add_non_bonded_pair_forces_batched(
+    ParticleSoA &soa, std::size_t i, Partners const &partners,
+    BoxGeometry const &box, double cutoff2, BatchedPairTable const &table,
+    Coulomb::RealSpaceErfcParameters const *erfc_params,
+    Coulomb::ShortRangeForceKernel::kernel_type const *coulomb_kernel) {
+  constexpr std::size_t batch_size = 64;
+
+#ifdef EXCLUSIONS
+  if (soa.has_exclusions[i]) {
+    add_non_bonded_pair_forces_soa(soa, i, partners, box, cutoff2,
+                                   coulomb_kernel);
+    return;
+  }
+  auto const *const has_exclusions = soa.has_exclusions.data();
+#endif
+
+  std::array<double, 3> periodic_length;
+  for (unsigned int k = 0; k < 3; ++k) {
+    periodic_length[k] = box.periodic(k) ? box.length()[k] : 0.;
+  }
+  auto const &length_half = box.length_half();
+
+  auto const x_i = soa.pos[0][i];
+  auto const y_i = soa.pos[1][i];
+  auto const z_i = soa.pos[2][i];
+  auto const *const x = soa.pos[0].data();
+  auto const *const y = soa.pos[1].data();
+  auto const *const z = soa.pos[2].data();
+  auto *const f_x = soa.force[0].data();
+  auto *const f_y = soa.force[1].data();
+  auto *const f_z = soa.force[2].data();
+  auto const *const type = soa.type.data();
+  auto const *const params_i = table.row(soa.type[i]);
+
+#ifdef ELECTROSTATICS
+  auto const q_i = soa.q[i];
+  auto const *const q = soa.q.data();
+  auto const prefactor = erfc_params ? erfc_params->prefactor : 0.;
+  auto const alpha = erfc_params ? erfc_params->alpha : 0.;
+  auto const r_cut = erfc_params ? erfc_params->r_cut : 0.;
+  auto const two_a_sqrt_pi_i = 2.0 * alpha * Utils::sqrt_pi_i();
+#endif
+
+  double force_x_i = 0.;
+  double force_y_i = 0.;
+  double force_z_i = 0.;
+  // Per-partner intermediate results of the current batch. Masks are
+  // stored as floating-point numbers, so that all vector lanes in the
+  // loops have the same width.
+  std::array<double, batch_size> batchable, active;
+  std::array<double, batch_size> dx, dy, dz, dist, force_factor;
+#ifdef ELECTROSTATICS
+  std::array<double, batch_size> coulomb_factor;
+#endif
+
+  auto const n_partners = partners.size();
+  for (std::size_t start = 0; start < n_partners; start += batch_size) {
+    auto const n = std::min(batch_size, n_partners - start);
+
+    for (std::size_t l = 0; l < n; ++l) {
+      auto const j = partners[start + l];
+#ifdef EXCLUSIONS
+      auto const excluded = has_exclusions[j] != 0;
+#else
+      auto const excluded = false;
+#endif
+      batchable[l] = (params_i[type[j]].batched and not excluded) ? 1. : 0.;
+    }
+
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+    for (std::size_t l = 0; l < n; ++l) {
+      auto const j = partners[start + l];
+      dx[l] = detail::batched_mi_coord(x_i - x[j], periodic_length[0],
+                                       length_half[0]);
+      dy[l] = detail::batched_mi_coord(y_i - y[j], periodic_length[1],
+                                       length_half[1]);
+      dz[l] = detail::batched_mi_coord(z_i - z[j], periodic_length[2],
+                                       length_half[2]);
+      auto const dist2 = dx[l] * dx[l] + dy[l] * dy[l] + dz[l] * dz[l];
+      auto const r = std::sqrt(dist2);
+      auto const &params = params_i[type[j]];
+
+      auto factor = 0.;
+#ifdef LENNARD_JONES
+      {
+        auto const r_off = r - params.lj_offset;
+        auto const frac6 = Utils::int_pow<6>(params.lj_sig / r_off);
+        auto const lj =
+            48.0 * params.lj_eps * frac6 * (frac6 - 0.5) / (r_off * r);
+        factor += ((r < params.lj_cut) & (r > params.lj_min)) ? lj : 0.;
+      }
+#endif
+#ifdef WCA
+      {
+        auto const frac6 = Utils::int_pow<6>(params.wca_sig / r);
+        auto const wca =
+            48.0 * params.wca_eps * frac6 * (frac6 - 0.5) / (r * r);
+        factor += (r < params.wca_cut) ? wca : 0.;
+      }
+#endif
+      // no short-circuit evaluation, which would introduce branches
+      bool const is_active = (dist2 <= cutoff2) & (batchable[l] != 0.);
+      active[l] = is_active ? 1. : 0.;
+      force_factor[l] = is_active ? factor : 0.;
+      dist[l] = r;
+    }
+
+#ifdef ELECTROSTATICS
+    // the exponential is kept out of the loop above, since there is
+    // no vectorized implementation of it in the standard library
+    if (erfc_params and q_i != 0.) {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+      for (std::size_t l = 0; l < n; ++l) {
+        auto const q1q2 = q_i * q[partners[start + l]];
+        auto const r = dist[l];
+        auto const adist = alpha * r;
+        auto const exp_adist_sq = std::exp(-adist * adist);
+#if USE_ERFC_APPROXIMATION
+        auto const erfc_part_ri = Utils::AS_erfc_part(adist) / r;
+        auto const fac =
+            exp_adist_sq * (erfc_part_ri + two_a_sqrt_pi_i) / (r * r);
+#else
+        auto const erfc_part_ri = std::erfc(adist) / r;
+        auto const fac =
+            (erfc_part_ri + two_a_sqrt_pi_i * exp_adist_sq) / (r * r);
+#endif
+        coulomb_factor[l] =
+            ((active[l] != 0.) & (q1q2 != 0.) & (r < r_cut) & (r > 0.))
+                ? fac * prefactor * q1q2
+                : 0.;
+      }
+    } else {
+      std::fill_n(coulomb_factor.begin(), n, 0.);
+    }
+#endif
+
+    // the partners of a particle are distinct, so that the forces can
+    // be scattered to them from all vector lanes at once
+#ifdef _OPENMP
+#pragma omp simd reduction(+ : force_x_i, force_y_i, force_z_i)
+#endif
+    for (std::size_t l = 0; l < n; ++l) {
+      auto const j = partners[start + l];
+#ifdef ELECTROSTATICS
+      auto const force_x = force_factor[l] * dx[l] + coulomb_factor[l] * dx[l];
+      auto const force_y = force_factor[l] * dy[l] + coulomb_factor[l] * dy[l];
+      auto const force_z = force_factor[l] * dz[l] + coulomb_factor[l] * dz[l];
+#else
+      auto const force_x = force_factor[l] * dx[l];
+      auto const force_y = force_factor[l] * dy[l];
+      auto const force_z = force_factor[l] * dz[l];
+#endif
+      force_x_i += force_x;
+      force_y_i += force_y;
+      force_z_i += force_z;
+      f_x[j] -= force_x;
+      f_y[j] -= force_y;
+      f_z[j] -= force_z;
+    }
+
+    // the scalar kernel applies the cutoff itself
+    for (std::size_t l = 0; l < n; ++l) {
+      if (batchable[l] == 0.) {
+        auto const j = static_cast<std::size_t>(partners[start + l]);
+        add_non_bonded_pair_forces_soa(soa, i, SoAIndexRange{j, j + 1}, box,
+                                       cutoff2, coulomb_kernel);
+      }
+    }
+  }
+
+  soa.force[0][i] += force_x_i;
+  soa.force[1][i] += force_y_i;
+  soa.force[2][i] += force_z_i;
+}
+
+#endif
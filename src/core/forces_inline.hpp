@@ -62,6 +62,8 @@
 
 #include "Particle.hpp"
 #include "bond_error.hpp"
+#include "cell_system/BondTable.hpp"
+#include "cell_system/ParticleSoA.hpp"
 #include "errorhandling.hpp"
 #include "exclusions.hpp"
 #include "thermostat.hpp"
@@ -69,9 +71,12 @@
 #include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
+#include <boost/container/static_vector.hpp>
 #include <boost/optional.hpp>
 #include <boost/variant.hpp>
 
+#include <cmath>
+#include <cstddef>
 #include <tuple>
 
 inline ParticleForce calc_non_bonded_pair_force(
@@ -255,6 +260,82 @@ inline void add_non_bonded_pair_force(
   p2.f += calc_opposing_force(pf, d);
 }
 
+/** Calculate non-bonded forces between a particle and its partners in
+ *  the structure-of-arrays mirror and update their forces in the mirror
+ *  (see @ref CellStructure::soa_non_bonded_loop).
+ *  Lennard-Jones, WCA and the real-space electrostatics are evaluated on
+ *  the mirror. Pairs of types with other potentials, and particles with
+ *  exclusions, are handed to @ref add_non_bonded_pair_force instead.
+ *  Short-range magnetostatics and ELC are not supported.
+ *  @param soa             Particle data.
+ *  @param i               Index of the first particle.
+ *  @param partners        Indices of the partner particles, a
+ *                         @ref SoAIndexRange or a span of indices.
+ *  @param box             Box geometry, for the minimum image convention.
+ *  @param cutoff2         Squared pair cutoff.
+ *  @param coulomb_kernel  Coulomb force kernel.
+ */
+template <class Partners>
+void add_non_bonded_pair_forces_soa(
+    ParticleSoA &soa, std::size_t i, Partners const &partners,
+    BoxGeometry const &box, double cutoff2,
+    Coulomb::ShortRangeForceKernel::kernel_type const *coulomb_kernel) {
+  auto const pos_i = Utils::Vector3d{soa.pos[0][i], soa.pos[1][i],
+                                     soa.pos[2][i]};
+  auto const type_i = soa.type[i];
+  Utils::Vector3d force_i{};
+
+  for (std::size_t k = 0; k < partners.size(); ++k) {
+    std::size_t const j = partners[k];
+    auto const d = box.get_mi_vector(
+        pos_i, Utils::Vector3d{soa.pos[0][j], soa.pos[1][j], soa.pos[2][j]});
+    auto const dist2 = d.norm2();
+    if (dist2 > cutoff2) {
+      continue;
+    }
+    auto const dist = std::sqrt(dist2);
+    IA_parameters const &ia_params = *get_ia_param(type_i, soa.type[j]);
+
+#ifdef EXCLUSIONS
+    auto const excluded = soa.has_exclusions[i] or soa.has_exclusions[j];
+#else
+    auto const excluded = false;
+#endif
+    if (excluded or not ia_params.lj_wca_only) {
+      add_non_bonded_pair_force(*soa.particles[i], *soa.particles[j], d, dist,
+                                dist2, coulomb_kernel, nullptr, nullptr);
+      continue;
+    }
+
+    double force_factor = 0.;
+    if (dist < ia_params.max_cut) {
+#ifdef LENNARD_JONES
+      force_factor += lj_pair_force_factor(ia_params, dist);
+#endif
+#ifdef WCA
+      force_factor += wca_pair_force_factor(ia_params, dist);
+#endif
+    }
+    auto force = force_factor * d;
+
+#ifdef ELECTROSTATICS
+    auto const q1q2 = soa.q[i] * soa.q[j];
+    if (q1q2 != 0. and coulomb_kernel != nullptr) {
+      force += (*coulomb_kernel)(q1q2, d, dist);
+    }
+#endif
+
+    force_i += force;
+    for (unsigned int k = 0; k < 3; ++k) {
+      soa.force[k][j] -= force[k];
+    }
+  }
+
+  for (unsigned int k = 0; k < 3; ++k) {
+    soa.force[k][i] += force_i[k];
+  }
+}
+
 /** Compute the bonded interaction force between particle pairs.
  *
  *  @param[in] p1          First particle.
@@ -445,4 +526,127 @@ add_bonded_force(Particle &p1, int bond_id, Utils::Span<Particle *> partners,
   }
 }
 
+/** @brief Report bond @p i of a @ref BondTable group as broken. */
+inline void bond_group_broken_error(BondTable::Group &group, std::size_t i) {
+  boost::container::static_vector<int, 4> partner_ids;
+  for (auto const partner : group.partners(i)) {
+    partner_ids.push_back(partner->id());
+  }
+  bond_broken_error(group.particle(i).id(),
+                    {partner_ids.data(), partner_ids.size()});
+}
+
+/** @brief Add the forces of a group of pair bonds of the same type. */
+template <class BondType>
+void add_pair_bond_group_forces(BondType const &iaparams,
+                                BondTable::Group &group) {
+  for (std::size_t i = 0; i < group.size(); ++i) {
+    auto &p1 = group.particle(i);
+    auto &p2 = *group.partners(i)[0];
+    auto const dx = box_geo.get_mi_vector(p1.pos(), p2.pos());
+    if (BondBreakage::check_and_handle_breakage(p1.id(), p2.id(),
+                                                group.bond_id, dx.norm())) {
+      continue;
+    }
+    auto const force = iaparams.force(dx);
+    if (not force) {
+      bond_group_broken_error(group, i);
+      continue;
+    }
+    p1.force() += *force;
+    p2.force() -= *force;
+#ifdef NPT
+    npt_add_virial_force_contribution(*force, dx);
+#endif
+  }
+}
+
+/** @brief Add the forces of a group of angle bonds of the same type. */
+template <class BondType>
+void add_angle_bond_group_forces(BondType const &iaparams,
+                                 BondTable::Group &group) {
+  for (std::size_t i = 0; i < group.size(); ++i) {
+    auto &p1 = group.particle(i);
+    auto const partners = group.partners(i);
+    auto &p2 = *partners[0];
+    auto &p3 = *partners[1];
+    auto const forces = iaparams.forces(p1.pos(), p2.pos(), p3.pos());
+    using std::get;
+    p1.force() += get<0>(forces);
+    p2.force() += get<1>(forces);
+    p3.force() += get<2>(forces);
+  }
+}
+
+/** @brief Add the forces of a group of dihedral bonds of the same type. */
+template <class BondType>
+void add_dihedral_bond_group_forces(BondType const &iaparams,
+                                    BondTable::Group &group) {
+  for (std::size_t i = 0; i < group.size(); ++i) {
+    auto &p1 = group.particle(i);
+    auto const partners = group.partners(i);
+    auto &p2 = *partners[0];
+    auto &p3 = *partners[1];
+    auto &p4 = *partners[2];
+    auto const forces =
+        iaparams.forces(p2.pos(), p1.pos(), p3.pos(), p4.pos());
+    if (not forces) {
+      bond_group_broken_error(group, i);
+      continue;
+    }
+    using std::get;
+    p1.force() += get<0>(*forces);
+    p2.force() += get<1>(*forces);
+    p3.force() += get<2>(*forces);
+    p4.force() += get<3>(*forces);
+  }
+}
+
+/**
+ * @brief Add the forces of a group of bonds with the same bond id.
+ *
+ * The bond parameters are looked up once per group. Bonds of the most
+ * common types are evaluated in loops specialized for their type, all
+ * other bonds one at a time by @ref add_bonded_force.
+ *
+ * @param group Bonds with resolved partners.
+ * @param kernel %Coulomb force kernel.
+ */
+inline void add_bonded_group_forces(
+    BondTable::Group &group,
+    Coulomb::ShortRangeForceKernel::kernel_type const *kernel) {
+  auto const &iaparams = *bonded_ia_params.at(group.bond_id);
+
+  if (group.n_partners == number_of_partners(iaparams)) {
+    if (auto const *iap = boost::get<FeneBond>(&iaparams)) {
+      return add_pair_bond_group_forces(*iap, group);
+    }
+    if (auto const *iap = boost::get<HarmonicBond>(&iaparams)) {
+      return add_pair_bond_group_forces(*iap, group);
+    }
+    if (auto const *iap = boost::get<QuarticBond>(&iaparams)) {
+      return add_pair_bond_group_forces(*iap, group);
+    }
+    if (auto const *iap = boost::get<AngleHarmonicBond>(&iaparams)) {
+      return add_angle_bond_group_forces(*iap, group);
+    }
+    if (auto const *iap = boost::get<AngleCosineBond>(&iaparams)) {
+      return add_angle_bond_group_forces(*iap, group);
+    }
+    if (auto const *iap = boost::get<AngleCossquareBond>(&iaparams)) {
+      return add_angle_bond_group_forces(*iap, group);
+    }
+    if (auto const *iap = boost::get<DihedralBond>(&iaparams)) {
+      return add_dihedral_bond_group_forces(*iap, group);
+    }
+  }
+
+  for (std::size_t i = 0; i < group.size(); ++i) {
+    if (add_bonded_force(group.particle(i), group.bond_id, group.partners(i),
+                         kernel)) {
+      bond_group_broken_error(group, i);
+    }
+  }
+}
+
 #endif // CORE_FORCES_INLINE_HPP
@@ -32,6 +32,8 @@
 #include "Particle.hpp"
 
 #include <utils/Span.hpp>
+#include <utils/Vector.hpp>
+#include <utils/quaternion.hpp>
 #include <utils/serialization/memcpy_archive.hpp>
 
 #include <boost/archive/binary_iarchive.hpp>
@@ -40,6 +42,8 @@
 #include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <boost/mpi/collectives.hpp>
+#include <boost/mpi/nonblocking.hpp>
+#include <boost/mpi/request.hpp>
 #include <boost/range/numeric.hpp>
 #include <boost/serialization/vector.hpp>
 
@@ -48,6 +52,8 @@
 #include <cstddef>
 #include <functional>
 #include <iterator>
+#include <memory>
+#include <unordered_set>
 #include <vector>
 
 /** Tag for ghosts communications. */
@@ -89,7 +95,15 @@ static std::size_t calc_transmit_size(unsigned data_parts) {
   if (data_parts & GHOSTTRANS_PROPRTS)
     size += Utils::MemcpyOArchive::packing_size<ParticleProperties>();
   if (data_parts & GHOSTTRANS_POSITION)
-    size += Utils::MemcpyOArchive::packing_size<ParticlePosition>();
+    size += Utils::MemcpyOArchive::packing_size<Utils::Vector3d>();
+#ifdef ROTATION
+  if (data_parts & GHOSTTRANS_ORIENTATION)
+    size += Utils::MemcpyOArchive::packing_size<Utils::Quaternion<double>>();
+#endif
+#ifdef BOND_CONSTRAINT
+  if (data_parts & GHOSTTRANS_LAST_POSITION)
+    size += Utils::MemcpyOArchive::packing_size<Utils::Vector3d>();
+#endif
   if (data_parts & GHOSTTRANS_MOMENTUM)
     size += Utils::MemcpyOArchive::packing_size<ParticleMomentum>();
   if (data_parts & GHOSTTRANS_FORCE)
@@ -140,11 +154,18 @@ static void prepare_send_buffer(CommBuf &send_buffer,
           archiver << part.p;
         }
         if (data_parts & GHOSTTRANS_POSITION) {
-          /* ok, this is not nice, but perhaps fast */
-          auto pp = part.r;
-          pp.p += ghost_comm.shift;
-          archiver << pp;
+          archiver << Utils::Vector3d{part.pos() + ghost_comm.shift};
+        }
+#ifdef ROTATION
+        if (data_parts & GHOSTTRANS_ORIENTATION) {
+          archiver << part.quat();
         }
+#endif
+#ifdef BOND_CONSTRAINT
+        if (data_parts & GHOSTTRANS_LAST_POSITION) {
+          archiver << part.pos_last_time_step();
+        }
+#endif
         if (data_parts & GHOSTTRANS_MOMENTUM) {
           archiver << part.m;
         }
@@ -204,8 +225,18 @@ static void put_recv_buffer(CommBuf &recv_buffer,
           archiver >> part.p;
         }
         if (data_parts & GHOSTTRANS_POSITION) {
-          archiver >> part.r;
+          archiver >> part.pos();
         }
+#ifdef ROTATION
+        if (data_parts & GHOSTTRANS_ORIENTATION) {
+          archiver >> part.quat();
+        }
+#endif
+#ifdef BOND_CONSTRAINT
+        if (data_parts & GHOSTTRANS_LAST_POSITION) {
+          archiver >> part.pos_last_time_step();
+        }
+#endif
         if (data_parts & GHOSTTRANS_MOMENTUM) {
           archiver >> part.m;
         }
@@ -267,6 +298,26 @@ static void add_forces_from_recv_buffer(CommBuf &recv_buffer,
   }
 }
 
+/**
+ * @brief Write back the data of a receive operation.
+ *
+ * Forces and rattle corrections have to be added, the rest overwritten.
+ * Exception is @ref GHOST_RDCE, where the addition is integrated into
+ * the communication.
+ */
+static void write_back_recv_buffer(CommBuf &recv_buffer,
+                                   const GhostCommunication &ghost_comm,
+                                   int comm_type, unsigned int data_parts) {
+  if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
+    add_forces_from_recv_buffer(recv_buffer, ghost_comm);
+#ifdef BOND_CONSTRAINT
+  else if (data_parts == GHOSTTRANS_RATTLE && comm_type != GHOST_RDCE)
+    add_rattle_correction_from_recv_buffer(recv_buffer, ghost_comm);
+#endif
+  else
+    put_recv_buffer(recv_buffer, ghost_comm, data_parts);
+}
+
 static void cell_cell_transfer(const GhostCommunication &ghost_comm,
                                unsigned int data_parts) {
   /* transfer data */
@@ -293,10 +344,18 @@ static void cell_cell_transfer(const GhostCommunication &ghost_comm,
           part2.bonds() = part1.bonds();
         }
         if (data_parts & GHOSTTRANS_POSITION) {
-          /* ok, this is not nice, but perhaps fast */
-          part2.r = part1.r;
-          part2.pos() += ghost_comm.shift;
+          part2.pos() = part1.pos() + ghost_comm.shift;
+        }
+#ifdef ROTATION
+        if (data_parts & GHOSTTRANS_ORIENTATION) {
+          part2.quat() = part1.quat();
+        }
+#endif
+#ifdef BOND_CONSTRAINT
+        if (data_parts & GHOSTTRANS_LAST_POSITION) {
+          part2.pos_last_time_step() = part1.pos_last_time_step();
         }
+#endif
         if (data_parts & GHOSTTRANS_MOMENTUM) {
           part2.m = part1.m;
         }
@@ -428,16 +487,7 @@ void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts) {
     // recv op; write back data directly, if no PSTSTORE delay is requested.
     if (is_recv_op(comm_type, node, comm.rank())) {
       if (!poststore) {
-        /* forces have to be added, the rest overwritten. Exception is RDCE,
-         * where the addition is integrated into the communication. */
-        if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
-          add_forces_from_recv_buffer(recv_buffer, ghost_comm);
-#ifdef BOND_CONSTRAINT
-        else if (data_parts == GHOSTTRANS_RATTLE && comm_type != GHOST_RDCE)
-          add_rattle_correction_from_recv_buffer(recv_buffer, ghost_comm);
-#endif
-        else
-          put_recv_buffer(recv_buffer, ghost_comm, data_parts);
+        write_back_recv_buffer(recv_buffer, ghost_comm, comm_type, data_parts);
       }
     } else if (poststore) {
       /* send op; write back delayed data from last recv, when this was a
@@ -452,17 +502,154 @@ void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts) {
       if (poststore_ghost_comm != gcr.communications.rend()) {
         assert(recv_buffer.size() ==
                calc_transmit_size(*poststore_ghost_comm, data_parts));
-        /* as above */
-        if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
-          add_forces_from_recv_buffer(recv_buffer, *poststore_ghost_comm);
-#ifdef BOND_CONSTRAINT
-        else if (data_parts == GHOSTTRANS_RATTLE && comm_type != GHOST_RDCE)
-          add_rattle_correction_from_recv_buffer(recv_buffer,
-                                                 *poststore_ghost_comm);
-#endif
-        else
-          put_recv_buffer(recv_buffer, *poststore_ghost_comm, data_parts);
+        write_back_recv_buffer(recv_buffer, *poststore_ghost_comm, comm_type,
+                               data_parts);
       }
     }
   }
 }
+
+/**
+ * @brief Group the communications of a ghost communicator into stages.
+ *
+ * A new stage is started by every communication that reads or writes
+ * cells written by an earlier communication of the current stage.
+ *
+ * @return Index of the first communication of each stage, followed by
+ * the number of communications.
+ */
+static std::vector<std::size_t>
+ghost_communication_stages(GhostCommunicator const &gcr) {
+  std::vector<std::size_t> stages = {0u};
+  std::unordered_set<ParticleList const *> written;
+
+  for (std::size_t k = 0; k < gcr.communications.size(); ++k) {
+    auto const &ghost_comm = gcr.communications[k];
+    auto const comm_type = ghost_comm.type & GHOST_JOBMASK;
+    auto const n_lists = ghost_comm.part_lists.size();
+    /* for local transfers, the first half of the cells are the sending
+     * cells, the other half the receiving cells */
+    auto const n_read = (comm_type == GHOST_LOCL)   ? n_lists / 2
+                        : (comm_type == GHOST_SEND) ? n_lists
+                                                    : 0;
+    auto const begin = ghost_comm.part_lists.begin();
+    auto const end = ghost_comm.part_lists.end();
+    auto const middle = std::next(begin, static_cast<long>(n_read));
+
+    auto const depends = std::any_of(begin, end, [&written](auto part_list) {
+      return written.count(part_list) != 0;
+    });
+    if (depends) {
+      stages.push_back(k);
+      written.clear();
+    }
+    written.insert(middle, end);
+  }
+  stages.push_back(gcr.communications.size());
+
+  return stages;
+}
+
+struct GhostCommunicationRequest::Implementation {
+  GhostCommunicator const *gcr = nullptr;
+  unsigned int data_parts = GHOSTTRANS_NONE;
+  /** Index of the first communication of each stage, followed by the
+   *  number of communications */
+  std::vector<std::size_t> stages;
+  /** Stage in flight */
+  std::size_t stage = 0;
+  /** Send and receive buffers, for each communication */
+  std::vector<CommBuf> send_buffers, recv_buffers;
+  std::vector<boost::mpi::request> requests;
+
+  bool pending() const { return stage + 1 < stages.size(); }
+
+  /** @brief Post the messages of the current stage. */
+  void post() {
+    auto const &comm = gcr->mpi_comm;
+    requests.clear();
+    for (auto k = stages[stage]; k < stages[stage + 1]; ++k) {
+      auto const &ghost_comm = gcr->communications[k];
+      switch (ghost_comm.type & GHOST_JOBMASK) {
+      case GHOST_LOCL:
+        cell_cell_transfer(ghost_comm, data_parts);
+        break;
+      case GHOST_SEND: {
+        auto &send_buffer = send_buffers[k];
+        prepare_send_buffer(send_buffer, ghost_comm, data_parts);
+        requests.emplace_back(comm.isend(ghost_comm.node, REQ_GHOST_SEND,
+                                         send_buffer.data(),
+                                         static_cast<int>(send_buffer.size())));
+        break;
+      }
+      case GHOST_RECV: {
+        auto &recv_buffer = recv_buffers[k];
+        prepare_recv_buffer(recv_buffer, ghost_comm, data_parts);
+        requests.emplace_back(comm.irecv(ghost_comm.node, REQ_GHOST_SEND,
+                                         recv_buffer.data(),
+                                         static_cast<int>(recv_buffer.size())));
+        break;
+      }
+      }
+    }
+  }
+
+  /** @brief Wait for the messages of the current stage, and write back
+   *  the received data. */
+  void complete() {
+    boost::mpi::wait_all(requests.begin(), requests.end());
+    requests.clear();
+    for (auto k = stages[stage]; k < stages[stage + 1]; ++k) {
+      auto const &ghost_comm = gcr->communications[k];
+      if ((ghost_comm.type & GHOST_JOBMASK) == GHOST_RECV) {
+        write_back_recv_buffer(recv_buffers[k], ghost_comm, GHOST_RECV,
+                               data_parts);
+      }
+    }
+  }
+};
+
+GhostCommunicationRequest::GhostCommunicationRequest()
+    : m_impl{std::make_unique<Implementation>()} {}
+
+GhostCommunicationRequest::~GhostCommunicationRequest() { wait(); }
+
+bool GhostCommunicationRequest::pending() const { return m_impl->pending(); }
+
+void GhostCommunicationRequest::start(GhostCommunicator const &gcr,
+                                      unsigned int data_parts) {
+  wait();
+
+  auto const non_blocking =
+      not(data_parts & GHOSTTRANS_BONDS) and
+      std::all_of(gcr.communications.begin(), gcr.communications.end(),
+                  [](GhostCommunication const &ghost_comm) {
+                    auto const comm_type = ghost_comm.type & GHOST_JOBMASK;
+                    return comm_type == GHOST_SEND or
+                           comm_type == GHOST_RECV or comm_type == GHOST_LOCL;
+                  });
+  if (GHOSTTRANS_NONE == data_parts or not non_blocking) {
+    ghost_communicator(gcr, data_parts);
+    return;
+  }
+
+  auto &impl = *m_impl;
+  impl.gcr = &gcr;
+  impl.data_parts = data_parts;
+  impl.stages = ghost_communication_stages(gcr);
+  impl.stage = 0;
+  impl.send_buffers.resize(gcr.communications.size());
+  impl.recv_buffers.resize(gcr.communications.size());
+  impl.post();
+}
+
+void GhostCommunicationRequest::wait() {
+  auto &impl = *m_impl;
+  while (impl.pending()) {
+    impl.complete();
+    ++impl.stage;
+    if (impl.pending()) {
+      impl.post();
+    }
+  }
+}
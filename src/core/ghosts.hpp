@@ -42,7 +42,9 @@
  *  determined by their type) and a list of ghost communications. The data
  *  types are described by the particle data classes:
  *  - @ref GHOSTTRANS_PROPRTS transfers the @ref ParticleProperties
- *  - @ref GHOSTTRANS_POSITION transfers the @ref ParticlePosition
+ *  - @ref GHOSTTRANS_POSITION, @c GHOSTTRANS_ORIENTATION and
+ *    @c GHOSTTRANS_LAST_POSITION transfer the parts of the
+ *    @ref ParticlePosition
  *  - @ref GHOSTTRANS_MOMENTUM transfers the @ref ParticleMomentum
  *  - @ref GHOSTTRANS_FORCE transfers the @ref ParticleForce
  *  - @ref GHOSTTRANS_RATTLE transfers the @ref ParticleRattle
@@ -90,6 +92,7 @@
 #include <boost/mpi/communicator.hpp>
 
 #include <cstddef>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -121,8 +124,12 @@ enum : unsigned {
   GHOSTTRANS_NONE = 0u,
   /// transfer \ref ParticleProperties
   GHOSTTRANS_PROPRTS = 1u,
-  /// transfer \ref ParticlePosition
+  /// transfer the position in \ref ParticlePosition
   GHOSTTRANS_POSITION = 2u,
+#ifdef ROTATION
+  /// transfer the quaternion in \ref ParticlePosition
+  GHOSTTRANS_ORIENTATION = 4u,
+#endif
   /// transfer \ref ParticleMomentum
   GHOSTTRANS_MOMENTUM = 8u,
   /// transfer \ref ParticleForce
@@ -133,9 +140,25 @@ enum : unsigned {
 #endif
   /// resize the receiver particle arrays to the size of the senders
   GHOSTTRANS_PARTNUM = 64u,
-  GHOSTTRANS_BONDS = 128u
+  GHOSTTRANS_BONDS = 128u,
+#ifdef BOND_CONSTRAINT
+  /// transfer the position of the previous time step in \ref ParticlePosition
+  GHOSTTRANS_LAST_POSITION = 256u,
+#endif
 };
 
+/** All transfer classes of \ref ParticlePosition */
+/* clang-format off */
+constexpr unsigned GHOSTTRANS_POSITION_ALL = GHOSTTRANS_POSITION
+#ifdef ROTATION
+                                           | GHOSTTRANS_ORIENTATION
+#endif
+#ifdef BOND_CONSTRAINT
+                                           | GHOSTTRANS_LAST_POSITION
+#endif
+    ;
+/* clang-format on */
+
 struct GhostCommunication {
   /** Communication type. */
   int type;
@@ -168,4 +191,49 @@ struct GhostCommunicator {
  */
 void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts);
 
+/**
+ * @brief Ghost communication with non-blocking MPI calls.
+ *
+ * The ghost communications are grouped into stages of consecutive sends,
+ * receives and local transfers, in which no communication reads or writes
+ * cells written by an earlier communication of the same stage. All
+ * messages of a stage are posted at once with @c MPI_Isend and
+ * @c MPI_Irecv, and the received data is written back when all of them
+ * have completed. The stages are executed in order, since a stage can
+ * forward data received in the previous one (e.g. the corners of the
+ * regular decomposition).
+ *
+ * The first stage is posted by @ref start, the caller can then work on
+ * data not touched by the communication until it calls @ref wait.
+ * Communicators with broadcasts or reductions, and the transfer of
+ * bonds, are not supported by the non-blocking calls: @ref start then
+ * runs the whole communication with @ref ghost_communicator.
+ */
+class GhostCommunicationRequest {
+public:
+  GhostCommunicationRequest();
+  ~GhostCommunicationRequest();
+  GhostCommunicationRequest(GhostCommunicationRequest const &) = delete;
+  GhostCommunicationRequest &
+  operator=(GhostCommunicationRequest const &) = delete;
+
+  /**
+   * @brief Start a ghost communication with caller specified data parts.
+   *
+   * A communication still in flight is completed first. The communicator
+   * has to stay alive until the communication is completed.
+   */
+  void start(GhostCommunicator const &gcr, unsigned int data_parts);
+
+  /** @brief Complete the communication, if one is in flight. */
+  void wait();
+
+  /** @brief Whether a communication is in flight. */
+  bool pending() const;
+
+private:
+  struct Implementation;
+  std::unique_ptr<Implementation> m_impl;
+};
+
 #endif
@@ -62,12 +62,14 @@
 #include <cinttypes>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 using Utils::get_linear_index;
@@ -189,6 +191,36 @@ LB_Fluid lbfluid_post;
 
 std::vector<LB_FluidNode> lbfields;
 
+namespace {
+/** Runs of consecutive fluid nodes along the x-rows of the local lattice
+ *  (halo excluded), as linear index of the first node and number of nodes.
+ */
+std::vector<std::pair<Lattice::index_t, int>> lb_fluid_runs;
+
+#ifdef LB_BOUNDARIES
+/** Boundary node visited by the bounce back. */
+struct LB_BoundaryLinks {
+  Lattice::index_t index;
+  /** Bit @c i is set if the populations along velocity @c i are streamed
+   *  into the node from a fluid node of the local lattice.
+   */
+  std::uint32_t fluid_links;
+  /** Bit @c i is set if the populations along velocity @c i come from a
+   *  boundary node of the local lattice. Nothing is streamed along these
+   *  links, but the populations can be overwritten by the halo exchange
+   *  or by population updates from the interface, hence they are cleared
+   *  in every bounce back.
+   */
+  std::uint32_t solid_links;
+};
+
+/** Boundary nodes with links to nodes of the local lattice, in the order
+ *  of the lattice.
+ */
+std::vector<LB_BoundaryLinks> lb_boundary_links;
+#endif // LB_BOUNDARIES
+} // namespace
+
 HaloCommunicator update_halo_comm = HaloCommunicator(0);
 
 /**
@@ -207,6 +239,7 @@ void lb_initialize_fields(std::vector<LB_FluidNode> &lb_fields,
     field.boundary = false;
 #endif // LB_BOUNDARIES
   }
+  lb_update_fluid_nodes(lb_fields, lb_lattice);
 }
 
 /** (Re-)allocate memory for the fluid and initialize pointers. */
@@ -786,52 +819,60 @@ std::array<T, 19> lb_relax_modes(const std::array<T, 19> &modes,
            parameters.gamma_even * modes[18]}};
 }
 
-template <typename T>
-std::array<T, 19> lb_thermalize_modes(
-    Lattice::index_t index, const std::array<T, 19> &modes,
-    const LB_Parameters &lb_parameters,
-    boost::optional<Utils::Counter<uint64_t>> const &rng_counter) {
-  if (lb_parameters.kT > 0.0) {
-    using Utils::uniform;
-    using rng_type = r123::Philox4x64;
-    using ctr_type = rng_type::ctr_type;
-
-    const ctr_type c{
-        {rng_counter->value(), static_cast<uint64_t>(RNGSalt::FLUID)}};
-    const T rootdensity =
-        std::sqrt(std::fabs(modes[0] + lb_parameters.density));
-    auto const pref = std::sqrt(12.) * rootdensity;
-
-    const ctr_type noise[4] = {
-        rng_type{}(c, {{static_cast<uint64_t>(index), 0ul}}),
-        rng_type{}(c, {{static_cast<uint64_t>(index), 1ul}}),
-        rng_type{}(c, {{static_cast<uint64_t>(index), 2ul}}),
-        rng_type{}(c, {{static_cast<uint64_t>(index), 3ul}})};
-
-    auto rng = [&](int i) { return uniform(noise[i / 4][i % 4]) - 0.5; };
-
-    return {/* conserved modes */
-            {modes[0], modes[1], modes[2], modes[3],
-             /* stress modes */
-             modes[4] + pref * lb_parameters.phi[4] * rng(0),
-             modes[5] + pref * lb_parameters.phi[5] * rng(1),
-             modes[6] + pref * lb_parameters.phi[6] * rng(2),
-             modes[7] + pref * lb_parameters.phi[7] * rng(3),
-             modes[8] + pref * lb_parameters.phi[8] * rng(4),
-             modes[9] + pref * lb_parameters.phi[9] * rng(5),
-
-             /* ghost modes */
-             modes[10] + pref * lb_parameters.phi[10] * rng(6),
-             modes[11] + pref * lb_parameters.phi[11] * rng(7),
-             modes[12] + pref * lb_parameters.phi[12] * rng(8),
-             modes[13] + pref * lb_parameters.phi[13] * rng(9),
-             modes[14] + pref * lb_parameters.phi[14] * rng(10),
-             modes[15] + pref * lb_parameters.phi[15] * rng(11),
-             modes[16] + pref * lb_parameters.phi[16] * rng(12),
-             modes[17] + pref * lb_parameters.phi[17] * rng(13),
-             modes[18] + pref * lb_parameters.phi[18] * rng(14)}};
+/** Uniformly distributed noise in [-0.5, 0.5) for the 15 modes of a node
+ *  that are not conserved, padded to a multiple of the Philox output size.
+ */
+using LB_Noise = std::array<double, 16>;
+
+LB_Noise lb_fluid_noise(Lattice::index_t index,
+                        Utils::Counter<uint64_t> const &rng_counter) {
+  using Utils::uniform;
+  using rng_type = r123::Philox4x64;
+  using ctr_type = rng_type::ctr_type;
+
+  const ctr_type c{
+      {rng_counter.value(), static_cast<uint64_t>(RNGSalt::FLUID)}};
+
+  const ctr_type noise[4] = {
+      rng_type{}(c, {{static_cast<uint64_t>(index), 0ul}}),
+      rng_type{}(c, {{static_cast<uint64_t>(index), 1ul}}),
+      rng_type{}(c, {{static_cast<uint64_t>(index), 2ul}}),
+      rng_type{}(c, {{static_cast<uint64_t>(index), 3ul}})};
+
+  LB_Noise rng;
+  for (std::size_t i = 0; i < rng.size(); i++) {
+    rng[i] = uniform(noise[i / 4][i % 4]) - 0.5;
   }
-  return modes;
+  return rng;
+}
+
+template <typename T>
+std::array<T, 19> lb_thermalize_modes(const std::array<T, 19> &modes,
+                                      const LB_Parameters &lb_parameters,
+                                      LB_Noise const &rng) {
+  const T rootdensity = std::sqrt(std::fabs(modes[0] + lb_parameters.density));
+  auto const pref = std::sqrt(12.) * rootdensity;
+
+  return {/* conserved modes */
+          {modes[0], modes[1], modes[2], modes[3],
+           /* stress modes */
+           modes[4] + pref * lb_parameters.phi[4] * rng[0],
+           modes[5] + pref * lb_parameters.phi[5] * rng[1],
+           modes[6] + pref * lb_parameters.phi[6] * rng[2],
+           modes[7] + pref * lb_parameters.phi[7] * rng[3],
+           modes[8] + pref * lb_parameters.phi[8] * rng[4],
+           modes[9] + pref * lb_parameters.phi[9] * rng[5],
+
+           /* ghost modes */
+           modes[10] + pref * lb_parameters.phi[10] * rng[6],
+           modes[11] + pref * lb_parameters.phi[11] * rng[7],
+           modes[12] + pref * lb_parameters.phi[12] * rng[8],
+           modes[13] + pref * lb_parameters.phi[13] * rng[9],
+           modes[14] + pref * lb_parameters.phi[14] * rng[10],
+           modes[15] + pref * lb_parameters.phi[15] * rng[11],
+           modes[16] + pref * lb_parameters.phi[16] * rng[12],
+           modes[17] + pref * lb_parameters.phi[17] * rng[13],
+           modes[18] + pref * lb_parameters.phi[18] * rng[14]}};
 }
 
 template <typename T>
@@ -888,71 +929,179 @@ auto lb_next_offsets(const Lattice &lb_lattice,
   return offsets;
 }
 
-template <typename T>
-void lb_stream(LB_Fluid &lb_fluid, const std::array<T, 19> &populations,
-               std::size_t index,
-               std::array<std::ptrdiff_t, 19> const &offsets) {
-  for (int i = 0; i < populations.size(); i++) {
-    lb_fluid[i][index + offsets[i]] = populations[i];
+/** Number of consecutive nodes of an x-row that are collided together. */
+constexpr std::size_t lb_batch_size = 8;
+
+/** Populations or modes of a batch of nodes, one array per velocity. */
+using LB_Batch = std::array<std::array<double, lb_batch_size>, 19>;
+
+/**
+ * @brief Batched version of @ref Utils::matrix_vector_product.
+ *
+ * The sums are evaluated in the same order as in the per-node transform,
+ * including the additions of the zero matrix elements, such that the results
+ * are identical to the per-node results, while the loops over the nodes of
+ * the batch map to SIMD instructions.
+ *
+ * @param[in]  in   Vectors of the batch.
+ * @param[out] out  Matrix-vector products of the batch.
+ * @param[in]  n    Number of nodes in the batch.
+ */
+template <const std::array<std::array<int, 19>, 19> &matrix>
+void lb_batch_matrix_vector_product(LB_Batch const &in, LB_Batch &out,
+                                    std::size_t n) {
+  for (std::size_t k = 0; k < 19; k++) {
+    auto const &row = matrix[k];
+    auto &sum = out[k];
+    auto const c_last = static_cast<double>(row[18]);
+    if (row[18] == 0) {
+      std::fill_n(sum.begin(), n, 0.);
+    } else {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+      for (std::size_t l = 0; l < n; l++) {
+        sum[l] = c_last * in[18][l];
+      }
+    }
+    for (std::size_t i = 18; i-- > 0;) {
+      auto const c = static_cast<double>(row[i]);
+      auto const &in_i = in[i];
+      if (row[i] == 0) {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+        for (std::size_t l = 0; l < n; l++) {
+          sum[l] = 0. + sum[l];
+        }
+      } else {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+        for (std::size_t l = 0; l < n; l++) {
+          sum[l] = c * in_i[l] + sum[l];
+        }
+      }
+    }
   }
 }
 
-/* Collisions and streaming (push scheme) */
-void lb_integrate() {
-  ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
-  /* loop over all lattice cells (halo excluded) */
-#ifdef LB_BOUNDARIES
-  for (auto &lbboundary : LBBoundaries::lbboundaries) {
-    (*lbboundary).reset_force();
-  }
-#endif // LB_BOUNDARIES
+/**
+ * @brief Collide a run of fluid nodes of an x-row and stream their
+ * populations.
+ *
+ * The nodes are processed in batches of @ref lb_batch_size: the transforms
+ * between populations and modes are evaluated for the whole batch at once,
+ * the collision of the modes node by node.
+ *
+ * @param first         Linear index of the first node of the run.
+ * @param n_nodes       Number of nodes of the run, none of them a boundary.
+ * @param next_offsets  Relative index of the next node for each velocity.
+ */
+void lb_collide_stream_row(Lattice::index_t first, int n_nodes,
+                           std::array<std::ptrdiff_t, 19> const &next_offsets) {
+  LB_Batch populations;
+  LB_Batch modes;
+  std::array<LB_Noise, lb_batch_size> noise;
+  auto const thermalized = lbpar.kT > 0.0;
+
+  for (int start = 0; start < n_nodes; start += lb_batch_size) {
+    auto const first_index = first + start;
+    auto const n =
+        std::min(lb_batch_size, static_cast<std::size_t>(n_nodes - start));
+
+    /* calculate modes locally */
+    for (std::size_t i = 0; i < 19; i++) {
+      std::copy_n(lbfluid[i].data() + first_index, n, populations[i].begin());
+    }
+    lb_batch_matrix_vector_product<e_ki>(populations, modes, n);
 
-  auto const next_offsets = lb_next_offsets(lblattice, D3Q19::c);
+    /* draw the random numbers of the batch ahead of the collisions */
+    if (thermalized) {
+      for (std::size_t l = 0; l < n; l++) {
+        auto const index = first_index + static_cast<int>(l);
+        noise[l] = lb_fluid_noise(index, *rng_counter_fluid);
+      }
+    }
 
-  Lattice::index_t index = lblattice.halo_offset;
-  for (int z = 1; z <= lblattice.grid[2]; z++) {
-    for (int y = 1; y <= lblattice.grid[1]; y++) {
-      for (int x = 1; x <= lblattice.grid[0]; x++) {
-        // as we only want to apply this to non-boundary nodes we can throw out
-        // the if-clause if we have a non-bounded domain
-#ifdef LB_BOUNDARIES
-        if (!lbfields[index].boundary)
-#endif // LB_BOUNDARIES
-        {
-          /* calculate modes locally */
-          auto const modes = lb_calc_modes(index, lbfluid);
+    for (std::size_t l = 0; l < n; l++) {
+      auto const index = first_index + static_cast<int>(l);
+      auto &node = lbfields[index];
+      std::array<double, 19> node_modes;
+      for (std::size_t k = 0; k < 19; k++) {
+        node_modes[k] = modes[k][l];
+      }
 
-          /* deterministic collisions */
-          auto const relaxed_modes =
-              lb_relax_modes(modes, lbfields[index].force_density, lbpar);
+      /* deterministic collisions */
+      auto const relaxed_modes =
+          lb_relax_modes(node_modes, node.force_density, lbpar);
 
-          /* fluctuating hydrodynamics */
-          auto const thermalized_modes = lb_thermalize_modes(
-              index, relaxed_modes, lbpar, rng_counter_fluid);
+      /* fluctuating hydrodynamics */
+      auto const thermalized_modes =
+          thermalized ? lb_thermalize_modes(relaxed_modes, lbpar, noise[l])
+                      : relaxed_modes;
 
-          /* apply forces */
-          auto const modes_with_forces = lb_apply_forces(
-              thermalized_modes, lbpar, lbfields[index].force_density);
+      /* apply forces */
+      auto const modes_with_forces =
+          lb_apply_forces(thermalized_modes, lbpar, node.force_density);
 
 #ifdef VIRTUAL_SITES_INERTIALESS_TRACERS
-          // Safeguard the node forces so that we can later use them for the IBM
-          // particle update
-          lbfields[index].force_density_buf = lbfields[index].force_density;
+      // Safeguard the node forces so that we can later use them for the IBM
+      // particle update
+      node.force_density_buf = node.force_density;
 #endif
 
-          /* reset the force density */
-          lbfields[index].force_density = lbpar.ext_force_density;
+      /* reset the force density */
+      node.force_density = lbpar.ext_force_density;
 
-          /* transform back to populations and streaming */
-          auto const populations = lb_calc_n_from_m(modes_with_forces);
-          lb_stream(lbfluid_post, populations, index, next_offsets);
-        }
+      auto const normalized_modes = normalize_modes(modes_with_forces);
+      for (std::size_t k = 0; k < 19; k++) {
+        modes[k][l] = normalized_modes[k];
+      }
+    }
 
-        ++index; /* next node */
+    /* transform back to populations */
+    lb_batch_matrix_vector_product<e_ki_transposed>(modes, populations, n);
+    for (std::size_t i = 0; i < 19; i++) {
+      auto const w_i = D3Q19::w[i];
+      auto &populations_i = populations[i];
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+      for (std::size_t l = 0; l < n; l++) {
+        populations_i[l] *= w_i;
       }
-      index += 2; /* skip halo region */
     }
-    index += 2 * lblattice.halo_grid[0]; /* skip halo region */
+
+    /* streaming */
+    for (std::size_t i = 0; i < 19; i++) {
+      auto const dest = lbfluid_post[i].data() + first_index + next_offsets[i];
+      std::copy_n(populations[i].begin(), n, dest);
+    }
+  }
+}
+
+/* Collisions and streaming (push scheme) */
+void lb_integrate() {
+  ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
+#ifdef LB_BOUNDARIES
+  for (auto &lbboundary : LBBoundaries::lbboundaries) {
+    (*lbboundary).reset_force();
+  }
+#endif // LB_BOUNDARIES
+
+  auto const next_offsets = lb_next_offsets(lblattice, D3Q19::c);
+
+  /* loop over the fluid nodes (halo and boundary nodes excluded), the runs
+   * of fluid nodes are distributed over the threads: each population of the
+   * post-collision lattice is written by exactly one node */
+  auto const n_runs = static_cast<int>(lb_fluid_runs.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int r = 0; r < n_runs; r++) {
+    auto const &run = lb_fluid_runs[r];
+    lb_collide_stream_row(run.first, run.second, next_offsets);
   }
 
   /* exchange halo regions */
@@ -1249,46 +1398,106 @@ Utils::Vector6d lb_calc_pressure_tensor(std::array<double, 19> const &modes,
   return stress;
 }
 
+namespace {
+constexpr std::array<int, 19> reverse_velocity = {
+    {0, 2, 1, 4, 3, 6, 5, 8, 7, 10, 9, 12, 11, 14, 13, 16, 15, 18, 17}};
+} // namespace
+
+void lb_update_fluid_nodes(std::vector<LB_FluidNode> const &lb_fields,
+                           Lattice const &lb_lattice) {
+  auto const is_fluid = [&lb_fields](Lattice::index_t index) {
+#ifdef LB_BOUNDARIES
+    return !lb_fields[index].boundary;
+#else
+    return true;
+#endif
+  };
+
+  lb_fluid_runs.clear();
+  for (int z = 1; z <= lb_lattice.grid[2]; z++) {
+    for (int y = 1; y <= lb_lattice.grid[1]; y++) {
+      for (int x = 1; x <= lb_lattice.grid[0]; x++) {
+        auto const index = get_linear_index(x, y, z, lb_lattice.halo_grid);
+        if (!is_fluid(index)) {
+          continue;
+        }
+        if (x > 1 && is_fluid(index - 1)) {
+          lb_fluid_runs.back().second++;
+        } else {
+          lb_fluid_runs.emplace_back(index, 1);
+        }
+      }
+    }
+  }
+
+#ifdef LB_BOUNDARIES
+  auto const next = lb_next_offsets(lb_lattice, D3Q19::c);
+  auto const is_interior = [&lb_lattice](Utils::Vector3i const &node) {
+    for (unsigned int j = 0; j < 3; j++) {
+      if (node[j] < 1 || node[j] > lb_lattice.grid[j]) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  lb_boundary_links.clear();
+  for (int z = 0; z < lb_lattice.grid[2] + 2; z++) {
+    for (int y = 0; y < lb_lattice.grid[1] + 2; y++) {
+      for (int x = 0; x < lb_lattice.grid[0] + 2; x++) {
+        auto const k = get_linear_index(x, y, z, lb_lattice.halo_grid);
+        if (is_fluid(k)) {
+          continue;
+        }
+        auto const node = Utils::Vector3i{{x, y, z}};
+        std::uint32_t fluid_links = 0u;
+        std::uint32_t solid_links = 0u;
+        for (int i = 0; i < 19; i++) {
+          if (!is_interior(node - D3Q19::c[i])) {
+            continue;
+          }
+          if (is_fluid(k - next[i])) {
+            fluid_links |= 1u << i;
+          } else {
+            solid_links |= 1u << i;
+          }
+        }
+        if (fluid_links or solid_links) {
+          lb_boundary_links.push_back({k, fluid_links, solid_links});
+        }
+      }
+    }
+  }
+#endif // LB_BOUNDARIES
+}
+
 #ifdef LB_BOUNDARIES
 void lb_bounce_back(LB_Fluid &lb_fluid, const LB_Parameters &lb_parameters,
                     const std::vector<LB_FluidNode> &lb_fields) {
   auto const next = lb_next_offsets(lblattice, D3Q19::c);
-  static constexpr int reverse[] = {0, 2,  1,  4,  3,  6,  5,  8,  7, 10,
-                                    9, 12, 11, 14, 13, 16, 15, 18, 17};
-
-  /* bottom-up sweep */
-  for (int z = 0; z < lblattice.grid[2] + 2; z++) {
-    for (int y = 0; y < lblattice.grid[1] + 2; y++) {
-      for (int x = 0; x < lblattice.grid[0] + 2; x++) {
-        auto const k = get_linear_index(x, y, z, lblattice.halo_grid);
-
-        if (lb_fields[k].boundary) {
-          Utils::Vector3d boundary_force = {};
-          for (int i = 0; i < 19; i++) {
-            auto const ci = D3Q19::c[i];
-
-            if (x - ci[0] > 0 && x - ci[0] < lblattice.grid[0] + 1 &&
-                y - ci[1] > 0 && y - ci[1] < lblattice.grid[1] + 1 &&
-                z - ci[2] > 0 && z - ci[2] < lblattice.grid[2] + 1) {
-              if (!lb_fields[k - next[i]].boundary) {
-                auto const population_shift =
-                    -lb_parameters.density * 2 * D3Q19::w[i] *
-                    (ci * lb_fields[k].slip_velocity) /
-                    D3Q19::c_sound_sq<double>;
-
-                boundary_force += (2 * lb_fluid[i][k] + population_shift) * ci;
-                lb_fluid[reverse[i]][k - next[i]] =
-                    lb_fluid[i][k] + population_shift;
-              } else {
-                lb_fluid[reverse[i]][k - next[i]] = lb_fluid[i][k] = 0.0;
-              }
-            }
-          }
-          LBBoundaries::lbboundaries[lb_fields[k].boundary - 1]->force() +=
-              boundary_force;
-        }
+
+  for (auto const &node : lb_boundary_links) {
+    auto const k = node.index;
+    Utils::Vector3d boundary_force = {};
+    for (int i = 0; i < 19; i++) {
+      if (node.fluid_links & (1u << i)) {
+        auto const ci = D3Q19::c[i];
+        auto const population_shift =
+            -lb_parameters.density * 2 * D3Q19::w[i] *
+            (ci * lb_fields[k].slip_velocity) / D3Q19::c_sound_sq<double>;
+
+        boundary_force += (2 * lb_fluid[i][k] + population_shift) * ci;
+        lb_fluid[reverse_velocity[i]][k - next[i]] =
+            lb_fluid[i][k] + population_shift;
+      } else if (node.solid_links & (1u << i)) {
+        lb_fluid[reverse_velocity[i]][k - next[i]] = lb_fluid[i][k] = 0.0;
       }
     }
+    if (!node.fluid_links) {
+      continue;
+    }
+    LBBoundaries::lbboundaries[lb_fields[k].boundary - 1]->force() +=
+        boundary_force;
   }
 }
 #endif // LB_BOUNDARIES
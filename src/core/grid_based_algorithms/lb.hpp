@@ -239,11 +239,20 @@ void lb_fluid_set_rng_state(uint64_t counter);
 void lb_prepare_communication(HaloCommunicator &halo_comm,
                               const Lattice &lb_lattice);
 
+/** Update the fluid nodes visited by the collisions and the links of the
+ * boundary nodes visited by the bounce back, which have to be recomputed
+ * whenever the boundary flags of @p lb_fields change.
+ */
+void lb_update_fluid_nodes(std::vector<LB_FluidNode> const &lb_fields,
+                           Lattice const &lb_lattice);
+
 #ifdef LB_BOUNDARIES
 /** Bounce back boundary conditions.
  * The populations that have propagated into a boundary node
  * are bounced back to the node they came from. This results
  * in no slip boundary conditions, cf. @cite ladd01a.
+ * The populations along links between two boundary nodes are set to zero.
+ * Only the boundary nodes are visited.
  */
 void lb_bounce_back(LB_Fluid &lbfluid, const LB_Parameters &lb_parameters,
                     const std::vector<LB_FluidNode> &lb_fields);
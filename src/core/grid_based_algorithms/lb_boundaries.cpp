@@ -265,6 +265,7 @@ void lb_init_boundaries() {
         }
       }
     }
+    lb_update_fluid_nodes(lbfields, lblattice);
 #else  // defined(LB_BOUNDARIES)
     if (not lbboundaries.empty()) {
       runtimeErrorMsg()
@@ -21,6 +21,7 @@
 #include "communication.hpp"
 #include "config.hpp"
 #include "grid.hpp"
+#include "lb-d3q19.hpp"
 #include "lb.hpp"
 #include "lb_constants.hpp"
 #include "lb_interpolation.hpp"
@@ -28,8 +29,21 @@
 #include <utils/Vector.hpp>
 #include <utils/index.hpp>
 
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/collectives/gather.hpp>
+#include <boost/mpi/datatype.hpp>
+#include <boost/mpi/operations.hpp>
 #include <boost/optional.hpp>
 
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <vector>
+
 using Utils::get_linear_index;
 
 /* LB CPU callback interface */
@@ -60,6 +74,109 @@ auto lb_calc_for_pos(Utils::Vector3d const &pos, Kernel kernel) {
   return boost::optional<R>();
 }
 
+/**
+ * @brief Visit the nodes of a lattice block in column-major order.
+ * @param offset  Global index of the block origin.
+ * @param shape   Number of nodes of the block in each direction.
+ * @param visitor Function called with the global index of each node.
+ */
+template <typename Visitor>
+void lb_for_each_block_node(Utils::Vector3i const &offset,
+                            Utils::Vector3i const &shape, Visitor visitor) {
+  Utils::Vector3i ind;
+  for (ind[2] = 0; ind[2] < shape[2]; ++ind[2])
+    for (ind[1] = 0; ind[1] < shape[1]; ++ind[1])
+      for (ind[0] = 0; ind[0] < shape[0]; ++ind[0])
+        visitor(offset + ind);
+}
+
+/**
+ * @brief Evaluate a kernel on all nodes of the local lattice block.
+ * The kernel takes the linear index of a node in the halo grid and returns
+ * a vector of @p N components. The values are returned in column-major
+ * order of the local block.
+ */
+template <std::size_t N, typename T, typename Kernel>
+std::vector<T> lb_calc_local_block(Kernel kernel) {
+  std::vector<T> values;
+  values.reserve(N * static_cast<std::size_t>(Utils::product(lblattice.grid)));
+  lb_for_each_block_node(
+      lblattice.local_index_offset, lblattice.grid, [&](auto const &index) {
+        auto const linear_index =
+            get_linear_index(lblattice.local_index(index), lblattice.halo_grid);
+        auto const value = kernel(linear_index);
+        values.insert(values.end(), value.begin(), value.end());
+      });
+  return values;
+}
+
+/**
+ * @brief Gather the local lattice blocks of all ranks on the head node.
+ * @param local Values of the local block, see @ref lb_calc_local_block.
+ * @return On the head node, the values of all nodes in column-major order
+ * of the global lattice, @p N components per node.
+ */
+template <std::size_t N, typename T>
+std::vector<T> lb_gather_blocks(std::vector<T> const &local) {
+  std::vector<Utils::Vector3i> offsets, shapes;
+  boost::mpi::gather(comm_cart, lblattice.local_index_offset, offsets, 0);
+  boost::mpi::gather(comm_cart, lblattice.grid, shapes, 0);
+  std::vector<int> sizes;
+  boost::mpi::gather(comm_cart, static_cast<int>(local.size()), sizes, 0);
+  std::vector<int> displs(sizes.size(), 0);
+  if (not sizes.empty()) {
+    std::partial_sum(sizes.begin(), sizes.end() - 1, displs.begin() + 1);
+  }
+  std::vector<T> buffer(std::accumulate(sizes.begin(), sizes.end(), 0));
+  auto const type = boost::mpi::get_mpi_datatype<T>();
+  MPI_Gatherv(local.data(), static_cast<int>(local.size()), type,
+              buffer.data(), sizes.data(), displs.data(), type, 0, comm_cart);
+
+  std::vector<T> global(buffer.size());
+  auto it = buffer.begin();
+  for (std::size_t rank = 0; rank < offsets.size(); ++rank) {
+    lb_for_each_block_node(offsets[rank], shapes[rank], [&](auto const &ind) {
+      auto const j = N * static_cast<std::size_t>(
+                             get_linear_index(ind, lblattice.global_grid));
+      std::copy_n(it, N, global.begin() + static_cast<std::ptrdiff_t>(j));
+      it += N;
+    });
+  }
+  return global;
+}
+
+/**
+ * @brief Scatter the values of the global lattice from the head node
+ * to the local lattice blocks.
+ * @param global On the head node, the values of all nodes in column-major
+ * order of the global lattice, @p N components per node.
+ * @return The values of the local block in column-major order.
+ */
+template <std::size_t N, typename T>
+std::vector<T> lb_scatter_blocks(std::vector<T> const &global) {
+  std::vector<Utils::Vector3i> offsets, shapes;
+  boost::mpi::gather(comm_cart, lblattice.local_index_offset, offsets, 0);
+  boost::mpi::gather(comm_cart, lblattice.grid, shapes, 0);
+  std::vector<T> buffer;
+  std::vector<int> sizes, displs;
+  for (std::size_t rank = 0; rank < offsets.size(); ++rank) {
+    displs.emplace_back(static_cast<int>(buffer.size()));
+    lb_for_each_block_node(offsets[rank], shapes[rank], [&](auto const &ind) {
+      auto const j = N * static_cast<std::size_t>(
+                             get_linear_index(ind, lblattice.global_grid));
+      std::copy_n(global.begin() + static_cast<std::ptrdiff_t>(j), N,
+                  std::back_inserter(buffer));
+    });
+    sizes.emplace_back(static_cast<int>(buffer.size()) - displs.back());
+  }
+  auto const n_nodes = static_cast<std::size_t>(Utils::product(lblattice.grid));
+  std::vector<T> local(N * n_nodes);
+  auto const type = boost::mpi::get_mpi_datatype<T>();
+  MPI_Scatterv(buffer.data(), sizes.data(), displs.data(), type, local.data(),
+               static_cast<int>(local.size()), type, 0, comm_cart);
+  return local;
+}
+
 template <class Kernel>
 auto lb_calc_fluid_kernel(Utils::Vector3i const &index, Kernel kernel) {
   return lb_calc(index, [&](auto index) {
@@ -178,3 +295,183 @@ void mpi_bcast_lb_params(LBParam field) {
   mpi_call(mpi_bcast_lb_params_local, field, lbpar);
   lb_on_param_change(field);
 }
+
+/* LB CPU lattice block interface */
+
+static std::vector<double> mpi_lb_gather_populations_local() {
+  return detail::lb_gather_blocks<D3Q19::n_vel>(
+      detail::lb_calc_local_block<D3Q19::n_vel, double>(lb_get_population));
+}
+
+REGISTER_CALLBACK_MAIN_RANK(mpi_lb_gather_populations_local)
+
+static std::vector<double> mpi_lb_gather_velocities_local() {
+  return detail::lb_gather_blocks<3>(
+      detail::lb_calc_local_block<3, double>([](auto const linear_index) {
+        auto const force_density = lbfields[linear_index].force_density;
+        auto const modes = lb_calc_modes(linear_index, lbfluid);
+        return lb_calc_momentum_density(modes, force_density) /
+               lb_calc_density(modes, lbpar);
+      }));
+}
+
+REGISTER_CALLBACK_MAIN_RANK(mpi_lb_gather_velocities_local)
+
+static std::vector<int> mpi_lb_gather_boundary_flags_local() {
+  return detail::lb_gather_blocks<1>(
+      detail::lb_calc_local_block<1, int>([](auto const linear_index) {
+#ifdef LB_BOUNDARIES
+        return Utils::Vector<int, 1>{lbfields[linear_index].boundary};
+#else
+        return Utils::Vector<int, 1>{0};
+#endif
+      }));
+}
+
+REGISTER_CALLBACK_MAIN_RANK(mpi_lb_gather_boundary_flags_local)
+
+static void lb_set_local_block_populations(std::vector<double> const &values) {
+  auto it = values.begin();
+  detail::lb_for_each_block_node(
+      lblattice.local_index_offset, lblattice.grid, [&](auto const &index) {
+        auto const linear_index =
+            get_linear_index(lblattice.local_index(index), lblattice.halo_grid);
+        Utils::Vector19d population;
+        std::copy_n(it, D3Q19::n_vel, population.begin());
+        it += D3Q19::n_vel;
+        lb_set_population(linear_index, population);
+      });
+}
+
+static void mpi_lb_scatter_populations_local() {
+  lb_set_local_block_populations(
+      detail::lb_scatter_blocks<D3Q19::n_vel>(std::vector<double>{}));
+}
+
+REGISTER_CALLBACK(mpi_lb_scatter_populations_local)
+
+std::vector<Utils::Vector19d> mpi_lb_gather_populations() {
+  auto const values = mpi_call(::Communication::Result::main_rank,
+                               mpi_lb_gather_populations_local);
+  std::vector<Utils::Vector19d> populations(values.size() / D3Q19::n_vel);
+  auto it = values.begin();
+  for (auto &population : populations) {
+    std::copy_n(it, D3Q19::n_vel, population.begin());
+    it += D3Q19::n_vel;
+  }
+  return populations;
+}
+
+std::vector<Utils::Vector3d> mpi_lb_gather_velocities() {
+  auto const values = mpi_call(::Communication::Result::main_rank,
+                               mpi_lb_gather_velocities_local);
+  std::vector<Utils::Vector3d> velocities(values.size() / 3u);
+  auto it = values.begin();
+  for (auto &velocity : velocities) {
+    std::copy_n(it, 3u, velocity.begin());
+    it += 3u;
+  }
+  return velocities;
+}
+
+std::vector<int> mpi_lb_gather_boundary_flags() {
+  return mpi_call(::Communication::Result::main_rank,
+                  mpi_lb_gather_boundary_flags_local);
+}
+
+void mpi_lb_scatter_populations(
+    std::vector<Utils::Vector19d> const &populations) {
+  std::vector<double> values;
+  values.reserve(populations.size() * D3Q19::n_vel);
+  for (auto const &population : populations) {
+    values.insert(values.end(), population.begin(), population.end());
+  }
+  mpi_call(mpi_lb_scatter_populations_local);
+  lb_set_local_block_populations(
+      detail::lb_scatter_blocks<D3Q19::n_vel>(values));
+}
+
+/**
+ * @brief Write or read the populations of the local lattice block with
+ * MPI-IO. The file stores the populations of the global lattice in
+ * row-major order after a header of @p header_size bytes.
+ * @return 1 if an error occurred on any rank, 0 otherwise.
+ */
+static int mpi_lb_populations_mpiio_local(std::string const &filename,
+                                          long header_size, bool write) {
+  auto const mode = (write) ? MPI_MODE_WRONLY : MPI_MODE_RDONLY;
+  MPI_File f;
+  auto ret = MPI_File_open(comm_cart, const_cast<char *>(filename.c_str()),
+                           mode, MPI_INFO_NULL, &f);
+  if (ret == MPI_SUCCESS) {
+    // the local block is a subarray of the global lattice in the file
+    auto const &global_grid = lblattice.global_grid;
+    auto const &grid = lblattice.grid;
+    auto const &offset = lblattice.local_index_offset;
+    int sizes[3] = {global_grid[0], global_grid[1], global_grid[2]};
+    int subsizes[3] = {grid[0], grid[1], grid[2]};
+    int starts[3] = {offset[0], offset[1], offset[2]};
+    MPI_Datatype node_type, block_type;
+    MPI_Type_contiguous(static_cast<int>(D3Q19::n_vel), MPI_DOUBLE,
+                        &node_type);
+    MPI_Type_commit(&node_type);
+    MPI_Type_create_subarray(3, sizes, subsizes, starts, MPI_ORDER_C,
+                             node_type, &block_type);
+    MPI_Type_commit(&block_type);
+
+    // linear index of the nodes in row-major order of the local block
+    auto const n_nodes = Utils::product(grid);
+    std::vector<Lattice::index_t> node_index;
+    node_index.reserve(static_cast<std::size_t>(n_nodes));
+    Utils::Vector3i ind;
+    for (ind[0] = 0; ind[0] < grid[0]; ++ind[0])
+      for (ind[1] = 0; ind[1] < grid[1]; ++ind[1])
+        for (ind[2] = 0; ind[2] < grid[2]; ++ind[2])
+          node_index.emplace_back(get_linear_index(
+              lblattice.local_index(offset + ind), lblattice.halo_grid));
+
+    std::vector<double> buffer(static_cast<std::size_t>(n_nodes) *
+                               D3Q19::n_vel);
+    ret = MPI_File_set_view(f, static_cast<MPI_Offset>(header_size),
+                            node_type, block_type,
+                            const_cast<char *>("native"), MPI_INFO_NULL);
+    if (write) {
+      auto it = buffer.begin();
+      for (auto const linear_index : node_index) {
+        auto const population = lb_get_population(linear_index);
+        it = std::copy(population.begin(), population.end(), it);
+      }
+      ret |= MPI_File_write_all(f, buffer.data(), n_nodes, node_type,
+                                MPI_STATUS_IGNORE);
+    } else {
+      ret |= MPI_File_read_all(f, buffer.data(), n_nodes, node_type,
+                               MPI_STATUS_IGNORE);
+      auto it = buffer.begin();
+      for (auto const linear_index : node_index) {
+        Utils::Vector19d population;
+        std::copy_n(it, D3Q19::n_vel, population.begin());
+        it += D3Q19::n_vel;
+        lb_set_population(linear_index, population);
+      }
+    }
+    MPI_Type_free(&block_type);
+    MPI_Type_free(&node_type);
+    MPI_File_close(&f);
+  }
+  auto const error = static_cast<int>(ret != MPI_SUCCESS);
+  return boost::mpi::all_reduce(comm_cart, error, boost::mpi::maximum<int>());
+}
+
+REGISTER_CALLBACK_MAIN_RANK(mpi_lb_populations_mpiio_local)
+
+bool mpi_lb_write_populations(std::string const &filename, long header_size) {
+  return mpi_call(::Communication::Result::main_rank,
+                  mpi_lb_populations_mpiio_local, filename, header_size,
+                  true) == 0;
+}
+
+bool mpi_lb_read_populations(std::string const &filename, long header_size) {
+  return mpi_call(::Communication::Result::main_rank,
+                  mpi_lb_populations_mpiio_local, filename, header_size,
+                  false) == 0;
+}
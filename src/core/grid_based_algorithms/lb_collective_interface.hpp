@@ -24,6 +24,9 @@
 #include <boost/optional.hpp>
 #include <utils/Vector.hpp>
 
+#include <string>
+#include <vector>
+
 /* collective getter functions */
 boost::optional<Utils::Vector3d>
 mpi_lb_get_interpolated_velocity(Utils::Vector3d const &pos);
@@ -44,6 +47,37 @@ void mpi_lb_set_population(Utils::Vector3i const &index,
 void mpi_lb_set_force_density(Utils::Vector3i const &index,
                               Utils::Vector3d const &force_density);
 
+/* collective lattice block functions */
+/** @brief Gather the populations of all nodes on the head node,
+ *  in column-major order of the global lattice.
+ */
+std::vector<Utils::Vector19d> mpi_lb_gather_populations();
+/** @brief Gather the velocities of all nodes on the head node,
+ *  in column-major order of the global lattice.
+ */
+std::vector<Utils::Vector3d> mpi_lb_gather_velocities();
+/** @brief Gather the boundary flags of all nodes on the head node,
+ *  in column-major order of the global lattice.
+ */
+std::vector<int> mpi_lb_gather_boundary_flags();
+/** @brief Set the populations of all nodes from the head node.
+ *  @param populations Populations in column-major order of the global lattice.
+ */
+void mpi_lb_scatter_populations(
+    std::vector<Utils::Vector19d> const &populations);
+/** @brief Write the populations of all nodes to a binary file with MPI-IO.
+ *  Each rank writes its local block. The populations are stored in
+ *  row-major order of the global lattice, after a header of
+ *  @p header_size bytes which is left untouched.
+ *  @return Whether the write was successful.
+ */
+bool mpi_lb_write_populations(std::string const &filename, long header_size);
+/** @brief Read the populations of all nodes from a binary file with MPI-IO.
+ *  The file layout is the one of @ref mpi_lb_write_populations.
+ *  @return Whether the read was successful.
+ */
+bool mpi_lb_read_populations(std::string const &filename, long header_size);
+
 /* collective sync functions */
 void mpi_bcast_lb_params(LBParam field);
 
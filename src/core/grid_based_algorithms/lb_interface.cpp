@@ -34,6 +34,7 @@
 #include "lbgpu.hpp"
 
 #include <utils/Vector.hpp>
+#include <utils/index.hpp>
 
 #include <cmath>
 #include <fstream>
@@ -507,13 +508,11 @@ void lb_lbfluid_print_vtk_boundary(const std::string &filename) {
     });
 #endif //  CUDA
   } else {
+    auto const flags = mpi_lb_gather_boundary_flags();
     vtk_writer("lbboundaries", [&]() {
-      auto const grid_size = lb_lbfluid_get_shape();
-      Utils::Vector3i pos;
-      for (pos[2] = 0; pos[2] < grid_size[2]; pos[2]++)
-        for (pos[1] = 0; pos[1] < grid_size[1]; pos[1]++)
-          for (pos[0] = 0; pos[0] < grid_size[0]; pos[0]++)
-            cpfile << lb_lbnode_get_boundary(pos) << "\n";
+      for (auto const flag : flags) {
+        cpfile << flag << "\n";
+      }
     });
   }
   cpfile.close();
@@ -588,7 +587,11 @@ void lb_lbfluid_print_vtk_velocity(const std::string &filename,
     });
 #endif //  CUDA
   } else {
-    vtk_writer("lbfluid_cpu", lb_lbnode_get_velocity);
+    auto const velocities = mpi_lb_gather_velocities();
+    auto const grid_size = lb_lbfluid_get_shape();
+    vtk_writer("lbfluid_cpu", [&](Utils::Vector3i const &pos) {
+      return velocities[Utils::get_linear_index(pos, grid_size)];
+    });
   }
   cpfile.close();
 }
@@ -625,11 +628,13 @@ void lb_lbfluid_print_boundary(const std::string &filename) {
     auto const shift = Vector3d{{0.5, 0.5, 0.5}};
     auto const agrid = lb_lbfluid_get_agrid();
     auto const grid_size = lb_lbfluid_get_shape();
+    auto const flags = mpi_lb_gather_boundary_flags();
+    auto flag_it = flags.begin();
     Utils::Vector3i pos;
     for (pos[2] = 0; pos[2] < grid_size[2]; pos[2]++)
       for (pos[1] = 0; pos[1] < grid_size[1]; pos[1]++)
         for (pos[0] = 0; pos[0] < grid_size[0]; pos[0]++) {
-          auto const flag = (lb_lbnode_get_boundary(pos) != 0) ? 1 : 0;
+          auto const flag = (*flag_it++ != 0) ? 1 : 0;
           cpfile << vtk_format << (pos + shift) * agrid << " " << flag << "\n";
         }
   }
@@ -671,12 +676,14 @@ void lb_lbfluid_print_velocity(const std::string &filename) {
     auto const agrid = lb_lbfluid_get_agrid();
     auto const grid_size = lb_lbfluid_get_shape();
     auto const lattice_speed = lb_lbfluid_get_lattice_speed();
+    auto const velocities = mpi_lb_gather_velocities();
+    auto velocity_it = velocities.begin();
     Utils::Vector3i pos;
     for (pos[2] = 0; pos[2] < grid_size[2]; pos[2]++)
       for (pos[1] = 0; pos[1] < grid_size[1]; pos[1]++)
         for (pos[0] = 0; pos[0] < grid_size[0]; pos[0]++)
           cpfile << vtk_format << (pos + shift) * agrid << " " << vtk_format
-                 << lb_lbnode_get_velocity(pos) * lattice_speed << "\n";
+                 << *velocity_it++ * lattice_speed << "\n";
   }
 
   cpfile.close();
@@ -779,13 +786,23 @@ void lb_lbfluid_save_checkpoint(const std::string &filename, bool binary) {
       auto const grid_size = lb_lbfluid_get_shape();
       cpfile.write(grid_size);
 
-      for (int i = 0; i < grid_size[0]; i++) {
-        for (int j = 0; j < grid_size[1]; j++) {
-          for (int k = 0; k < grid_size[2]; k++) {
-            auto const ind = Utils::Vector3i{{i, j, k}};
-            auto const pop = mpi_call(::Communication::Result::one_rank,
-                                      mpi_lb_get_populations, ind);
-            cpfile.write(pop);
+      if (binary) {
+        // each rank writes its lattice block after the header
+        cpfile.stream.flush();
+        auto const header_size = static_cast<long>(cpfile.stream.tellp());
+        if (not mpi_lb_write_populations(filename, header_size)) {
+          throw std::runtime_error(err_msg + "could not write data to " +
+                                   filename);
+        }
+      } else {
+        auto const populations = mpi_lb_gather_populations();
+        for (int i = 0; i < grid_size[0]; i++) {
+          for (int j = 0; j < grid_size[1]; j++) {
+            for (int k = 0; k < grid_size[2]; k++) {
+              auto const ind = Utils::Vector3i{{i, j, k}};
+              auto const index = Utils::get_linear_index(ind, grid_size);
+              cpfile.write(populations[index]);
+            }
           }
         }
       }
@@ -838,15 +855,37 @@ void lb_lbfluid_load_checkpoint(const std::string &filename, bool binary) {
       mpi_bcast_lb_params(LBParam::DENSITY);
       check_header(gridsize);
 
-      Utils::Vector19d pop;
-      for (int i = 0; i < gridsize[0]; i++) {
-        for (int j = 0; j < gridsize[1]; j++) {
-          for (int k = 0; k < gridsize[2]; k++) {
-            auto const ind = Utils::Vector3i{{i, j, k}};
-            cpfile.read(pop);
-            lb_lbnode_set_pop(ind, pop);
+      if (binary) {
+        // check the file size before each rank reads its lattice block
+        auto const header_size = static_cast<long>(cpfile.stream.tellg());
+        cpfile.stream.seekg(0, std::ios_base::end);
+        auto const data_size =
+            static_cast<long>(cpfile.stream.tellg()) - header_size;
+        auto const expected_size = static_cast<long>(
+            Utils::product(gridsize) * D3Q19::n_vel * sizeof(double));
+        if (data_size < expected_size) {
+          throw std::runtime_error(err_msg + "EOF found.");
+        }
+        if (data_size > expected_size) {
+          throw std::runtime_error(err_msg + "extra data found, expected EOF.");
+        }
+        if (not mpi_lb_read_populations(filename, header_size)) {
+          throw std::runtime_error(err_msg + "could not read data from " +
+                                   filename);
+        }
+      } else {
+        std::vector<Utils::Vector19d> populations(
+            static_cast<std::size_t>(Utils::product(gridsize)));
+        for (int i = 0; i < gridsize[0]; i++) {
+          for (int j = 0; j < gridsize[1]; j++) {
+            for (int k = 0; k < gridsize[2]; k++) {
+              auto const ind = Utils::Vector3i{{i, j, k}};
+              auto const index = Utils::get_linear_index(ind, gridsize);
+              cpfile.read(populations[index]);
+            }
           }
         }
+        mpi_lb_scatter_populations(populations);
       }
     } else {
       throw std::runtime_error(
@@ -28,6 +28,7 @@
 
 #include "integrate.hpp"
 #include "integrators/brownian_inline.hpp"
+#include "integrators/respa.hpp"
 #include "integrators/steepest_descent.hpp"
 #include "integrators/stokesian_dynamics_inline.hpp"
 #include "integrators/velocity_verlet_inline.hpp"
@@ -40,6 +41,7 @@
 #include "cells.hpp"
 #include "collision.hpp"
 #include "communication.hpp"
+#include "error_handling/DeferredErrorCheck.hpp"
 #include "errorhandling.hpp"
 #include "event.hpp"
 #include "forces.hpp"
@@ -90,6 +92,14 @@ bool recalc_forces = true;
 /** Average number of integration steps the Verlet list has been re-using. */
 static double verlet_reuse = 0.0;
 
+/** Whether the runtime errors of a time step are only checked at the end
+ *  of the following time step, see @ref mpi_set_deferred_error_check. */
+static bool deferred_error_check = false;
+
+/** Number of runtime error checks in the last integration which did not
+ *  block the integration loop. */
+static int n_deferred_error_checks = 0;
+
 static int fluid_step = 0;
 
 bool set_py_interrupt = false;
@@ -157,6 +167,7 @@ void integrator_sanity_checks() {
     if (thermo_switch & (THERMO_NPT_ISO | THERMO_BROWNIAN | THERMO_SD))
       runtimeErrorMsg() << "The VV integrator is incompatible with the "
                            "currently active combination of thermostats";
+    respa_sanity_checks();
     break;
 #ifdef NPT
   case INTEG_METHOD_NPT_ISO:
@@ -260,6 +271,8 @@ int integrate(int n_steps, int reuse_forces) {
   if (check_runtime_errors(comm_cart))
     return 0;
 
+  respa_start_integration();
+
   // Additional preparations for the first integration step
   if (reuse_forces == -1 || (recalc_forces && reuse_forces != 1)) {
     ESPRESSO_PROFILER_MARK_BEGIN("Initial Force Calculation");
@@ -272,6 +285,8 @@ int integrate(int n_steps, int reuse_forces) {
     // Communication step: distribute ghost positions
     cells_update_ghosts(global_ghost_flags());
 
+    // The first force calculation starts a new outer time step
+    respa_reset_phase();
     force_calc(cell_structure, time_step, temperature);
 
     if (integ_switch != INTEG_METHOD_STEEPEST_DESCENT) {
@@ -279,6 +294,7 @@ int integrate(int n_steps, int reuse_forces) {
       convert_initial_torques(cell_structure.local_particles());
 #endif
     }
+    respa_end_of_step(n_steps);
 
     ESPRESSO_PROFILER_MARK_END("Initial Force Calculation");
   }
@@ -291,6 +307,9 @@ int integrate(int n_steps, int reuse_forces) {
   // Keep track of the number of Verlet updates (i.e. particle resorts)
   int n_verlet_updates = 0;
 
+  // Runtime errors of a time step, collected at the end of the next one
+  ErrorHandling::DeferredErrorCheck error_check(comm_cart);
+
 #ifdef VALGRIND_INSTRUMENTATION
   CALLGRIND_START_INSTRUMENTATION;
 #endif
@@ -338,8 +357,9 @@ int integrate(int n_steps, int reuse_forces) {
     if (cell_structure.get_resort_particles() >= Cells::RESORT_LOCAL)
       n_verlet_updates++;
 
-    // Communication step: distribute ghost positions
-    cells_update_ghosts(global_ghost_flags());
+    // Communication step: distribute ghost positions, which may overlap
+    // with the force calculation
+    cells_update_ghosts_begin(global_ghost_flags());
 
     particles = cell_structure.local_particles();
 
@@ -356,6 +376,7 @@ int integrate(int n_steps, int reuse_forces) {
       correct_velocity_shake(cell_structure);
     }
 #endif
+    respa_end_of_step(n_steps - step - 1);
 
     // propagate one-step functionalities
     if (integ_switch != INTEG_METHOD_STEEPEST_DESCENT) {
@@ -383,8 +404,13 @@ int integrate(int n_steps, int reuse_forces) {
 
     integrated_steps++;
 
-    if (check_runtime_errors(comm_cart))
+    if (deferred_error_check) {
+      if (error_check.wait())
+        break;
+      error_check.start(check_runtime_errors_local());
+    } else if (check_runtime_errors(comm_cart)) {
       break;
+    }
 
     // Check if SIGINT has been caught.
     if (ctrl_C == 1) {
@@ -393,6 +419,9 @@ int integrate(int n_steps, int reuse_forces) {
     }
 
   } // for-loop over integration steps
+  // Errors of the last time step are reported by the caller
+  error_check.wait();
+  n_deferred_error_checks = error_check.n_started();
   LeesEdwards::update_box_params();
   ESPRESSO_PROFILER_CXX_MARK_LOOP_END(integration_loop);
 
@@ -506,7 +535,10 @@ void integrate_set_steepest_descent(const double f_max, const double gamma,
   mpi_set_integ_switch(INTEG_METHOD_STEEPEST_DESCENT);
 }
 
-void integrate_set_nvt() { mpi_set_integ_switch(INTEG_METHOD_NVT); }
+void integrate_set_nvt(int long_range_interval, bool monitor_energy) {
+  respa_init(long_range_interval, monitor_energy);
+  mpi_set_integ_switch(INTEG_METHOD_NVT);
+}
 
 void integrate_set_bd() { mpi_set_integ_switch(INTEG_METHOD_BD); }
 
@@ -535,6 +567,10 @@ double interaction_range() {
 
 double get_verlet_reuse() { return verlet_reuse; }
 
+bool get_deferred_error_check() { return deferred_error_check; }
+
+int get_n_deferred_error_checks() { return n_deferred_error_checks; }
+
 double get_time_step() { return time_step; }
 
 double get_sim_time() { return sim_time; }
@@ -576,6 +612,16 @@ REGISTER_CALLBACK(mpi_set_time_local)
 
 void mpi_set_time(double time) { mpi_call_all(mpi_set_time_local, time); }
 
+static void mpi_set_deferred_error_check_local(bool deferred) {
+  deferred_error_check = deferred;
+}
+
+REGISTER_CALLBACK(mpi_set_deferred_error_check_local)
+
+void mpi_set_deferred_error_check(bool deferred) {
+  mpi_call_all(mpi_set_deferred_error_check_local, deferred);
+}
+
 void mpi_set_integ_switch_local(int integ_switch) {
   ::integ_switch = integ_switch;
 }
@@ -126,8 +126,15 @@ int mpi_steepest_descent(int steps);
 void integrate_set_steepest_descent(double f_max, double gamma,
                                     double max_displacement);
 
-/** @brief Set the velocity Verlet integrator for the NVT ensemble. */
-void integrate_set_nvt();
+/** @brief Set the velocity Verlet integrator for the NVT ensemble.
+ *
+ *  @param long_range_interval  Number of time steps per evaluation of the
+ *                              long-range forces, see @ref respa.hpp
+ *  @param monitor_energy       Whether to calculate the total energy at
+ *                              every outer time step
+ */
+void integrate_set_nvt(int long_range_interval = 1,
+                       bool monitor_energy = false);
 
 /** @brief Set the Brownian Dynamics integrator. */
 void integrate_set_bd();
@@ -157,6 +164,13 @@ void integrate_set_npt_isotropic(double ext_pressure, double piston,
 /** Get @c verlet_reuse */
 double get_verlet_reuse();
 
+/** Get whether runtime errors are checked with a delay of one time step. */
+bool get_deferred_error_check();
+
+/** Get the number of runtime error checks of the last integration which
+ *  did not block the integration loop. */
+int get_n_deferred_error_checks();
+
 /** Get time step */
 double get_time_step();
 
@@ -180,6 +194,18 @@ void mpi_set_skin_local(double skin);
  */
 void mpi_set_time(double time);
 
+/** @brief Set and broadcast the runtime error check mode.
+ *
+ *  By default, the runtime errors of all nodes are counted at the end of
+ *  every time step with a blocking reduction. In deferred mode, the
+ *  reduction runs in the background during the following time step
+ *  instead, and the integration stops one time step after the one which
+ *  raised the error. The time steps are not rolled back.
+ *
+ *  @param deferred Whether to check the errors with a delay of one step.
+ */
+void mpi_set_deferred_error_check(bool deferred);
+
 void mpi_set_integ_switch(int integ_switch);
 
 #endif
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "integrators/respa.hpp"
+
+#include "actor/visitors.hpp"
+#include "communication.hpp"
+#include "config.hpp"
+#include "electrostatics/coulomb.hpp"
+#include "energy.hpp"
+#include "errorhandling.hpp"
+#include "grid_based_algorithms/electrokinetics.hpp"
+#include "integrate.hpp"
+#include "magnetostatics/dipoles.hpp"
+
+#include <stdexcept>
+
+/** Currently active multiple time step parameters */
+static RespaParameters params{};
+
+static RespaDiagnostics diagnostics{};
+
+/** Number of force calculations since the last evaluation of the
+ *  long-range forces, modulo the long-range interval. */
+static int phase = 0;
+
+/** Whether the last force calculation evaluated the long-range forces. */
+static bool long_range_evaluated = false;
+
+/** Number of outer time step boundaries in the current integration. */
+static int n_boundaries = 0;
+
+/** Whether long-range forces are calculated on the GPU. They are only
+ *  copied to the particles at the end of the force calculation, after
+ *  the long-range forces were scaled.
+ */
+static bool gpu_long_range_forces() {
+#if defined(ELECTROSTATICS) && defined(P3M) && defined(CUDA)
+  if (has_actor_of_type<CoulombP3MGPU>(electrostatics_actor)) {
+    return true;
+  }
+#endif
+#if defined(ELECTROSTATICS) && defined(MMM1D_GPU)
+  if (has_actor_of_type<CoulombMMM1DGpu>(electrostatics_actor)) {
+    return true;
+  }
+#endif
+#if defined(DIPOLES) && defined(DIPOLAR_DIRECT_SUM)
+  if (has_actor_of_type<DipolarDirectSumGpu>(magnetostatics_actor)) {
+    return true;
+  }
+#endif
+#if defined(DIPOLES) && defined(DIPOLAR_BARNES_HUT)
+  if (has_actor_of_type<DipolarBarnesHutGpu>(magnetostatics_actor)) {
+    return true;
+  }
+#endif
+#if defined(CUDA) && defined(ELECTROKINETICS)
+  if (ek_initialized) {
+    return true;
+  }
+#endif
+  return false;
+}
+
+static constexpr auto gpu_error_message =
+    "The multiple time step scheme cannot be used with long-range forces "
+    "calculated on the GPU or with electrokinetics.";
+
+void respa_sanity_checks() {
+  if (respa_active() and gpu_long_range_forces()) {
+    runtimeErrorMsg() << gpu_error_message;
+  }
+}
+
+RespaParameters const &respa_get_parameters() { return params; }
+
+RespaDiagnostics const &respa_get_diagnostics() { return diagnostics; }
+
+bool respa_active() {
+  return params.long_range_interval > 1 and integ_switch == INTEG_METHOD_NVT;
+}
+
+void respa_start_integration() {
+  diagnostics = RespaDiagnostics{};
+  n_boundaries = 0;
+  long_range_evaluated = false;
+}
+
+void respa_reset_phase() { phase = 0; }
+
+bool respa_long_range_step() {
+  long_range_evaluated = (phase == 0);
+  phase = (phase + 1) % params.long_range_interval;
+  if (long_range_evaluated) {
+    ++diagnostics.n_long_range_evaluations;
+  }
+  return long_range_evaluated;
+}
+
+double respa_long_range_scale() {
+  return static_cast<double>(params.long_range_interval);
+}
+
+void respa_end_of_step(int remaining_steps) {
+  if (not respa_active() or not long_range_evaluated) {
+    return;
+  }
+  long_range_evaluated = false;
+  if (n_boundaries > 0) {
+    ++diagnostics.n_outer_steps;
+  }
+  ++n_boundaries;
+  // the energy is only needed at the first and the last boundary, the
+  // next boundary is long_range_interval time steps ahead
+  auto const first = (n_boundaries == 1);
+  auto const last = (remaining_steps < params.long_range_interval);
+  if (params.monitor_energy and (first or last)) {
+    auto const energy = calculate_total_energy_local();
+    if (first) {
+      diagnostics.energy_start = energy;
+    }
+    diagnostics.energy_end = energy;
+  }
+}
+
+static void mpi_set_respa_parameters_local(RespaParameters new_params) {
+  // the forces on the particles depend on the long-range interval
+  if (new_params.long_range_interval != params.long_range_interval) {
+    phase = 0;
+    recalc_forces = true;
+  }
+  params = new_params;
+}
+
+REGISTER_CALLBACK(mpi_set_respa_parameters_local)
+
+void respa_init(int long_range_interval, bool monitor_energy) {
+  if (long_range_interval < 1) {
+    throw std::runtime_error("The long-range interval must be positive.");
+  }
+  if (long_range_interval > 1 and gpu_long_range_forces()) {
+    throw std::runtime_error(gpu_error_message);
+  }
+
+  RespaParameters new_params{};
+  new_params.long_range_interval = long_range_interval;
+  new_params.monitor_energy = monitor_energy;
+
+  mpi_call_all(mpi_set_respa_parameters_local, new_params);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_INTEGRATORS_RESPA_HPP
+#define CORE_INTEGRATORS_RESPA_HPP
+
+/** \file
+ *  Multiple time step scheme (impulse r-RESPA) for the velocity Verlet
+ *  integrator.
+ *
+ *  The long-range parts of the electrostatic and magnetostatic
+ *  interactions (see @ref calc_long_range_forces) vary slowly compared
+ *  to the short-range forces. They are only evaluated every
+ *  @ref RespaParameters::long_range_interval "long_range_interval" time
+ *  steps, scaled by that number and applied together with the
+ *  short-range forces as an impulse at the beginning and the end of
+ *  each outer time step. The inner time steps are regular velocity
+ *  Verlet steps with the short-range forces and the thermostat.
+ *
+ *  Implementation in respa.cpp.
+ */
+
+#include <boost/serialization/access.hpp>
+
+/** Parameters of the multiple time step scheme */
+struct RespaParameters {
+  /** Number of time steps per evaluation of the long-range forces */
+  int long_range_interval = 1;
+  /** Whether to calculate the total energy at the first and the last
+   *  outer time step boundary of each integration
+   */
+  bool monitor_energy = false;
+
+private:
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &long_range_interval;
+    ar &monitor_energy;
+  }
+};
+
+/** Diagnostics of the multiple time step scheme in the last integration */
+struct RespaDiagnostics {
+  /** Number of evaluations of the long-range forces */
+  int n_long_range_evaluations = 0;
+  /** Number of completed outer time steps */
+  int n_outer_steps = 0;
+  /** Total energy at the first outer time step boundary */
+  double energy_start = 0.;
+  /** Total energy at the last outer time step boundary */
+  double energy_end = 0.;
+};
+
+/** Multiple time step initializer
+ *
+ *  Sets the parameters in @ref RespaParameters on all nodes. The forces
+ *  are recalculated at the next integration, which starts a new outer
+ *  time step.
+ */
+void respa_init(int long_range_interval, bool monitor_energy);
+
+RespaParameters const &respa_get_parameters();
+
+/** Diagnostics of the last integration, only complete on the head node. */
+RespaDiagnostics const &respa_get_diagnostics();
+
+/** Whether the long-range forces are only evaluated every few time steps.
+ *  Only the velocity Verlet integrator supports the multiple time step
+ *  scheme, the other integrators evaluate them in every time step.
+ */
+bool respa_active();
+
+/** Reset the diagnostics at the beginning of an integration. */
+void respa_start_integration();
+
+/** Start a new outer time step in the next force calculation. */
+void respa_reset_phase();
+
+/** Check whether the long-range forces are due in the current force
+ *  calculation and advance to the next inner time step.
+ */
+bool respa_long_range_step();
+
+/** Factor by which the long-range forces are scaled in the force
+ *  calculations in which they are evaluated.
+ */
+double respa_long_range_scale();
+
+/** Update the diagnostics after the velocity update of a time step.
+ *  Collective call, which calculates the total energy if the time step
+ *  completed the first or the last outer time step of the integration
+ *  and the energy is monitored.
+ *  @param remaining_steps Number of time steps left in the integration
+ */
+void respa_end_of_step(int remaining_steps);
+
+/** Report an error if the long-range forces cannot be scaled, which is
+ *  the case if they are calculated on the GPU.
+ */
+void respa_sanity_checks();
+
+#endif
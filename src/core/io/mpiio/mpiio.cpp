@@ -46,15 +46,33 @@
  *   <tt>id[i]</tt>. The iteration indices for local part of 1.bonds are:
  *   <tt>subarray[i] : subarray[i+1]</tt>
  * - Take a look at the bond input code. It's easy to understand.
+ *
+ * Checkpoints store the complete particle state in fixed-size records,
+ * so that they can be read back on any number of ranks:
+ * - 1.chkh contains the layout version and the size of a record.
+ * - 1.part contains one @ref ParticleRecord per particle, in the rank
+ *   ordering like scalar arrays.
+ * - 1.cbnd contains the bonds of all particles in the same ordering.
+ *   Every bond is stored as its id, the number of partners and the
+ *   partner ids. The record holds the number of entries per particle.
+ * - 1.excl contains the exclusions of all particles in the same
+ *   ordering, the record holds their number per particle.
+ * The entries of a rank in 1.cbnd and 1.excl are located by summing up
+ * the number of entries in the records of all lower ranks, which only
+ * depends on the range of particles a rank reads.
  */
 
 #include "mpiio.hpp"
 
 #include "Particle.hpp"
 #include "bonded_interactions/bonded_interaction_data.hpp"
+#include "BondList.hpp"
 #include "cells.hpp"
 #include "errorhandling.hpp"
+#include "event.hpp"
+#include "particle_node.hpp"
 
+#include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
 #include <boost/archive/binary_iarchive.hpp>
@@ -62,19 +80,23 @@
 #include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/stream.hpp>
+#include <boost/range/algorithm/copy.hpp>
 
 #include <mpi.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cerrno>
 #include <cstddef>
 #include <cstdio>
 #include <cstring>
+#include <iterator>
 #include <sstream>
 #include <string>
 #include <sys/stat.h>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -211,30 +233,45 @@ static void dump_info(const std::string &fn, unsigned fields) {
   static_cast<void>(success or fatal_error("Could not write file", fn));
 }
 
-void mpi_mpiio_common_write(const std::string &prefix, unsigned fields,
-                            const ParticleRange &particles) {
+namespace {
+/** @brief Particle data of one output frame, in the file layout. */
+struct FrameBuffers {
+  /** @brief Number of particles on all nodes with lower rank. */
+  unsigned long offset = 0ul;
+  /** @brief Size of the serialized bonds of the local particles. */
+  unsigned long bonds_size = 0ul;
+  /** @brief Size of the serialized bonds on all nodes with lower rank. */
+  unsigned long bonds_offset = 0ul;
+  std::vector<int> id, type;
+  std::vector<double> pos, vel;
+  std::vector<char> bonds;
+};
+} // namespace
+
+/**
+ * @brief Pack the particle data of the requested fields.
+ * To be called by all MPI processes.
+ *
+ * @param fields Specifier for which fields to pack.
+ * @param particles Range of particles to serialize.
+ * @param buffers Buffers to fill.
+ */
+static void pack_frame(unsigned fields, const ParticleRange &particles,
+                       FrameBuffers &buffers) {
   auto const nlocalpart = static_cast<unsigned long>(particles.size());
-  auto const offset = mpi_calculate_file_offset(nlocalpart);
-  // Keep static buffers in order to avoid allocating them on every
-  // function call
-  static std::vector<double> pos, vel;
-  static std::vector<int> id, type;
-
-  // Realloc static buffers if necessary
-  if (nlocalpart > id.size())
-    id.resize(nlocalpart);
-  if (fields & MPIIO_OUT_POS && 3ul * nlocalpart > pos.size())
-    pos.resize(3ul * nlocalpart);
-  if (fields & MPIIO_OUT_VEL && 3ul * nlocalpart > vel.size())
-    vel.resize(3ul * nlocalpart);
-  if (fields & MPIIO_OUT_TYP && nlocalpart > type.size())
-    type.resize(nlocalpart);
+  buffers.offset = mpi_calculate_file_offset(nlocalpart);
+
+  // Resizing keeps the capacity of buffers that are reused
+  buffers.id.resize(nlocalpart);
+  buffers.pos.resize((fields & MPIIO_OUT_POS) ? 3ul * nlocalpart : 0ul);
+  buffers.vel.resize((fields & MPIIO_OUT_VEL) ? 3ul * nlocalpart : 0ul);
+  buffers.type.resize((fields & MPIIO_OUT_TYP) ? nlocalpart : 0ul);
 
   // Pack the necessary information
-  auto id_it = id.begin();
-  auto type_it = type.begin();
-  auto pos_it = pos.begin();
-  auto vel_it = vel.begin();
+  auto id_it = buffers.id.begin();
+  auto type_it = buffers.type.begin();
+  auto pos_it = buffers.pos.begin();
+  auto vel_it = buffers.vel.begin();
   for (auto const &p : particles) {
     *id_it = p.id();
     ++id_it;
@@ -252,32 +289,13 @@ void mpi_mpiio_common_write(const std::string &prefix, unsigned fields,
     }
   }
 
-  int rank;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  if (rank == 0)
-    dump_info(prefix + ".head", fields);
-  auto const pref_offset = static_cast<unsigned long>(rank);
-  mpiio_dump_array<unsigned long>(prefix + ".pref", &offset, 1ul, pref_offset,
-                                  MPI_UNSIGNED_LONG);
-  mpiio_dump_array<int>(prefix + ".id", id.data(), nlocalpart, offset, MPI_INT);
-  if (fields & MPIIO_OUT_POS)
-    mpiio_dump_array<double>(prefix + ".pos", pos.data(), 3ul * nlocalpart,
-                             3ul * offset, MPI_DOUBLE);
-  if (fields & MPIIO_OUT_VEL)
-    mpiio_dump_array<double>(prefix + ".vel", vel.data(), 3ul * nlocalpart,
-                             3ul * offset, MPI_DOUBLE);
-  if (fields & MPIIO_OUT_TYP)
-    mpiio_dump_array<int>(prefix + ".type", type.data(), nlocalpart, offset,
-                          MPI_INT);
-
+  buffers.bonds.clear();
   if (fields & MPIIO_OUT_BND) {
-    std::vector<char> bonds;
-
     /* Construct archive that pushes back to the bond buffer */
     {
       namespace io = boost::iostreams;
       io::stream_buffer<io::back_insert_device<std::vector<char>>> os{
-          io::back_inserter(bonds)};
+          io::back_inserter(buffers.bonds)};
       boost::archive::binary_oarchive bond_archiver{os};
 
       for (auto const &p : particles) {
@@ -286,13 +304,168 @@ void mpi_mpiio_common_write(const std::string &prefix, unsigned fields,
     }
 
     // Determine the prefixes in the bond file
-    auto const bonds_size = static_cast<unsigned long>(bonds.size());
-    auto const bonds_offset = mpi_calculate_file_offset(bonds_size);
+    buffers.bonds_size = static_cast<unsigned long>(buffers.bonds.size());
+    buffers.bonds_offset = mpi_calculate_file_offset(buffers.bonds_size);
+  }
+}
 
-    mpiio_dump_array<unsigned long>(prefix + ".boff", &bonds_size, 1ul,
-                                    pref_offset, MPI_UNSIGNED_LONG);
-    mpiio_dump_array<char>(prefix + ".bond", bonds.data(), bonds.size(),
-                           bonds_offset, MPI_CHAR);
+/**
+ * @brief Dump packed particle data.
+ * To be called by all MPI processes.
+ *
+ * @param prefix Filepath prefix.
+ * @param fields Specifier for which fields to dump.
+ * @param buffers Packed particle data.
+ * @param dump_array Function with the signature of @ref mpiio_dump_array.
+ */
+template <typename DumpArray>
+static void dump_frame(const std::string &prefix, unsigned fields,
+                       FrameBuffers const &buffers, DumpArray dump_array) {
+  auto const nlocalpart = static_cast<unsigned long>(buffers.id.size());
+  auto const offset = buffers.offset;
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (rank == 0)
+    dump_info(prefix + ".head", fields);
+  auto const pref_offset = static_cast<unsigned long>(rank);
+  dump_array(prefix + ".pref", &buffers.offset, 1ul, pref_offset,
+             MPI_UNSIGNED_LONG);
+  dump_array(prefix + ".id", buffers.id.data(), nlocalpart, offset, MPI_INT);
+  if (fields & MPIIO_OUT_POS)
+    dump_array(prefix + ".pos", buffers.pos.data(), 3ul * nlocalpart,
+               3ul * offset, MPI_DOUBLE);
+  if (fields & MPIIO_OUT_VEL)
+    dump_array(prefix + ".vel", buffers.vel.data(), 3ul * nlocalpart,
+               3ul * offset, MPI_DOUBLE);
+  if (fields & MPIIO_OUT_TYP)
+    dump_array(prefix + ".type", buffers.type.data(), nlocalpart, offset,
+               MPI_INT);
+  if (fields & MPIIO_OUT_BND) {
+    dump_array(prefix + ".boff", &buffers.bonds_size, 1ul, pref_offset,
+               MPI_UNSIGNED_LONG);
+    dump_array(prefix + ".bond", buffers.bonds.data(), buffers.bonds.size(),
+               buffers.bonds_offset, MPI_CHAR);
+  }
+}
+
+void mpi_mpiio_common_write(const std::string &prefix, unsigned fields,
+                            const ParticleRange &particles) {
+  // Keep static buffers in order to avoid allocating them on every
+  // function call
+  static FrameBuffers buffers;
+  pack_frame(fields, particles, buffers);
+  dump_frame(prefix, fields, buffers,
+             [](std::string const &fn, auto const *arr, std::size_t len,
+                std::size_t pref, MPI_Datatype MPI_T) {
+               mpiio_dump_array(fn, arr, len, pref, MPI_T);
+             });
+}
+
+namespace {
+/** @brief Frame staged for an asynchronous write. */
+struct AsyncFrame {
+  FrameBuffers buffers;
+  std::vector<std::string> file_names;
+  std::vector<MPI_File> files;
+  std::vector<MPI_Request> requests;
+};
+
+/**
+ * @brief Staging areas of the asynchronous writer.
+ * One frame can be packed while the previous one is still being written.
+ */
+std::array<AsyncFrame, 2> async_frames;
+/** @brief Index of the staging area used by the next frame. */
+std::size_t async_next_frame = 0;
+} // namespace
+
+/**
+ * @brief Start a non-blocking collective write of @p arr.
+ * Same arguments as @ref mpiio_dump_array. The array must not be
+ * modified until @ref wait_async_frame has completed the write.
+ */
+template <typename T>
+static void mpiio_dump_array_async(AsyncFrame &frame, const std::string &fn,
+                                   T const *arr, std::size_t len,
+                                   std::size_t pref, MPI_Datatype MPI_T) {
+  MPI_File f;
+  int ret;
+  ret = MPI_File_open(MPI_COMM_WORLD, const_cast<char *>(fn.c_str()),
+                      // MPI_MODE_EXCL: Prohibit overwriting
+                      MPI_MODE_WRONLY | MPI_MODE_CREATE | MPI_MODE_EXCL,
+                      MPI_INFO_NULL, &f);
+  if (ret) {
+    fatal_error("Could not open file", fn, &f, ret);
+  }
+  auto const offset =
+      static_cast<MPI_Offset>(pref) * static_cast<MPI_Offset>(sizeof(T));
+  MPI_Request request;
+  ret = MPI_File_set_view(f, offset, MPI_T, MPI_T, const_cast<char *>("native"),
+                          MPI_INFO_NULL);
+  ret |= MPI_File_iwrite_all(f, arr, static_cast<int>(len), MPI_T, &request);
+  static_cast<void>(ret and fatal_error("Could not write file", fn, &f, ret));
+  frame.file_names.emplace_back(fn);
+  frame.files.emplace_back(f);
+  frame.requests.emplace_back(request);
+}
+
+/**
+ * @brief Complete the pending writes of a frame and close its files.
+ * To be called by all MPI processes.
+ */
+static void wait_async_frame(AsyncFrame &frame) {
+  int error = MPI_SUCCESS;
+  std::string error_file;
+  for (std::size_t i = 0; i < frame.files.size(); ++i) {
+    auto const ret = MPI_Wait(&frame.requests[i], MPI_STATUS_IGNORE);
+    MPI_File_close(&frame.files[i]);
+    if (ret and not error) {
+      error = ret;
+      error_file = frame.file_names[i];
+    }
+  }
+  frame.file_names.clear();
+  frame.files.clear();
+  frame.requests.clear();
+  if (error) {
+    fatal_error("Could not write file", error_file, nullptr, error);
+  }
+}
+
+/** @brief Complete pending writes when MPI is finalized. */
+static int flush_on_finalize(MPI_Comm, int, void *, void *) {
+  mpi_mpiio_async_flush();
+  return MPI_SUCCESS;
+}
+
+void mpi_mpiio_async_write(const std::string &prefix, unsigned fields,
+                           const ParticleRange &particles) {
+  static bool flush_registered = false;
+  if (not flush_registered) {
+    // attributes of MPI_COMM_SELF are deleted at the start of MPI_Finalize
+    int keyval;
+    MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, flush_on_finalize, &keyval,
+                           nullptr);
+    MPI_Comm_set_attr(MPI_COMM_SELF, keyval, nullptr);
+    flush_registered = true;
+  }
+  auto &frame = async_frames[async_next_frame];
+  async_next_frame = (async_next_frame + 1u) % async_frames.size();
+  // back-pressure: wait for the frame previously staged in this area
+  wait_async_frame(frame);
+  pack_frame(fields, particles, frame.buffers);
+  dump_frame(prefix, fields, frame.buffers,
+             [&frame](std::string const &fn, auto const *arr, std::size_t len,
+                      std::size_t pref, MPI_Datatype MPI_T) {
+               mpiio_dump_array_async(frame, fn, arr, len, pref, MPI_T);
+             });
+}
+
+void mpi_mpiio_async_flush() {
+  // complete the frames in the order they were staged
+  for (std::size_t i = 0; i < async_frames.size(); ++i) {
+    wait_async_frame(
+        async_frames[(async_next_frame + i) % async_frames.size()]);
   }
 }
 
@@ -515,4 +688,203 @@ void mpi_mpiio_common_read(const std::string &prefix, unsigned fields) {
     cell_structure.add_particle(std::move(p));
   }
 }
+
+/** Version of the checkpoint file layout */
+static constexpr unsigned checkpoint_version = 1u;
+
+/**
+ * @brief State of a particle in a checkpoint, without the bonds and
+ * exclusions, which are stored in separate files.
+ */
+struct ParticleRecord {
+  ParticleProperties p;
+  ParticlePosition r;
+  ParticleMomentum m;
+  ParticleForce f;
+  ParticleLocal l;
+  /** Number of entries of the particle in the bond file */
+  int n_bond_entries;
+  /** Number of entries of the particle in the exclusion file */
+  int n_exclusions;
+};
+
+static_assert(std::is_trivially_copyable<ParticleRecord>::value,
+              "ParticleRecord is written and read as raw bytes");
+
+/**
+ * @brief MPI datatype of a @ref ParticleRecord.
+ * Has to be freed with @c MPI_Type_free.
+ */
+static MPI_Datatype mpi_particle_record_type() {
+  MPI_Datatype record_type;
+  MPI_Type_contiguous(static_cast<int>(sizeof(ParticleRecord)), MPI_BYTE,
+                      &record_type);
+  MPI_Type_commit(&record_type);
+  return record_type;
+}
+
+/**
+ * @brief Dump the checkpoint layout.
+ * To be called by the head node only.
+ *
+ * @param fn The filename to write to
+ */
+static void dump_checkpoint_head(const std::string &fn) {
+  FILE *f = fopen(fn.c_str(), "wb");
+  if (!f) {
+    fatal_error("Could not open file", fn);
+  }
+  auto const record_size = static_cast<unsigned long>(sizeof(ParticleRecord));
+  bool success = (fwrite(&checkpoint_version, sizeof(unsigned), 1u, f) == 1);
+  success = success && (fwrite(&record_size, sizeof(record_size), 1u, f) == 1);
+  fclose(f);
+  static_cast<void>(success or fatal_error("Could not write file", fn));
+}
+
+/**
+ * @brief Check that the checkpoint layout matches this build.
+ * To be called by all processes.
+ *
+ * @param fn Filename of the checkpoint head file
+ * @param rank The rank of the current process in @c MPI_COMM_WORLD
+ */
+static void check_checkpoint_head(const std::string &fn, int rank) {
+  if (rank != 0) {
+    return;
+  }
+  FILE *f = fopen(fn.c_str(), "rb");
+  static_cast<void>(not f and fatal_error("Could not open file", fn));
+  unsigned version = 0u;
+  unsigned long record_size = 0ul;
+  auto success = (fread(&version, sizeof version, 1u, f) == 1);
+  success = success && (fread(&record_size, sizeof record_size, 1u, f) == 1);
+  fclose(f);
+  static_cast<void>(success or fatal_error("Could not read file", fn));
+  if (version != checkpoint_version or record_size != sizeof(ParticleRecord)) {
+    fatal_error("Checkpoint was written with a different version or "
+                "feature set",
+                fn);
+  }
+}
+
+void mpi_mpiio_checkpoint_write(const std::string &prefix,
+                                const ParticleRange &particles) {
+  auto const nlocalpart = static_cast<unsigned long>(particles.size());
+  auto const offset = mpi_calculate_file_offset(nlocalpart);
+
+  std::vector<ParticleRecord> records;
+  std::vector<int> bonds;
+  std::vector<int> exclusions;
+  records.reserve(nlocalpart);
+  for (auto const &p : particles) {
+    ParticleRecord record{};
+    record.p = p.p;
+    record.r = p.r;
+    record.m = p.m;
+    record.f = p.f;
+    record.l = p.l;
+    auto const n_bond_entries = bonds.size();
+    for (auto const &bond : p.bonds()) {
+      auto const &partners = bond.partner_ids();
+      bonds.push_back(bond.bond_id());
+      bonds.push_back(static_cast<int>(partners.size()));
+      boost::copy(partners, std::back_inserter(bonds));
+    }
+    record.n_bond_entries = static_cast<int>(bonds.size() - n_bond_entries);
+#ifdef EXCLUSIONS
+    boost::copy(p.exclusions(), std::back_inserter(exclusions));
+    record.n_exclusions = static_cast<int>(p.exclusions().size());
+#endif
+    records.push_back(record);
+  }
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (rank == 0)
+    dump_checkpoint_head(prefix + ".chkh");
+
+  auto record_type = mpi_particle_record_type();
+  mpiio_dump_array<ParticleRecord>(prefix + ".part", records.data(),
+                                   nlocalpart, offset, record_type);
+  MPI_Type_free(&record_type);
+
+  auto const nlocalbonds = static_cast<unsigned long>(bonds.size());
+  mpiio_dump_array<int>(prefix + ".cbnd", bonds.data(), nlocalbonds,
+                        mpi_calculate_file_offset(nlocalbonds), MPI_INT);
+  auto const nlocalexcl = static_cast<unsigned long>(exclusions.size());
+  mpiio_dump_array<int>(prefix + ".excl", exclusions.data(), nlocalexcl,
+                        mpi_calculate_file_offset(nlocalexcl), MPI_INT);
+}
+
+void mpi_mpiio_checkpoint_read(const std::string &prefix) {
+  cell_structure.remove_all_particles();
+
+  int size, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  check_checkpoint_head(prefix + ".chkh", rank);
+
+  // Distribute the particles evenly over the ranks, independently of the
+  // number of ranks at the point of writing. The global resort at the
+  // next integration moves them to the ranks they belong to.
+  auto const nglobalpart =
+      get_num_elem(prefix + ".part", sizeof(ParticleRecord));
+  auto const pref = nglobalpart * static_cast<unsigned long>(rank) /
+                    static_cast<unsigned long>(size);
+  auto const nlocalpart = nglobalpart * static_cast<unsigned long>(rank + 1) /
+                              static_cast<unsigned long>(size) -
+                          pref;
+
+  std::vector<ParticleRecord> records(nlocalpart);
+  auto record_type = mpi_particle_record_type();
+  mpiio_read_array<ParticleRecord>(prefix + ".part", records.data(),
+                                   nlocalpart, pref, record_type);
+  MPI_Type_free(&record_type);
+
+  unsigned long nlocalbonds = 0ul;
+  unsigned long nlocalexcl = 0ul;
+  for (auto const &record : records) {
+    nlocalbonds += static_cast<unsigned long>(record.n_bond_entries);
+    nlocalexcl += static_cast<unsigned long>(record.n_exclusions);
+  }
+  std::vector<int> bonds(nlocalbonds);
+  mpiio_read_array<int>(prefix + ".cbnd", bonds.data(), nlocalbonds,
+                        mpi_calculate_file_offset(nlocalbonds), MPI_INT);
+  std::vector<int> exclusions(nlocalexcl);
+  mpiio_read_array<int>(prefix + ".excl", exclusions.data(), nlocalexcl,
+                        mpi_calculate_file_offset(nlocalexcl), MPI_INT);
+
+  std::size_t bond_index = 0u;
+#ifdef EXCLUSIONS
+  auto excl_it = exclusions.cbegin();
+#endif
+  for (auto const &record : records) {
+    Particle p;
+    p.p = record.p;
+    p.r = record.r;
+    p.m = record.m;
+    p.f = record.f;
+    p.l = record.l;
+    auto const bond_end =
+        bond_index + static_cast<std::size_t>(record.n_bond_entries);
+    while (bond_index < bond_end) {
+      auto const bond_id = bonds[bond_index];
+      auto const n_partners = static_cast<std::size_t>(bonds[bond_index + 1]);
+      auto const partners =
+          Utils::Span<const int>(bonds.data() + bond_index + 2, n_partners);
+      p.bonds().insert(BondView(bond_id, partners));
+      bond_index += 2u + n_partners;
+    }
+#ifdef EXCLUSIONS
+    p.exclusions().resize(static_cast<std::size_t>(record.n_exclusions));
+    std::copy_n(excl_it, record.n_exclusions, p.exclusions().begin());
+    excl_it += record.n_exclusions;
+#endif
+    cell_structure.add_particle(std::move(p));
+  }
+
+  cell_structure.set_resort_particles(Cells::RESORT_GLOBAL);
+  on_particle_change();
+  clear_particle_node();
+}
 } // namespace Mpiio
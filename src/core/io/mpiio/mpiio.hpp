@@ -57,6 +57,31 @@ enum MPIIOOutputFields : unsigned int {
 void mpi_mpiio_common_write(const std::string &prefix, unsigned fields,
                             const ParticleRange &particles);
 
+/**
+ * @brief Asynchronous parallel binary output using MPI-IO.
+ * Writes the same files as @ref mpi_mpiio_common_write, but returns as
+ * soon as the particle data has been copied to a staging area, while the
+ * data is written with non-blocking collective MPI-IO. There are two
+ * staging areas: when both hold a frame that is still being written,
+ * the call first waits for the oldest frame to complete. The files are
+ * only complete after @ref mpi_mpiio_async_flush. To be called by all
+ * MPI processes. Aborts ESPResSo if an error occurs, see
+ * @ref mpi_mpiio_common_write.
+ *
+ * @param prefix Filepath prefix.
+ * @param fields Specifier for which fields to dump.
+ * @param particles Range of particles to serialize.
+ */
+void mpi_mpiio_async_write(const std::string &prefix, unsigned fields,
+                           const ParticleRange &particles);
+
+/**
+ * @brief Complete all asynchronous writes and close their files.
+ * Called automatically when MPI is finalized. To be called by all MPI
+ * processes.
+ */
+void mpi_mpiio_async_flush();
+
 /**
  * @brief Parallel binary input using MPI-IO.
  * To be called by all MPI processes. Aborts ESPResSo if an error occurs.
@@ -68,6 +93,30 @@ void mpi_mpiio_common_write(const std::string &prefix, unsigned fields,
  */
 void mpi_mpiio_common_read(const std::string &prefix, unsigned fields);
 
+/**
+ * @brief Parallel binary checkpoint of the particles using MPI-IO.
+ * Writes the complete state of the particles, including their bonds and
+ * exclusions. To be called by all MPI processes. Aborts ESPResSo if an
+ * error occurs, see @ref mpi_mpiio_common_write.
+ *
+ * @param prefix Filepath prefix.
+ * @param particles Range of particles to serialize.
+ */
+void mpi_mpiio_checkpoint_write(const std::string &prefix,
+                                const ParticleRange &particles);
+
+/**
+ * @brief Parallel binary restart of the particles using MPI-IO.
+ * Replaces all particles by the ones from a checkpoint written by
+ * @ref mpi_mpiio_checkpoint_write. The number of MPI processes may
+ * differ from the one at the point of writing. To be called by all MPI
+ * processes. Aborts ESPResSo if an error occurs, see
+ * @ref mpi_mpiio_common_read.
+ *
+ * @param prefix Filepath prefix.
+ */
+void mpi_mpiio_checkpoint_read(const std::string &prefix);
+
 } // namespace Mpiio
 
 #endif
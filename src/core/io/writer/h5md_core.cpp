@@ -31,6 +31,7 @@
 
 #include <boost/mpi/collectives.hpp>
 
+#include <hdf5.h>
 #include <mpi.h>
 
 #include <algorithm>
@@ -40,12 +41,13 @@
 #include <iterator>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace Writer {
 namespace H5md {
 
-using MultiArray3i = boost::multi_array<int, 3>;
 using Vector1hs = Utils::Vector<hsize_t, 1>;
 using Vector2hs = Utils::Vector<hsize_t, 2>;
 using Vector3hs = Utils::Vector<hsize_t, 3>;
@@ -85,6 +87,74 @@ static void write_dataset(value_type const &data, h5xx::dataset &dataset,
   h5xx::write_dataset(dataset, data, h5xx::slice(offset, count));
 }
 
+static hid_t native_type(int const *) { return H5T_NATIVE_INT; }
+static hid_t native_type(double const *) { return H5T_NATIVE_DOUBLE; }
+
+/**
+ * @brief Write a contiguous buffer to a hyperslab of a dataset.
+ * The write is collective: all ranks of the communicator must call this
+ * function, ranks without data take part with an empty selection.
+ * MPI-IO can then aggregate the hyperslabs of all ranks into a few
+ * large contiguous file accesses.
+ */
+template <typename T, typename extent_type>
+static void write_hyperslab(h5xx::dataset &dataset,
+                            std::vector<T> const &buffer,
+                            extent_type const &offset,
+                            extent_type const &count) {
+  auto const file_space = H5Dget_space(dataset.hid());
+  if (file_space < 0) {
+    throw std::runtime_error("H5MD Error: cannot get the dataset dataspace");
+  }
+  auto const mem_size =
+      static_cast<hsize_t>(std::max(buffer.size(), std::size_t{1}));
+  auto const mem_space = H5Screate_simple(1, &mem_size, nullptr);
+  if (mem_space < 0) {
+    H5Sclose(file_space);
+    throw std::runtime_error("H5MD Error: cannot create the memory dataspace");
+  }
+  T const dummy{};
+  auto const *data = &dummy;
+  herr_t selection = 0;
+  if (not buffer.empty()) {
+    selection = H5Sselect_hyperslab(file_space, H5S_SELECT_SET, offset.data(),
+                                    nullptr, count.data(), nullptr);
+    data = buffer.data();
+  }
+  if (buffer.empty() or selection < 0) {
+    /* still take part in the collective write, the other ranks wait for it */
+    H5Sselect_none(file_space);
+    H5Sselect_none(mem_space);
+    data = &dummy;
+  }
+  auto const xfer_plist = H5Pcreate(H5P_DATASET_XFER);
+  H5Pset_dxpl_mpio(xfer_plist, H5FD_MPIO_COLLECTIVE);
+  auto const status = H5Dwrite(dataset.hid(), native_type(data), mem_space,
+                               file_space, xfer_plist, data);
+  H5Pclose(xfer_plist);
+  H5Sclose(mem_space);
+  H5Sclose(file_space);
+  if (selection < 0) {
+    throw std::runtime_error("H5MD Error: cannot select the hyperslab");
+  }
+  if (status < 0) {
+    throw std::runtime_error("H5MD Error: collective write failed");
+  }
+}
+
+/**
+ * @brief Open an H5MD file with MPI-IO collective buffering.
+ */
+static h5xx::file open_file(std::string const &file_path,
+                            boost::mpi::communicator const &comm) {
+  MPI_Info info;
+  MPI_Info_create(&info);
+  MPI_Info_set(info, "romio_cb_write", "enable");
+  auto file = h5xx::file(file_path, comm, info, h5xx::file::out);
+  MPI_Info_free(&info);
+  return file;
+}
+
 static void write_script(std::string const &target,
                          boost::filesystem::path const &script_path) {
   if (!script_path.empty()) {
@@ -162,8 +232,9 @@ static std::vector<hsize_t> create_dims(hsize_t rank, hsize_t data_dim) {
   }
 }
 
-static std::vector<hsize_t> create_chunk_dims(hsize_t rank, hsize_t data_dim) {
-  hsize_t chunk_size = (rank > 1) ? 1000 : 1;
+static std::vector<hsize_t> create_chunk_dims(hsize_t rank, hsize_t data_dim,
+                                              hsize_t n_part_chunk) {
+  hsize_t chunk_size = (rank > 1) ? n_part_chunk : 1;
   switch (rank) {
   case 3:
     return {1, chunk_size, data_dim};
@@ -179,20 +250,33 @@ static std::vector<hsize_t> create_chunk_dims(hsize_t rank, hsize_t data_dim) {
 
 void File::create_datasets() {
   namespace hps = h5xx::policy::storage;
+  namespace hpf = h5xx::policy::filter;
+#if !H5_VERSION_GE(1, 10, 2)
+  if (m_compression_level > 0 and m_comm.size() > 1) {
+    throw std::runtime_error("H5MD Error: compressed datasets can only be "
+                             "written in parallel with HDF5 1.10.2 or newer");
+  }
+#endif
   for (const auto &d : m_h5md_specification.get_datasets()) {
     if (d.is_link)
       continue;
     auto maxdims = std::vector<hsize_t>(d.rank, H5S_UNLIMITED);
     auto dataspace = h5xx::dataspace(create_dims(d.rank, d.data_dim), maxdims);
-    auto storage = hps::chunked(create_chunk_dims(d.rank, d.data_dim))
-                       .set(hps::fill_value(-10));
+    auto storage =
+        hps::chunked(create_chunk_dims(d.rank, d.data_dim,
+                                       static_cast<hsize_t>(m_chunk_size)))
+            .set(hps::fill_value(-10));
+    if (m_compression_level > 0) {
+      storage = storage.add(hpf::shuffle()).add(hpf::deflate(
+          static_cast<unsigned int>(m_compression_level)));
+    }
     datasets[d.path()] = h5xx::dataset(m_h5md_file, d.path(), d.type, dataspace,
                                        storage, H5P_DEFAULT, H5P_DEFAULT);
   }
 }
 
 void File::load_file(const std::string &file_path) {
-  m_h5md_file = h5xx::file(file_path, m_comm, MPI_INFO_NULL, h5xx::file::out);
+  m_h5md_file = open_file(file_path, m_comm);
   load_datasets();
 }
 
@@ -267,7 +351,7 @@ void File::create_file(const std::string &file_path) {
   if (m_comm.rank() == 0)
     write_script(file_path, m_absolute_script_path);
   m_comm.barrier();
-  m_h5md_file = h5xx::file(file_path, m_comm, MPI_INFO_NULL, h5xx::file::out);
+  m_h5md_file = open_file(file_path, m_comm);
   create_groups();
   create_datasets();
   write_attributes(m_h5md_file);
@@ -288,7 +372,9 @@ template <> struct slice_info<3> {
   static auto extent(hsize_t n_part_diff) {
     return Vector3hs{1, n_part_diff, 0};
   }
-  static constexpr auto count() { return Vector3hs{1, 1, 3}; }
+  static auto count(hsize_t n_part_local) {
+    return Vector3hs{1, n_part_local, 3};
+  }
   static auto offset(hsize_t n_time_steps, hsize_t prefix) {
     return Vector3hs{n_time_steps, prefix, 0};
   }
@@ -296,7 +382,9 @@ template <> struct slice_info<3> {
 
 template <> struct slice_info<2> {
   static auto extent(hsize_t n_part_diff) { return Vector2hs{1, n_part_diff}; }
-  static constexpr auto count() { return Vector2hs{1, 1}; }
+  static auto count(hsize_t n_part_local) {
+    return Vector2hs{1, n_part_local};
+  }
   static auto offset(hsize_t n_time_steps, hsize_t prefix) {
     return Vector2hs{n_time_steps, prefix};
   }
@@ -313,13 +401,18 @@ void write_td_particle_property(hsize_t prefix, hsize_t n_part_global,
       std::max(n_part_global, old_extents[1]) - old_extents[1];
   extend_dataset(dataset,
                  detail::slice_info<dim>::extent(extent_particle_number));
-  auto const count = detail::slice_info<dim>::count();
-  auto offset = detail::slice_info<dim>::offset(old_extents[0], prefix);
+  // pack the local particles into a contiguous buffer
+  using Data = std::decay_t<decltype(op(std::declval<Particle const &>()))>;
+  std::vector<typename Data::value_type> buffer;
+  buffer.reserve(particles.size() * Data{}.size());
   for (auto const &p : particles) {
-    h5xx::write_dataset(dataset, op(p), h5xx::slice(offset, count));
-    // advance in the particle dimension
-    offset[1] += 1;
+    auto const data = op(p);
+    buffer.insert(buffer.end(), data.begin(), data.end());
   }
+  auto const n_part_local = static_cast<hsize_t>(particles.size());
+  auto const count = detail::slice_info<dim>::count(n_part_local);
+  auto const offset = detail::slice_info<dim>::offset(old_extents[0], prefix);
+  write_hyperslab(dataset, buffer, offset, count);
 }
 
 static void write_box(BoxGeometry const &geometry, h5xx::dataset &dataset) {
@@ -438,23 +531,18 @@ void File::write(const ParticleRange &particles, double time, int step,
 }
 
 void File::write_connectivity(const ParticleRange &particles) {
-  MultiArray3i bond(boost::extents[0][0][0]);
-  int particle_index = 0;
+  std::vector<int> bonds;
   for (auto const &p : particles) {
-    auto nbonds_local = static_cast<decltype(bond)::index>(bond.shape()[1]);
     for (auto const b : p.bonds()) {
       auto const partner_ids = b.partner_ids();
       if (partner_ids.size() == 1) {
-        bond.resize(boost::extents[1][nbonds_local + 1][2]);
-        bond[0][nbonds_local][0] = p.id();
-        bond[0][nbonds_local][1] = partner_ids[0];
-        nbonds_local++;
+        bonds.push_back(p.id());
+        bonds.push_back(partner_ids[0]);
       }
     }
-    particle_index++;
   }
 
-  auto const n_bonds_local = static_cast<int>(bond.shape()[1]);
+  auto const n_bonds_local = static_cast<int>(bonds.size() / 2);
   int prefix_bonds = 0;
   BOOST_MPI_CHECK_RESULT(
       MPI_Exscan, (&n_bonds_local, &prefix_bonds, 1, MPI_INT, MPI_SUM, m_comm));
@@ -468,8 +556,9 @@ void File::write_connectivity(const ParticleRange &particles) {
   auto const n_bond_diff =
       std::max(static_cast<hsize_t>(n_bonds_total), extents[1]) - extents[1];
   Vector3hs change_extent_bonds = {1, static_cast<hsize_t>(n_bond_diff), 0};
-  write_dataset(bond, datasets["connectivity/atoms/value"], change_extent_bonds,
-                offset_bonds, count_bonds);
+  extend_dataset(datasets["connectivity/atoms/value"], change_extent_bonds);
+  write_hyperslab(datasets["connectivity/atoms/value"], bonds, offset_bonds,
+                  count_bonds);
 }
 
 void File::flush() { m_h5md_file.flush(); }
@@ -113,21 +113,33 @@ public:
    * @param force_unit The unit for force.
    * @param velocity_unit The unit for velocity.
    * @param charge_unit The unit for charge.
+   * @param chunk_size Number of particles per HDF5 chunk.
+   * @param compression_level Deflate compression level of the datasets,
+   *        between 0 (no compression) and 9.
    * @param comm The MPI communicator.
    */
   File(std::string file_path, std::string script_path,
        std::vector<std::string> const &output_fields, std::string mass_unit,
        std::string length_unit, std::string time_unit, std::string force_unit,
        std::string velocity_unit, std::string charge_unit,
+       int chunk_size = 1000, int compression_level = 0,
        boost::mpi::communicator comm = boost::mpi::communicator())
       : m_script_path(std::move(script_path)),
         m_mass_unit(std::move(mass_unit)),
         m_length_unit(std::move(length_unit)),
         m_time_unit(std::move(time_unit)), m_force_unit(std::move(force_unit)),
         m_velocity_unit(std::move(velocity_unit)),
-        m_charge_unit(std::move(charge_unit)), m_comm(std::move(comm)),
+        m_charge_unit(std::move(charge_unit)), m_chunk_size(chunk_size),
+        m_compression_level(compression_level), m_comm(std::move(comm)),
         m_fields(fields_list_to_bitfield(output_fields)),
         m_h5md_specification(m_fields) {
+    if (m_chunk_size < 1) {
+      throw std::domain_error("Parameter 'chunk_size' must be >= 1");
+    }
+    if (m_compression_level < 0 or m_compression_level > 9) {
+      throw std::domain_error(
+          "Parameter 'compression_level' must be in the range [0, 9]");
+    }
     init_file(file_path);
   }
   ~File() = default;
@@ -196,6 +208,18 @@ public:
    */
   auto const &charge_unit() const { return m_charge_unit; }
 
+  /**
+   * @brief Retrieve the number of particles per HDF5 chunk.
+   * @return The chunk size.
+   */
+  auto chunk_size() const { return m_chunk_size; }
+
+  /**
+   * @brief Retrieve the deflate compression level.
+   * @return The compression level, 0 if compression is disabled.
+   */
+  auto compression_level() const { return m_compression_level; }
+
   /**
    * @brief Build the list of valid output fields.
    * @return The list as a vector of strings.
@@ -269,6 +293,8 @@ private:
   std::string m_force_unit;
   std::string m_velocity_unit;
   std::string m_charge_unit;
+  int m_chunk_size;
+  int m_compression_level;
   boost::mpi::communicator m_comm;
   unsigned int m_fields;
   std::string m_backup_filename;
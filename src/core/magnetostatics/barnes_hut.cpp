@@ -0,0 +1,404 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.hpp"
+
+#ifdef DIPOLES
+
+#include "magnetostatics/barnes_hut.hpp"
+
+#include "Particle.hpp"
+#include "communication.hpp"
+#include "grid.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/math/tensor_product.hpp>
+#include <utils/matrix.hpp>
+
+#include <boost/mpi/collectives/all_gather.hpp>
+#include <boost/mpi/collectives/all_gatherv.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/** Maximal depth of the octree, guards against coincident dipoles. */
+static constexpr int max_tree_depth = 64;
+
+/**
+ * Calculate the dipolar energy between two dipoles and optionally the force
+ * and torque acting on the first one, without the prefactor.
+ * @param[in]     dr          Distance vector from the second to the first
+ *                            dipole
+ * @param[in]     dip1        First dipole moment
+ * @param[in]     dip2        Second dipole moment
+ * @param[in,out] force       Force on the first dipole
+ * @param[in,out] torque      Torque on the first dipole
+ * @param[in]     force_flag  If true, update the force and torque
+ */
+static double pair_kernel(Utils::Vector3d const &dr,
+                          Utils::Vector3d const &dip1,
+                          Utils::Vector3d const &dip2, Utils::Vector3d &force,
+                          Utils::Vector3d &torque, bool force_flag) {
+  // Inverse powers of distance
+  auto const r2_inv = 1. / dr.norm2();
+  auto const r3_inv = r2_inv * std::sqrt(r2_inv);
+  auto const r5_inv = r3_inv * r2_inv;
+
+  // Dot products
+  auto const pe1 = dip1 * dip2;
+  auto const pe2 = dip1 * dr;
+  auto const pe3 = dip2 * dr;
+  auto const pe4 = 3.0 * r5_inv;
+
+  if (force_flag) {
+    auto const ab = pe4 * (pe1 - 5.0 * pe2 * pe3 * r2_inv);
+    auto const cc = pe4 * pe3;
+    auto const dd = pe4 * pe2;
+    force += ab * dr + cc * dip1 + dd * dip2;
+    torque += vector_product(dip1, cc * dr - r3_inv * dip2);
+  }
+
+  return pe1 * r3_inv - pe4 * pe2 * pe3;
+}
+
+/**
+ * Calculate the energy of a dipole in the field of a tree node and optionally
+ * the force and torque acting on it, without the prefactor. The node is
+ * expanded to the first moment of its dipoles.
+ * @param[in]     dr          Distance vector from the node to the dipole
+ * @param[in]     dip         Dipole moment
+ * @param[in]     dip_node    Total dipole moment of the node
+ * @param[in]     moment      First moment of the dipoles of the node
+ * @param[in,out] force       Force on the dipole
+ * @param[in,out] torque      Torque on the dipole
+ * @param[in]     force_flag  If true, update the force and torque
+ */
+static double node_kernel(Utils::Vector3d const &dr,
+                          Utils::Vector3d const &dip,
+                          Utils::Vector3d const &dip_node,
+                          Utils::Matrix<double, 3, 3> const &moment,
+                          Utils::Vector3d &force, Utils::Vector3d &torque,
+                          bool force_flag) {
+  auto const r2 = dr.norm2();
+  auto const r = std::sqrt(r2);
+  auto const r3 = r2 * r;
+  auto const r5 = r3 * r2;
+  auto const r7 = r5 * r2;
+
+  /* field of the total dipole and of the first moment */
+  Utils::Vector3d const moment_dr = moment * dr;
+  Utils::Vector3d const moment_t_dr = moment.transposed() * dr;
+  auto const trace = moment.trace();
+  auto const dr_moment_dr = dr * moment_dr;
+  auto const field = 3. * (dip_node * dr) / r5 * dr - dip_node / r3 +
+                     15. * dr_moment_dr / r7 * dr -
+                     3. / r5 * (moment_dr + moment_t_dr + trace * dr);
+
+  if (force_flag) {
+    auto const r9 = r7 * r2;
+    auto const pe1 = dip * dip_node;
+    auto const pe2 = dip * dr;
+    auto const pe3 = dip_node * dr;
+    Utils::Vector3d const moment_dip = moment * dip;
+    Utils::Vector3d const moment_t_dip = moment.transposed() * dip;
+    auto const dip_moment_dr = dip * moment_dr;
+    auto const dr_moment_dip = dr * moment_dip;
+    force += (3. * pe1 / r5 - 15. * pe2 * pe3 / r7) * dr +
+             3. * pe3 / r5 * dip + 3. * pe2 / r5 * dip_node;
+    force -= 105. * pe2 * dr_moment_dr / r9 * dr -
+             15. / r7 *
+                 ((dip_moment_dr + dr_moment_dip + pe2 * trace) * dr +
+                  dr_moment_dr * dip + pe2 * (moment_dr + moment_t_dr)) +
+             3. / r5 * (moment_t_dip + moment_dip + trace * dip);
+    torque += vector_product(dip, field);
+  }
+
+  return -(dip * field);
+}
+
+/** Create a node enclosing the dipoles in the range [begin, end). */
+DipolarBarnesHut::Node
+DipolarBarnesHut::make_node(std::vector<Utils::Vector3d> const &pos,
+                            int begin, int end) {
+  auto lo = pos[begin];
+  auto hi = pos[begin];
+  for (int i = begin + 1; i < end; ++i) {
+    for (unsigned d = 0; d < 3; ++d) {
+      lo[d] = std::min(lo[d], pos[i][d]);
+      hi[d] = std::max(hi[d], pos[i][d]);
+    }
+  }
+  Node node{};
+  node.center = 0.5 * (lo + hi);
+  node.half_extent = 0.5 * (hi - lo);
+  node.begin = begin;
+  node.end = end;
+  node.first_child = -1;
+  node.n_children = 0;
+  return node;
+}
+
+void DipolarBarnesHut::build_tree(Tree &tree) const {
+  auto &nodes = tree.nodes;
+  nodes.clear();
+  auto const n_dipoles = static_cast<int>(tree.pos.size());
+  if (n_dipoles == 0) {
+    return;
+  }
+
+  std::vector<Utils::Vector3d> pos_buf, dip_buf;
+  std::vector<int> id_buf, octant;
+
+  /* Split the nodes top-down. Children are appended contiguously,
+   * hence they always have a larger index than their parent. */
+  nodes.emplace_back(make_node(tree.pos, 0, n_dipoles));
+  std::vector<std::pair<int, int>> stack{{0, 0}};
+  while (not stack.empty()) {
+    auto const k = stack.back().first;
+    auto const depth = stack.back().second;
+    stack.pop_back();
+    auto const node = nodes[k];
+    auto const size = node.end - node.begin;
+    auto const extent = *std::max_element(node.half_extent.begin(),
+                                          node.half_extent.end());
+    if (size <= leaf_size or extent == 0. or depth == max_tree_depth) {
+      continue;
+    }
+
+    /* counting sort of the dipoles by octant */
+    std::array<int, 9> offsets{};
+    octant.resize(static_cast<std::size_t>(size));
+    for (int i = 0; i < size; ++i) {
+      auto const &p = tree.pos[node.begin + i];
+      auto const o = int(p[0] > node.center[0]) +
+                     2 * int(p[1] > node.center[1]) +
+                     4 * int(p[2] > node.center[2]);
+      octant[i] = o;
+      ++offsets[o + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    auto const bounds = offsets;
+    pos_buf.resize(static_cast<std::size_t>(size));
+    dip_buf.resize(static_cast<std::size_t>(size));
+    id_buf.resize(static_cast<std::size_t>(size));
+    for (int i = 0; i < size; ++i) {
+      auto const j = offsets[octant[i]]++;
+      pos_buf[j] = tree.pos[node.begin + i];
+      dip_buf[j] = tree.dip[node.begin + i];
+      id_buf[j] = tree.id[node.begin + i];
+    }
+    std::copy(pos_buf.begin(), pos_buf.end(), tree.pos.begin() + node.begin);
+    std::copy(dip_buf.begin(), dip_buf.end(), tree.dip.begin() + node.begin);
+    std::copy(id_buf.begin(), id_buf.end(), tree.id.begin() + node.begin);
+
+    nodes[k].first_child = static_cast<int>(nodes.size());
+    for (int o = 0; o < 8; ++o) {
+      if (bounds[o + 1] != bounds[o]) {
+        nodes.emplace_back(make_node(tree.pos, node.begin + bounds[o],
+                                     node.begin + bounds[o + 1]));
+        stack.emplace_back(static_cast<int>(nodes.size()) - 1, depth + 1);
+        ++nodes[k].n_children;
+      }
+    }
+  }
+
+  /* Accumulate the dipole moments bottom-up. */
+  for (auto k = static_cast<int>(nodes.size()) - 1; k >= 0; --k) {
+    auto &node = nodes[k];
+    node.dip = Utils::Vector3d{};
+    node.dipm = 0.;
+    Utils::Vector3d weighted_pos{};
+    if (node.n_children == 0) {
+      for (int i = node.begin; i < node.end; ++i) {
+        auto const dipm = tree.dip[i].norm();
+        node.dip += tree.dip[i];
+        node.dipm += dipm;
+        weighted_pos += dipm * tree.pos[i];
+      }
+    } else {
+      for (int c = 0; c < node.n_children; ++c) {
+        auto const &child = nodes[node.first_child + c];
+        node.dip += child.dip;
+        node.dipm += child.dipm;
+        weighted_pos += child.dipm * child.dip_center;
+      }
+    }
+    node.dip_center = weighted_pos / node.dipm;
+    node.dip_moment = Utils::Matrix<double, 3, 3>{};
+    node.radius = 0.;
+    if (node.n_children == 0) {
+      for (int i = node.begin; i < node.end; ++i) {
+        auto const shift = tree.pos[i] - node.dip_center;
+        node.dip_moment += Utils::tensor_product(tree.dip[i], shift);
+        node.radius = std::max(node.radius, shift.norm());
+      }
+    } else {
+      for (int c = 0; c < node.n_children; ++c) {
+        auto const &child = nodes[node.first_child + c];
+        auto const shift = child.dip_center - node.dip_center;
+        node.dip_moment +=
+            child.dip_moment + Utils::tensor_product(child.dip, shift);
+        node.radius = std::max(node.radius, shift.norm() + child.radius);
+      }
+    }
+  }
+}
+
+double DipolarBarnesHut::walk_tree(Tree const &tree, int id,
+                                   Utils::Vector3d const &pos,
+                                   Utils::Vector3d const &dip,
+                                   Utils::Vector3d &force,
+                                   Utils::Vector3d &torque,
+                                   bool force_flag) const {
+  double energy = 0.;
+  std::vector<int> stack{0};
+  stack.reserve(64);
+  while (not stack.empty()) {
+    auto const &node = tree.nodes[stack.back()];
+    stack.pop_back();
+
+    /* Distance to the bounding box center. In the periodic directions,
+     * the whole node has to lie in the minimum image of the target. */
+    auto const dc = box_geo.get_mi_vector(pos, node.center);
+    auto outside = false;
+    auto same_image = true;
+    for (unsigned d = 0; d < 3; ++d) {
+      if (std::abs(dc[d]) > node.half_extent[d]) {
+        outside = true;
+      }
+      if (box_geo.periodic(d) and
+          std::abs(dc[d]) + node.half_extent[d] >= box_geo.length_half()[d]) {
+        same_image = false;
+      }
+    }
+    if (outside and same_image) {
+      auto const dr = dc + (node.center - node.dip_center);
+      if (node.radius < theta * dr.norm()) {
+        energy += node_kernel(dr, dip, node.dip, node.dip_moment, force,
+                              torque, force_flag);
+        continue;
+      }
+    }
+
+    if (node.n_children == 0) {
+      /* all dipoles of the node share the periodic image of its center */
+      auto const image_shift = dc - (pos - node.center);
+      for (int i = node.begin; i < node.end; ++i) {
+        if (tree.id[i] != id) {
+          auto const dr = same_image
+                              ? pos - tree.pos[i] + image_shift
+                              : box_geo.get_mi_vector(pos, tree.pos[i]);
+          energy +=
+              pair_kernel(dr, dip, tree.dip[i], force, torque, force_flag);
+        }
+      }
+    } else {
+      for (int c = 0; c < node.n_children; ++c) {
+        stack.push_back(node.first_child + c);
+      }
+    }
+  }
+  return energy;
+}
+
+double DipolarBarnesHut::kernel(bool force_flag, bool energy_flag,
+                                ParticleRange const &particles) const {
+
+  assert(force_flag || energy_flag);
+
+  /* collect the local dipoles */
+  std::vector<Particle *> local;
+  std::vector<double> send_buf;
+  for (auto &p : particles) {
+    if (p.dipm() != 0.) {
+      auto const pos = folded_position(p.pos(), box_geo);
+      auto const dip = p.calc_dip();
+      local.emplace_back(&p);
+      send_buf.insert(send_buf.end(), pos.begin(), pos.end());
+      send_buf.insert(send_buf.end(), dip.begin(), dip.end());
+    }
+  }
+
+  /* gather the dipoles of all ranks */
+  std::vector<int> sizes;
+  std::vector<double> recv_buf;
+  boost::mpi::all_gather(comm_cart, static_cast<int>(send_buf.size()), sizes);
+  boost::mpi::all_gatherv(comm_cart, send_buf, recv_buf, sizes);
+  auto const offset =
+      std::accumulate(sizes.begin(), sizes.begin() + this_node, 0) / 6;
+
+  Tree tree;
+  auto const n_dipoles = recv_buf.size() / 6;
+  tree.pos.resize(n_dipoles);
+  tree.dip.resize(n_dipoles);
+  tree.id.resize(n_dipoles);
+  for (std::size_t i = 0; i < n_dipoles; ++i) {
+    auto const buf = recv_buf.data() + 6 * i;
+    tree.pos[i] = {buf[0], buf[1], buf[2]};
+    tree.dip[i] = {buf[3], buf[4], buf[5]};
+    tree.id[i] = static_cast<int>(i);
+  }
+  build_tree(tree);
+
+  /* walk the tree for the local dipoles */
+  auto const n_local = static_cast<long>(local.size());
+  double energy = 0.;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+ : energy)
+#endif
+  for (long i = 0; i < n_local; ++i) {
+    auto const id = offset + static_cast<int>(i);
+    auto const buf = send_buf.data() + 6 * i;
+    auto const pos = Utils::Vector3d{buf[0], buf[1], buf[2]};
+    auto const dip = Utils::Vector3d{buf[3], buf[4], buf[5]};
+    Utils::Vector3d force{}, torque{};
+    energy += walk_tree(tree, id, pos, dip, force, torque, force_flag);
+    if (force_flag) {
+      auto &p = *local[static_cast<std::size_t>(i)];
+      p.force() += prefactor * force;
+      p.torque() += prefactor * torque;
+    }
+  }
+
+  /* each pair contributes to the energy of both dipoles */
+  return 0.5 * prefactor * energy;
+}
+
+DipolarBarnesHut::DipolarBarnesHut(double prefactor, double theta,
+                                   int leaf_size)
+    : prefactor{prefactor}, theta{theta}, leaf_size{leaf_size} {
+  if (prefactor <= 0.) {
+    throw std::domain_error("Parameter 'prefactor' must be > 0");
+  }
+  if (theta < 0.) {
+    throw std::domain_error("Parameter 'theta' must be >= 0");
+  }
+  if (leaf_size < 1) {
+    throw std::domain_error("Parameter 'leaf_size' must be >= 1");
+  }
+}
+
+#endif // DIPOLES
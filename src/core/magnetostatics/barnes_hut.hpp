@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESPRESSO_SRC_CORE_MAGNETOSTATICS_BARNES_HUT_HPP
+#define ESPRESSO_SRC_CORE_MAGNETOSTATICS_BARNES_HUT_HPP
+
+#include "config.hpp"
+
+#ifdef DIPOLES
+
+#include "ParticleRange.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/matrix.hpp>
+
+#include <vector>
+
+/**
+ * @brief Dipolar Barnes-Hut octree sum on the CPU.
+ *
+ * The dipoles of all MPI ranks are gathered into an octree, which is
+ * replicated on every rank. Each rank then walks the tree for its local
+ * particles, distributing the particles over the OpenMP threads. A tree
+ * node is replaced by its total dipole moment, located at the center of
+ * the dipole magnitudes, and by the first moment of its dipoles around
+ * that center, when the ratio of the node radius to its distance is smaller
+ * than the opening angle @ref theta. The force error decreases with the
+ * opening angle, an opening angle of zero recovers the direct summation.
+ *
+ * The minimum image convention is applied in the periodic directions:
+ * a node is only approximated if all its dipoles lie in the same periodic
+ * image with respect to the target particle.
+ */
+struct DipolarBarnesHut {
+  double prefactor;
+  /** @brief Opening angle of the multipole acceptance criterion. */
+  double theta;
+  /** @brief Maximal number of dipoles in a leaf of the octree. */
+  int leaf_size;
+  DipolarBarnesHut(double prefactor, double theta, int leaf_size);
+
+  void on_activation() const {}
+  void on_boxl_change() const {}
+  void on_node_grid_change() const {}
+  void on_periodicity_change() const {}
+  void on_cell_structure_change() const {}
+  void init() const {}
+  void sanity_checks() const {}
+
+  double kernel(bool force_flag, bool energy_flag,
+                ParticleRange const &particles) const;
+
+private:
+  /** @brief Octree node. */
+  struct Node {
+    /** @brief Center of the bounding box of the dipoles. */
+    Utils::Vector3d center;
+    /** @brief Half edge lengths of the bounding box of the dipoles. */
+    Utils::Vector3d half_extent;
+    /** @brief Total dipole moment. */
+    Utils::Vector3d dip;
+    /** @brief Center of the dipole magnitudes. */
+    Utils::Vector3d dip_center;
+    /** @brief First moment of the dipoles around @ref dip_center,
+     *  <tt>sum_j m_j (x_j - dip_center)^T</tt>.
+     */
+    Utils::Matrix<double, 3, 3> dip_moment;
+    /** @brief Sum of the dipole magnitudes. */
+    double dipm;
+    /** @brief Upper bound of the dipole distances to @ref dip_center. */
+    double radius;
+    /** @brief Range of the dipoles in the sorted dipole arrays. */
+    int begin, end;
+    /** @brief Index of the first child node, children are contiguous. */
+    int first_child;
+    int n_children;
+  };
+
+  /** @brief Dipoles of all ranks, sorted by octree node. */
+  struct Tree {
+    std::vector<Utils::Vector3d> pos;
+    std::vector<Utils::Vector3d> dip;
+    /** @brief Index of the dipole in the gathered arrays. */
+    std::vector<int> id;
+    std::vector<Node> nodes;
+  };
+
+  static Node make_node(std::vector<Utils::Vector3d> const &pos, int begin,
+                        int end);
+  void build_tree(Tree &tree) const;
+  double walk_tree(Tree const &tree, int id, Utils::Vector3d const &pos,
+                   Utils::Vector3d const &dip, Utils::Vector3d &force,
+                   Utils::Vector3d &torque, bool force_flag) const;
+};
+
+#endif // DIPOLES
+#endif
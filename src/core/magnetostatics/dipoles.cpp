@@ -131,6 +131,9 @@ struct LongRangeForce : public boost::static_visitor<void> {
   void operator()(std::shared_ptr<DipolarDirectSum> const &actor) const {
     actor->kernel(true, false, m_particles);
   }
+  void operator()(std::shared_ptr<DipolarBarnesHut> const &actor) const {
+    actor->kernel(true, false, m_particles);
+  }
   void
   operator()(std::shared_ptr<DipolarDirectSumWithReplica> const &actor) const {
     actor->kernel(true, false, m_particles);
@@ -171,6 +174,9 @@ struct LongRangeEnergy : public boost::static_visitor<double> {
   double operator()(std::shared_ptr<DipolarDirectSum> const &actor) const {
     return actor->kernel(false, true, m_particles);
   }
+  double operator()(std::shared_ptr<DipolarBarnesHut> const &actor) const {
+    return actor->kernel(false, true, m_particles);
+  }
   double
   operator()(std::shared_ptr<DipolarDirectSumWithReplica> const &actor) const {
     return actor->kernel(false, true, m_particles);
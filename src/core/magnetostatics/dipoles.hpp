@@ -26,6 +26,7 @@
 
 #include "actor/traits.hpp"
 
+#include "magnetostatics/barnes_hut.hpp"
 #include "magnetostatics/barnes_hut_gpu.hpp"
 #include "magnetostatics/dds.hpp"
 #include "magnetostatics/dds_gpu.hpp"
@@ -50,6 +51,7 @@
 
 using MagnetostaticsActor =
     boost::variant<std::shared_ptr<DipolarDirectSum>,
+                   std::shared_ptr<DipolarBarnesHut>,
 #ifdef DIPOLAR_DIRECT_SUM
                    std::shared_ptr<DipolarDirectSumGpu>,
 #endif
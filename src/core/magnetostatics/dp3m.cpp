@@ -106,7 +106,8 @@ double DipolarP3M::calc_average_self_energy_k_space() const {
   auto const size = Utils::Vector3i{dp3m.fft.plan[3].new_mesh};
 
   auto const node_phi = grid_influence_function_self_energy(
-      dp3m.params, start, start + size, dp3m.g_energy);
+      dp3m.params, start, start + size, dp3m.g_energy,
+      dp3m.fft.hermitian_dir);
 
   double phi = 0.;
   boost::mpi::reduce(comm_cart, node_phi, phi, std::plus<>(), 0);
@@ -264,9 +265,7 @@ double DipolarP3M::kernel(bool force_flag, bool energy_flag,
     dp3m.sm.gather_grid(Utils::make_span(meshes), comm_cart,
                         dp3m.local_mesh.dim);
 
-    fft_perform_forw(dp3m.rs_mesh_dip[0].data(), dp3m.fft, comm_cart);
-    fft_perform_forw(dp3m.rs_mesh_dip[1].data(), dp3m.fft, comm_cart);
-    fft_perform_forw(dp3m.rs_mesh_dip[2].data(), dp3m.fft, comm_cart);
+    fft_perform_forw(Utils::make_span(meshes), dp3m.fft, comm_cart);
     // Note: after these calls, the grids are in the order yzx and not xyz
     // anymore!!!
   }
@@ -286,7 +285,7 @@ double DipolarP3M::kernel(bool force_flag, bool energy_flag,
         for (j[1] = 0; j[1] < dp3m.fft.plan[3].new_mesh[1]; j[1]++) {
           for (j[2] = 0; j[2] < dp3m.fft.plan[3].new_mesh[2]; j[2]++) {
             node_k_space_energy_dip +=
-                dp3m.g_energy[i] *
+                dp3m.fft.hermitian_weight(i) * dp3m.g_energy[i] *
                 (Utils::sqr(
                      dp3m.rs_mesh_dip[0][ind] *
                          dp3m.d_op[0][j[2] + dp3m.fft.plan[3].start[2]] +
@@ -389,7 +388,7 @@ double DipolarP3M::kernel(bool force_flag, bool energy_flag,
         }
 
         /* Back FFT force component mesh */
-        fft_perform_back(dp3m.rs_mesh.data(), false, dp3m.fft, comm_cart);
+        fft_perform_back(dp3m.rs_mesh.data(), dp3m.fft, comm_cart);
         /* redistribute force component mesh */
         dp3m.sm.spread_grid(dp3m.rs_mesh.data(), comm_cart,
                             dp3m.local_mesh.dim);
@@ -466,18 +465,12 @@ double DipolarP3M::kernel(bool force_flag, bool energy_flag,
             }
           }
         }
-        /* Back FFT force component mesh */
-        fft_perform_back(dp3m.rs_mesh_dip[0].data(), false, dp3m.fft,
-                         comm_cart);
-        fft_perform_back(dp3m.rs_mesh_dip[1].data(), false, dp3m.fft,
-                         comm_cart);
-        fft_perform_back(dp3m.rs_mesh_dip[2].data(), false, dp3m.fft,
-                         comm_cart);
-        /* redistribute force component mesh */
+        /* Back FFT force component meshes */
         std::array<double *, 3> meshes = {{dp3m.rs_mesh_dip[0].data(),
                                            dp3m.rs_mesh_dip[1].data(),
                                            dp3m.rs_mesh_dip[2].data()}};
-
+        fft_perform_back(Utils::make_span(meshes), dp3m.fft, comm_cart);
+        /* redistribute force component mesh */
         dp3m.sm.spread_grid(Utils::make_span(meshes), comm_cart,
                             dp3m.local_mesh.dim);
         /* Assign force component from mesh to particle */
@@ -121,7 +121,10 @@ void ia_params_set_state(std::string const &state) {
   mpi_bcast_all_ia_params();
 }
 
-static double recalc_maximal_cutoff(const IA_parameters &data) {
+/** Maximal cutoff of the potentials supported by the
+ *  structure-of-arrays force kernel.
+ */
+static double recalc_maximal_cutoff_lj_wca(const IA_parameters &data) {
   auto max_cut_current = INACTIVE_CUTOFF;
 
 #ifdef LENNARD_JONES
@@ -132,6 +135,13 @@ static double recalc_maximal_cutoff(const IA_parameters &data) {
   max_cut_current = std::max(max_cut_current, data.wca.cut);
 #endif
 
+  return max_cut_current;
+}
+
+/** Maximal cutoff of all other potentials. */
+static double recalc_maximal_cutoff(const IA_parameters &data) {
+  auto max_cut_current = INACTIVE_CUTOFF;
+
 #ifdef DPD
   max_cut_current = std::max(
       max_cut_current, std::max(data.dpd_radial.cutoff, data.dpd_trans.cutoff));
@@ -207,7 +217,9 @@ double maximal_cutoff_nonbonded() {
   auto max_cut_nonbonded = INACTIVE_CUTOFF;
 
   for (auto &data : nonbonded_ia_params) {
-    data.max_cut = recalc_maximal_cutoff(data);
+    auto const max_cut_other = recalc_maximal_cutoff(data);
+    data.max_cut = std::max(recalc_maximal_cutoff_lj_wca(data), max_cut_other);
+    data.lj_wca_only = (max_cut_other == INACTIVE_CUTOFF);
     max_cut_nonbonded = std::max(max_cut_nonbonded, data.max_cut);
   }
 
@@ -202,6 +202,12 @@ struct IA_parameters {
    */
   double max_cut = INACTIVE_CUTOFF;
 
+  /** Whether Lennard-Jones and WCA are the only active short-ranged
+   *  potentials for this pair of particle types, such that the pair can
+   *  be handled by the structure-of-arrays force kernel.
+   */
+  bool lj_wca_only = true;
+
 #ifdef LENNARD_JONES
   LJ_Parameters lj;
 #endif
@@ -117,6 +117,12 @@ public:
     }
   }
 
+  void report_differentiation(std::string const &name) const {
+    if (m_verbose) {
+      std::printf("differentiation %s\n", name.c_str());
+    }
+  }
+
   auto get_name() const { return m_name; }
 
 private:
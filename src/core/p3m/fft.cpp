@@ -42,8 +42,9 @@
 #include <fftw3.h>
 #include <mpi.h>
 
+#include <algorithm>
 #include <cmath>
-#include <cstdio>
+#include <cstddef>
 #include <cstring>
 #include <stdexcept>
 #include <utility>
@@ -52,14 +53,6 @@
 using Utils::get_linear_index;
 using Utils::permute_ifield;
 
-/** @name MPI tags for FFT communication */
-/**@{*/
-/** Tag for communication in forw_grid_comm() */
-#define REQ_FFT_FORW 301
-/** Tag for communication in back_grid_comm() */
-#define REQ_FFT_BACK 302
-/**@}*/
-
 namespace {
 /** This ugly function does the bookkeeping: which nodes have to
  *  communicate to each other, when you change the node grid.
@@ -351,69 +344,104 @@ void pack_block_permute2(double const *const in, double *const out,
   }
 }
 
-/** Communicate the grid data according to the given forward FFT plan.
- *  \param plan   FFT communication plan.
- *  \param in     input mesh.
- *  \param out    output mesh.
- *  \param fft    FFT communication plan.
- *  \param comm   MPI communicator.
+/** Start the redistribution of a mesh according to the given forward
+ *  FFT plan: pack the send blocks, ordered by destination node, and post
+ *  a non-blocking all-to-all exchange.
+ *  \param plan      FFT communication plan.
+ *  \param in        input mesh.
+ *  \param send_buf  send buffer.
+ *  \param recv_buf  receive buffer.
+ *  \param comm      MPI communicator.
+ *  \return Request of the exchange.
  */
-void forw_grid_comm(fft_forw_plan plan, const double *in, double *out,
-                    fft_data_struct &fft,
-                    const boost::mpi::communicator &comm) {
-  for (int i = 0; i < plan.group.size(); i++) {
-    plan.pack_function(in, fft.send_buf.data(), &(plan.send_block[6 * i]),
-                       &(plan.send_block[6 * i + 3]), plan.old_mesh,
-                       plan.element);
-
-    if (plan.group[i] != comm.rank()) {
-      MPI_Sendrecv(fft.send_buf.data(), plan.send_size[i], MPI_DOUBLE,
-                   plan.group[i], REQ_FFT_FORW, fft.recv_buf.data(),
-                   plan.recv_size[i], MPI_DOUBLE, plan.group[i], REQ_FFT_FORW,
-                   comm, MPI_STATUS_IGNORE);
-    } else { /* Self communication... */
-      std::swap(fft.send_buf, fft.recv_buf);
-    }
-    fft_unpack_block(fft.recv_buf.data(), out, &(plan.recv_block[6 * i]),
-                     &(plan.recv_block[6 * i + 3]), plan.new_mesh,
-                     plan.element);
+MPI_Request forw_grid_comm_start(fft_forw_plan const &plan, double const *in,
+                                 double *send_buf, double *recv_buf,
+                                 const boost::mpi::communicator &comm) {
+  for (std::size_t i = 0; i < plan.group.size(); i++) {
+    plan.pack_function(in, send_buf + plan.send_displs[plan.group[i]],
+                       &(plan.send_block[6 * i]), &(plan.send_block[6 * i + 3]),
+                       plan.old_mesh, plan.element);
+  }
+  MPI_Request request;
+  MPI_Ialltoallv(send_buf, plan.send_counts.data(), plan.send_displs.data(),
+                 MPI_DOUBLE, recv_buf, plan.recv_counts.data(),
+                 plan.recv_displs.data(), MPI_DOUBLE, comm, &request);
+  return request;
+}
+
+/** Complete a redistribution started by @ref forw_grid_comm_start.
+ *  \param plan      FFT communication plan.
+ *  \param request   Request of the exchange.
+ *  \param recv_buf  receive buffer.
+ *  \param out       output mesh.
+ */
+void forw_grid_comm_finish(fft_forw_plan const &plan, MPI_Request &request,
+                           double const *recv_buf, double *out) {
+  MPI_Wait(&request, MPI_STATUS_IGNORE);
+  for (std::size_t i = 0; i < plan.group.size(); i++) {
+    fft_unpack_block(recv_buf + plan.recv_displs[plan.group[i]], out,
+                     &(plan.recv_block[6 * i]), &(plan.recv_block[6 * i + 3]),
+                     plan.new_mesh, plan.element);
   }
 }
 
-/** Communicate the grid data according to the given backward FFT plan.
- *  \param plan_f Forward FFT plan.
- *  \param plan_b Backward FFT plan.
- *  \param in     input mesh.
- *  \param out    output mesh.
- *  \param fft    FFT communication plan.
- *  \param comm   MPI communicator.
+/** Start the redistribution of a mesh according to the given backward
+ *  FFT plan.
+ *  Back means: Use the send/receive stuff from the forward plan but
+ *  replace the receive blocks by the send blocks and vice
+ *  versa. Attention then also new_mesh and old_mesh are exchanged.
+ *  \param plan_f    Forward FFT plan.
+ *  \param plan_b    Backward FFT plan.
+ *  \param in        input mesh.
+ *  \param send_buf  send buffer.
+ *  \param recv_buf  receive buffer.
+ *  \param comm      MPI communicator.
+ *  \return Request of the exchange.
  */
-void back_grid_comm(fft_forw_plan plan_f, fft_back_plan plan_b,
-                    const double *in, double *out, fft_data_struct &fft,
-                    const boost::mpi::communicator &comm) {
-  /* Back means: Use the send/receive stuff from the forward plan but
-     replace the receive blocks by the send blocks and vice
-     versa. Attention then also new_mesh and old_mesh are exchanged */
-
-  for (int i = 0; i < plan_f.group.size(); i++) {
-    plan_b.pack_function(in, fft.send_buf.data(), &(plan_f.recv_block[6 * i]),
+MPI_Request back_grid_comm_start(fft_forw_plan const &plan_f,
+                                 fft_back_plan const &plan_b, double const *in,
+                                 double *send_buf, double *recv_buf,
+                                 const boost::mpi::communicator &comm) {
+  for (std::size_t i = 0; i < plan_f.group.size(); i++) {
+    plan_b.pack_function(in, send_buf + plan_f.recv_displs[plan_f.group[i]],
+                         &(plan_f.recv_block[6 * i]),
                          &(plan_f.recv_block[6 * i + 3]), plan_f.new_mesh,
                          plan_f.element);
+  }
+  MPI_Request request;
+  MPI_Ialltoallv(send_buf, plan_f.recv_counts.data(),
+                 plan_f.recv_displs.data(), MPI_DOUBLE, recv_buf,
+                 plan_f.send_counts.data(), plan_f.send_displs.data(),
+                 MPI_DOUBLE, comm, &request);
+  return request;
+}
 
-    if (plan_f.group[i] != comm.rank()) { /* send first, receive second */
-      MPI_Sendrecv(fft.send_buf.data(), plan_f.recv_size[i], MPI_DOUBLE,
-                   plan_f.group[i], REQ_FFT_BACK, fft.recv_buf.data(),
-                   plan_f.send_size[i], MPI_DOUBLE, plan_f.group[i],
-                   REQ_FFT_BACK, comm, MPI_STATUS_IGNORE);
-    } else { /* Self communication... */
-      std::swap(fft.send_buf, fft.recv_buf);
-    }
-    fft_unpack_block(fft.recv_buf.data(), out, &(plan_f.send_block[6 * i]),
+/** Complete a redistribution started by @ref back_grid_comm_start.
+ *  \param plan_f    Forward FFT plan.
+ *  \param request   Request of the exchange.
+ *  \param recv_buf  receive buffer.
+ *  \param out       output mesh.
+ */
+void back_grid_comm_finish(fft_forw_plan const &plan_f, MPI_Request &request,
+                           double const *recv_buf, double *out) {
+  MPI_Wait(&request, MPI_STATUS_IGNORE);
+  for (std::size_t i = 0; i < plan_f.group.size(); i++) {
+    fft_unpack_block(recv_buf + plan_f.send_displs[plan_f.group[i]], out,
+                     &(plan_f.send_block[6 * i]),
                      &(plan_f.send_block[6 * i + 3]), plan_f.old_mesh,
                      plan_f.element);
   }
 }
 
+/** Make room for the communication buffers of @p n_meshes meshes. */
+void resize_comm_buffers(fft_data_struct &fft, std::size_t n_meshes) {
+  auto const size = n_meshes * static_cast<std::size_t>(fft.max_comm_size);
+  if (fft.send_buf.size() < size) {
+    fft.send_buf.resize(size);
+    fft.recv_buf.resize(size);
+  }
+}
+
 /** Calculate 'best' mapping between a 2D and 3D grid.
  *  Required for the communication from 3D regular domain
  *  decomposition to 2D regular row decomposition.
@@ -529,6 +557,13 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
   fft.plan[2].row_dir = (fft.plan[1].row_dir - 1) % 3;
   fft.plan[3].row_dir = (fft.plan[1].row_dir - 2) % 3;
 
+  /* The spectrum of the real mesh is Hermitian: after the first
+     (real-to-complex) FFT along the first row direction, only the
+     non-negative frequencies along that direction are kept. */
+  auto global_mesh_hermitian = global_mesh_dim;
+  global_mesh_hermitian[fft.plan[1].row_dir] =
+      global_mesh_dim[fft.plan[1].row_dir] / 2 + 1;
+
   /* === communication groups === */
   /* copy local mesh off real space charge assignment grid */
   for (int i = 0; i < 3; i++)
@@ -562,9 +597,13 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
     fft.plan[i].recv_block.resize(6 * fft.plan[i].group.size());
     fft.plan[i].recv_size.resize(fft.plan[i].group.size());
 
-    fft.plan[i].new_size = calc_local_mesh(
-        my_pos[i], n_grid[i], global_mesh_dim.data(), global_mesh_off.data(),
-        fft.plan[i].new_mesh, fft.plan[i].start);
+    /* the first plan redistributes the real mesh, the others the
+       half spectrum */
+    auto const &mesh = (i == 1) ? global_mesh_dim : global_mesh_hermitian;
+    fft.plan[i].new_size =
+        calc_local_mesh(my_pos[i], n_grid[i], mesh.data(),
+                        global_mesh_off.data(), fft.plan[i].new_mesh,
+                        fft.plan[i].start);
     permute_ifield(fft.plan[i].new_mesh, 3, -(fft.plan[i].n_permute));
     permute_ifield(fft.plan[i].start, 3, -(fft.plan[i].n_permute));
     fft.plan[i].n_ffts = fft.plan[i].new_mesh[0] * fft.plan[i].new_mesh[1];
@@ -575,14 +614,12 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
       int node = fft.plan[i].group[j];
       fft.plan[i].send_size[j] = calc_send_block(
           my_pos[i - 1], n_grid[i - 1], &(n_pos[i][3 * node]), n_grid[i],
-          global_mesh_dim.data(), global_mesh_off.data(),
+          mesh.data(), global_mesh_off.data(),
           &(fft.plan[i].send_block[6 * j]));
       permute_ifield(&(fft.plan[i].send_block[6 * j]), 3,
                      -(fft.plan[i - 1].n_permute));
       permute_ifield(&(fft.plan[i].send_block[6 * j + 3]), 3,
                      -(fft.plan[i - 1].n_permute));
-      if (fft.plan[i].send_size[j] > fft.max_comm_size)
-        fft.max_comm_size = fft.plan[i].send_size[j];
       /* First plan send blocks have to be adjusted, since the CA grid
          may have an additional margin outside the actual domain of the
          node */
@@ -593,18 +630,19 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
       /* recv block: comm.rank() from comm-group-node i (identity: node) */
       fft.plan[i].recv_size[j] = calc_send_block(
           my_pos[i], n_grid[i], &(n_pos[i - 1][3 * node]), n_grid[i - 1],
-          global_mesh_dim.data(), global_mesh_off.data(),
+          mesh.data(), global_mesh_off.data(),
           &(fft.plan[i].recv_block[6 * j]));
       permute_ifield(&(fft.plan[i].recv_block[6 * j]), 3,
                      -(fft.plan[i].n_permute));
       permute_ifield(&(fft.plan[i].recv_block[6 * j + 3]), 3,
                      -(fft.plan[i].n_permute));
-      if (fft.plan[i].recv_size[j] > fft.max_comm_size)
-        fft.max_comm_size = fft.plan[i].recv_size[j];
     }
 
     for (int j = 0; j < 3; j++)
       fft.plan[i].old_mesh[j] = fft.plan[i - 1].new_mesh[j];
+    /* the first FFT only outputs the non-negative frequencies */
+    if (i == 2)
+      fft.plan[i].old_mesh[2] = fft.plan[i - 1].new_mesh[2] / 2 + 1;
     if (i == 1) {
       fft.plan[i].element = 1;
     } else {
@@ -614,15 +652,46 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
         fft.plan[i].recv_size[j] *= 2;
       }
     }
-  }
 
-  /* Factor 2 for complex fields */
-  fft.max_comm_size *= 2;
+    /* === all-to-all layout of the communication buffers === */
+    auto &plan = fft.plan[i];
+    plan.send_counts.assign(comm.size(), 0);
+    plan.recv_counts.assign(comm.size(), 0);
+    plan.send_displs.assign(comm.size(), 0);
+    plan.recv_displs.assign(comm.size(), 0);
+    for (int j = 0; j < plan.group.size(); j++) {
+      plan.send_counts[plan.group[j]] = plan.send_size[j];
+      plan.recv_counts[plan.group[j]] = plan.recv_size[j];
+    }
+    for (int node = 1; node < comm.size(); node++) {
+      plan.send_displs[node] =
+          plan.send_displs[node - 1] + plan.send_counts[node - 1];
+      plan.recv_displs[node] =
+          plan.recv_displs[node - 1] + plan.recv_counts[node - 1];
+    }
+    auto const send_total =
+        plan.send_displs.back() + plan.send_counts.back();
+    auto const recv_total =
+        plan.recv_displs.back() + plan.recv_counts.back();
+    fft.max_comm_size = std::max({fft.max_comm_size, send_total, recv_total});
+  }
   fft.max_mesh_size = Utils::product(ca_mesh_dim);
-  for (int i = 1; i < 4; i++)
+  if (fft.plan[1].new_size > fft.max_mesh_size)
+    fft.max_mesh_size = fft.plan[1].new_size;
+  if (2 * fft.plan[1].n_ffts * fft.plan[2].old_mesh[2] > fft.max_mesh_size)
+    fft.max_mesh_size = 2 * fft.plan[1].n_ffts * fft.plan[2].old_mesh[2];
+  for (int i = 2; i < 4; i++)
     if (2 * fft.plan[i].new_size > fft.max_mesh_size)
       fft.max_mesh_size = 2 * fft.plan[i].new_size;
 
+  /* k-space direction of the half spectrum */
+  int k_dirs[3] = {0, 1, 2};
+  permute_ifield(k_dirs, 3, -(fft.plan[3].n_permute));
+  for (int i = 0; i < 3; i++)
+    if (k_dirs[i] == fft.plan[1].row_dir)
+      fft.hermitian_dir = i;
+  fft.hermitian_mesh = global_mesh_dim[fft.plan[1].row_dir];
+
   /* === pack function === */
   for (int i = 1; i < 4; i++) {
     fft.plan[i].pack_function = pack_block_permute2;
@@ -642,7 +711,19 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
   auto *c_data = (fftw_complex *)(fft.data_buf.data());
 
   /* === FFT Routines (Using FFTW / RFFTW package)=== */
-  for (int i = 1; i < 4; i++) {
+  /* the first FFT is out-of-place, plan it with a scratch output array */
+  fft_vector<double> r2c_buf(fft.max_mesh_size);
+  auto *c_r2c_buf = (fftw_complex *)(r2c_buf.data());
+  auto const r2c_n = fft.plan[1].new_mesh[2];
+  auto const r2c_nc = fft.plan[2].old_mesh[2];
+  fft.plan[1].dir = FFTW_FORWARD;
+  if (fft.init_tag)
+    fftw_destroy_plan(fft.plan[1].our_fftw_plan);
+  fft.plan[1].our_fftw_plan = fftw_plan_many_dft_r2c(
+      1, &fft.plan[1].new_mesh[2], fft.plan[1].n_ffts, fft.data_buf.data(),
+      nullptr, 1, r2c_n, c_r2c_buf, nullptr, 1, r2c_nc, FFTW_PATIENT);
+
+  for (int i = 2; i < 4; i++) {
     fft.plan[i].dir = FFTW_FORWARD;
     /* FFT plan creation.*/
 
@@ -656,7 +737,15 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
 
   /* === The BACK Direction === */
   /* this is needed because slightly different functions are used */
-  for (int i = 1; i < 4; i++) {
+  fft.back[1].dir = FFTW_BACKWARD;
+  if (fft.init_tag)
+    fftw_destroy_plan(fft.back[1].our_fftw_plan);
+  fft.back[1].our_fftw_plan = fftw_plan_many_dft_c2r(
+      1, &fft.plan[1].new_mesh[2], fft.plan[1].n_ffts, c_r2c_buf, nullptr, 1,
+      r2c_nc, fft.data_buf.data(), nullptr, 1, r2c_n, FFTW_PATIENT);
+  fft.back[1].pack_function = pack_block_permute1;
+
+  for (int i = 2; i < 4; i++) {
     fft.back[i].dir = FFTW_BACKWARD;
 
     if (fft.init_tag)
@@ -679,79 +768,105 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
   return fft.max_mesh_size;
 }
 
-void fft_perform_forw(double *data, fft_data_struct &fft,
+void fft_perform_forw(Utils::Span<double *> data, fft_data_struct &fft,
                       const boost::mpi::communicator &comm) {
-  /* ===== first direction  ===== */
-
-  auto *c_data = (fftw_complex *)data;
-  auto *c_data_buf = (fftw_complex *)fft.data_buf.data();
+  auto const n_meshes = data.size();
+  resize_comm_buffers(fft, n_meshes);
+  std::vector<MPI_Request> requests(n_meshes);
+  auto send_buf = [&fft](std::size_t m) {
+    return fft.send_buf.data() + m * fft.max_comm_size;
+  };
+  auto recv_buf = [&fft](std::size_t m) {
+    return fft.recv_buf.data() + m * fft.max_comm_size;
+  };
 
+  /* ===== first direction  ===== */
   /* communication to current dir row format (in is data) */
-  forw_grid_comm(fft.plan[1], data, fft.data_buf.data(), fft, comm);
+  for (std::size_t m = 0; m < n_meshes; m++) {
+    requests[m] = forw_grid_comm_start(fft.plan[1], data[m], send_buf(m),
+                                       recv_buf(m), comm);
+  }
+  for (std::size_t m = 0; m < n_meshes; m++) {
+    forw_grid_comm_finish(fft.plan[1], requests[m], recv_buf(m),
+                          fft.data_buf.data());
+    /* perform real-to-complex FFT (in is fft.data_buf, out is data) */
+    fftw_execute_dft_r2c(fft.plan[1].our_fftw_plan, fft.data_buf.data(),
+                         reinterpret_cast<fftw_complex *>(data[m]));
+  }
 
-  /* complexify the real data array (in is fft.data_buf) */
-  for (int i = 0; i < fft.plan[1].new_size; i++) {
-    data[2 * i + 0] = fft.data_buf[i]; /* real value */
-    data[2 * i + 1] = 0;               /* complex value */
+  /* ===== second and third direction ===== */
+  for (int i = 2; i < 4; i++) {
+    /* communication to current dir row format (in/out is data) */
+    for (std::size_t m = 0; m < n_meshes; m++) {
+      requests[m] = forw_grid_comm_start(fft.plan[i], data[m], send_buf(m),
+                                         recv_buf(m), comm);
+    }
+    for (std::size_t m = 0; m < n_meshes; m++) {
+      forw_grid_comm_finish(fft.plan[i], requests[m], recv_buf(m), data[m]);
+      /* perform FFT (in/out is data) */
+      auto *c_data = reinterpret_cast<fftw_complex *>(data[m]);
+      fftw_execute_dft(fft.plan[i].our_fftw_plan, c_data, c_data);
+    }
   }
-  /* perform FFT (in/out is data)*/
-  fftw_execute_dft(fft.plan[1].our_fftw_plan, c_data, c_data);
-  /* ===== second direction ===== */
-  /* communication to current dir row format (in is data) */
-  forw_grid_comm(fft.plan[2], data, fft.data_buf.data(), fft, comm);
-  /* perform FFT (in/out is fft.data_buf) */
-  fftw_execute_dft(fft.plan[2].our_fftw_plan, c_data_buf, c_data_buf);
-  /* ===== third direction  ===== */
-  /* communication to current dir row format (in is fft.data_buf) */
-  forw_grid_comm(fft.plan[3], fft.data_buf.data(), data, fft, comm);
-  /* perform FFT (in/out is data)*/
-  fftw_execute_dft(fft.plan[3].our_fftw_plan, c_data, c_data);
 
   /* REMARK: Result has to be in data. */
 }
 
-void fft_perform_back(double *data, bool check_complex, fft_data_struct &fft,
+void fft_perform_forw(double *data, fft_data_struct &fft,
                       const boost::mpi::communicator &comm) {
+  fft_perform_forw(Utils::make_span(&data, 1), fft, comm);
+}
 
-  auto *c_data = (fftw_complex *)data;
-  auto *c_data_buf = (fftw_complex *)fft.data_buf.data();
-
-  /* ===== third direction  ===== */
-
-  /* perform FFT (in is data) */
-  fftw_execute_dft(fft.back[3].our_fftw_plan, c_data, c_data);
-  /* communicate (in is data)*/
-  back_grid_comm(fft.plan[3], fft.back[3], data, fft.data_buf.data(), fft,
-                 comm);
-
-  /* ===== second direction ===== */
-  /* perform FFT (in is fft.data_buf) */
-  fftw_execute_dft(fft.back[2].our_fftw_plan, c_data_buf, c_data_buf);
-  /* communicate (in is fft.data_buf) */
-  back_grid_comm(fft.plan[2], fft.back[2], fft.data_buf.data(), data, fft,
-                 comm);
+void fft_perform_back(Utils::Span<double *> data, fft_data_struct &fft,
+                      const boost::mpi::communicator &comm) {
+  auto const n_meshes = data.size();
+  resize_comm_buffers(fft, n_meshes);
+  std::vector<MPI_Request> requests(n_meshes);
+  auto send_buf = [&fft](std::size_t m) {
+    return fft.send_buf.data() + m * fft.max_comm_size;
+  };
+  auto recv_buf = [&fft](std::size_t m) {
+    return fft.recv_buf.data() + m * fft.max_comm_size;
+  };
+
+  /* ===== third and second direction  ===== */
+  for (int i = 3; i > 1; i--) {
+    for (std::size_t m = 0; m < n_meshes; m++) {
+      /* perform FFT (in/out is data) */
+      auto *c_data = reinterpret_cast<fftw_complex *>(data[m]);
+      fftw_execute_dft(fft.back[i].our_fftw_plan, c_data, c_data);
+      /* communicate (in/out is data) */
+      requests[m] = back_grid_comm_start(fft.plan[i], fft.back[i], data[m],
+                                         send_buf(m), recv_buf(m), comm);
+    }
+    for (std::size_t m = 0; m < n_meshes; m++) {
+      back_grid_comm_finish(fft.plan[i], requests[m], recv_buf(m), data[m]);
+    }
+  }
 
   /* ===== first direction  ===== */
-  /* perform FFT (in is data) */
-  fftw_execute_dft(fft.back[1].our_fftw_plan, c_data, c_data);
-  /* throw away the (hopefully) empty complex component (in is data) */
-  for (int i = 0; i < fft.plan[1].new_size; i++) {
-    fft.data_buf[i] = data[2 * i]; /* real value */
-    // Vincent:
-    if (check_complex && (data[2 * i + 1] > 1e-5)) {
-      printf("Complex value is not zero (i=%d,data=%g)!!!\n", i,
-             data[2 * i + 1]);
-      if (i > 100)
-        throw std::runtime_error("Complex value is not zero");
-    }
+  for (std::size_t m = 0; m < n_meshes; m++) {
+    /* perform complex-to-real FFT (in is data, out is fft.data_buf) */
+    fftw_execute_dft_c2r(fft.back[1].our_fftw_plan,
+                         reinterpret_cast<fftw_complex *>(data[m]),
+                         fft.data_buf.data());
+    /* communicate (in is fft.data_buf, out is data) */
+    requests[m] = back_grid_comm_start(fft.plan[1], fft.back[1],
+                                       fft.data_buf.data(), send_buf(m),
+                                       recv_buf(m), comm);
+  }
+  for (std::size_t m = 0; m < n_meshes; m++) {
+    back_grid_comm_finish(fft.plan[1], requests[m], recv_buf(m), data[m]);
   }
-  /* communicate (in is fft.data_buf) */
-  back_grid_comm(fft.plan[1], fft.back[1], fft.data_buf.data(), data, fft,
-                 comm);
 
   /* REMARK: Result has to be in data. */
 }
 
+void fft_perform_back(double *data, fft_data_struct &fft,
+                      const boost::mpi::communicator &comm) {
+  fft_perform_back(Utils::make_span(&data, 1), fft, comm);
+}
+
 void fft_pack_block(double const *const in, double *const out,
                     int const start[3], int const size[3], int const dim[3],
                     int element) {
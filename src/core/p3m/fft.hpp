@@ -31,9 +31,17 @@
  *  1D-FFT. After performing the FFT on that direction the data is
  *  redistributed.
  *
- *  For simplicity at the moment I have implemented a full complex to
- *  complex FFT (even though a real to complex FFT would be
- *  sufficient)
+ *  The redistributions are all-to-all exchanges of contiguous, pre-packed
+ *  blocks. Several meshes can be transformed together: their exchanges
+ *  are non-blocking, such that the 1D-FFTs of one mesh overlap with the
+ *  communication of the others.
+ *
+ *  The first 1D-FFT is a real-to-complex transform: since the mesh is
+ *  real, its spectrum is Hermitian and only the non-negative frequencies
+ *  along the first FFT direction are stored. The two remaining 1D-FFTs
+ *  and the redistributions only operate on that half of the spectrum.
+ *  The backward transform ends with the corresponding complex-to-real
+ *  transform.
  *
  *  \todo Combine the forward and backward structures.
  *  \todo The packing routines could be moved to utils.hpp when they are needed
@@ -46,6 +54,7 @@
 
 #if defined(P3M) || defined(DP3M)
 
+#include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
 #include <boost/mpi/communicator.hpp>
@@ -126,6 +135,14 @@ struct fft_forw_plan {
   std::vector<int> recv_block;
   /** Recv block communication sizes. */
   std::vector<int> recv_size;
+  /** Number of doubles sent to each node of the communicator. */
+  std::vector<int> send_counts;
+  /** Offsets of the send blocks in the send buffer, by node. */
+  std::vector<int> send_displs;
+  /** Number of doubles received from each node of the communicator. */
+  std::vector<int> recv_counts;
+  /** Offsets of the recv blocks in the recv buffer, by node. */
+  std::vector<int> recv_displs;
   /** size of send block elements. */
   int element;
 };
@@ -155,10 +172,16 @@ struct fft_data_struct { // NOLINT(bugprone-reserved-identifier)
   /** Information for backward FFTs. */
   fft_back_plan back[4];
 
+  /** Direction of the k-space mesh (in the order of @c plan[3]) along
+   *  which only the non-negative frequencies are stored. */
+  int hermitian_dir = 0;
+  /** Global mesh size along @ref hermitian_dir. */
+  int hermitian_mesh = 0;
+
   /** Whether FFT is initialized or not. */
   bool init_tag = false;
 
-  /** Maximal size of the communication buffers. */
+  /** Maximal size of the communication buffers for one mesh. */
   int max_comm_size = 0;
 
   /** Maximal local mesh size. */
@@ -170,6 +193,27 @@ struct fft_data_struct { // NOLINT(bugprone-reserved-identifier)
   std::vector<double> recv_buf;
   /** Buffer for receive data. */
   fft_vector<double> data_buf;
+
+  /**
+   * @brief Number of points of the full spectrum represented by a point
+   * of the local k-space mesh.
+   *
+   * Sums over the full spectrum, e.g. of the energy, are obtained by
+   * weighting the stored half spectrum: all points count twice, except
+   * the zero and Nyquist frequencies along @ref hermitian_dir.
+   *
+   * @param ind  Linear index in the local k-space mesh of @c plan[3].
+   */
+  double hermitian_weight(int ind) const {
+    auto const &mesh = plan[3].new_mesh;
+    auto stride = 1;
+    for (int d = 2; d > hermitian_dir; d--) {
+      stride *= mesh[d];
+    }
+    auto const n = (ind / stride) % mesh[hermitian_dir] +
+                   plan[3].start[hermitian_dir];
+    return (n == 0 or 2 * n == hermitian_mesh) ? 1. : 2.;
+  }
 };
 
 /** Initialize everything connected to the 3D-FFT.
@@ -191,6 +235,8 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
              boost::mpi::communicator const &comm);
 
 /** Perform an in-place forward 3D FFT.
+ *  Only the half spectrum is stored, see
+ *  @ref fft_data_struct::hermitian_weight.
  *  \warning The content of \a data is overwritten.
  *  \param[in,out] data  Mesh.
  *  \param[in,out] fft   FFT plan.
@@ -199,15 +245,35 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
 void fft_perform_forw(double *data, fft_data_struct &fft,
                       const boost::mpi::communicator &comm);
 
-/** Perform an in-place backward 3D FFT.
+/** Perform in-place forward 3D FFTs of several meshes.
+ *  The redistributions of all meshes are in flight at the same time,
+ *  and the 1D FFTs of one mesh overlap with the communication of the
+ *  following ones.
+ *  \warning The content of \a data is overwritten.
+ *  \param[in,out] data  Meshes.
+ *  \param[in,out] fft   FFT plan.
+ *  \param[in]     comm  MPI communicator
+ */
+void fft_perform_forw(Utils::Span<double *> data, fft_data_struct &fft,
+                      const boost::mpi::communicator &comm);
+
+/** Perform an in-place backward 3D FFT of a half spectrum.
  *  \warning The content of \a data is overwritten.
- *  \param[in,out] data           Mesh.
- *  \param[in]     check_complex  Throw an error if the complex component is
- *                                non-zero.
- *  \param[in,out] fft            FFT plan.
- *  \param[in]     comm           MPI communicator.
+ *  \param[in,out] data  Mesh.
+ *  \param[in,out] fft   FFT plan.
+ *  \param[in]     comm  MPI communicator.
+ */
+void fft_perform_back(double *data, fft_data_struct &fft,
+                      const boost::mpi::communicator &comm);
+
+/** Perform in-place backward 3D FFTs of several half spectra, with the
+ *  same overlap of communication and computation as the forward FFT.
+ *  \warning The content of \a data is overwritten.
+ *  \param[in,out] data  Meshes.
+ *  \param[in,out] fft   FFT plan.
+ *  \param[in]     comm  MPI communicator.
  */
-void fft_perform_back(double *data, bool check_complex, fft_data_struct &fft,
+void fft_perform_back(Utils::Span<double *> data, fft_data_struct &fft,
                       const boost::mpi::communicator &comm);
 
 /** Pack a block (<tt>size[3]</tt> starting at <tt>start[3]</tt>) of an input
@@ -95,26 +95,88 @@ double G_opt(int cao, double alpha, Utils::Vector3d const &k,
 }
 
 /**
- * @brief Map influence function over a grid.
+ * @brief Optimal influence function for the analytical differentiation.
  *
- * This evaluates the optimal influence function @ref G_opt
- * over a regular grid of k vectors, and returns the values as a vector.
+ * This implements the force-optimized influence function of P3M with
+ * analytical differentiation (ad-P3M) of @cite ballenegger12a, where the
+ * forces are interpolated from the potential mesh with the gradient of
+ * the charge assignment function:
+ * @f[
+ *   G_{\textrm{opt}}(\vec{k}) =
+ *   \frac{\sum_{\vec{m}} \tilde{U}^2(\vec{k}_m) \vec{k}_m^2
+ *          \tilde{\phi}(\vec{k}_m)}
+ *         {\sum_{\vec{m}} \tilde{U}^2(\vec{k}_m)
+ *          \sum_{\vec{m}} \tilde{U}^2(\vec{k}_m) \vec{k}_m^2}
+ * @f]
  *
- * @tparam S Order of the differential operator, e.g. 0 for potential,
- *          1 for electric field...
  * @tparam m Number of aliasing terms to take into account.
  *
+ * @param cao Charge assignment order.
+ * @param alpha Ewald splitting parameter.
+ * @param k k Vector to evaluate the function for.
+ * @param h Grid spacing.
+ */
+template <std::size_t m>
+double G_opt_ad(int cao, double alpha, Utils::Vector3d const &k,
+                Utils::Vector3d const &h) {
+  using namespace detail::FFT_indexing;
+  using Utils::sinc;
+
+  auto constexpr two_pi = 2. * Utils::pi();
+  auto constexpr two_pi_i = 1. / two_pi;
+  auto constexpr limit = 30.;
+
+  if (k.norm2() == 0.0) {
+    return 0.0;
+  }
+
+  auto constexpr m_max = static_cast<int>(m);
+
+  double numerator = 0.0;
+  double denominator_U2 = 0.0;
+  double denominator_U2_k2 = 0.0;
+
+  for (int mx = -m_max; mx <= m_max; mx++) {
+    for (int my = -m_max; my <= m_max; my++) {
+      for (int mz = -m_max; mz <= m_max; mz++) {
+        auto const km =
+            k + two_pi * Utils::Vector3d{mx / h[RX], my / h[RY], mz / h[RZ]};
+        auto const U2 = std::pow(sinc(km[RX] * h[RX] * two_pi_i) *
+                                     sinc(km[RY] * h[RY] * two_pi_i) *
+                                     sinc(km[RZ] * h[RZ] * two_pi_i),
+                                 2 * cao);
+
+        auto const km2 = km.norm2();
+        auto const exponent = Utils::sqr(1. / (2. * alpha)) * km2;
+        if (exponent < limit) {
+          numerator += U2 * std::exp(-exponent) * 4. * Utils::pi();
+        }
+        denominator_U2 += U2;
+        denominator_U2_k2 += U2 * km2;
+      }
+    }
+  }
+
+  return numerator / (denominator_U2 * denominator_U2_k2);
+}
+
+namespace detail {
+/**
+ * @brief Map an influence function over a grid.
+ *
  * @param params P3M parameters
  * @param n_start Lower left corner of the grid
  * @param n_end Upper right corner of the grid.
  * @param box_l Box size
- * @return Values of G_opt at regular grid points.
+ * @param G Influence function of the k vector and the grid spacing
+ * @return Values of @p G at regular grid points.
  */
-template <std::size_t S, std::size_t m = 0>
-std::vector<double> grid_influence_function(const P3MParameters &params,
-                                            const Utils::Vector3i &n_start,
-                                            const Utils::Vector3i &n_end,
-                                            const Utils::Vector3d &box_l) {
+template <class InfluenceFunction>
+std::vector<double> map_influence_function(const P3MParameters &params,
+                                           const Utils::Vector3i &n_start,
+                                           const Utils::Vector3i &n_end,
+                                           const Utils::Vector3d &box_l,
+                                           InfluenceFunction G) {
   using namespace detail::FFT_indexing;
 
   auto const shifts = detail::calc_meshift(params.mesh);
@@ -149,7 +211,7 @@ std::vector<double> grid_influence_function(const P3MParameters &params,
                                          shifts[RY][n[KY]] / box_l[RY],
                                          shifts[RZ][n[KZ]] / box_l[RZ]};
 
-          g[ind] = G_opt<S, m>(params.cao, params.alpha, k, h);
+          g[ind] = G(k, h);
         }
       }
     }
@@ -157,5 +219,61 @@ std::vector<double> grid_influence_function(const P3MParameters &params,
 
   return g;
 }
+} // namespace detail
+
+/**
+ * @brief Map influence function over a grid.
+ *
+ * This evaluates the optimal influence function @ref G_opt
+ * over a regular grid of k vectors, and returns the values as a vector.
+ *
+ * @tparam S Order of the differential operator, e.g. 0 for potential,
+ *          1 for electric field...
+ * @tparam m Number of aliasing terms to take into account.
+ *
+ * @param params P3M parameters
+ * @param n_start Lower left corner of the grid
+ * @param n_end Upper right corner of the grid.
+ * @param box_l Box size
+ * @return Values of G_opt at regular grid points.
+ */
+template <std::size_t S, std::size_t m = 0>
+std::vector<double> grid_influence_function(const P3MParameters &params,
+                                            const Utils::Vector3i &n_start,
+                                            const Utils::Vector3i &n_end,
+                                            const Utils::Vector3d &box_l) {
+  return detail::map_influence_function(
+      params, n_start, n_end, box_l,
+      [&params](Utils::Vector3d const &k, Utils::Vector3d const &h) {
+        return G_opt<S, m>(params.cao, params.alpha, k, h);
+      });
+}
+
+/**
+ * @brief Map the influence function of the analytical differentiation
+ * over a grid.
+ *
+ * This evaluates the optimal influence function @ref G_opt_ad
+ * over a regular grid of k vectors, and returns the values as a vector.
+ *
+ * @tparam m Number of aliasing terms to take into account.
+ *
+ * @param params P3M parameters
+ * @param n_start Lower left corner of the grid
+ * @param n_end Upper right corner of the grid.
+ * @param box_l Box size
+ * @return Values of G_opt_ad at regular grid points.
+ */
+template <std::size_t m = 0>
+std::vector<double> grid_influence_function_ad(const P3MParameters &params,
+                                               const Utils::Vector3i &n_start,
+                                               const Utils::Vector3i &n_end,
+                                               const Utils::Vector3d &box_l) {
+  return detail::map_influence_function(
+      params, n_start, n_end, box_l,
+      [&params](Utils::Vector3d const &k, Utils::Vector3d const &h) {
+        return G_opt_ad<m>(params.cao, params.alpha, k, h);
+      });
+}
 
 #endif
@@ -128,24 +128,38 @@ std::vector<double> grid_influence_function(P3MParameters const &params,
   auto const shifts = detail::calc_meshift(params.mesh, false);
   auto const d_ops = detail::calc_meshift(params.mesh, true);
 
+  auto const influence_function = [&](Utils::Vector3i const &n) {
+    if (((n[0] % (params.mesh[0] / 2) == 0) &&
+         (n[1] % (params.mesh[0] / 2) == 0) &&
+         (n[2] % (params.mesh[0] / 2) == 0))) {
+      return 0.0;
+    }
+    auto const shift =
+        Utils::Vector3i{shifts[0][n[0]], shifts[0][n[1]], shifts[0][n[2]]};
+    auto const d_op =
+        Utils::Vector3i{d_ops[0][n[0]], d_ops[0][n[1]], d_ops[0][n[2]]};
+    auto const fak2 = G_opt_dipolar<S>(params, shift, d_op);
+    return fak1 * fak2;
+  };
+
   Utils::Vector3i n{};
   for (n[0] = n_start[0]; n[0] < n_end[0]; n[0]++) {
     for (n[1] = n_start[1]; n[1] < n_end[1]; n[1]++) {
       for (n[2] = n_start[2]; n[2] < n_end[2]; n[2]++) {
         auto const ind = Utils::get_linear_index(n - n_start, size,
                                                  Utils::MemoryOrder::ROW_MAJOR);
-
-        if (((n[0] % (params.mesh[0] / 2) == 0) &&
-             (n[1] % (params.mesh[0] / 2) == 0) &&
-             (n[2] % (params.mesh[0] / 2) == 0))) {
-          g[ind] = 0.0;
-        } else {
-          auto const shift = Utils::Vector3i{shifts[0][n[0]], shifts[0][n[1]],
-                                             shifts[0][n[2]]};
-          auto const d_op =
-              Utils::Vector3i{d_ops[0][n[0]], d_ops[0][n[1]], d_ops[0][n[2]]};
-          auto const fak2 = G_opt_dipolar<S>(params, shift, d_op);
-          g[ind] = fak1 * fak2;
+        g[ind] = influence_function(n);
+        if (params.mesh[0] % 2 == 1) {
+          /* On odd meshes, the excluded points and the zeroed midpoint
+           * of the differential operator are not symmetric under
+           * k -> -k. Only the Hermitian part of the spectrum survives
+           * the real-valued back transform, hence the influence function
+           * is averaged with its value at -k. */
+          auto const n_mirror =
+              Utils::Vector3i{(params.mesh[0] - n[0]) % params.mesh[0],
+                              (params.mesh[0] - n[1]) % params.mesh[0],
+                              (params.mesh[0] - n[2]) % params.mesh[0]};
+          g[ind] = 0.5 * (g[ind] + influence_function(n_mirror));
         }
       }
     }
@@ -181,16 +195,23 @@ inline double G_opt_dipolar_self_energy(P3MParameters const &params,
 /**
  * @brief Calculate self-energy of the influence function.
  *
+ * The grid only holds the non-negative frequencies along
+ * @p hermitian_dir, the other half of the spectrum is accounted for
+ * by weighting the grid points. Grid points where the influence
+ * function vanishes are skipped.
+ *
  * @param params DP3M parameters
  * @param n_start Lower left corner of the grid
  * @param n_end Upper right corner of the grid.
  * @param g Energies on the grid.
+ * @param hermitian_dir Grid direction of the half spectrum.
  * @return Total self-energy.
  */
 double grid_influence_function_self_energy(P3MParameters const &params,
                                            Utils::Vector3i const &n_start,
                                            Utils::Vector3i const &n_end,
-                                           std::vector<double> const &g) {
+                                           std::vector<double> const &g,
+                                           int hermitian_dir) {
   auto const size = n_end - n_start;
 
   auto const shifts = detail::calc_meshift(params.mesh, false);
@@ -201,20 +222,19 @@ double grid_influence_function_self_energy(P3MParameters const &params,
   for (n[0] = n_start[0]; n[0] < n_end[0]; n[0]++) {
     for (n[1] = n_start[1]; n[1] < n_end[1]; n[1]++) {
       for (n[2] = n_start[2]; n[2] < n_end[2]; n[2]++) {
-        if (((n[0] % (params.mesh[0] / 2) == 0) &&
-             (n[1] % (params.mesh[0] / 2) == 0) &&
-             (n[2] % (params.mesh[0] / 2) == 0))) {
-          energy += 0.0;
-        } else {
-          auto const ind = Utils::get_linear_index(
-              n - n_start, size, Utils::MemoryOrder::ROW_MAJOR);
-          auto const shift = Utils::Vector3i{shifts[0][n[0]], shifts[0][n[1]],
-                                             shifts[0][n[2]]};
-          auto const d_op =
-              Utils::Vector3i{d_ops[0][n[0]], d_ops[0][n[1]], d_ops[0][n[2]]};
-          auto const U2 = G_opt_dipolar_self_energy(params, shift);
-          energy += g[ind] * U2 * d_op.norm2();
+        auto const ind = Utils::get_linear_index(n - n_start, size,
+                                                 Utils::MemoryOrder::ROW_MAJOR);
+        if (g[ind] == 0.) {
+          continue;
         }
+        auto const shift = Utils::Vector3i{shifts[0][n[0]], shifts[0][n[1]],
+                                           shifts[0][n[2]]};
+        auto const d_op =
+            Utils::Vector3i{d_ops[0][n[0]], d_ops[0][n[1]], d_ops[0][n[2]]};
+        auto const U2 = G_opt_dipolar_self_energy(params, shift);
+        auto const n_h = n[hermitian_dir];
+        auto const weight = (n_h == 0 or 2 * n_h == params.mesh[0]) ? 1. : 2.;
+        energy += weight * g[ind] * U2 * d_op.norm2();
       }
     }
   }
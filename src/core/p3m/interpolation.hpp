@@ -22,12 +22,14 @@
 #define ESPRESSO_CORE_P3M_INTERPOLATION_HPP
 
 #include <utils/Span.hpp>
+#include <utils/Vector.hpp>
 #include <utils/index.hpp>
 #include <utils/math/bspline.hpp>
 
 #include <boost/range/algorithm/copy.hpp>
 
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <tuple>
 #include <vector>
@@ -46,6 +48,25 @@ template <int cao> struct InterpolationWeights {
   Utils::Array<double, cao> w_x, w_y, w_z;
 };
 
+/**
+ * @brief Interpolation weights and their gradients for one point.
+ *
+ * Used by the analytical differentiation, where the force on a particle is
+ * interpolated from the potential mesh with the gradient of the charge
+ * assignment function.
+ *
+ * @tparam cao Interpolation order.
+ */
+template <int cao> struct InterpolationGradientWeights {
+  /** Linear index of the corner of the interpolation cube. */
+  int ind;
+  /** Weights for the directions */
+  Utils::Array<double, cao> w_x, w_y, w_z;
+  /** Derivatives of the weights along the directions, in units of the
+   *  inverse length. */
+  Utils::Array<double, cao> dw_x, dw_y, dw_z;
+};
+
 /**
  * @brief Cache for interpolation weights.
  *
@@ -135,11 +156,18 @@ public:
  * As described in from @cite hockney88a 5-189 (or 8-61).
  * The weights are also tabulated in @cite deserno98a @cite deserno98b.
  */
+namespace detail {
+/**
+ * @brief Find the first mesh point of the interpolation cube.
+ *
+ * @return Linear index of the first mesh point and the distance of the
+ *         point to the nearest mesh point in units of the mesh constant.
+ */
 template <int cao>
-InterpolationWeights<cao>
-p3m_calculate_interpolation_weights(const Utils::Vector3d &position,
-                                    const Utils::Vector3d &ai,
-                                    P3MLocalMesh const &local_mesh) {
+std::tuple<int, Utils::Vector3d>
+p3m_interpolation_origin(const Utils::Vector3d &position,
+                         const Utils::Vector3d &ai,
+                         P3MLocalMesh const &local_mesh) {
   /** position shift for calc. of first assignment mesh point. */
   static auto const pos_shift = std::floor((cao - 1) / 2.0) - (cao % 2) / 2.0;
 
@@ -159,13 +187,26 @@ p3m_calculate_interpolation_weights(const Utils::Vector3d &position,
     dist[d] = (pos - nmp[d]) - 0.5;
   }
 
-  InterpolationWeights<cao> ret;
+  assert((nmp + Utils::Vector3i::broadcast(cao)) <= local_mesh.dim);
 
   /* 3d-array index of nearest mesh point */
-  ret.ind = Utils::get_linear_index(nmp, local_mesh.dim,
-                                    Utils::MemoryOrder::ROW_MAJOR);
+  auto const ind = Utils::get_linear_index(nmp, local_mesh.dim,
+                                           Utils::MemoryOrder::ROW_MAJOR);
+
+  return std::make_tuple(ind, dist);
+}
+} // namespace detail
+
+template <int cao>
+InterpolationWeights<cao>
+p3m_calculate_interpolation_weights(const Utils::Vector3d &position,
+                                    const Utils::Vector3d &ai,
+                                    P3MLocalMesh const &local_mesh) {
+  InterpolationWeights<cao> ret;
+  Utils::Vector3d dist;
+  std::tie(ret.ind, dist) =
+      detail::p3m_interpolation_origin<cao>(position, ai, local_mesh);
 
-  assert((nmp + Utils::Vector3i::broadcast(cao)) <= local_mesh.dim);
   for (int i = 0; i < cao; i++) {
     using Utils::bspline;
 
@@ -177,6 +218,35 @@ p3m_calculate_interpolation_weights(const Utils::Vector3d &position,
   return ret;
 }
 
+/**
+ * @brief Calculate the P-th order interpolation weights and their
+ * derivatives with respect to the position of the point.
+ */
+template <int cao>
+InterpolationGradientWeights<cao>
+p3m_calculate_interpolation_gradient_weights(const Utils::Vector3d &position,
+                                             const Utils::Vector3d &ai,
+                                             P3MLocalMesh const &local_mesh) {
+  InterpolationGradientWeights<cao> ret;
+  Utils::Vector3d dist;
+  std::tie(ret.ind, dist) =
+      detail::p3m_interpolation_origin<cao>(position, ai, local_mesh);
+
+  for (int i = 0; i < cao; i++) {
+    using Utils::bspline;
+    using Utils::bspline_d;
+
+    ret.w_x[i] = bspline<cao>(i, dist[0]);
+    ret.w_y[i] = bspline<cao>(i, dist[1]);
+    ret.w_z[i] = bspline<cao>(i, dist[2]);
+    ret.dw_x[i] = ai[0] * bspline_d<cao>(i, dist[0]);
+    ret.dw_y[i] = ai[1] * bspline_d<cao>(i, dist[1]);
+    ret.dw_z[i] = ai[2] * bspline_d<cao>(i, dist[2]);
+  }
+
+  return ret;
+}
+
 /**
  * @brief P3M grid interpolation.
  *
@@ -207,4 +277,38 @@ void p3m_interpolate(P3MLocalMesh const &local_mesh,
   }
 }
 
+/**
+ * @brief P3M grid interpolation with the gradient of the weights.
+ *
+ * This runs a kernel for every interpolation point with the linear
+ * grid index and the gradient of the weight of the point with respect
+ * to the interpolated position as arguments.
+ *
+ * @param local_mesh Mesh info.
+ * @param weights Set of weights and their derivatives
+ * @param kernel The kernel to run.
+ */
+template <int cao, class Kernel>
+void p3m_interpolate_gradient(P3MLocalMesh const &local_mesh,
+                              InterpolationGradientWeights<cao> const &weights,
+                              Kernel kernel) {
+  auto q_ind = weights.ind;
+  for (int i0 = 0; i0 < cao; i0++) {
+    for (int i1 = 0; i1 < cao; i1++) {
+      auto const w_xy = weights.w_x[i0] * weights.w_y[i1];
+      auto const dw_xy = weights.dw_x[i0] * weights.w_y[i1];
+      auto const w_dxy = weights.w_x[i0] * weights.dw_y[i1];
+      for (int i2 = 0; i2 < cao; i2++) {
+        auto const w_z = weights.w_z[i2];
+        kernel(q_ind, Utils::Vector3d{dw_xy * w_z, w_dxy * w_z,
+                                      w_xy * weights.dw_z[i2]});
+
+        q_ind++;
+      }
+      q_ind += local_mesh.q_2_off;
+    }
+    q_ind += local_mesh.q_21_off;
+  }
+}
+
 #endif
@@ -36,16 +36,21 @@
 #include <utils/Vector.hpp>
 #include <utils/quaternion.hpp>
 
+#include <boost/mpi/collectives/scatter.hpp>
 #include <boost/range/algorithm/copy.hpp>
 #include <boost/range/algorithm/find.hpp>
+#include <boost/serialization/utility.hpp>
 #include <boost/serialization/variant.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/variant.hpp>
 
+#include <cstddef>
 #include <iterator>
+#include <set>
 #include <stdexcept>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 constexpr auto some_tag = 42;
@@ -337,10 +342,12 @@ struct UpdateVisitor : public boost::static_visitor<void> {
 
 void local_remove_bond(Particle &p, std::vector<int> const &bond) {
   RemoveBond{bond}(p);
+  cell_structure.invalidate_bond_table();
 }
 
 void local_remove_pair_bonds_to(Particle &p, int other_pid) {
   RemovePairBondsTo{other_pid}(p);
+  cell_structure.invalidate_bond_table();
 }
 
 static void mpi_send_update_message_local(int node, int id) {
@@ -390,6 +397,43 @@ static void mpi_send_update_message(int id, const UpdateMessage &msg) {
   on_particle_change();
 }
 
+/** @brief Update messages for the particles of one rank. */
+using UpdateMessages = std::vector<std::pair<int, UpdateMessage>>;
+
+static void apply_update_messages(UpdateMessages const &msgs) {
+  for (auto const &kv : msgs) {
+    boost::apply_visitor(UpdateVisitor{kv.first}, kv.second);
+  }
+}
+
+static void mpi_send_update_messages_local() {
+  UpdateMessages msgs;
+  boost::mpi::scatter(comm_cart, msgs, 0);
+  apply_update_messages(msgs);
+
+  on_particle_change();
+}
+
+REGISTER_CALLBACK(mpi_send_update_messages_local)
+
+/**
+ * @brief Send particle update messages for many particles.
+ *
+ * Same as @ref mpi_send_update_message, but the messages of all ranks
+ * are distributed in one scatter operation.
+ *
+ * @param node_msgs The messages, grouped by the rank owning the particles
+ */
+static void mpi_send_update_messages(std::vector<UpdateMessages> &node_msgs) {
+  mpi_call(mpi_send_update_messages_local);
+
+  UpdateMessages msgs;
+  boost::mpi::scatter(comm_cart, node_msgs, msgs, 0);
+  apply_update_messages(msgs);
+
+  on_particle_change();
+}
+
 template <typename S, S Particle::*s, typename T, T S::*m>
 void mpi_update_particle(int id, const T &value) {
   using MessageType = message_type_t<S, s>;
@@ -402,6 +446,29 @@ void mpi_update_particle_property(int id, const T &value) {
   mpi_update_particle<ParticleProperties, &Particle::p, T, m>(id, value);
 }
 
+template <typename S, S Particle::*s, typename T, T S::*m>
+void mpi_update_particles(std::vector<int> const &ids,
+                          std::vector<T> const &values) {
+  if (ids.size() != values.size()) {
+    throw std::invalid_argument("Got " + std::to_string(values.size()) +
+                                " values for " + std::to_string(ids.size()) +
+                                " particles");
+  }
+  using MessageType = message_type_t<S, s>;
+  std::vector<UpdateMessages> node_msgs(comm_cart.size());
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    MessageType msg = UpdateParticle<S, s, T, m>{values[i]};
+    node_msgs[get_particle_node(ids[i])].emplace_back(ids[i], msg);
+  }
+  mpi_send_update_messages(node_msgs);
+}
+
+template <typename T, T ParticleProperties::*m>
+void mpi_update_particles_property(std::vector<int> const &ids,
+                                   std::vector<T> const &values) {
+  mpi_update_particles<ParticleProperties, &Particle::p, T, m>(ids, values);
+}
+
 void set_particle_v(int part, Utils::Vector3d const &v) {
   mpi_update_particle<ParticleMomentum, &Particle::m, Utils::Vector3d,
                       &ParticleMomentum::v>(part, v);
@@ -620,6 +687,63 @@ void set_particle_fix(int part, Utils::Vector3i const &flag) {
 }
 #endif // EXTERNAL_FORCES
 
+void set_particles_v(std::vector<int> const &ids,
+                     std::vector<Utils::Vector3d> const &values) {
+  mpi_update_particles<ParticleMomentum, &Particle::m, Utils::Vector3d,
+                       &ParticleMomentum::v>(ids, values);
+}
+
+void set_particles_f(std::vector<int> const &ids,
+                     std::vector<Utils::Vector3d> const &values) {
+  mpi_update_particles<ParticleForce, &Particle::f, Utils::Vector3d,
+                       &ParticleForce::f>(ids, values);
+}
+
+void set_particles_type(std::vector<int> const &ids,
+                        std::vector<int> const &values) {
+  for (auto const type : std::set<int>(values.begin(), values.end())) {
+    make_particle_type_exist(type);
+  }
+  mpi_update_particles_property<int, &ParticleProperties::type>(ids, values);
+  on_particles_type_change(ids, values);
+}
+
+void set_particles_mol_id(std::vector<int> const &ids,
+                          std::vector<int> const &values) {
+  mpi_update_particles_property<int, &ParticleProperties::mol_id>(ids, values);
+}
+
+void set_particles_q(std::vector<int> const &ids,
+                     std::vector<double> const &values) {
+#ifdef ELECTROSTATICS
+  mpi_update_particles_property<double, &ParticleProperties::q>(ids, values);
+#endif
+}
+
+#ifdef MASS
+void set_particles_mass(std::vector<int> const &ids,
+                        std::vector<double> const &values) {
+  mpi_update_particles_property<double, &ParticleProperties::mass>(ids,
+                                                                   values);
+}
+#endif
+
+#ifdef DIPOLES
+void set_particles_dipm(std::vector<int> const &ids,
+                        std::vector<double> const &values) {
+  mpi_update_particles_property<double, &ParticleProperties::dipm>(ids,
+                                                                   values);
+}
+#endif
+
+#ifdef EXTERNAL_FORCES
+void set_particles_ext_force(std::vector<int> const &ids,
+                             std::vector<Utils::Vector3d> const &values) {
+  mpi_update_particles_property<Utils::Vector3d,
+                                &ParticleProperties::ext_force>(ids, values);
+}
+#endif
+
 void delete_particle_bond(int part, Utils::Span<const int> bond) {
   mpi_send_update_message(
       part, UpdateBondMessage{RemoveBond{{bond.begin(), bond.end()}}});
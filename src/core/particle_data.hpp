@@ -224,6 +224,38 @@ void set_particle_ext_force(int part, const Utils::Vector3d &force);
 void set_particle_fix(int part, Utils::Vector3i const &flag);
 #endif // EXTERNAL_FORCES
 
+/** @name Bulk particle updates.
+ *  Call only on the head node: set a property of many particles at once.
+ *  The values are grouped by the rank that owns the particles and sent in
+ *  a single collective operation, instead of one message per particle.
+ *  @param ids     the particles.
+ *  @param values  their new values, in the same order.
+ */
+/**@{*/
+void set_particles_v(std::vector<int> const &ids,
+                     std::vector<Utils::Vector3d> const &values);
+void set_particles_f(std::vector<int> const &ids,
+                     std::vector<Utils::Vector3d> const &values);
+void set_particles_type(std::vector<int> const &ids,
+                        std::vector<int> const &values);
+void set_particles_mol_id(std::vector<int> const &ids,
+                          std::vector<int> const &values);
+void set_particles_q(std::vector<int> const &ids,
+                     std::vector<double> const &values);
+#ifdef MASS
+void set_particles_mass(std::vector<int> const &ids,
+                        std::vector<double> const &values);
+#endif
+#ifdef DIPOLES
+void set_particles_dipm(std::vector<int> const &ids,
+                        std::vector<double> const &values);
+#endif
+#ifdef EXTERNAL_FORCES
+void set_particles_ext_force(std::vector<int> const &ids,
+                             std::vector<Utils::Vector3d> const &values);
+#endif
+/**@}*/
+
 /** Call only on the head node: remove bond from particle.
  *  @param part     identity of principal atom of the bond.
  *  @param bond     field containing the bond type number and the identity
@@ -43,6 +43,7 @@
 #include <boost/range/numeric.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <stdexcept>
 #include <string>
@@ -110,6 +111,20 @@ void on_particle_type_change(int p_id, int type) {
   }
 }
 
+void on_particles_type_change(std::vector<int> const &p_ids,
+                              std::vector<int> const &types) {
+  if (type_list_enable) {
+    for (auto &kv : particle_type_map) {
+      for (auto const p_id : p_ids) {
+        kv.second.erase(p_id);
+      }
+    }
+    for (std::size_t i = 0; i < p_ids.size(); ++i) {
+      add_id_to_type_map(p_ids[i], types[i]);
+    }
+  }
+}
+
 namespace {
 /* Limit cache to 100 MiB */
 std::size_t const max_cache_size = (100ul * 1048576ul) / sizeof(Particle);
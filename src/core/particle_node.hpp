@@ -89,6 +89,11 @@ void remove_all_particles();
 
 void init_type_map(int type);
 void on_particle_type_change(int p_id, int type);
+/** @brief Update the type tracking after the types of many particles
+ *  were changed, without fetching their previous types.
+ */
+void on_particles_type_change(std::vector<int> const &p_ids,
+                              std::vector<int> const &types);
 
 /** Find a particle of given type and return its id */
 int get_random_p_id(int type, int random_index_in_type_map);
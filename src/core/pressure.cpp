@@ -38,6 +38,7 @@
 #include "virtual_sites.hpp"
 
 #include "short_range_loop.hpp"
+#include "threads.hpp"
 
 #include "electrostatics/coulomb.hpp"
 #include "magnetostatics/dipoles.hpp"
@@ -74,6 +75,7 @@ static std::shared_ptr<Observable_stat> calculate_pressure_local() {
 
   auto const coulomb_force_kernel = Coulomb::pair_force_kernel();
   auto const coulomb_pressure_kernel = Coulomb::pair_pressure_kernel();
+  Threads::PerThread<Observable_stat> obs_pressure_threads(9);
 
   short_range_loop(
       [&obs_pressure,
@@ -94,14 +96,20 @@ static std::shared_ptr<Observable_stat> calculate_pressure_local() {
         }
         return true;
       },
-      [&obs_pressure, coulomb_force_kernel_ptr = coulomb_force_kernel.get_ptr(),
+      [&obs_pressure_threads,
+       coulomb_force_kernel_ptr = coulomb_force_kernel.get_ptr(),
        coulomb_pressure_kernel_ptr = coulomb_pressure_kernel.get_ptr()](
           Particle const &p1, Particle const &p2, Distance const &d) {
         add_non_bonded_pair_virials(p1, p2, d.vec21, sqrt(d.dist2),
-                                    obs_pressure, coulomb_force_kernel_ptr,
+                                    obs_pressure_threads.local(),
+                                    coulomb_force_kernel_ptr,
                                     coulomb_pressure_kernel_ptr);
       },
-      maximal_cutoff(n_nodes), maximal_cutoff_bonded());
+      maximal_cutoff(n_nodes), maximal_cutoff_bonded(), detail::True{},
+      PairLoopPolicy::THREADED);
+
+  obs_pressure_threads.for_each(
+      [&obs_pressure](Observable_stat const &obs) { obs_pressure += obs; });
 
 #ifdef ELECTROSTATICS
   /* calculate k-space part of electrostatic interaction. */
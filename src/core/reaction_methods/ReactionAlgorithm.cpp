@@ -55,6 +55,7 @@ int ReactionAlgorithm::do_reaction(int reaction_steps) {
   // assume that the kinetic part drops out in the process of calculating
   // ensemble averages (kinetic part may be separated and crossed out)
   auto current_E_pot = calculate_current_potential_energy_of_system();
+  reset_long_range_energy_reference();
   for (int i = 0; i < reaction_steps; i++) {
     int reaction_id = i_random(static_cast<int>(reactions.size()));
     generic_oneway_reaction(*reactions[reaction_id], current_E_pot);
@@ -289,13 +290,14 @@ void ReactionAlgorithm::generic_oneway_reaction(
   std::vector<StoredParticleProperty> hidden_particles_properties;
   std::vector<StoredParticleProperty> changed_particles_properties;
 
+  begin_trial_move();
   std::tie(changed_particles_properties, p_ids_created_particles,
            hidden_particles_properties) =
       make_reaction_attempt(current_reaction);
 
   auto const E_pot_new = (particle_inside_exclusion_range_touched)
                              ? std::numeric_limits<double>::max()
-                             : calculate_current_potential_energy_of_system();
+                             : calculate_trial_move_potential_energy(E_pot_old);
 
   auto const bf = calculate_acceptance_probability(
       current_reaction, E_pot_old, E_pot_new, old_particle_numbers);
@@ -326,6 +328,7 @@ void ReactionAlgorithm::generic_oneway_reaction(
     }
     current_reaction.accepted_moves += 1;
     E_pot_old = E_pot_new; // Update the system energy
+    accept_trial_move();
 
   } else {
     // reject
@@ -345,7 +348,8 @@ void ReactionAlgorithm::generic_oneway_reaction(
  * Replaces a particle with the given particle id to be of a certain type. This
  * especially means that the particle type and the particle charge are changed.
  */
-void ReactionAlgorithm::replace_particle(int p_id, int desired_type) const {
+void ReactionAlgorithm::replace_particle(int p_id, int desired_type) {
+  before_particle_change(p_id);
   set_particle_type(p_id, desired_type);
 #ifdef ELECTROSTATICS
   set_particle_q(p_id, charges_of_types.at(desired_type));
@@ -368,13 +372,70 @@ void ReactionAlgorithm::replace_particle(int p_id, int desired_type) const {
  * there would be a need for a rule for such "collision" reactions (a reaction
  * like the one above).
  */
-void ReactionAlgorithm::hide_particle(int p_id) const {
+void ReactionAlgorithm::hide_particle(int p_id) {
+  before_particle_change(p_id);
   set_particle_type(p_id, non_interacting_type);
 #ifdef ELECTROSTATICS
   set_particle_q(p_id, 0.0);
 #endif
 }
 
+bool ReactionAlgorithm::begin_trial_move() {
+  m_incremental_energy = particles_energy_contribution_available();
+  m_trial_p_ids.clear();
+  m_trial_charges_old.clear();
+  m_trial_charges_new.clear();
+  m_trial_E_pot_old = 0.;
+  if (m_incremental_energy and not m_long_range_reference_valid) {
+    set_long_range_energy_reference();
+    m_long_range_reference_valid = true;
+  }
+  return m_incremental_energy;
+}
+
+/**
+ * Records the energy and the charge of a particle before the trial move
+ * changes it. Interactions with particles changed earlier in the same
+ * trial move are left out, since they were recorded before either
+ * particle changed.
+ */
+void ReactionAlgorithm::before_particle_change(int p_id) {
+  if (not m_incremental_energy or Utils::contains(m_trial_p_ids, p_id)) {
+    return;
+  }
+  m_trial_E_pot_old += particles_energy_contribution({p_id}, m_trial_p_ids);
+  m_trial_p_ids.emplace_back(p_id);
+  auto const &p = get_particle_data(p_id);
+  if (p.q() != 0.) {
+    m_trial_charges_old.emplace_back(p.pos(), p.q());
+  }
+}
+
+double ReactionAlgorithm::calculate_trial_move_potential_energy(
+    double E_pot_old) {
+  if (not m_incremental_energy) {
+    return calculate_current_potential_energy_of_system();
+  }
+  auto const E_pot_trial = particles_energy_contribution(m_trial_p_ids, {});
+  m_trial_charges_new.clear();
+  for (auto const p_id : m_trial_p_ids) {
+    auto const &p = get_particle_data(p_id);
+    if (p.q() != 0.) {
+      m_trial_charges_new.emplace_back(p.pos(), p.q());
+    }
+  }
+  auto const E_long_range =
+      long_range_energy_change(m_trial_charges_old, m_trial_charges_new);
+  return E_pot_old + (E_pot_trial - m_trial_E_pot_old) + E_long_range;
+}
+
+void ReactionAlgorithm::accept_trial_move() {
+  if (m_incremental_energy) {
+    update_long_range_energy_reference(m_trial_charges_old,
+                                       m_trial_charges_new);
+  }
+}
+
 /**
  * Check if the inserted particle is too close to neighboring particles.
  */
@@ -534,6 +595,9 @@ int ReactionAlgorithm::create_particle(int desired_type) {
 #ifdef ELECTROSTATICS
   set_particle_q(p_id, charges_of_types[desired_type]);
 #endif
+  if (m_incremental_energy) {
+    m_trial_p_ids.emplace_back(p_id);
+  }
   return p_id;
 }
 
@@ -570,6 +634,7 @@ ReactionAlgorithm::generate_new_particle_positions(int type, int n_particles) {
     // write new position
     auto const prefactor = std::sqrt(kT / p.mass());
     auto const new_pos = get_random_position_in_box();
+    before_particle_change(p_id);
     move_particle(p_id, new_pos, prefactor);
     check_exclusion_range(p_id);
   }
@@ -584,6 +649,7 @@ bool ReactionAlgorithm::do_global_mc_move_for_particles_of_type(
     int type, int particle_number_of_type_to_be_changed) {
   m_tried_configurational_MC_moves += 1;
   particle_inside_exclusion_range_touched = false;
+  reset_long_range_energy_reference();
 
   auto const particle_number_of_type = number_of_particles_with_type(type);
   if (particle_number_of_type == 0 or
@@ -592,14 +658,17 @@ bool ReactionAlgorithm::do_global_mc_move_for_particles_of_type(
     return false;
   }
 
-  auto const E_pot_old = calculate_current_potential_energy_of_system();
+  /* with incremental energies, only the energy difference is computed */
+  auto const E_pot_old = (begin_trial_move())
+                             ? 0.
+                             : calculate_current_potential_energy_of_system();
 
   auto const original_positions = generate_new_particle_positions(
       type, particle_number_of_type_to_be_changed);
 
   auto const E_pot_new = (particle_inside_exclusion_range_touched)
                              ? std::numeric_limits<double>::max()
-                             : calculate_current_potential_energy_of_system();
+                             : calculate_trial_move_potential_energy(E_pot_old);
 
   auto const beta = 1.0 / kT;
 
@@ -620,6 +689,7 @@ bool ReactionAlgorithm::do_global_mc_move_for_particles_of_type(
   if (m_uniform_real_distribution(m_generator) < bf) {
     // accept
     m_accepted_configurational_MC_moves += 1;
+    accept_trial_move();
     return true;
   }
   // reject: restore original particle positions
@@ -188,6 +188,37 @@ protected:
     return -10.;
   }
 
+  /**
+   * @brief Start recording the particles changed by a trial move.
+   *
+   * If the energy of the system can be updated from the interactions of
+   * the changed particles, their energy is recorded before each change.
+   *
+   * @return Whether the energy of the trial move is computed incrementally.
+   */
+  bool begin_trial_move();
+  /**
+   * @brief Potential energy of the system after the trial move.
+   *
+   * @param E_pot_old  The potential energy before the trial move, which
+   *                   is only needed when the energy is computed
+   *                   incrementally.
+   */
+  double calculate_trial_move_potential_energy(double E_pot_old);
+  /**
+   * @brief Keep the changes of an accepted trial move in the reference
+   * state of the incremental long-range energy.
+   */
+  void accept_trial_move();
+  /**
+   * @brief Rebuild the reference state of the incremental long-range
+   * energy at the next trial move, since the particles may have changed
+   * since the last trial move.
+   */
+  void reset_long_range_energy_reference() {
+    m_long_range_reference_valid = false;
+  }
+
 private:
   std::mt19937 m_generator;
   std::normal_distribution<double> m_normal_distribution;
@@ -196,9 +227,10 @@ private:
   std::map<int, int>
   save_old_particle_numbers(SingleReaction const &current_reaction) const;
 
-  void replace_particle(int p_id, int desired_type) const;
+  void replace_particle(int p_id, int desired_type);
   int create_particle(int desired_type);
-  void hide_particle(int p_id) const;
+  void hide_particle(int p_id);
+  void before_particle_change(int p_id);
   void check_exclusion_range(int inserted_particle_id);
   void move_particle(int p_id, Utils::Vector3d const &new_pos,
                      double velocity_prefactor);
@@ -215,6 +247,19 @@ private:
   double m_slab_end_z = -10.0;
   double m_max_exclusion_range = 0.;
 
+  /** Whether the current trial move computes the energy incrementally */
+  bool m_incremental_energy = false;
+  /** Particles changed or created by the current trial move */
+  std::vector<int> m_trial_p_ids;
+  /** Energy of the changed particles before the current trial move */
+  double m_trial_E_pot_old = 0.;
+  /** Charges of the changed particles before the current trial move */
+  std::vector<std::pair<Utils::Vector3d, double>> m_trial_charges_old;
+  /** Charges of the changed particles after the current trial move */
+  std::vector<std::pair<Utils::Vector3d, double>> m_trial_charges_new;
+  /** Whether the reference state of the long-range energy is up to date */
+  bool m_long_range_reference_valid = false;
+
 protected:
   Utils::Vector3d get_random_position_in_box();
 };
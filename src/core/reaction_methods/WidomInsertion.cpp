@@ -36,7 +36,11 @@ double WidomInsertion::calculate_particle_insertion_potential_energy(
     throw std::runtime_error("Trying to remove some non-existing particles "
                              "from the system via the inverse Widom scheme.");
 
-  auto const E_pot_old = calculate_current_potential_energy_of_system();
+  /* with incremental energies, only the energy difference is computed */
+  reset_long_range_energy_reference();
+  auto const E_pot_old = (begin_trial_move())
+                             ? 0.
+                             : calculate_current_potential_energy_of_system();
 
   // make reaction attempt
   std::vector<int> p_ids_created_particles;
@@ -46,7 +50,7 @@ double WidomInsertion::calculate_particle_insertion_potential_energy(
            hidden_particles_properties) =
       make_reaction_attempt(current_reaction);
 
-  auto const E_pot_new = calculate_current_potential_energy_of_system();
+  auto const E_pot_new = calculate_trial_move_potential_energy(E_pot_old);
   // reverse reaction attempt
   // reverse reaction
   // 1) delete created product particles
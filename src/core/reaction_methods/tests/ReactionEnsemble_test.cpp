@@ -30,6 +30,8 @@
 
 #include "EspressoSystemStandAlone.hpp"
 #include "communication.hpp"
+#include "energy.hpp"
+#include "nonbonded_interactions/lj.hpp"
 #include "particle_data.hpp"
 #include "particle_node.hpp"
 
@@ -125,8 +127,8 @@ BOOST_AUTO_TEST_CASE(ReactionEnsemble_test) {
     place_particle(pid, ref_position);
     set_particle_type(pid, type_D);
 
-    // sentinel value to check energies get updated
-    double energy = 1.0;
+    // the energy is updated from the energy of the current state
+    double energy = calculate_current_potential_energy_of_system();
 
     // for an ideal system with gamma ~ inf, the reaction is always accepted
     test_reaction.generic_oneway_reaction(reaction, energy);
@@ -139,6 +141,24 @@ BOOST_AUTO_TEST_CASE(ReactionEnsemble_test) {
     // the reaction was updated
     BOOST_CHECK_EQUAL(reaction.tried_moves, 1);
     BOOST_CHECK_EQUAL(reaction.accepted_moves, 1);
+
+#ifdef LENNARD_JONES
+    // in an interacting system, the energy of the new state is computed
+    // from the energy change of the reacting particles
+    lennard_jones_set_params(type_D, type_E, 1., 0.1, 0.18, 0., 0., 0.);
+    lennard_jones_set_params(type_E, type_E, 2., 0.1, 0.18, 0., 0., 0.);
+    place_particle(pid + 1, ref_position + Utils::Vector3d{0.11, 0., 0.});
+    set_particle_type(pid + 1, type_D);
+    auto const energy_old = calculate_current_potential_energy_of_system();
+    BOOST_REQUIRE_GT(std::abs(energy_old), 0.1);
+    energy = energy_old;
+    test_reaction.generic_oneway_reaction(reaction, energy);
+    BOOST_REQUIRE_EQUAL(reaction.accepted_moves, 2);
+    // the pair interaction changed from D-E to E-E
+    BOOST_CHECK_CLOSE(energy, 2. * energy_old, 1e3 * tol);
+    BOOST_CHECK_CLOSE(energy, calculate_current_potential_energy_of_system(),
+                      1e3 * tol);
+#endif // LENNARD_JONES
   }
 }
 
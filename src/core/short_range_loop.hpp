@@ -24,6 +24,7 @@
 #include <profiler/profiler.hpp>
 
 #include <cassert>
+#include <utility>
 
 namespace detail {
 /**
@@ -35,21 +36,96 @@ struct True {
 };
 } // namespace detail
 
+/**
+ * @brief Bond kernel which processes groups of bonds with the same bond
+ * id from the bond table, see @ref CellStructure::bond_table_loop.
+ */
+template <class GroupKernel> struct BondGroupKernel {
+  GroupKernel kernel;
+};
+
+template <class GroupKernel>
+BondGroupKernel<GroupKernel> make_bond_group_kernel(GroupKernel kernel) {
+  return {std::move(kernel)};
+}
+
+namespace detail {
+/** @brief Run a bond kernel on the bonds of the local particles. */
+template <class BondKernel> void bond_loop(BondKernel const &bond_kernel) {
+  cell_structure.bond_loop(bond_kernel);
+}
+
+template <class GroupKernel>
+void bond_loop(BondGroupKernel<GroupKernel> const &bond_kernel) {
+  cell_structure.bond_table_loop(bond_kernel.kernel);
+}
+} // namespace detail
+
+/** @brief Execution policy of the non-bonded pair loop. */
+enum class PairLoopPolicy {
+  /** Run the pair kernel on the calling thread only. */
+  SERIAL,
+  /** Distribute the pair kernel calls over the thread team, see
+   *  @ref CellStructure::threaded_non_bonded_loop. */
+  THREADED
+};
+
 template <class BondKernel, class PairKernel,
           class VerletCriterion = detail::True>
 void short_range_loop(BondKernel bond_kernel, PairKernel pair_kernel,
                       double pair_cutoff, double bond_cutoff,
-                      const VerletCriterion &verlet_criterion = {}) {
+                      const VerletCriterion &verlet_criterion = {},
+                      PairLoopPolicy policy = PairLoopPolicy::SERIAL) {
+  ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
+
+  assert(cell_structure.get_resort_particles() == Cells::RESORT_NONE);
+
+  /* With a ghost update in flight, the bonds are evaluated after the pair
+   * loop, which completes the update after the interior cells. */
+  auto const bonds_first = not cell_structure.ghosts_update_pending();
+
+  if (bonds_first and bond_cutoff >= 0.) {
+    detail::bond_loop(bond_kernel);
+  }
+
+  if (pair_cutoff > 0.) {
+    if (policy == PairLoopPolicy::THREADED) {
+      cell_structure.threaded_non_bonded_loop(pair_kernel, verlet_criterion);
+    } else {
+      cell_structure.non_bonded_loop(pair_kernel, verlet_criterion);
+    }
+  }
+
+  if (not bonds_first and bond_cutoff >= 0.) {
+    detail::bond_loop(bond_kernel);
+  }
+}
+
+/**
+ * @brief Short-range loop with the non-bonded pairs evaluated on the
+ * structure-of-arrays mirror, see @ref CellStructure::soa_non_bonded_loop.
+ */
+template <class BondKernel, class SoAKernel>
+void soa_short_range_loop(BondKernel bond_kernel, SoAKernel soa_kernel,
+                          double pair_cutoff, double bond_cutoff,
+                          double verlet_cutoff) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
 
   assert(cell_structure.get_resort_particles() == Cells::RESORT_NONE);
 
-  if (bond_cutoff >= 0.) {
-    cell_structure.bond_loop(bond_kernel);
+  /* see short_range_loop */
+  auto const bonds_first = not cell_structure.ghosts_update_pending();
+
+  if (bonds_first and bond_cutoff >= 0.) {
+    detail::bond_loop(bond_kernel);
   }
 
   if (pair_cutoff > 0.) {
-    cell_structure.non_bonded_loop(pair_kernel, verlet_criterion);
+    cell_structure.soa_non_bonded_loop(soa_kernel, verlet_cutoff);
+  }
+
+  if (not bonds_first and bond_cutoff >= 0.) {
+    detail::bond_loop(bond_kernel);
   }
 }
 #endif
@@ -27,56 +27,185 @@
 #include "statistics.hpp"
 
 #include "Particle.hpp"
+#include "cell_system/CellStructureType.hpp"
 #include "cells.hpp"
 #include "communication.hpp"
 #include "errorhandling.hpp"
+#include "event.hpp"
 #include "grid.hpp"
 #include "grid_based_algorithms/lb_interface.hpp"
+#include "integrate.hpp"
 #include "partCfg_global.hpp"
 
 #include <utils/Vector.hpp>
 #include <utils/constants.hpp>
 #include <utils/contains.hpp>
 #include <utils/math/sqr.hpp>
+#include <utils/mpi/gather_buffer.hpp>
 
+#include <boost/mpi/collectives/all_gather.hpp>
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/collectives/reduce.hpp>
+#include <boost/mpi/operations.hpp>
+#include <boost/range/algorithm/min_element.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstddef>
 #include <cstdlib>
+#include <functional>
 #include <limits>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 /****************************************************************************************
  *                                 basic observables calculation
  ****************************************************************************************/
 
-double mindist(PartCfg &partCfg, const std::vector<int> &set1,
-               const std::vector<int> &set2) {
-  using Utils::contains;
+/**
+ * @brief Range in which the cell system finds all neighbors of a particle.
+ * The particles may have moved by up to half the skin since they were
+ * sorted into the cells, which shortens the range by the skin.
+ * The neighbor cells of the hybrid decomposition are not searched.
+ */
+static double neighbor_search_range() {
+  if (cell_structure.decomposition_type() ==
+      CellStructureType::CELL_STRUCTURE_HYBRID) {
+    return 0.;
+  }
+  return std::max(*boost::min_element(cell_structure.max_range()) - skin, 0.);
+}
 
-  auto mindist_sq = std::numeric_limits<double>::infinity();
+/**
+ * @brief Squared distance of the local particles to their closest partner.
+ *
+ * For every local particle accepted by @p filter1, find the squared
+ * minimum image distance to the closest other particle accepted by
+ * @p filter2. Partners within the range of the cell system are found in
+ * the neighbor cells. Only if a particle has no partner in that range and
+ * distances up to @p limit are requested, or if it is not in a cell of the
+ * local domain, the positions of all candidate partners are gathered,
+ * which is the case in dilute systems only.
+ * Has to be called on all ranks.
+ *
+ * @param filter1  Selection of the local particles
+ * @param filter2  Selection of the partners
+ * @param limit    Distances larger than this do not have to be exact
+ * @return For each selected local particle, its squared distance to the
+ *         closest partner if that is below @p limit, otherwise a value
+ *         larger than <tt>limit * limit</tt>.
+ */
+template <class Filter1, class Filter2>
+static std::vector<double> local_min_distances2(Filter1 const &filter1,
+                                                Filter2 const &filter2,
+                                                double limit) {
+  on_observable_calc();
+
+  auto const range = neighbor_search_range();
+  auto const range2 = range * range;
+
+  std::vector<Particle const *> particles;
+  std::vector<double> min_dist2;
+  std::vector<bool> no_cell;
+  for (auto const &p : cell_structure.local_particles()) {
+    if (filter1(p)) {
+      auto dist2 = std::numeric_limits<double>::infinity();
+      auto found = false;
+      if (range > 0.) {
+        auto kernel = [&dist2, &filter2](Particle const &p1,
+                                         Particle const &p2,
+                                         Utils::Vector3d const &vec) {
+          if (p1.id() != p2.id() and filter2(p2)) {
+            dist2 = std::min(dist2, vec.norm2());
+          }
+        };
+        found = cell_structure.run_on_particle_short_range_neighbors(p, kernel);
+      }
+      particles.emplace_back(&p);
+      min_dist2.emplace_back(dist2);
+      no_cell.emplace_back(range > 0. and not found);
+    }
+  }
 
-  for (auto jt = partCfg.begin(); jt != partCfg.end(); ++jt) {
-    /* check which sets particle j belongs to (bit 0: set1, bit1: set2) */
-    auto in_set = 0u;
-    if (set1.empty() || contains(set1, jt->type()))
-      in_set = 1u;
-    if (set2.empty() || contains(set2, jt->type()))
-      in_set |= 2u;
-    if (in_set == 0)
-      continue;
+  /* particles without a partner within the cell system range, or whose
+   * neighbor cells could not be searched */
+  auto const unresolved = [&, range2, limit](std::size_t i) {
+    return no_cell[i] or (min_dist2[i] > range2 and limit > range);
+  };
+  auto local_unresolved = false;
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    local_unresolved |= unresolved(i);
+  }
+  if (boost::mpi::all_reduce(comm_cart, local_unresolved,
+                             std::logical_or<bool>())) {
+    std::vector<std::pair<int, Utils::Vector3d>> local_partners;
+    for (auto const &p : cell_structure.local_particles()) {
+      if (filter2(p)) {
+        local_partners.emplace_back(p.id(), p.pos());
+      }
+    }
+    std::vector<std::vector<std::pair<int, Utils::Vector3d>>> partners;
+    boost::mpi::all_gather(comm_cart, local_partners, partners);
+
+    for (std::size_t i = 0; i < particles.size(); ++i) {
+      if (unresolved(i)) {
+        auto const &p1 = *particles[i];
+        for (auto const &rank_partners : partners) {
+          for (auto const &p2 : rank_partners) {
+            if (p1.id() != p2.first) {
+              auto const d = box_geo.get_mi_vector(p1.pos(), p2.second);
+              min_dist2[i] = std::min(min_dist2[i], d.norm2());
+            }
+          }
+        }
+      }
+    }
+  }
+
+  return min_dist2;
+}
 
-    for (auto it = std::next(jt); it != partCfg.end(); ++it)
-      /* accept a pair if particle j is in set1 and particle i in set2 or vice
-       * versa. */
-      if (((in_set & 1u) && (set2.empty() || contains(set2, it->type()))) ||
-          ((in_set & 2u) && (set1.empty() || contains(set1, it->type()))))
-        mindist_sq = std::min(
-            mindist_sq, box_geo.get_mi_vector(jt->pos(), it->pos()).norm2());
+static double mindist_local(std::vector<int> set1, std::vector<int> set2) {
+  auto const filter1 = [&set1](Particle const &p) {
+    return set1.empty() or Utils::contains(set1, p.type());
+  };
+  auto const filter2 = [&set2](Particle const &p) {
+    return set2.empty() or Utils::contains(set2, p.type());
+  };
+  auto const global_min = [](std::vector<double> const &dist2) {
+    auto const local_min =
+        (dist2.empty()) ? std::numeric_limits<double>::infinity()
+                        : *boost::min_element(dist2);
+    return boost::mpi::all_reduce(comm_cart, local_min,
+                                  boost::mpi::minimum<double>());
+  };
+
+  /* A pair is accepted if one particle is in set1 and the other one in
+   * set2, hence every pair is visited from its particle in set1. Unless
+   * no pair is closer than the cell system range, the closest pair is
+   * found in the neighbor cells or, for particles outside of the cells,
+   * among the gathered partners. */
+  auto const range = neighbor_search_range();
+  auto mindist_sq = global_min(local_min_distances2(filter1, filter2, 0.));
+  if (not(mindist_sq <= range * range)) {
+    mindist_sq = global_min(local_min_distances2(
+        filter1, filter2, std::numeric_limits<double>::infinity()));
   }
 
   return std::sqrt(mindist_sq);
 }
 
+REGISTER_CALLBACK_MAIN_RANK(mindist_local)
+
+double mindist(std::vector<int> const &set1, std::vector<int> const &set2) {
+  return mpi_call(Communication::Result::main_rank, mindist_local, set1, set2);
+}
+
 static Utils::Vector3d mpi_particle_momentum_local() {
   auto const particles = cell_structure.local_particles();
   auto const momentum =
@@ -161,114 +290,195 @@ void momentofinertiamatrix(PartCfg &partCfg, int type, double *MofImatrix) {
   MofImatrix[7] = MofImatrix[5];
 }
 
-std::vector<int> nbhood(PartCfg &partCfg, const Utils::Vector3d &pos,
-                        double dist) {
+static std::vector<int> nbhood_local(Utils::Vector3d pos, double dist) {
   std::vector<int> ids;
   auto const dist_sq = dist * dist;
 
-  for (auto const &p : partCfg) {
+  for (auto const &p : cell_structure.local_particles()) {
     auto const r_sq = box_geo.get_mi_vector(pos, p.pos()).norm2();
     if (r_sq < dist_sq) {
       ids.push_back(p.id());
     }
   }
 
+  Utils::Mpi::gather_buffer(ids, comm_cart);
+  std::sort(ids.begin(), ids.end());
+
   return ids;
 }
 
-void calc_part_distribution(PartCfg &partCfg, std::vector<int> const &p1_types,
+REGISTER_CALLBACK_MAIN_RANK(nbhood_local)
+
+std::vector<int> nbhood(Utils::Vector3d const &pos, double dist) {
+  return mpi_call(Communication::Result::main_rank, nbhood_local, pos, dist);
+}
+
+static std::vector<double>
+calc_part_distribution_local(std::vector<int> p1_types,
+                             std::vector<int> p2_types, double r_min,
+                             double r_max, int r_bins, bool log_flag) {
+  auto const filter1 = [&p1_types](Particle const &p) {
+    return Utils::contains(p1_types, p.type());
+  };
+  auto const filter2 = [&p2_types](Particle const &p) {
+    return Utils::contains(p2_types, p.type());
+  };
+  auto const min_dist2 = local_min_distances2(filter1, filter2, r_max);
+
+  auto const inv_bin_width =
+      (log_flag) ? static_cast<double>(r_bins) / std::log(r_max / r_min)
+                 : static_cast<double>(r_bins) / (r_max - r_min);
+
+  /* histogram, followed by the particles closer than r_min and the number
+   * of particles */
+  std::vector<double> local_dist(r_bins + 2, 0.);
+  for (auto const dist2 : min_dist2) {
+    auto const min_dist = std::sqrt(dist2);
+    if (min_dist <= r_max) {
+      if (min_dist >= r_min) {
+        /* calculate bin index */
+        auto const ind =
+            (log_flag) ? static_cast<int>(std::log(min_dist / r_min) *
+                                          inv_bin_width)
+                       : static_cast<int>((min_dist - r_min) * inv_bin_width);
+        if (ind >= 0 and ind < r_bins) {
+          local_dist[ind] += 1.;
+        }
+      } else {
+        local_dist[r_bins] += 1.;
+      }
+    }
+  }
+  local_dist[r_bins + 1] = static_cast<double>(min_dist2.size());
+
+  std::vector<double> dist(local_dist.size());
+  boost::mpi::reduce(comm_cart, local_dist.data(),
+                     static_cast<int>(local_dist.size()), dist.data(),
+                     std::plus<double>(), 0);
+
+  return dist;
+}
+
+REGISTER_CALLBACK_MAIN_RANK(calc_part_distribution_local)
+
+void calc_part_distribution(std::vector<int> const &p1_types,
                             std::vector<int> const &p2_types, double r_min,
                             double r_max, int r_bins, bool log_flag,
                             double *low, double *dist) {
-  int ind, cnt = 0;
-  double inv_bin_width = 0.0;
-  double min_dist, min_dist2 = 0.0, start_dist2;
+  auto const result =
+      mpi_call(Communication::Result::main_rank, calc_part_distribution_local,
+               p1_types, p2_types, r_min, r_max, r_bins, log_flag);
+  auto const cnt = result[r_bins + 1];
 
-  start_dist2 = Utils::sqr(box_geo.length()[0] + box_geo.length()[1] +
-                           box_geo.length()[2]);
-  /* bin preparation */
   *low = 0.0;
   for (int i = 0; i < r_bins; i++)
     dist[i] = 0.0;
-  if (log_flag)
-    inv_bin_width = (double)r_bins / (log(r_max / r_min));
-  else
-    inv_bin_width = (double)r_bins / (r_max - r_min);
-
-  /* particle loop: p1_types */
-  for (auto const &p1 : partCfg) {
-    for (int t1 : p1_types) {
-      if (p1.type() == t1) {
-        min_dist2 = start_dist2;
-        /* particle loop: p2_types */
-        for (auto const &p2 : partCfg) {
-          if (p1 != p2) {
-            for (int t2 : p2_types) {
-              if (p2.type() == t2) {
-                auto const act_dist2 =
-                    box_geo.get_mi_vector(p1.pos(), p2.pos()).norm2();
-                if (act_dist2 < min_dist2) {
-                  min_dist2 = act_dist2;
-                }
-              }
-            }
-          }
-        }
-        min_dist = sqrt(min_dist2);
-        if (min_dist <= r_max) {
-          if (min_dist >= r_min) {
-            /* calculate bin index */
-            if (log_flag)
-              ind = (int)((log(min_dist / r_min)) * inv_bin_width);
-            else
-              ind = (int)((min_dist - r_min) * inv_bin_width);
-            if (ind >= 0 && ind < r_bins) {
-              dist[ind] += 1.0;
-            }
-          } else {
-            *low += 1.0;
+  if (cnt == 0.)
+    return;
+
+  /* normalization */
+  *low = result[r_bins] / cnt;
+  for (int i = 0; i < r_bins; i++)
+    dist[i] = result[i] / cnt;
+}
+
+/**
+ * @brief Sum the Fourier modes of the local particle density.
+ *
+ * The phase factors of the wave vectors are built from powers of the
+ * phase factors of the unit wave vectors, which avoids the evaluation
+ * of trigonometric functions for every pair of particle and wave vector.
+ * The sums of all ranks are reduced on the head node.
+ *
+ * @return The real and imaginary part of the sum for each wave vector
+ *         with indices <tt>(i, j, k)</tt> in the range used by
+ *         @ref calc_structurefactor, followed by the number of particles.
+ */
+static std::vector<double>
+structure_factor_modes_local(std::vector<int> p_types, int order) {
+  on_observable_calc();
+
+  auto const order_sq = order * order;
+  auto const twoPI_L = 2 * Utils::pi() * box_geo.length_inv()[0];
+  auto const n_modes = (order + 1) * Utils::sqr(2 * order + 1);
+
+  std::vector<std::complex<double>> modes(n_modes);
+  std::vector<std::complex<double>> phase_x(order + 1);
+  std::vector<std::complex<double>> phase_y(2 * order + 1);
+  std::vector<std::complex<double>> phase_z(2 * order + 1);
+  auto const fill_phases = [order](std::vector<std::complex<double>> &phases,
+                                   double qr, int offset) {
+    auto const unit = std::polar(1., qr);
+    phases[offset] = 1.;
+    for (int n = 1; n <= order; n++) {
+      phases[offset + n] = phases[offset + n - 1] * unit;
+      if (offset != 0) {
+        phases[offset - n] = std::conj(phases[offset + n]);
+      }
+    }
+  };
+
+  double n_particles = 0.;
+  for (auto const &p : cell_structure.local_particles()) {
+    if (not Utils::contains(p_types, p.type()))
+      continue;
+    n_particles += 1.;
+    auto const pos = p.pos();
+    fill_phases(phase_x, twoPI_L * pos[0], 0);
+    fill_phases(phase_y, twoPI_L * pos[1], order);
+    fill_phases(phase_z, twoPI_L * pos[2], order);
+    auto mode = modes.begin();
+    for (int i = 0; i <= order; i++) {
+      for (int j = -order; j <= order; j++) {
+        auto const phase_xy = phase_x[i] * phase_y[j + order];
+        for (int k = -order; k <= order; k++, ++mode) {
+          if (i * i + j * j + k * k <= order_sq) {
+            *mode += phase_xy * phase_z[k + order];
           }
         }
-        cnt++;
       }
     }
   }
-  if (cnt == 0)
-    return;
 
-  /* normalization */
-  *low /= (double)cnt;
-  for (int i = 0; i < r_bins; i++)
-    dist[i] /= (double)cnt;
+  std::vector<double> local_sums(2 * n_modes + 1);
+  for (std::size_t m = 0; m < modes.size(); ++m) {
+    local_sums[2 * m] = modes[m].real();
+    local_sums[2 * m + 1] = modes[m].imag();
+  }
+  local_sums.back() = n_particles;
+
+  std::vector<double> sums(local_sums.size());
+  boost::mpi::reduce(comm_cart, local_sums.data(),
+                     static_cast<int>(local_sums.size()), sums.data(),
+                     std::plus<double>(), 0);
+
+  return sums;
 }
 
-void calc_structurefactor(PartCfg &partCfg, std::vector<int> const &p_types,
-                          int order, std::vector<double> &wavevectors,
+REGISTER_CALLBACK_MAIN_RANK(structure_factor_modes_local)
+
+void calc_structurefactor(std::vector<int> const &p_types, int order,
+                          std::vector<double> &wavevectors,
                           std::vector<double> &intensities) {
 
   if (order < 1)
     throw std::domain_error("order has to be a strictly positive number");
 
+  auto const sums = mpi_call(Communication::Result::main_rank,
+                             structure_factor_modes_local, p_types, order);
+
   auto const order_sq = Utils::sqr(static_cast<std::size_t>(order));
   std::vector<double> ff(2 * order_sq + 1);
   auto const twoPI_L = 2 * Utils::pi() * box_geo.length_inv()[0];
 
+  std::size_t m = 0;
   for (int i = 0; i <= order; i++) {
     for (int j = -order; j <= order; j++) {
-      for (int k = -order; k <= order; k++) {
+      for (int k = -order; k <= order; k++, m++) {
         auto const n = i * i + j * j + k * k;
         if ((static_cast<std::size_t>(n) <= order_sq) && (n >= 1)) {
-          double C_sum = 0.0, S_sum = 0.0;
-          for (auto const &p : partCfg) {
-            for (int t : p_types) {
-              if (p.type() == t) {
-                auto const qr =
-                    twoPI_L * (Utils::Vector3i{{i, j, k}} * p.pos());
-                C_sum += cos(qr);
-                S_sum += sin(qr);
-              }
-            }
-          }
+          auto const C_sum = sums[2 * m];
+          auto const S_sum = sums[2 * m + 1];
           ff[2 * n - 2] += C_sum * C_sum + S_sum * S_sum;
           ff[2 * n - 1]++;
         }
@@ -276,18 +486,12 @@ void calc_structurefactor(PartCfg &partCfg, std::vector<int> const &p_types,
     }
   }
 
-  long n_particles = 0l;
-  for (auto const &p : partCfg) {
-    for (int t : p_types) {
-      if (p.type() == t)
-        n_particles++;
-    }
-  }
+  auto const n_particles = sums.back();
 
   int length = 0;
   for (std::size_t qi = 0; qi < order_sq; qi++) {
     if (ff[2 * qi + 1] != 0) {
-      ff[2 * qi] /= static_cast<double>(n_particles) * ff[2 * qi + 1];
+      ff[2 * qi] /= n_particles * ff[2 * qi + 1];
       length++;
     }
   }
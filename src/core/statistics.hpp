@@ -32,23 +32,22 @@
 
 /** Calculate the minimal distance of two particles with types in set1 resp.
  *  set2.
- *  @param partCfg particle collection.
+ *  The closest pairs are searched in parallel in the neighbor cells of the
+ *  cell system. Only if no pair is closer than the cell system range, the
+ *  positions of the particles in set2 are gathered on all ranks.
  *  @param set1 types of particles
  *  @param set2 types of particles
  *  @return the minimal distance of two particles
  */
-double mindist(PartCfg &partCfg, const std::vector<int> &set1,
-               const std::vector<int> &set2);
+double mindist(std::vector<int> const &set1, std::vector<int> const &set2);
 
 /** Find all particles within a given radius @p r_catch around a position.
- *  @param partCfg    @copybrief PartCfg
  *  @param pos        position of sphere center
  *  @param dist       the sphere radius
  *
- *  @return List of ids close to @p pos.
+ *  @return List of ids close to @p pos, in ascending order.
  */
-std::vector<int> nbhood(PartCfg &partCfg, const Utils::Vector3d &pos,
-                        double dist);
+std::vector<int> nbhood(Utils::Vector3d const &pos, double dist);
 
 /** Calculate the distribution of particles around others.
  *
@@ -58,7 +57,10 @@ std::vector<int> nbhood(PartCfg &partCfg, const Utils::Vector3d &pos,
  *  into @p r_bins bins which are either equidistant (@p log_flag==false) or
  *  logarithmically equidistant (@p log_flag==true). The result is stored
  *  in the @p array dist.
- *  @param partCfg  particle collection.
+ *  The closest particles are searched in parallel in the neighbor cells of
+ *  the cell system. Particles without a neighbor closer than the cell system
+ *  range are compared with the positions of all particles of @p p2_types,
+ *  which are gathered only if @p r_max exceeds that range.
  *  @param p1_types list with types of particles to find the distribution for.
  *  @param p2_types list with types of particles the others are distributed
  *                  around.
@@ -69,7 +71,7 @@ std::vector<int> nbhood(PartCfg &partCfg, const Utils::Vector3d &pos,
  *  @param low      particles closer than @p r_min
  *  @param dist     Array to store the result (size: @p r_bins).
  */
-void calc_part_distribution(PartCfg &partCfg, std::vector<int> const &p1_types,
+void calc_part_distribution(std::vector<int> const &p1_types,
                             std::vector<int> const &p2_types, double r_min,
                             double r_max, int r_bins, bool log_flag,
                             double *low, double *dist);
@@ -86,15 +88,16 @@ void calc_part_distribution(PartCfg &partCfg, std::vector<int> const &p1_types,
  *  nonzero, the first is meaningful. This means the q=1 entries are sf[0]=S(1)
  *  and sf[1]=1. For q=7, there are no possible wave vectors, so
  *  sf[2*(7-1)]=sf[2*(7-1)+1]=0.
+ *  The Fourier modes of the density are summed up over the local particles
+ *  of each rank and reduced on the head node.
  *
- *  @param[in]  partCfg   particle collection
  *  @param[in]  p_types   list with types of particles to be analyzed
  *  @param[in]  order     the maximum wave vector length in units of 2PI/L
  *  @param[out] wavevectors  the scattering vectors q
  *  @param[out] intensities  the structure factor S(q)
  */
-void calc_structurefactor(PartCfg &partCfg, std::vector<int> const &p_types,
-                          int order, std::vector<double> &wavevectors,
+void calc_structurefactor(std::vector<int> const &p_types, int order,
+                          std::vector<double> &wavevectors,
                           std::vector<double> &intensities);
 
 /** Calculate the center of mass of a special type of the current configuration.
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_SRC_CORE_THREADS_HPP
+#define ESPRESSO_SRC_CORE_THREADS_HPP
+
+/** @file
+ *  Shared-memory parallelism inside an MPI rank.
+ *
+ *  When ESPResSo is compiled with OpenMP support, the short-range
+ *  pair loops are distributed over the OpenMP thread team of each
+ *  MPI rank. The number of threads is controlled by the usual
+ *  OpenMP mechanisms, e.g. the @c OMP_NUM_THREADS environment variable.
+ */
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Threads {
+
+/** @brief Maximal number of threads in a parallel region. */
+inline int max_threads() {
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+/** @brief Index of the calling thread in the current thread team. */
+inline int thread_num() {
+#ifdef _OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief One independent instance of an object per thread.
+ *
+ * Used to accumulate thread-local partial results in parallel
+ * regions, which are reduced serially afterwards.
+ */
+template <class T> class PerThread {
+  std::vector<std::unique_ptr<T>> m_instances;
+
+public:
+  template <class... Args> explicit PerThread(Args const &...args) {
+    auto const n_threads = static_cast<std::size_t>(max_threads());
+    m_instances.reserve(n_threads);
+    for (std::size_t i = 0; i < n_threads; ++i) {
+      m_instances.emplace_back(std::make_unique<T>(args...));
+    }
+  }
+
+  /** @brief Instance of the calling thread. */
+  T &local() {
+    auto const i = static_cast<std::size_t>(thread_num());
+    assert(i < m_instances.size());
+    return *m_instances[i];
+  }
+
+  template <class F> void for_each(F &&f) const {
+    for (auto const &instance : m_instances) {
+      f(*instance);
+    }
+  }
+};
+
+} // namespace Threads
+
+#endif
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE BalancedDecomposition test
+
+#include "config.hpp"
+
+#ifdef LENNARD_JONES
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/data/monomorphic.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <boost/test/unit_test.hpp>
+namespace utf = boost::unit_test;
+namespace bdata = boost::unit_test::data;
+
+#include "EspressoSystemStandAlone.hpp"
+#include "MpiCallbacks.hpp"
+#include "Particle.hpp"
+#include "ParticleFactory.hpp"
+#include "cell_system/BalancedDecomposition.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "particle_node.hpp"
+#include "thermostat.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/as_const.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+static void mpi_set_balanced_decomposition_local(int metric) {
+  LoadBalancingParameters params{};
+  params.rebalance_interval = 1;
+  params.imbalance_threshold = 1.05;
+  params.metric = static_cast<LoadMetric>(metric);
+  set_balanced_decomposition(params);
+}
+
+REGISTER_CALLBACK(mpi_set_balanced_decomposition_local)
+
+static void mpi_set_regular_decomposition_local() {
+  cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+}
+
+REGISTER_CALLBACK(mpi_set_regular_decomposition_local)
+
+BOOST_AUTO_TEST_CASE(balanced_cuts) {
+  using detail::balanced_cuts;
+  // equal loads are split evenly
+  BOOST_CHECK((balanced_cuts({1., 1., 1., 1., 1., 1.}, 3) ==
+               std::vector<int>{0, 2, 4, 6}));
+  // without load, the planes are split evenly
+  BOOST_CHECK((balanced_cuts({0., 0., 0., 0., 0., 0., 0., 0.}, 4) ==
+               std::vector<int>{0, 2, 4, 6, 8}));
+  // slabs shrink where the load is concentrated
+  BOOST_CHECK((balanced_cuts({4., 4., 1., 1., 1., 1., 0., 0.}, 3) ==
+               std::vector<int>{0, 1, 2, 8}));
+  // every slab keeps at least one plane
+  BOOST_CHECK((balanced_cuts({0., 0., 0., 0., 10.}, 3) ==
+               std::vector<int>{0, 3, 4, 5}));
+  BOOST_CHECK((balanced_cuts({10., 0., 0., 0., 0.}, 3) ==
+               std::vector<int>{0, 1, 2, 5}));
+  BOOST_CHECK((balanced_cuts({1., 2., 3.}, 3) == std::vector<int>{0, 1, 2, 3}));
+  BOOST_CHECK((balanced_cuts({1., 2., 3.}, 1) == std::vector<int>{0, 3}));
+}
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_DATA_TEST_CASE_F(ParticleFactory, inhomogeneous_system,
+                       bdata::make({0, 1}), metric_id) {
+  auto const metric = static_cast<LoadMetric>(metric_id);
+  auto const n_nodes = 4;
+  auto const box_l = Utils::Vector3d{12., 4., 4.};
+  espresso::system->set_box_l(box_l);
+  espresso::system->set_node_grid({n_nodes, 1, 1});
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.1);
+  mpi_set_thermo_switch(THERMO_OFF);
+  integrate_set_nvt();
+  lennard_jones_set_params(0, 0, 1., 0.3, 0.55, 0., 0., 0.);
+  mpi_call_all(mpi_set_regular_decomposition_local);
+
+  // The cells are 0.75 wide along x, with 4 cells per node. The left half
+  // of the box holds two particle layers per cell plane, which interact
+  // with the layers of the neighboring planes, the right half holds one
+  // layer every other plane.
+  std::vector<double> layers;
+  for (int plane = 0; plane < 8; ++plane) {
+    layers.emplace_back(0.75 * plane + 0.2);
+    layers.emplace_back(0.75 * plane + 0.55);
+  }
+  for (int plane = 8; plane < 16; plane += 2) {
+    layers.emplace_back(0.75 * plane + 0.375);
+  }
+  int pid = 0;
+  for (auto const x : layers) {
+    for (int j = 0; j < 8; ++j) {
+      for (int k = 0; k < 8; ++k) {
+        create_particle({x, 0.5 * j + 0.1, 0.5 * k + 0.1}, pid++, 0);
+      }
+    }
+  }
+  auto const n_part = pid;
+
+  auto const particles_per_node = [n_part, n_nodes]() {
+    clear_particle_node();
+    std::vector<int> counts(n_nodes, 0);
+    for (int i = 0; i < n_part; ++i) {
+      counts[get_particle_node(i)]++;
+    }
+    return counts;
+  };
+  auto const forces = [n_part]() {
+    std::vector<Utils::Vector3d> result;
+    for (int i = 0; i < n_part; ++i) {
+      result.emplace_back(get_particle_data(i).force());
+    }
+    return result;
+  };
+
+  // reference with equal node domains
+  BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+  auto const forces_ref = forces();
+  auto const counts_ref = particles_per_node();
+  BOOST_REQUIRE((counts_ref == std::vector<int>{512, 512, 128, 128}));
+
+  // the node domains are rebuilt on the next resort
+  mpi_call_all(mpi_set_balanced_decomposition_local, metric_id);
+  BOOST_REQUIRE(cell_structure.decomposition_type() ==
+                CellStructureType::CELL_STRUCTURE_BALANCED);
+  BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+  auto const &bd = dynamic_cast<BalancedDecomposition const &>(
+      Utils::as_const(cell_structure).decomposition());
+  BOOST_CHECK_EQUAL(bd.get_n_rebalances(), 1);
+  auto const imbalance_ref = bd.get_imbalance();
+  BOOST_CHECK_GT(imbalance_ref, 1.5);
+
+  // all particles are kept and the load is spread
+  auto const counts = particles_per_node();
+  BOOST_CHECK_EQUAL(std::accumulate(counts.begin(), counts.end(), 0), n_part);
+  BOOST_CHECK_GT(*std::min_element(counts.begin(), counts.end()), 128);
+  if (metric == LoadMetric::PARTICLES) {
+    BOOST_CHECK_CLOSE(imbalance_ref, 512. * n_nodes / n_part, 1e-9);
+    BOOST_CHECK((counts == std::vector<int>{384, 256, 384, 256}));
+  }
+  auto const &partition = bd.get_partition();
+  BOOST_CHECK_EQUAL(partition.global_cell_grid[0], 16);
+  BOOST_CHECK_EQUAL(partition.cuts[1].size(), 2u);
+  BOOST_CHECK_EQUAL(partition.cuts[2].size(), 2u);
+
+  // the forces do not depend on the node domains
+  auto const forces_balanced = forces();
+  for (int i = 0; i < n_part; ++i) {
+    BOOST_CHECK_SMALL((forces_balanced[i] - forces_ref[i]).norm(),
+                      1e-10 * (1. + forces_ref[i].norm()));
+  }
+
+  // the load is evaluated again on the next resort, but the node
+  // domains are only rebuilt if the balance improves
+  place_particle(0, get_particle_data(0).pos());
+  BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+  auto const &bd_new = dynamic_cast<BalancedDecomposition const &>(
+      Utils::as_const(cell_structure).decomposition());
+  BOOST_CHECK_EQUAL(bd_new.get_n_rebalances(), 1);
+  BOOST_CHECK_LT(bd_new.get_imbalance(), imbalance_ref - 0.2);
+  if (metric == LoadMetric::PARTICLES) {
+    BOOST_CHECK_CLOSE(bd_new.get_imbalance(), 384. * n_nodes / n_part, 1e-9);
+  }
+
+  mpi_call_all(mpi_set_regular_decomposition_local);
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  // the test case only works for 4 MPI ranks
+  boost::mpi::communicator world;
+  if (world.size() == 4)
+    return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
+#else // ifdef LENNARD_JONES
+int main(int argc, char **argv) {}
+#endif
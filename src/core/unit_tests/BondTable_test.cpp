@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE bond table test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+namespace utf = boost::unit_test;
+
+#include "EspressoSystemStandAlone.hpp"
+#include "MpiCallbacks.hpp"
+#include "Particle.hpp"
+#include "ParticleFactory.hpp"
+#include "bonded_interactions/angle_harmonic.hpp"
+#include "bonded_interactions/bonded_interaction_data.hpp"
+#include "bonded_interactions/dihedral.hpp"
+#include "bonded_interactions/fene.hpp"
+#include "bonded_interactions/harmonic.hpp"
+#include "cell_system/BondTable.hpp"
+#include "cells.hpp"
+#include "collision.hpp"
+#include "communication.hpp"
+#include "config.hpp"
+#include "grid.hpp"
+#include "integrate.hpp"
+#include "particle_data.hpp"
+#include "particle_node.hpp"
+#include "thermostat.hpp"
+
+#include <utils/Span.hpp>
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+#include <boost/variant.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+auto constexpr fene_bond_id = 0;
+auto constexpr harm_bond_id = 1;
+auto constexpr angle_bond_id = 2;
+auto constexpr dihedral_bond_id = 3;
+auto constexpr virtual_bond_id = 4;
+
+static void mpi_create_bonds_local() {
+  bonded_ia_params.insert(fene_bond_id, std::make_shared<Bonded_IA_Parameters>(
+                                            FeneBond(30., 2., 0.1)));
+  bonded_ia_params.insert(harm_bond_id, std::make_shared<Bonded_IA_Parameters>(
+                                            HarmonicBond(10., 0.8, -1.)));
+  bonded_ia_params.insert(
+      angle_bond_id,
+      std::make_shared<Bonded_IA_Parameters>(AngleHarmonicBond(5., 2.5)));
+  bonded_ia_params.insert(
+      dihedral_bond_id,
+      std::make_shared<Bonded_IA_Parameters>(DihedralBond(2, 3., 0.5)));
+  bonded_ia_params.insert(virtual_bond_id,
+                          std::make_shared<Bonded_IA_Parameters>(VirtualBond()));
+}
+
+REGISTER_CALLBACK(mpi_create_bonds_local)
+
+#ifdef COLLISION_DETECTION
+static void mpi_set_collision_mode_local(CollisionModeType mode) {
+  collision_params.mode = mode;
+  collision_params.distance = 0.5;
+  collision_params.bond_centers = harm_bond_id;
+  collision_params.initialize();
+}
+
+REGISTER_CALLBACK(mpi_set_collision_mode_local)
+#endif // COLLISION_DETECTION
+
+BOOST_AUTO_TEST_CASE(bond_table_groups) {
+  std::vector<Particle> particles(5);
+  for (int i = 0; i < 5; ++i) {
+    particles[i].id() = i;
+  }
+  BondTable table;
+  auto const add_bond = [&table, &particles](int id, int bond_id,
+                                             std::vector<int> const &ids) {
+    std::vector<Particle *> partners;
+    for (auto const partner_id : ids) {
+      partners.push_back(&particles[partner_id]);
+    }
+    table.add(particles[id], bond_id, partners);
+  };
+
+  add_bond(0, 7, {1});
+  add_bond(1, 3, {0, 2});
+  add_bond(2, 7, {3});
+  add_bond(4, 7, {0});
+  table.add_unresolved(3, std::vector<int>{42});
+
+  // bonds are grouped by bond id, in the order of their first appearance
+  auto &groups = table.groups();
+  BOOST_REQUIRE_EQUAL(groups.size(), 2u);
+  BOOST_CHECK_EQUAL(groups[0].bond_id, 7);
+  BOOST_CHECK_EQUAL(groups[0].n_partners, 1);
+  BOOST_REQUIRE_EQUAL(groups[0].size(), 3u);
+  BOOST_CHECK_EQUAL(groups[0].particle(1).id(), 2);
+  BOOST_CHECK_EQUAL(groups[0].partners(1).size(), 1u);
+  BOOST_CHECK_EQUAL(groups[0].partners(1)[0]->id(), 3);
+  BOOST_CHECK_EQUAL(groups[0].particle(2).id(), 4);
+  BOOST_CHECK_EQUAL(groups[0].partners(2)[0]->id(), 0);
+  BOOST_CHECK_EQUAL(groups[1].bond_id, 3);
+  BOOST_REQUIRE_EQUAL(groups[1].size(), 1u);
+  BOOST_CHECK_EQUAL(groups[1].particle(0).id(), 1);
+  BOOST_CHECK_EQUAL(groups[1].partners(0)[0]->id(), 0);
+  BOOST_CHECK_EQUAL(groups[1].partners(0)[1]->id(), 2);
+  BOOST_REQUIRE_EQUAL(table.unresolved().size(), 1u);
+  BOOST_CHECK_EQUAL(table.unresolved()[0].particle_id, 3);
+  BOOST_CHECK(table.unresolved()[0].partner_ids == std::vector<int>{42});
+
+  table.clear();
+  BOOST_CHECK(table.groups().empty());
+  BOOST_CHECK(table.unresolved().empty());
+}
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_FIXTURE_TEST_CASE(bonded_forces, ParticleFactory) {
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(10.));
+  espresso::system->set_node_grid({2, 1, 1});
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.4);
+  mpi_set_thermo_switch(THERMO_OFF);
+  integrate_set_nvt();
+  mpi_call_all(mpi_create_bonds_local);
+
+  // a chain across the boundary of the node domains
+  auto const n_part = 8;
+  for (int i = 0; i < n_part; ++i) {
+    create_particle({3.4 + 0.45 * i, 2. + 0.1 * std::sin(1. * i),
+                     2. + 0.1 * std::cos(2. * i)},
+                    i, 0);
+  }
+  std::vector<std::vector<int>> bonds;
+  for (int i = 0; i < n_part; ++i) {
+    if (i + 1 < n_part) {
+      bonds.push_back({i, fene_bond_id, i + 1});
+      bonds.push_back({i + 1, virtual_bond_id, i});
+    }
+    if (i + 2 < n_part) {
+      bonds.push_back({i + 2, harm_bond_id, i});
+      bonds.push_back({i + 1, angle_bond_id, i, i + 2});
+    }
+    if (i + 3 < n_part) {
+      bonds.push_back({i + 1, dihedral_bond_id, i, i + 2, i + 3});
+    }
+  }
+  for (auto const &bond : bonds) {
+    add_particle_bond(bond[0], Utils::Span<const int>(bond.data() + 1,
+                                                       bond.size() - 1));
+  }
+
+  auto const reference_forces = [&bonds]() {
+    std::vector<Utils::Vector3d> pos(n_part);
+    std::vector<Utils::Vector3d> forces(n_part, Utils::Vector3d{});
+    for (int i = 0; i < n_part; ++i) {
+      pos[i] = get_particle_data(i).pos();
+    }
+    for (auto const &bond : bonds) {
+      auto const &iaparams = *bonded_ia_params.at(bond[1]);
+      if (auto const *iap = boost::get<FeneBond>(&iaparams)) {
+        auto const f = *iap->force(box_geo.get_mi_vector(pos[bond[0]],
+                                                         pos[bond[2]]));
+        forces[bond[0]] += f;
+        forces[bond[2]] -= f;
+      } else if (auto const *iap = boost::get<HarmonicBond>(&iaparams)) {
+        auto const f = *iap->force(box_geo.get_mi_vector(pos[bond[0]],
+                                                         pos[bond[2]]));
+        forces[bond[0]] += f;
+        forces[bond[2]] -= f;
+      } else if (auto const *iap = boost::get<AngleHarmonicBond>(&iaparams)) {
+        auto const f = iap->forces(pos[bond[0]], pos[bond[2]], pos[bond[3]]);
+        forces[bond[0]] += std::get<0>(f);
+        forces[bond[2]] += std::get<1>(f);
+        forces[bond[3]] += std::get<2>(f);
+      } else if (auto const *iap = boost::get<DihedralBond>(&iaparams)) {
+        auto const f = *iap->forces(pos[bond[2]], pos[bond[0]], pos[bond[3]],
+                                    pos[bond[4]]);
+        forces[bond[0]] += std::get<0>(f);
+        forces[bond[2]] += std::get<1>(f);
+        forces[bond[3]] += std::get<2>(f);
+        forces[bond[4]] += std::get<3>(f);
+      }
+    }
+    return forces;
+  };
+  auto const check_forces = [&reference_forces]() {
+    auto const forces_ref = reference_forces();
+    for (int i = 0; i < n_part; ++i) {
+      auto const &force = get_particle_data(i).force();
+      BOOST_CHECK_SMALL((force - forces_ref[i]).norm(),
+                        1e-12 * (1. + forces_ref[i].norm()));
+      BOOST_CHECK_GT(forces_ref[i].norm(), 0.);
+    }
+  };
+
+  BOOST_REQUIRE_NE(get_particle_node(0), get_particle_node(n_part - 1));
+  BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+  check_forces();
+
+  // the bond partners are resolved again after the particles moved
+  BOOST_REQUIRE_EQUAL(mpi_integrate(20, 0), 0);
+  place_particle(4, get_particle_data(4).pos() + Utils::Vector3d{0., 0.1, 0.});
+  BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+  check_forces();
+
+  // removed bonds are no longer evaluated
+  delete_particle_bond(3, std::vector<int>{fene_bond_id, 4});
+  bonds.erase(std::find(bonds.begin(), bonds.end(),
+                        std::vector<int>{3, fene_bond_id, 4}));
+  BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+  check_forces();
+}
+
+#ifdef COLLISION_DETECTION
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_FIXTURE_TEST_CASE(collision_bonds, ParticleFactory) {
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(10.));
+  espresso::system->set_node_grid({2, 1, 1});
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.4);
+  mpi_set_thermo_switch(THERMO_OFF);
+  integrate_set_nvt();
+  mpi_call_all(mpi_create_bonds_local);
+  mpi_call_all(mpi_set_collision_mode_local, CollisionModeType::BIND_CENTERS);
+
+  // colliding pairs on one node and across the boundary of the node domains
+  create_particle({2.0, 2., 2.}, 0, 0);
+  create_particle({2.4, 2., 2.}, 1, 0);
+  create_particle({4.8, 6., 6.}, 2, 0);
+  create_particle({5.2, 6., 6.}, 3, 0);
+  BOOST_REQUIRE_NE(get_particle_node(2), get_particle_node(3));
+
+  // the bonds are created at the end of the first step, the particles do
+  // not move far enough to be resorted before the second step
+  BOOST_REQUIRE_EQUAL(mpi_integrate(2, 0), 0);
+  auto const &bond =
+      boost::get<HarmonicBond>(*bonded_ia_params.at(harm_bond_id));
+  for (auto const &pair : {std::make_pair(0, 1), std::make_pair(2, 3)}) {
+    auto const p1 = get_particle_data(pair.first);
+    auto const p2 = get_particle_data(pair.second);
+    BOOST_REQUIRE_EQUAL(p1.bonds().size() + p2.bonds().size(), 1u);
+    auto const force_ref =
+        *bond.force(box_geo.get_mi_vector(p1.pos(), p2.pos()));
+    BOOST_REQUIRE_GT(force_ref.norm(), 0.);
+    BOOST_CHECK_SMALL((p1.force() - force_ref).norm(), 1e-12);
+    BOOST_CHECK_SMALL((p2.force() + force_ref).norm(), 1e-12);
+  }
+
+  mpi_call_all(mpi_set_collision_mode_local, CollisionModeType::OFF);
+}
+#endif // COLLISION_DETECTION
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  // the test case only works for 2 MPI ranks
+  boost::mpi::communicator world;
+  if (world.size() == 2)
+    return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE deferred runtime error check test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+namespace utf = boost::unit_test;
+
+#include "EspressoSystemStandAlone.hpp"
+#include "MpiCallbacks.hpp"
+#include "bonded_interactions/bonded_interaction_data.hpp"
+#include "bonded_interactions/fene.hpp"
+#include "communication.hpp"
+#include "error_handling/DeferredErrorCheck.hpp"
+#include "errorhandling.hpp"
+#include "integrate.hpp"
+#include "particle_data.hpp"
+#include "particle_node.hpp"
+#include "thermostat.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+/** Number of wrong results of deferred reductions on this node. */
+static int mpi_deferred_reduction_local() {
+  boost::mpi::communicator world;
+  ErrorHandling::DeferredErrorCheck check(world);
+  int n_failures = 0;
+  auto const expect = [&n_failures](bool condition) {
+    n_failures += static_cast<int>(not condition);
+  };
+
+  expect(not check.pending());
+  expect(check.wait() == 0);
+
+  check.start(world.rank() + 1);
+  expect(check.pending());
+  expect(check.wait() == world.size() * (world.size() + 1) / 2);
+  expect(not check.pending());
+  expect(check.wait() == 0);
+
+  /* a reduction in flight is completed by the next one */
+  check.start(1);
+  check.start(static_cast<int>(world.rank() == 0));
+  expect(check.wait() == 1);
+  expect(check.n_started() == 3);
+
+  return n_failures;
+}
+
+REGISTER_CALLBACK_REDUCTION(mpi_deferred_reduction_local, std::plus<int>())
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_AUTO_TEST_CASE(deferred_reduction) {
+  BOOST_CHECK_EQUAL(mpi_call(Communication::Result::reduction,
+                             std::plus<int>(), mpi_deferred_reduction_local),
+                    0);
+}
+
+static void mpi_create_bond_local() {
+  bonded_ia_params.insert(
+      0, std::make_shared<Bonded_IA_Parameters>(FeneBond(0.1, 1.5, 0.)));
+}
+
+REGISTER_CALLBACK(mpi_create_bond_local)
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_AUTO_TEST_CASE(integration_stops_one_step_later) {
+  auto const time_step = 0.01;
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(10.));
+  espresso::system->set_time_step(time_step);
+  espresso::system->set_skin(0.4);
+  mpi_set_thermo_switch(THERMO_OFF);
+  integrate_set_nvt();
+  mpi_call_all(mpi_create_bond_local);
+
+  /* two bonded particles flying apart, the bond breaks after
+   * about 25 time steps and the integration stops with an error */
+  auto const steps_until_error = [time_step](bool deferred) {
+    mpi_set_deferred_error_check(deferred);
+    mpi_set_time(0.);
+    place_particle(0, {4.5, 5., 5.});
+    place_particle(1, {5.5, 5., 5.});
+    set_particle_v(0, {-1., 0., 0.});
+    set_particle_v(1, {1., 0., 0.});
+    add_particle_bond(0, std::vector<int>{0, 1});
+    BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+    BOOST_REQUIRE_GT(mpi_integrate(100, 0), 0);
+    ErrorHandling::mpi_gather_runtime_errors();
+    remove_particle(0);
+    remove_particle(1);
+    return static_cast<int>(std::round(get_sim_time() / time_step));
+  };
+
+  auto const n_steps_blocking = steps_until_error(false);
+  BOOST_CHECK_EQUAL(get_n_deferred_error_checks(), 0);
+  auto const n_steps_deferred = steps_until_error(true);
+  BOOST_CHECK_GT(n_steps_blocking, 10);
+  BOOST_CHECK_LT(n_steps_blocking, 100);
+  BOOST_CHECK_EQUAL(n_steps_deferred, n_steps_blocking + 1);
+  /* the reduction of the last time step is not started */
+  BOOST_CHECK_EQUAL(get_n_deferred_error_checks(), n_steps_deferred - 1);
+  mpi_set_deferred_error_check(false);
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
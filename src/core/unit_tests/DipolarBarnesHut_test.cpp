@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Barnes-Hut dipolar solver test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+namespace utf = boost::unit_test;
+
+#include "config.hpp"
+
+#ifdef DIPOLES
+
+#include "EspressoSystemStandAlone.hpp"
+#include "MpiCallbacks.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "grid.hpp"
+#include "integrate.hpp"
+#include "magnetostatics/barnes_hut.hpp"
+#include "magnetostatics/dipoles.hpp"
+#include "magnetostatics/registration.hpp"
+#include "particle_data.hpp"
+#include "particle_node.hpp"
+#include "thermostat.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+static std::shared_ptr<DipolarBarnesHut> solver;
+
+static void mpi_add_barnes_hut_local(double theta, int leaf_size) {
+  solver = std::make_shared<DipolarBarnesHut>(1.2, theta, leaf_size);
+  Dipoles::add_actor(solver);
+}
+
+static void mpi_remove_barnes_hut_local() {
+  Dipoles::remove_actor(solver);
+  solver.reset();
+}
+
+static double mpi_dipolar_energy_local() {
+  return Dipoles::calc_energy_long_range(cell_structure.local_particles());
+}
+
+REGISTER_CALLBACK(mpi_add_barnes_hut_local)
+REGISTER_CALLBACK(mpi_remove_barnes_hut_local)
+REGISTER_CALLBACK_REDUCTION(mpi_dipolar_energy_local, std::plus<>())
+
+struct Reference {
+  double energy = 0.;
+  std::vector<Utils::Vector3d> forces;
+  std::vector<Utils::Vector3d> torques;
+};
+
+/** Direct summation over all pairs with the minimum image convention. */
+static Reference direct_sum(int n_part, double prefactor) {
+  Reference ref;
+  ref.forces.resize(n_part);
+  ref.torques.resize(n_part);
+  std::vector<Particle> particles;
+  for (int pid = 0; pid < n_part; ++pid) {
+    particles.emplace_back(get_particle_data(pid));
+  }
+  for (int i = 0; i < n_part; ++i) {
+    auto const dip1 = particles[i].calc_dip();
+    for (int j = 0; j < n_part; ++j) {
+      if (i == j) {
+        continue;
+      }
+      auto const dip2 = particles[j].calc_dip();
+      auto const dr = box_geo.get_mi_vector(particles[i].pos(),
+                                            particles[j].pos());
+      auto const r = dr.norm();
+      auto const r3 = r * r * r;
+      auto const r5 = r3 * r * r;
+      auto const pe1 = dip1 * dip2;
+      auto const pe2 = dip1 * dr;
+      auto const pe3 = dip2 * dr;
+      ref.energy += 0.5 * prefactor * (pe1 / r3 - 3. * pe2 * pe3 / r5);
+      ref.forces[i] +=
+          prefactor * ((3. * pe1 / r5 - 15. * pe2 * pe3 / (r5 * r * r)) * dr +
+                       3. * pe3 / r5 * dip1 + 3. * pe2 / r5 * dip2);
+      ref.torques[i] += prefactor * (-vector_product(dip1, dip2) / r3 +
+                                     3. * pe3 / r5 * vector_product(dip1, dr));
+    }
+  }
+  return ref;
+}
+
+/** Root mean square of the force errors, relative to the force magnitude. */
+static double rms_force_error(int n_part, Reference const &ref) {
+  double error = 0.;
+  double norm = 0.;
+  for (int pid = 0; pid < n_part; ++pid) {
+    error += (get_particle_data(pid).force() - ref.forces[pid]).norm2();
+    norm += ref.forces[pid].norm2();
+  }
+  return std::sqrt(error / norm);
+}
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_AUTO_TEST_CASE(barnes_hut) {
+  auto const n_part = 216;
+  auto const box_l = 10.;
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(box_l));
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.4);
+  mpi_set_thermo_switch(THERMO_OFF);
+
+  // dipoles on a jittered lattice with random orientations
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> jitter(-0.3, 0.3);
+  std::normal_distribution<double> normal(0., 1.);
+  for (int pid = 0; pid < n_part; ++pid) {
+    auto const site = Utils::Vector3d{{static_cast<double>(pid % 6),
+                                       static_cast<double>((pid / 6) % 6),
+                                       static_cast<double>(pid / 36)}};
+    place_particle(pid, 1.6 * site + Utils::Vector3d{{0.8 + jitter(rng),
+                                                      0.8 + jitter(rng),
+                                                      0.8 + jitter(rng)}});
+    auto const dip = Utils::Vector3d{{normal(rng), normal(rng), normal(rng)}};
+    set_particle_dip(pid, (1. + 0.2 * jitter(rng)) * dip.normalized());
+  }
+  // a particle without dipole moment is ignored
+  place_particle(n_part, {5., 5., 5.});
+
+  auto const check_exact = [n_part](Reference const &ref) {
+    auto const energy = mpi_call(Communication::Result::reduction,
+                                 std::plus<>(), mpi_dipolar_energy_local);
+    BOOST_CHECK_CLOSE(energy, ref.energy, 1e-9);
+    BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+    for (int pid = 0; pid < n_part; ++pid) {
+      auto const p = get_particle_data(pid);
+      BOOST_CHECK_SMALL((p.force() - ref.forces[pid]).norm(),
+                        1e-10 * (1. + ref.forces[pid].norm()));
+      BOOST_CHECK_SMALL((p.torque() - ref.torques[pid]).norm(),
+                        1e-10 * (1. + ref.torques[pid].norm()));
+    }
+    BOOST_CHECK_EQUAL(get_particle_data(n_part).force().norm(), 0.);
+  };
+
+  for (auto const periodic : {false, true}) {
+    mpi_set_periodicity(periodic, periodic, false);
+    auto const ref = direct_sum(n_part, 1.2);
+
+    // a zero opening angle recovers the direct sum
+    for (auto const leaf_size : {1, 8}) {
+      mpi_call_all(mpi_add_barnes_hut_local, 0., leaf_size);
+      check_exact(ref);
+      mpi_call_all(mpi_remove_barnes_hut_local);
+    }
+
+    // the error decreases with the opening angle
+    auto previous_error = 1.;
+    auto energy = 0.;
+    for (auto const theta : {0.5, 0.3, 0.2, 0.1}) {
+      mpi_call_all(mpi_add_barnes_hut_local, theta, 8);
+      BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+      auto const error = rms_force_error(n_part, ref);
+      BOOST_CHECK_GT(error, 0.);
+      BOOST_CHECK_LT(error, previous_error);
+      previous_error = error;
+      energy = mpi_call(Communication::Result::reduction, std::plus<>(),
+                        mpi_dipolar_energy_local);
+      BOOST_CHECK_SMALL(energy - ref.energy, 0.25 * std::abs(ref.energy));
+      mpi_call_all(mpi_remove_barnes_hut_local);
+    }
+    BOOST_CHECK_LT(previous_error, 1e-3);
+    BOOST_CHECK_CLOSE(energy, ref.energy, 0.2);
+  }
+
+  mpi_set_periodicity(true, true, true);
+  remove_all_particles();
+}
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_AUTO_TEST_CASE(exceptions) {
+  BOOST_CHECK_THROW(DipolarBarnesHut(0., 0.5, 8), std::domain_error);
+  BOOST_CHECK_THROW(DipolarBarnesHut(1., -0.5, 8), std::domain_error);
+  BOOST_CHECK_THROW(DipolarBarnesHut(1., 0.5, 0), std::domain_error);
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
+
+#else // DIPOLES
+int main(int argc, char **argv) {}
+#endif // DIPOLES
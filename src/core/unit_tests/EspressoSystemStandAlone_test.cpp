@@ -33,18 +33,22 @@ namespace utf = boost::unit_test;
 #include "bonded_interactions/bonded_interaction_utils.hpp"
 #include "bonded_interactions/fene.hpp"
 #include "bonded_interactions/harmonic.hpp"
+#include "cells.hpp"
 #include "communication.hpp"
 #include "electrostatics/p3m.hpp"
 #include "electrostatics/registration.hpp"
 #include "energy.hpp"
 #include "galilei.hpp"
+#include "grid.hpp"
 #include "integrate.hpp"
 #include "nonbonded_interactions/lj.hpp"
 #include "observables/ParticleVelocities.hpp"
 #include "particle_data.hpp"
 #include "particle_node.hpp"
+#include "statistics.hpp"
 
 #include <utils/Vector.hpp>
+#include <utils/constants.hpp>
 #include <utils/index.hpp>
 #include <utils/math/int_pow.hpp>
 #include <utils/math/sqr.hpp>
@@ -53,11 +57,14 @@ namespace utf = boost::unit_test;
 #include <boost/range/numeric.hpp>
 #include <boost/variant.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstdlib>
 #include <limits>
 #include <memory>
+#include <stdexcept>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -114,6 +121,38 @@ REGISTER_CALLBACK(mpi_set_tuned_p3m_local)
 static void mpi_set_tuned_p3m(double prefactor) {
   mpi_call_all(mpi_set_tuned_p3m_local, prefactor);
 }
+
+static void
+mpi_set_p3m_differentiation_local(P3MDifferentiation differentiation) {
+  auto const solver = get_actor_by_type<CoulombP3M>(::electrostatics_actor);
+  assert(solver);
+  solver->p3m.differentiation = differentiation;
+  on_coulomb_change();
+}
+
+REGISTER_CALLBACK(mpi_set_p3m_differentiation_local)
+
+static void mpi_set_p3m_differentiation(P3MDifferentiation differentiation) {
+  mpi_call_all(mpi_set_p3m_differentiation_local, differentiation);
+}
+
+static void mpi_calc_p3m_long_range_forces_local() {
+  auto const solver = get_actor_by_type<CoulombP3M>(::electrostatics_actor);
+  assert(solver);
+  auto const particles = cell_structure.local_particles();
+  for (auto &p : particles) {
+    p.force() = {};
+  }
+  solver->charge_assign(particles);
+  solver->add_long_range_forces(particles);
+}
+
+REGISTER_CALLBACK(mpi_calc_p3m_long_range_forces_local)
+
+static void mpi_calc_p3m_long_range_forces() {
+  mpi_call_all(mpi_calc_p3m_long_range_forces_local);
+  invalidate_fetch_cache();
+}
 #endif // P3M
 
 BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
@@ -184,6 +223,108 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
     }
   }
 
+  // check bulk particle updates
+  {
+    auto const pids = std::vector<int>{pid1, pid2, pid3};
+    auto const velocities = std::vector<Utils::Vector3d>{
+        {1., 2., 3.}, {-1., 0., 0.5}, {0., 4., -2.}};
+    auto const mol_ids = std::vector<int>{3, 4, 3};
+    set_particles_v(pids, velocities);
+    set_particles_mol_id(pids, mol_ids);
+    for (std::size_t i = 0; i < pids.size(); ++i) {
+      auto const &p = get_particle_data(pids[i]);
+      BOOST_TEST(p.v() == velocities[i], boost::test_tools::per_element());
+      BOOST_CHECK_EQUAL(p.mol_id(), mol_ids[i]);
+    }
+    BOOST_CHECK_THROW(set_particles_v(pids, {velocities[0]}),
+                      std::invalid_argument);
+    // types are tracked after a bulk update
+    init_type_map(type_a);
+    init_type_map(type_b);
+    set_particles_type({pid1, pid2}, {type_b, type_a});
+    BOOST_CHECK_EQUAL(get_particle_data(pid1).type(), type_b);
+    BOOST_CHECK_EQUAL(get_particle_data(pid2).type(), type_a);
+    BOOST_CHECK_EQUAL(number_of_particles_with_type(type_a), 1);
+    BOOST_CHECK_EQUAL(number_of_particles_with_type(type_b), 2);
+    set_particles_type({pid1, pid2}, {type_a, type_b});
+    set_particles_mol_id(pids, {0, 0, 0});
+  }
+
+  // check distributed analysis
+  {
+    auto const pids = std::vector<int>{pid1, pid2, pid3};
+    std::vector<Particle> particles;
+    for (auto const pid : pids) {
+      particles.emplace_back(get_particle_data(pid));
+    }
+    auto const distance = [](Particle const &p1, Particle const &p2) {
+      return box_geo.get_mi_vector(p1.pos(), p2.pos()).norm();
+    };
+    auto const d12 = distance(particles[0], particles[1]);
+    auto const d13 = distance(particles[0], particles[2]);
+    auto const d23 = distance(particles[1], particles[2]);
+    BOOST_CHECK_CLOSE(mindist({}, {}), std::min({d12, d13, d23}), tol);
+    BOOST_CHECK_CLOSE(mindist({type_a}, {type_b}), std::min(d12, d13), tol);
+    BOOST_CHECK_CLOSE(mindist({type_b}, {type_b}), d23, tol);
+    BOOST_CHECK_EQUAL(mindist({type_a}, {type_a}),
+                      std::numeric_limits<double>::infinity());
+
+    auto const neighbors = nbhood(particles[0].pos(), (d12 + d13) / 2.);
+    auto const neighbors_ref = std::vector<int>{pid2, pid1};
+    BOOST_CHECK_EQUAL_COLLECTIONS(neighbors.begin(), neighbors.end(),
+                                  neighbors_ref.begin(), neighbors_ref.end());
+
+    // closest type_b particle around each type_a particle
+    auto const r_max = 2. * d12;
+    auto const r_bins = 4;
+    double low;
+    std::vector<double> dist(r_bins);
+    calc_part_distribution({type_a}, {type_b}, 0., r_max, r_bins, false, &low,
+                           dist.data());
+    auto const bin = static_cast<int>(std::min(d12, d13) / r_max * r_bins);
+    for (int i = 0; i < r_bins; ++i) {
+      BOOST_CHECK_EQUAL(dist[i], (i == bin) ? 1. : 0.);
+    }
+    BOOST_CHECK_EQUAL(low, 0.);
+
+    // structure factor of the type_b particles
+    auto const order = 2;
+    std::vector<double> wavevectors;
+    std::vector<double> intensities;
+    calc_structurefactor({type_b}, order, wavevectors, intensities);
+    auto const q_unit = 2. * Utils::pi() / box_l;
+    std::vector<double> sf_ref(order * order);
+    std::vector<int> sf_count(order * order);
+    for (int i = 0; i <= order; i++) {
+      for (int j = -order; j <= order; j++) {
+        for (int k = -order; k <= order; k++) {
+          auto const n = i * i + j * j + k * k;
+          if (n >= 1 and n <= order * order) {
+            auto const q = q_unit * Utils::Vector3d{{static_cast<double>(i),
+                                                     static_cast<double>(j),
+                                                     static_cast<double>(k)}};
+            auto const qr2 = q * particles[1].pos();
+            auto const qr3 = q * particles[2].pos();
+            sf_ref[n - 1] += Utils::sqr(std::cos(qr2) + std::cos(qr3)) +
+                             Utils::sqr(std::sin(qr2) + std::sin(qr3));
+            sf_count[n - 1]++;
+          }
+        }
+      }
+    }
+    std::size_t cnt = 0;
+    for (int n = 1; n <= order * order; n++) {
+      if (sf_count[n - 1] != 0) {
+        BOOST_REQUIRE_LT(cnt, intensities.size());
+        BOOST_CHECK_CLOSE(wavevectors[cnt], q_unit * std::sqrt(n), tol);
+        auto const sf = sf_ref[n - 1] / (2. * sf_count[n - 1]);
+        BOOST_CHECK_CLOSE(intensities[cnt], sf, 1e-10);
+        cnt++;
+      }
+    }
+    BOOST_CHECK_EQUAL(cnt, intensities.size());
+  }
+
   // check kinetic energy
   {
     mpi_kill_particle_motion(0);
@@ -260,6 +401,26 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
     BOOST_CHECK_CLOSE(obs_energy->bonded[fene_bond_id], fene_energy, 40. * tol);
   }
 
+  // check energy contributions of particle subsets
+  {
+    BOOST_REQUIRE(particles_energy_contribution_available());
+    auto const E_pot_old = calculate_current_potential_energy_of_system();
+    auto const E_ref_old = particles_energy_contribution({pid2, pid3}, {});
+    // record energies one particle at a time, as done in trial moves
+    auto E_sub_old = particles_energy_contribution({pid2}, {});
+    place_particle(pid2, start_positions.at(pid2) + Utils::Vector3d{5e-4, 0.,
+                                                                   0.});
+    E_sub_old += particles_energy_contribution({pid3}, {pid2});
+    place_particle(pid3, start_positions.at(pid3) + Utils::Vector3d{0., 3e-4,
+                                                                   0.});
+    auto const E_pot_new = calculate_current_potential_energy_of_system();
+    auto const E_sub_new = particles_energy_contribution({pid2, pid3}, {});
+    BOOST_CHECK_CLOSE(E_sub_old, E_ref_old, 1e3 * tol);
+    BOOST_CHECK_GT(std::abs(E_pot_new - E_pot_old), 1e-3);
+    BOOST_CHECK_CLOSE(E_sub_new - E_sub_old, E_pot_new - E_pot_old, 1e5 * tol);
+    reset_particle_positions();
+  }
+
   // check electrostatics
 #ifdef P3M
   {
@@ -270,6 +431,7 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
     // set up P3M
     auto const prefactor = 2.;
     mpi_set_tuned_p3m(prefactor);
+    BOOST_CHECK(particles_energy_contribution_available());
 
     // measure energies
     auto const step = 0.02;
@@ -288,6 +450,49 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
       auto const energy_p3m = obs_energy->coulomb[0] + obs_energy->coulomb[1];
       BOOST_CHECK_CLOSE(energy_p3m, energy_ref, 0.01);
     }
+
+    // check incremental energies of charge changes and moves
+    using PointCharges = std::vector<std::pair<Utils::Vector3d, double>>;
+    auto const pos2_old = get_particle_data(pid2).pos();
+    auto const pos3_old = get_particle_data(pid3).pos();
+    auto const pos2_new = pos2_old + Utils::Vector3d{0., 0.02, 0.01};
+    auto const pos3_new = pos3_old + Utils::Vector3d{0.01, 0., -0.02};
+    set_long_range_energy_reference();
+    {
+      // change pid2 from -1 to -2 and move it, change pid3 from 0 to +1
+      auto const E_pot_old = calculate_current_potential_energy_of_system();
+      auto E_sub_old = particles_energy_contribution({pid2}, {});
+      E_sub_old += particles_energy_contribution({pid3}, {pid2});
+      set_particle_q(pid2, -2.);
+      place_particle(pid2, pos2_new);
+      set_particle_q(pid3, +1.);
+      auto const E_pot_new = calculate_current_potential_energy_of_system();
+      auto const E_sub_new = particles_energy_contribution({pid2, pid3}, {});
+      auto const removed = PointCharges{{pos2_old, -1.}};
+      auto const added = PointCharges{{pos2_new, -2.}, {pos3_old, +1.}};
+      auto const E_long_range = long_range_energy_change(removed, added);
+      BOOST_CHECK_GT(std::abs(E_long_range), 1e-3);
+      BOOST_CHECK_CLOSE(E_sub_new - E_sub_old + E_long_range,
+                        E_pot_new - E_pot_old, 1e6 * tol);
+      update_long_range_energy_reference(removed, added);
+    }
+    {
+      // change pid2 from -2 back to -1, move pid3 and remove its charge
+      auto const E_pot_old = calculate_current_potential_energy_of_system();
+      auto const E_sub_old = particles_energy_contribution({pid2, pid3}, {});
+      set_particle_q(pid2, -1.);
+      place_particle(pid3, pos3_new);
+      set_particle_q(pid3, 0.);
+      auto const E_pot_new = calculate_current_potential_energy_of_system();
+      auto const E_sub_new = particles_energy_contribution({pid2, pid3}, {});
+      auto const removed = PointCharges{{pos2_new, -2.}, {pos3_old, +1.}};
+      auto const added = PointCharges{{pos2_new, -1.}};
+      auto const E_long_range = long_range_energy_change(removed, added);
+      BOOST_CHECK_GT(std::abs(E_long_range), 1e-3);
+      BOOST_CHECK_CLOSE(E_sub_new - E_sub_old + E_long_range,
+                        E_pot_new - E_pot_old, 1e6 * tol);
+    }
+    place_particle(pid3, pos3_old);
   }
 #endif // P3M
 
@@ -348,6 +553,41 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
       }
     }
   }
+
+  // check the analytical differentiation of the P3M forces
+#ifdef P3M
+  {
+    mpi_kill_particle_motion(0);
+    reset_particle_positions();
+    mpi_integrate(0, 0);
+    mpi_calc_p3m_long_range_forces();
+    auto const f1_ik = get_particle_data(pid1).force();
+    auto const f2_ik = get_particle_data(pid2).force();
+
+    mpi_set_p3m_differentiation(P3MDifferentiation::ad);
+    auto const &solver = *get_actor_by_type<CoulombP3M>(electrostatics_actor);
+    BOOST_CHECK(solver.p3m.differentiation == P3MDifferentiation::ad);
+    BOOST_CHECK(solver.p3m.E_mesh[1].empty());
+    BOOST_CHECK_GT(solver.p3m.ad_self_force[0].norm(), 0.);
+    mpi_calc_p3m_long_range_forces();
+    auto const f1_ad = get_particle_data(pid1).force();
+    auto const f2_ad = get_particle_data(pid2).force();
+
+    // both schemes agree within the accuracy of this coarse mesh
+    BOOST_CHECK_GT(f1_ik.norm(), 0.);
+    BOOST_CHECK_SMALL((f1_ad - f1_ik).norm(), 5e-2 * f1_ik.norm());
+    BOOST_CHECK_SMALL((f2_ad - f2_ik).norm(), 5e-2 * f2_ik.norm());
+    // only the ik-differentiation conserves momentum exactly
+    BOOST_CHECK_SMALL((f1_ik + f2_ik).norm(), tol);
+    // the self-force of a single charge is subtracted
+    set_particle_q(pid2, 0.);
+    mpi_calc_p3m_long_range_forces();
+    BOOST_CHECK_SMALL(get_particle_data(pid1).force().norm(),
+                      1e-3 * f1_ik.norm());
+    set_particle_q(pid2, -1.);
+    mpi_set_p3m_differentiation(P3MDifferentiation::ik);
+  }
+#endif // P3M
 }
 
 int main(int argc, char **argv) {
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Morton order of cells and particles test
+
+#include "config.hpp"
+
+#ifdef LENNARD_JONES
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+namespace utf = boost::unit_test;
+
+#include "EspressoSystemStandAlone.hpp"
+#include "MpiCallbacks.hpp"
+#include "Particle.hpp"
+#include "ParticleFactory.hpp"
+#include "cell_system/RegularDecomposition.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "grid.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "particle_node.hpp"
+#include "thermostat.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/as_const.hpp>
+#include <utils/index.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+static void mpi_set_cell_order_local(bool morton_order, int sort_interval) {
+  cell_structure.use_morton_order = morton_order;
+  cell_structure.particle_sort_interval = sort_interval;
+  cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+}
+
+REGISTER_CALLBACK(mpi_set_cell_order_local)
+
+/** Number of local cells and particles which are out of Morton order. */
+static int mpi_count_unordered_local() {
+  auto const &rd = dynamic_cast<RegularDecomposition const &>(
+      Utils::as_const(cell_structure).decomposition());
+  auto const cells = rd.get_local_cells();
+  auto const n_grid_points = 1 << 21;
+  auto const particle_key = [n_grid_points](Particle const &p) {
+    Utils::Vector3i ind;
+    for (int i = 0; i < 3; i++) {
+      ind[i] = static_cast<int>(p.pos()[i] * box_geo.length_inv()[i] *
+                                static_cast<double>(n_grid_points));
+    }
+    return Utils::morton_index(ind);
+  };
+
+  int n_unordered = 0;
+  for (std::size_t i = 1; i < cells.size(); ++i) {
+    if (Utils::morton_index(rd.cell_index(cells[i - 1])) >
+        Utils::morton_index(rd.cell_index(cells[i]))) {
+      ++n_unordered;
+    }
+  }
+  for (auto const cell : cells) {
+    auto const &particles = cell->particles();
+    for (auto it = particles.begin(); it != particles.end(); ++it) {
+      if (it != particles.begin() and
+          particle_key(*std::prev(it)) > particle_key(*it)) {
+        ++n_unordered;
+      }
+    }
+  }
+  return n_unordered;
+}
+
+REGISTER_CALLBACK_REDUCTION(mpi_count_unordered_local, std::plus<>())
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_FIXTURE_TEST_CASE(morton_order, ParticleFactory) {
+  auto const box_l = 6.;
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(box_l));
+  espresso::system->set_node_grid({2, 1, 1});
+  espresso::system->set_time_step(0.001);
+  espresso::system->set_skin(0.1);
+  mpi_set_thermo_switch(THERMO_OFF);
+  integrate_set_nvt();
+  lennard_jones_set_params(0, 0, 1., 0.25, 0.5, 0., 0., 0.);
+  mpi_call_all(mpi_set_cell_order_local, false, 0);
+
+  // particles on a jittered lattice, inserted in random order
+  auto const n_part = 1000;
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> jitter(-0.1, 0.1);
+  std::vector<int> sites(n_part);
+  std::iota(sites.begin(), sites.end(), 0);
+  std::shuffle(sites.begin(), sites.end(), rng);
+  for (int pid = 0; pid < n_part; ++pid) {
+    auto const site = Utils::Vector3d{
+        {static_cast<double>(sites[pid] % 10),
+         static_cast<double>((sites[pid] / 10) % 10),
+         static_cast<double>(sites[pid] / 100)}};
+    create_particle(0.6 * site + Utils::Vector3d{{0.3 + jitter(rng),
+                                                  0.3 + jitter(rng),
+                                                  0.3 + jitter(rng)}},
+                    pid, 0);
+  }
+  auto const forces = [n_part]() {
+    std::vector<Utils::Vector3d> result;
+    for (int pid = 0; pid < n_part; ++pid) {
+      result.emplace_back(get_particle_data(pid).force());
+    }
+    return result;
+  };
+  auto const check_forces = [&](std::vector<Utils::Vector3d> const &ref) {
+    auto const values = forces();
+    for (std::size_t i = 0; i < ref.size(); ++i) {
+      BOOST_CHECK_SMALL((values[i] - ref[i]).norm(),
+                        1e-10 * (1. + ref[i].norm()));
+    }
+  };
+
+  // reference in row-major cell order and insertion order
+  BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+  auto const forces_ref = forces();
+  BOOST_REQUIRE_GT(mpi_call(Communication::Result::reduction, std::plus<>(),
+                            mpi_count_unordered_local),
+                   0);
+
+  // cells and particles follow the curve after the next resort
+  mpi_call_all(mpi_set_cell_order_local, true, 1);
+  BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+  BOOST_CHECK_EQUAL(mpi_call(Communication::Result::reduction, std::plus<>(),
+                             mpi_count_unordered_local),
+                    0);
+  check_forces(forces_ref);
+
+  // particles entering a cell are sorted in on the next resort
+  for (int pid = 0; pid < n_part; pid += 10) {
+    auto const pos = get_particle_data(pid).pos();
+    place_particle(pid, {box_l - pos[0], pos[1], pos[2]});
+  }
+  BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+  BOOST_CHECK_EQUAL(mpi_call(Communication::Result::reduction, std::plus<>(),
+                             mpi_count_unordered_local),
+                    0);
+  mpi_call_all(mpi_set_cell_order_local, false, 0);
+  BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+  auto const forces_moved = forces();
+  mpi_call_all(mpi_set_cell_order_local, true, 1);
+  BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+  check_forces(forces_moved);
+
+  mpi_call_all(mpi_set_cell_order_local, false, 0);
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  // the test case only works for 2 MPI ranks
+  boost::mpi::communicator world;
+  if (world.size() == 2)
+    return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
+#else // ifdef LENNARD_JONES
+int main(int argc, char **argv) {}
+#endif
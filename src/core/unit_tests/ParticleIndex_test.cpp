@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE ParticleIndex
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "Particle.hpp"
+#include "cell_system/ParticleIndex.hpp"
+
+#include <cstddef>
+#include <map>
+#include <random>
+#include <vector>
+
+/* Check the index against a reference map. */
+static void check_index(ParticleIndex const &index,
+                        std::map<int, Particle *> const &reference) {
+  BOOST_REQUIRE_EQUAL(index.size(), reference.size());
+  for (auto const &kv : reference) {
+    BOOST_REQUIRE_EQUAL(index.find(kv.first), kv.second);
+  }
+  BOOST_CHECK_EQUAL(index.max_id(),
+                    reference.empty() ? -1 : reference.rbegin()->first);
+  std::map<int, Particle *> entries;
+  index.for_each([&entries](int id, Particle *p) { entries[id] = p; });
+  BOOST_CHECK(entries == reference);
+}
+
+BOOST_AUTO_TEST_CASE(dense_ids) {
+  std::vector<Particle> particles(3000);
+  ParticleIndex index;
+  std::map<int, Particle *> reference;
+  BOOST_CHECK_EQUAL(index.max_id(), -1);
+  BOOST_CHECK(index.find(0) == nullptr);
+  BOOST_CHECK(index.find(12345) == nullptr);
+
+  for (int id = 0; id < 3000; ++id) {
+    index.set(id, &particles[id]);
+    reference[id] = &particles[id];
+  }
+  check_index(index, reference);
+  /* consecutive ids are all kept in the dense array */
+  BOOST_CHECK_LE(index.capacity(), 2u * particles.size());
+
+  for (int id = 0; id < 3000; id += 3) {
+    index.set(id, nullptr);
+    reference.erase(id);
+  }
+  index.set(2999, nullptr);
+  reference.erase(2999);
+  check_index(index, reference);
+  BOOST_CHECK(index.find(3) == nullptr);
+  BOOST_CHECK(index.find(4) == &particles[4]);
+
+  index.clear();
+  BOOST_CHECK_EQUAL(index.size(), 0u);
+  BOOST_CHECK_EQUAL(index.capacity(), 0u);
+  BOOST_CHECK(index.find(4) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(sparse_ids) {
+  std::vector<Particle> particles(100);
+  ParticleIndex index;
+  std::map<int, Particle *> reference;
+
+  /* large ids do not allocate memory up to the id */
+  for (int i = 0; i < 100; ++i) {
+    auto const id = 2000000000 - 1000 * i;
+    index.set(id, &particles[i]);
+    reference[id] = &particles[i];
+  }
+  check_index(index, reference);
+  BOOST_CHECK_LE(index.capacity(), 4u * particles.size());
+  BOOST_CHECK(index.find(0) == nullptr);
+  BOOST_CHECK(index.find(2000000001) == nullptr);
+  BOOST_CHECK(index.find(1999999999) == nullptr);
+
+  /* small ids still go to the dense array */
+  index.set(7, &particles[0]);
+  reference[7] = &particles[0];
+  check_index(index, reference);
+  BOOST_CHECK_LE(index.capacity(), 1024u + 4u * particles.size());
+}
+
+BOOST_AUTO_TEST_CASE(random_updates) {
+  std::vector<Particle> particles(16);
+  ParticleIndex index;
+  std::map<int, Particle *> reference;
+  std::mt19937 rng(42);
+  /* ids from a dense range, a sparse range and close to the maximum */
+  std::uniform_int_distribution<int> range(0, 2);
+  std::uniform_int_distribution<int> dense(0, 5000);
+  std::uniform_int_distribution<int> sparse(0, 1000000);
+  std::uniform_int_distribution<int> high(2147483000, 2147483647);
+  std::uniform_int_distribution<std::size_t> particle(0, 15);
+  std::bernoulli_distribution remove(0.4);
+
+  for (int step = 0; step < 20000; ++step) {
+    auto const r = range(rng);
+    auto const id = (r == 0) ? dense(rng) : (r == 1) ? sparse(rng) : high(rng);
+    if (remove(rng)) {
+      index.set(id, nullptr);
+      reference.erase(id);
+    } else {
+      auto const p = &particles[particle(rng)];
+      index.set(id, p);
+      reference[id] = p;
+    }
+    if (step % 1000 == 0) {
+      check_index(index, reference);
+    }
+  }
+  check_index(index, reference);
+
+  /* removing all entries leaves an empty index */
+  auto const ids = [&reference]() {
+    std::vector<int> result;
+    for (auto const &kv : reference) {
+      result.push_back(kv.first);
+    }
+    return result;
+  }();
+  for (auto const id : ids) {
+    index.set(id, nullptr);
+    reference.erase(id);
+  }
+  check_index(index, reference);
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE multiple time step integrator test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+namespace utf = boost::unit_test;
+
+#include "EspressoSystemStandAlone.hpp"
+#include "integrate.hpp"
+#include "integrators/respa.hpp"
+#include "particle_data.hpp"
+#include "particle_node.hpp"
+#include "thermostat.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <memory>
+#include <stdexcept>
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_AUTO_TEST_CASE(long_range_schedule) {
+  integrate_set_nvt();
+  BOOST_CHECK(not respa_active());
+
+  integrate_set_nvt(3, false);
+  BOOST_CHECK(respa_active());
+  BOOST_CHECK_EQUAL(respa_get_parameters().long_range_interval, 3);
+  BOOST_CHECK_EQUAL(respa_long_range_scale(), 3.);
+
+  /* long-range forces are evaluated in every third force calculation */
+  respa_start_integration();
+  respa_reset_phase();
+  for (int i = 0; i < 7; ++i) {
+    BOOST_CHECK_EQUAL(respa_long_range_step(), i % 3 == 0);
+  }
+  BOOST_CHECK_EQUAL(respa_get_diagnostics().n_long_range_evaluations, 3);
+
+  /* a reset starts a new outer time step */
+  respa_reset_phase();
+  BOOST_CHECK(respa_long_range_step());
+
+  /* other integrators evaluate the long-range forces in every step */
+  integrate_set_bd();
+  BOOST_CHECK(not respa_active());
+
+  BOOST_CHECK_THROW(integrate_set_nvt(0, false), std::runtime_error);
+  integrate_set_nvt();
+}
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_AUTO_TEST_CASE(outer_time_steps) {
+  auto const time_step = 0.01;
+  auto const v = Utils::Vector3d{1., 2., 0.};
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(10.));
+  espresso::system->set_time_step(time_step);
+  espresso::system->set_skin(0.4);
+  mpi_set_thermo_switch(THERMO_OFF);
+  integrate_set_nvt(3, true);
+
+  place_particle(0, {1., 2., 3.});
+  set_particle_v(0, v);
+  BOOST_REQUIRE_EQUAL(mpi_integrate(10, 0), 0);
+
+  /* the initial force calculation and time steps 3, 6 and 9 complete an
+   * outer time step */
+  auto const &diagnostics = respa_get_diagnostics();
+  BOOST_CHECK_EQUAL(diagnostics.n_long_range_evaluations, 4);
+  BOOST_CHECK_EQUAL(diagnostics.n_outer_steps, 3);
+  auto const kinetic_energy = 0.5 * v.norm2();
+  BOOST_CHECK_CLOSE(diagnostics.energy_start, kinetic_energy, 1e-10);
+  BOOST_CHECK_CLOSE(diagnostics.energy_end, kinetic_energy, 1e-10);
+
+  /* without long-range forces, the trajectory is the one of the
+   * single time step integrator */
+  auto const p = get_particle_data(0);
+  auto const expected = Utils::Vector3d{1., 2., 3.} + 10. * time_step * v;
+  BOOST_CHECK_SMALL((p.pos() - expected).norm(), 1e-12);
+
+  /* the forces are reused, the outer time step continues */
+  BOOST_REQUIRE_EQUAL(mpi_integrate(2, 0), 0);
+  BOOST_CHECK_EQUAL(diagnostics.n_long_range_evaluations, 1);
+  BOOST_CHECK_EQUAL(diagnostics.n_outer_steps, 0);
+
+  remove_particle(0);
+  integrate_set_nvt();
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
@@ -33,8 +33,11 @@ namespace utf = boost::unit_test;
 namespace bdata = boost::unit_test::data;
 
 #include "EspressoSystemStandAlone.hpp"
+#include "MpiCallbacks.hpp"
 #include "Particle.hpp"
 #include "ParticleFactory.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
 #include "integrate.hpp"
 #include "nonbonded_interactions/lj.hpp"
 #include "particle_node.hpp"
@@ -123,6 +126,18 @@ struct : public IntegratorHelper {
 #endif // NPT
 } // namespace Testing
 
+static void mpi_set_use_soa_local(bool use_soa) {
+  cell_structure.use_soa = use_soa;
+}
+
+REGISTER_CALLBACK(mpi_set_use_soa_local)
+
+static void mpi_set_use_ghost_overlap_local(bool use_ghost_overlap) {
+  cell_structure.use_ghost_overlap = use_ghost_overlap;
+}
+
+REGISTER_CALLBACK(mpi_set_use_ghost_overlap_local)
+
 inline double get_dist_from_last_verlet_update(Particle const &p) {
   return (p.pos() - p.pos_at_last_verlet_update()).norm();
 }
@@ -139,11 +154,22 @@ auto const propagators =
         Testing::velocity_verlet_npt,
 #endif
         Testing::steepest_descent};
+/** The structure-of-arrays force loop and the overlap of the ghost
+ *  communication are bypassed by the NpT integrator. */
+auto const soa_propagators =
+    std::vector<std::reference_wrapper<Testing::IntegratorHelper>>{
+        Testing::velocity_verlet, Testing::steepest_descent};
 
 BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
-BOOST_DATA_TEST_CASE_F(ParticleFactory, verlet_list_update,
-                       bdata::make(node_grids) * bdata::make(propagators),
-                       node_grid, integration_helper) {
+BOOST_DATA_TEST_CASE_F(
+    ParticleFactory, verlet_list_update,
+    bdata::make(node_grids) * bdata::make(propagators) * bdata::make({false}) *
+            bdata::make({false}) +
+        bdata::make(node_grids) * bdata::make(soa_propagators) *
+            bdata::make({true}) * bdata::make({false}) +
+        bdata::make(node_grids) * bdata::make(soa_propagators) *
+            bdata::make({false, true}) * bdata::make({true}),
+    node_grid, integration_helper, use_soa, use_ghost_overlap) {
   constexpr auto tol = 100. * std::numeric_limits<double>::epsilon();
   boost::mpi::communicator world;
 
@@ -174,6 +200,8 @@ BOOST_DATA_TEST_CASE_F(ParticleFactory, verlet_list_update,
   espresso::system->set_time_step(time_step);
   espresso::system->set_skin(skin);
   integration_helper.get().set_integrator();
+  mpi_call_all(mpi_set_use_soa_local, use_soa);
+  mpi_call_all(mpi_set_use_ghost_overlap_local, use_ghost_overlap);
 
   // If the Verlet list is not updated, two particles initially placed in
   // different cells will never see each other, even when closer than the
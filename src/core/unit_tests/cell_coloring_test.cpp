@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE cell coloring test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "algorithm/cell_coloring.hpp"
+#include "algorithm/link_cell.hpp"
+
+#include "Particle.hpp"
+#include "cell_system/Cell.hpp"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+/** Cubic grid of cells with a half-shell of red neighbors. */
+std::vector<Cell> make_cell_grid(int n, int n_part_per_cell) {
+  std::vector<Cell> cells(n * n * n);
+  auto const index = [n](int i, int j, int k) { return (i * n + j) * n + k; };
+
+  auto id = 0;
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++)
+      for (int k = 0; k < n; k++) {
+        auto &cell = cells[index(i, j, k)];
+        std::vector<Cell *> red;
+        std::vector<Cell *> black;
+        for (int di = -1; di <= 1; di++)
+          for (int dj = -1; dj <= 1; dj++)
+            for (int dk = -1; dk <= 1; dk++) {
+              auto const ni = i + di, nj = j + dj, nk = k + dk;
+              if (ni < 0 or nj < 0 or nk < 0 or ni >= n or nj >= n or nk >= n)
+                continue;
+              auto const m = index(ni, nj, nk);
+              if (m > index(i, j, k))
+                red.push_back(&cells[m]);
+              else if (m < index(i, j, k))
+                black.push_back(&cells[m]);
+            }
+        cell.m_neighbors = Neighbors<Cell *>(red, black);
+        cell.particles().resize(n_part_per_cell);
+        for (auto &p : cell.particles()) {
+          p.id() = id++;
+        }
+      }
+
+  return cells;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(coloring) {
+  auto cells = make_cell_grid(4, 1);
+  auto const colors = Algorithm::color_cells(cells.begin(), cells.end());
+
+  /* every cell has exactly one color */
+  std::multiset<Cell *> colored;
+  for (auto const &color : colors) {
+    colored.insert(color.begin(), color.end());
+  }
+  BOOST_REQUIRE_EQUAL(colored.size(), cells.size());
+  for (auto &cell : cells) {
+    BOOST_CHECK_EQUAL(colored.count(&cell), 1);
+  }
+
+  /* cells of the same color do not write to the same cells */
+  for (auto const &color : colors) {
+    std::set<Cell *> written;
+    for (auto const cell : color) {
+      BOOST_CHECK(written.insert(cell).second);
+      for (auto const neighbor : cell->neighbors().red()) {
+        BOOST_CHECK(written.insert(neighbor).second);
+      }
+    }
+  }
+
+  /* a half shell in 3D needs at least 8 colors */
+  BOOST_CHECK_GE(colors.size(), 8);
+}
+
+BOOST_AUTO_TEST_CASE(colored_link_cell) {
+  auto cells = make_cell_grid(4, 3);
+  auto const colors = Algorithm::color_cells(cells.begin(), cells.end());
+
+  auto const sorted_pair = [](Particle const &p1, Particle const &p2) {
+    return std::make_pair(std::min(p1.id(), p2.id()),
+                          std::max(p1.id(), p2.id()));
+  };
+
+  std::vector<std::pair<int, int>> lc_pairs;
+  Algorithm::link_cell(cells.begin(), cells.end(),
+                       [&](Particle const &p1, Particle const &p2) {
+                         lc_pairs.emplace_back(sorted_pair(p1, p2));
+                       });
+
+  std::vector<std::vector<std::pair<int, int>>> cell_pairs(cells.size());
+  Algorithm::for_each_colored_cell(colors, [&](Cell &cell) {
+    auto &pairs = cell_pairs[&cell - cells.data()];
+    Algorithm::link_cell(&cell, &cell + 1,
+                         [&](Particle const &p1, Particle const &p2) {
+                           pairs.emplace_back(sorted_pair(p1, p2));
+                         });
+  });
+
+  std::vector<std::pair<int, int>> colored_pairs;
+  for (auto const &pairs : cell_pairs) {
+    colored_pairs.insert(colored_pairs.end(), pairs.begin(), pairs.end());
+  }
+
+  std::sort(lc_pairs.begin(), lc_pairs.end());
+  std::sort(colored_pairs.begin(), colored_pairs.end());
+  BOOST_CHECK(lc_pairs == colored_pairs);
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE distributed real-to-complex FFT test
+
+#include "config.hpp"
+
+#if defined(P3M) || defined(DP3M)
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+
+#include "p3m/fft.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/constants.hpp>
+#include <utils/index.hpp>
+#include <utils/mpi/cart_comm.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <functional>
+#include <vector>
+
+namespace {
+/** Value of the real test mesh at a global mesh point. */
+double mesh_value(Utils::Vector3i const &n, int seed = 0) {
+  return std::cos(0.37 * n[0] + 1.1 * n[1] * n[1] - 0.3 * n[2] + seed) +
+         0.1 * ((n[0] + 2 * n[1] + 3 * n[2] + seed) % 7);
+}
+
+/** FFT of a mesh with mixed even and odd sizes on a Cartesian node grid. */
+struct FFTSetup {
+  boost::mpi::communicator comm;
+  Utils::Vector3i node_grid;
+  Utils::Vector3i mesh = {{8, 12, 9}};
+  Utils::Vector3i local_mesh{};
+  Utils::Vector3i local_start{};
+  fft_data_struct fft;
+  int ks_pnum;
+  int mesh_size;
+
+  FFTSetup() {
+    boost::mpi::communicator world;
+    node_grid = Utils::Mpi::dims_create<3>(world.size());
+    comm = Utils::Mpi::cart_create(world, node_grid, false);
+    auto const node_pos = Utils::Mpi::cart_coords<3>(comm, comm.rank());
+    for (int i = 0; i < 3; i++) {
+      local_mesh[i] = mesh[i] / node_grid[i];
+      local_start[i] = local_mesh[i] * node_pos[i];
+    }
+    int const margin[6] = {0, 0, 0, 0, 0, 0};
+    mesh_size = fft_init(local_mesh, margin, mesh, Utils::Vector3d{}, ks_pnum,
+                         fft, node_grid, comm);
+  }
+
+  /** Local real-space mesh filled with @ref mesh_value. */
+  fft_vector<double> make_mesh(int seed) const {
+    fft_vector<double> data(mesh_size);
+    Utils::Vector3i n{};
+    for (n[0] = 0; n[0] < local_mesh[0]; n[0]++) {
+      for (n[1] = 0; n[1] < local_mesh[1]; n[1]++) {
+        for (n[2] = 0; n[2] < local_mesh[2]; n[2]++) {
+          auto const ind = Utils::get_linear_index(
+              n, local_mesh, Utils::MemoryOrder::ROW_MAJOR);
+          data[ind] = mesh_value(n + local_start, seed);
+        }
+      }
+    }
+    return data;
+  }
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(forward_and_backward_transform) {
+  FFTSetup setup;
+  auto const &comm = setup.comm;
+  auto const &mesh = setup.mesh;
+  auto const &local_mesh = setup.local_mesh;
+  auto const &local_start = setup.local_start;
+  auto &fft = setup.fft;
+  auto const ks_pnum = setup.ks_pnum;
+  auto const n_points = Utils::product(mesh);
+
+  // the k-space mesh only holds half of the spectrum
+  BOOST_CHECK_EQUAL(fft.hermitian_mesh,
+                    mesh[(fft.hermitian_dir + ks_pnum) % 3]);
+  auto n_k_points = 0;
+  boost::mpi::all_reduce(comm, fft.plan[3].new_size, n_k_points,
+                         std::plus<>());
+  BOOST_CHECK_EQUAL(n_k_points, n_points / fft.hermitian_mesh *
+                                    (fft.hermitian_mesh / 2 + 1));
+
+  auto data = setup.make_mesh(0);
+  auto sum_r2 = 0.;
+  for (int i = 0; i < Utils::product(local_mesh); i++) {
+    sum_r2 += data[i] * data[i];
+  }
+
+  fft_perform_forw(data.data(), fft, comm);
+
+  /* compare with a direct evaluation of the discrete Fourier transform */
+  auto sum_k2 = 0.;
+  int j[3];
+  int ind = 0;
+  for (j[0] = 0; j[0] < fft.plan[3].new_mesh[0]; j[0]++) {
+    for (j[1] = 0; j[1] < fft.plan[3].new_mesh[1]; j[1]++) {
+      for (j[2] = 0; j[2] < fft.plan[3].new_mesh[2]; j[2]++) {
+        Utils::Vector3i k{};
+        for (int d = 0; d < 3; d++) {
+          k[(d + ks_pnum) % 3] = j[d] + fft.plan[3].start[d];
+        }
+        std::complex<double> ref = 0.;
+        Utils::Vector3i r{};
+        for (r[0] = 0; r[0] < mesh[0]; r[0]++) {
+          for (r[1] = 0; r[1] < mesh[1]; r[1]++) {
+            for (r[2] = 0; r[2] < mesh[2]; r[2]++) {
+              auto phase = 0.;
+              for (int d = 0; d < 3; d++) {
+                phase -= 2. * Utils::pi() * k[d] * r[d] / mesh[d];
+              }
+              ref += mesh_value(r) * std::polar(1., phase);
+            }
+          }
+        }
+        BOOST_CHECK_SMALL(std::abs(ref - std::complex<double>(
+                                             data[2 * ind], data[2 * ind + 1])),
+                          1e-9);
+        sum_k2 += fft.hermitian_weight(ind) *
+                  (data[2 * ind] * data[2 * ind] +
+                   data[2 * ind + 1] * data[2 * ind + 1]);
+        ind++;
+      }
+    }
+  }
+
+  /* Parseval's theorem holds for the weighted half spectrum */
+  sum_r2 = boost::mpi::all_reduce(comm, sum_r2, std::plus<>());
+  sum_k2 = boost::mpi::all_reduce(comm, sum_k2, std::plus<>());
+  BOOST_CHECK_CLOSE(sum_k2, n_points * sum_r2, 1e-9);
+
+  /* the backward transform restores the mesh, up to normalization */
+  fft_perform_back(data.data(), fft, comm);
+  Utils::Vector3i n{};
+  for (n[0] = 0; n[0] < local_mesh[0]; n[0]++) {
+    for (n[1] = 0; n[1] < local_mesh[1]; n[1]++) {
+      for (n[2] = 0; n[2] < local_mesh[2]; n[2]++) {
+        auto const ind = Utils::get_linear_index(n, local_mesh,
+                                                Utils::MemoryOrder::ROW_MAJOR);
+        BOOST_CHECK_SMALL(data[ind] / n_points - mesh_value(n + local_start),
+                          1e-12);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(batched_transforms) {
+  FFTSetup setup;
+  auto const n_points = Utils::product(setup.mesh);
+  auto const n_local = Utils::product(setup.local_mesh);
+
+  std::vector<fft_vector<double>> meshes;
+  for (int seed = 0; seed < 3; seed++) {
+    meshes.emplace_back(setup.make_mesh(seed));
+  }
+  std::array<double *, 3> data = {
+      {meshes[0].data(), meshes[1].data(), meshes[2].data()}};
+
+  /* transforming meshes together is the same as one at a time */
+  fft_perform_forw(Utils::make_span(data), setup.fft, setup.comm);
+  for (int seed = 0; seed < 3; seed++) {
+    auto ref = setup.make_mesh(seed);
+    fft_perform_forw(ref.data(), setup.fft, setup.comm);
+    for (int i = 0; i < 2 * setup.fft.plan[3].new_size; i++) {
+      BOOST_CHECK_SMALL(meshes[seed][i] - ref[i], 1e-12 * n_points);
+    }
+  }
+
+  fft_perform_back(Utils::make_span(data), setup.fft, setup.comm);
+  for (int seed = 0; seed < 3; seed++) {
+    auto const ref = setup.make_mesh(seed);
+    for (int i = 0; i < n_local; i++) {
+      BOOST_CHECK_SMALL(meshes[seed][i] / n_points - ref[i], 1e-12);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  boost::mpi::environment mpi_env(argc, argv);
+
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
+#else // defined(P3M) || defined(DP3M)
+int main(int argc, char **argv) {}
+#endif
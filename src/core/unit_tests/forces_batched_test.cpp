@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE batched force kernel test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "config.hpp"
+
+#include "BoxGeometry.hpp"
+#include "Particle.hpp"
+#include "cell_system/ParticleSoA.hpp"
+#include "cell_system/VerletListCSR.hpp"
+#include "electrostatics/coulomb_inline.hpp"
+#include "forces_batched.hpp"
+#include "forces_inline.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/constants.hpp>
+#include <utils/math/AS_erfc_part.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(minimum_image) {
+  auto const box_l = 3.;
+  BoxGeometry box;
+  box.set_length({box_l, box_l, box_l});
+  box.set_periodic(2, false);
+
+  auto const n = 1000;
+  for (int i = -n; i <= n; ++i) {
+    // skip the ambiguous case of a distance of exactly half a box length
+    auto const dx = 1.4 * box_l * (i + 0.1) / n;
+    for (unsigned int k = 0; k < 3; ++k) {
+      auto const periodic_length = box.periodic(k) ? box.length()[k] : 0.;
+      BOOST_CHECK_EQUAL(detail::batched_mi_coord(dx, periodic_length,
+                                                 box.length_half()[k]),
+                        box.get_mi_coord(dx, 0., k));
+    }
+  }
+}
+
+#if defined(LENNARD_JONES) && defined(WCA)
+BOOST_AUTO_TEST_CASE(batched_kernel) {
+  auto const box_l = 6.;
+  BoxGeometry box;
+  box.set_length({box_l, box_l, box_l});
+
+  make_particle_type_exist_local(2);
+  {
+    auto &lj = get_ia_param(0, 0)->lj;
+    lj.eps = 1.;
+    lj.sig = 1.;
+    lj.cut = 2.5;
+    lj.offset = 0.1;
+  }
+  {
+    auto &lj = get_ia_param(0, 1)->lj;
+    lj.eps = 0.5;
+    lj.sig = 0.9;
+    lj.cut = 2.;
+    lj.min = 0.2;
+  }
+  {
+    auto &wca = get_ia_param(1, 1)->wca;
+    wca.eps = 1.;
+    wca.sig = 1.;
+    wca.cut = std::pow(2., 1. / 6.);
+  }
+  {
+    auto &ia_params = *get_ia_param(1, 2);
+    ia_params.lj.eps = 1.;
+    ia_params.lj.sig = 0.8;
+    ia_params.lj.cut = 2.;
+    ia_params.wca.eps = 2.;
+    ia_params.wca.sig = 1.;
+    ia_params.wca.cut = std::pow(2., 1. / 6.);
+  }
+  get_ia_param(2, 2)->lj = get_ia_param(0, 0)->lj;
+  maximal_cutoff_nonbonded();
+  // pairs of this type are handed to the fallback kernel
+  get_ia_param(0, 2)->lj = get_ia_param(0, 1)->lj;
+  get_ia_param(0, 2)->lj_wca_only = false;
+
+  auto const cutoff = 3.;
+  auto const erfc_params = Coulomb::RealSpaceErfcParameters{2., 1.2, cutoff};
+  auto const coulomb_kernel = Coulomb::ShortRangeForceKernel::kernel_type{
+      [&erfc_params](double q1q2, Utils::Vector3d const &d, double dist) {
+        auto const adist = erfc_params.alpha * dist;
+        auto const erfc_part_ri = Utils::AS_erfc_part(adist) / dist;
+        auto const fac =
+            std::exp(-adist * adist) *
+            (erfc_part_ri + 2. * erfc_params.alpha * Utils::sqrt_pi_i()) /
+            (dist * dist);
+        return (fac * erfc_params.prefactor * q1q2) * d;
+      }};
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> coordinate(0., box_l);
+  std::vector<Particle> particles(300);
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    auto &p = particles[i];
+    p.id() = static_cast<int>(i);
+    p.type() = static_cast<int>(i % 3);
+    p.pos() = {coordinate(rng), coordinate(rng), coordinate(rng)};
+#ifdef ELECTROSTATICS
+    p.q() = (i % 2) ? 1. : -0.5;
+#endif
+  }
+  auto particles_ref = particles;
+
+  auto particles_csr = particles;
+
+  ParticleSoA soa;
+  ParticleSoA soa_ref;
+  ParticleSoA soa_csr;
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    soa.push_back(particles[i]);
+    soa_ref.push_back(particles_ref[i]);
+    soa_csr.push_back(particles_csr[i]);
+  }
+
+  // partners in a compressed Verlet list, with a skin
+  auto const verlet_cutoff = cutoff + 0.4;
+  VerletListCSR verlet_list;
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    for (std::size_t j = i + 1; j < particles.size(); ++j) {
+      auto const d = box.get_mi_vector(particles[i].pos(), particles[j].pos());
+      if (d.norm() <= verlet_cutoff) {
+        verlet_list.add_partner(j);
+      }
+    }
+    verlet_list.next_particle();
+  }
+  BOOST_REQUIRE_EQUAL(verlet_list.n_particles(), particles.size());
+
+  BatchedPairTable const table{};
+  auto const n = soa.size();
+  for (std::size_t i = 0; i < n; ++i) {
+    auto const partners = SoAIndexRange{i + 1, n};
+    add_non_bonded_pair_forces_batched(soa, i, partners, box, cutoff * cutoff,
+                                       table, &erfc_params, &coulomb_kernel);
+    add_non_bonded_pair_forces_soa(soa_ref, i, partners, box, cutoff * cutoff,
+                                   &coulomb_kernel);
+    add_non_bonded_pair_forces_batched(soa_csr, i, verlet_list.partners(i),
+                                       box, cutoff * cutoff, table,
+                                       &erfc_params, &coulomb_kernel);
+  }
+
+  auto f_max = 0.;
+  for (std::size_t i = 0; i < n; ++i) {
+    auto const force = particles[i].force() +
+                       Utils::Vector3d{soa.force[0][i], soa.force[1][i],
+                                       soa.force[2][i]};
+    auto const force_ref =
+        particles_ref[i].force() +
+        Utils::Vector3d{soa_ref.force[0][i], soa_ref.force[1][i],
+                        soa_ref.force[2][i]};
+    auto const force_csr =
+        particles_csr[i].force() +
+        Utils::Vector3d{soa_csr.force[0][i], soa_csr.force[1][i],
+                        soa_csr.force[2][i]};
+    BOOST_CHECK_SMALL((force - force_ref).norm(),
+                      1e-12 * (1. + force_ref.norm()));
+    BOOST_CHECK_SMALL((force_csr - force_ref).norm(),
+                      1e-12 * (1. + force_ref.norm()));
+    f_max = std::max(f_max, force_ref.norm());
+  }
+  BOOST_CHECK_GT(f_max, 0.);
+}
+#endif // LENNARD_JONES && WCA
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE LB lattice block gather and checkpoint test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+namespace utf = boost::unit_test;
+
+#include "EspressoSystemStandAlone.hpp"
+#include "grid_based_algorithms/lb_collective_interface.hpp"
+#include "grid_based_algorithms/lb_interface.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/index.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+/** Populations that are unique to each node. */
+static Utils::Vector19d reference_populations(Utils::Vector3i const &ind,
+                                              double offset) {
+  Utils::Vector19d pop;
+  for (std::size_t i = 0; i < pop.size(); ++i) {
+    pop[i] = offset + 1e-2 * static_cast<double>(i) +
+             1e-3 * (ind[0] + 7 * ind[1] + 49 * ind[2]);
+  }
+  return pop;
+}
+
+/** Populations are stored as deviations from equilibrium, hence the
+ *  round trip through the lattice is only exact up to rounding errors.
+ */
+static void check_populations(std::vector<Utils::Vector19d> const &populations,
+                              std::vector<Utils::Vector19d> const &reference) {
+  BOOST_REQUIRE_EQUAL(populations.size(), reference.size());
+  for (std::size_t i = 0; i < populations.size(); ++i) {
+    BOOST_CHECK_SMALL((populations[i] - reference[i]).norm(), 1e-14);
+  }
+}
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_AUTO_TEST_CASE(lattice_block_io) {
+  espresso::system->set_box_l(Utils::Vector3d{{6., 5., 4.}});
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.4);
+  lb_lbfluid_set_lattice_switch(ActiveLB::CPU);
+  lb_lbfluid_set_agrid(1.);
+  lb_lbfluid_set_tau(0.01);
+  lb_lbfluid_set_density(1.);
+  lb_lbfluid_set_viscosity(1.);
+  lb_lbfluid_set_kT(0.);
+  auto const shape = lb_lbfluid_get_shape();
+  BOOST_REQUIRE_EQUAL(shape, Utils::Vector3i({6, 5, 4}));
+
+  std::vector<Utils::Vector19d> populations;
+  for (int k = 0; k < shape[2]; ++k) {
+    for (int j = 0; j < shape[1]; ++j) {
+      for (int i = 0; i < shape[0]; ++i) {
+        populations.emplace_back(reference_populations({i, j, k}, 0.1));
+      }
+    }
+  }
+
+  // the gathered lattice matches the per-node getters
+  mpi_lb_scatter_populations(populations);
+  auto const gathered = mpi_lb_gather_populations();
+  check_populations(gathered, populations);
+  auto const velocities = mpi_lb_gather_velocities();
+  auto const boundaries = mpi_lb_gather_boundary_flags();
+  for (auto const &ind : {Utils::Vector3i{{0, 0, 0}},
+                          Utils::Vector3i{{5, 4, 3}},
+                          Utils::Vector3i{{2, 3, 1}}}) {
+    auto const index = Utils::get_linear_index(ind, shape);
+    BOOST_CHECK_EQUAL(lb_lbnode_get_pop(ind), gathered[index]);
+    BOOST_CHECK_SMALL((lb_lbnode_get_velocity(ind) - velocities[index]).norm(),
+                      1e-12);
+    BOOST_CHECK_EQUAL(lb_lbnode_get_boundary(ind), boundaries[index]);
+  }
+
+  // checkpoints round trip
+  auto const filename =
+      "lb_block_io_test_" + std::to_string(::getpid()) + ".cpt";
+  for (auto const binary : {true, false}) {
+    for (auto &pop : populations) {
+      pop *= 2.;
+    }
+    mpi_lb_scatter_populations(populations);
+    auto const reference = mpi_lb_gather_populations();
+    lb_lbfluid_save_checkpoint(filename, binary);
+    mpi_lb_scatter_populations(std::vector<Utils::Vector19d>(
+        populations.size(), Utils::Vector19d::broadcast(1.)));
+    lb_lbfluid_load_checkpoint(filename, binary);
+    check_populations(mpi_lb_gather_populations(), reference);
+    std::remove(filename.c_str());
+  }
+
+  // corrupted binary checkpoints are rejected
+  lb_lbfluid_save_checkpoint(filename, true);
+  BOOST_REQUIRE_EQUAL(::truncate(filename.c_str(), 3 * sizeof(int) + 8), 0);
+  BOOST_CHECK_THROW(lb_lbfluid_load_checkpoint(filename, true),
+                    std::runtime_error);
+  std::remove(filename.c_str());
+
+  lb_lbfluid_set_lattice_switch(ActiveLB::NONE);
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
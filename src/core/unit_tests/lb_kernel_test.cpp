@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE LB collide and stream kernel test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+namespace utf = boost::unit_test;
+
+#include "config.hpp"
+
+#include "EspressoSystemStandAlone.hpp"
+#include "MpiCallbacks.hpp"
+#include "communication.hpp"
+#include "grid_based_algorithms/lb-d3q19.hpp"
+#include "grid_based_algorithms/lb_boundaries.hpp"
+#include "grid_based_algorithms/lb_collective_interface.hpp"
+#include "grid_based_algorithms/lb_interface.hpp"
+#include "grid_based_algorithms/lbboundaries/LBBoundary.hpp"
+
+#include <shapes/Sphere.hpp>
+#include <shapes/Wall.hpp>
+
+#include <utils/Vector.hpp>
+#include <utils/index.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+static void mpi_lb_propagate_local() { lb_lbfluid_propagate(); }
+
+REGISTER_CALLBACK(mpi_lb_propagate_local)
+
+#ifdef LB_BOUNDARIES
+static void mpi_add_lb_boundaries_local() {
+  auto const add_boundary = [](std::shared_ptr<Shapes::Shape> const &shape) {
+    auto boundary = std::make_shared<LBBoundaries::LBBoundary>();
+    boundary->set_shape(shape);
+    LBBoundaries::add(boundary);
+  };
+  // two layers of boundary nodes at the bottom and at the top of the box
+  auto bottom = std::make_shared<Shapes::Wall>();
+  bottom->set_normal({0., 0., 1.});
+  bottom->d() = 2.;
+  add_boundary(bottom);
+  auto top = std::make_shared<Shapes::Wall>();
+  top->set_normal({0., 0., -1.});
+  top->d() = -6.;
+  add_boundary(top);
+  // an obstacle that splits the rows of fluid nodes across the MPI ranks
+  auto sphere = std::make_shared<Shapes::Sphere>();
+  sphere->pos() = {11., 3., 4.};
+  sphere->rad() = 1.6;
+  add_boundary(sphere);
+}
+
+static void mpi_remove_lb_boundaries_local() {
+  while (not LBBoundaries::lbboundaries.empty()) {
+    LBBoundaries::remove(LBBoundaries::lbboundaries.back());
+  }
+}
+
+REGISTER_CALLBACK(mpi_add_lb_boundaries_local)
+REGISTER_CALLBACK(mpi_remove_lb_boundaries_local)
+#endif // LB_BOUNDARIES
+
+static double total_mass(std::vector<Utils::Vector19d> const &populations) {
+  auto mass = 0.;
+  for (auto const &pop : populations) {
+    for (auto const value : pop) {
+      mass += value;
+    }
+  }
+  return mass;
+}
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_AUTO_TEST_CASE(collide_stream) {
+  // the rows are longer than one batch of nodes and not a multiple of it
+  espresso::system->set_box_l(Utils::Vector3d{{22., 6., 4.}});
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.4);
+  lb_lbfluid_set_lattice_switch(ActiveLB::CPU);
+  lb_lbfluid_set_agrid(1.);
+  lb_lbfluid_set_tau(0.01);
+  lb_lbfluid_set_density(0.9);
+  lb_lbfluid_set_viscosity(1.3);
+  lb_lbfluid_set_bulk_viscosity(0.7);
+  lb_lbfluid_set_kT(0.);
+  lb_lbfluid_set_ext_force_density({0.01, -0.002, 0.003});
+  auto const shape = lb_lbfluid_get_shape();
+
+  // perturbed equilibrium populations and local force densities
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> noise(-0.01, 0.01);
+  std::vector<Utils::Vector19d> populations(Utils::product(shape));
+  for (auto &pop : populations) {
+    for (std::size_t i = 0; i < D3Q19::n_vel; ++i) {
+      pop[i] = 0.9 * D3Q19::w[i] + noise(rng);
+    }
+  }
+  std::vector<std::pair<Utils::Vector3i, Utils::Vector3d>> forces;
+  for (int i = 0; i < 30; ++i) {
+    auto const ind = Utils::Vector3i{{(7 * i) % shape[0], (5 * i) % shape[1],
+                                      (3 * i) % shape[2]}};
+    forces.emplace_back(ind, Utils::Vector3d{{noise(rng), noise(rng), 0.}});
+  }
+
+  // shift the fluid along the rows, which changes the nodes that are
+  // collided together, propagate it and shift it back
+  auto const propagate = [&](int shift) {
+    auto const shifted = [&](Utils::Vector3i ind) {
+      ind[0] = (ind[0] + shift) % shape[0];
+      return ind;
+    };
+    std::vector<Utils::Vector19d> initial(populations.size());
+    for (int i = 0; i < shape[0]; ++i) {
+      for (int j = 0; j < shape[1]; ++j) {
+        for (int k = 0; k < shape[2]; ++k) {
+          auto const ind = Utils::Vector3i{{i, j, k}};
+          initial[Utils::get_linear_index(shifted(ind), shape)] =
+              populations[Utils::get_linear_index(ind, shape)];
+        }
+      }
+    }
+    mpi_lb_scatter_populations(initial);
+    for (auto const &kv : forces) {
+      mpi_call_all(mpi_lb_set_force_density, shifted(kv.first), kv.second);
+    }
+    for (int step = 0; step < 3; ++step) {
+      mpi_call_all(mpi_lb_propagate_local);
+    }
+    auto const final_state = mpi_lb_gather_populations();
+    std::vector<Utils::Vector19d> result(populations.size());
+    for (int i = 0; i < shape[0]; ++i) {
+      for (int j = 0; j < shape[1]; ++j) {
+        for (int k = 0; k < shape[2]; ++k) {
+          auto const ind = Utils::Vector3i{{i, j, k}};
+          result[Utils::get_linear_index(ind, shape)] =
+              final_state[Utils::get_linear_index(shifted(ind), shape)];
+        }
+      }
+    }
+    return result;
+  };
+
+  auto const reference = propagate(0);
+
+  // the collisions conserve the mass
+  auto const mass = total_mass(populations);
+  BOOST_CHECK_SMALL(total_mass(reference) - mass, 1e-12 * mass);
+
+  // the result of each node is independent of its position in the batch
+  for (auto const shift : {1, 3, 8, 13}) {
+    BOOST_CHECK(propagate(shift) == reference);
+  }
+
+  lb_lbfluid_set_lattice_switch(ActiveLB::NONE);
+}
+
+#ifdef LB_BOUNDARIES
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_AUTO_TEST_CASE(boundaries) {
+  espresso::system->set_box_l(Utils::Vector3d{{22., 6., 8.}});
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.4);
+  lb_lbfluid_set_lattice_switch(ActiveLB::CPU);
+  lb_lbfluid_set_agrid(1.);
+  lb_lbfluid_set_tau(0.01);
+  lb_lbfluid_set_density(0.9);
+  lb_lbfluid_set_viscosity(1.3);
+  lb_lbfluid_set_kT(0.);
+  lb_lbfluid_set_ext_force_density({0.01, -0.002, 0.003});
+  auto const shape = lb_lbfluid_get_shape();
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> noise(-0.01, 0.01);
+  std::vector<Utils::Vector19d> populations(Utils::product(shape));
+  for (auto &pop : populations) {
+    for (std::size_t i = 0; i < D3Q19::n_vel; ++i) {
+      pop[i] = 0.9 * D3Q19::w[i] + noise(rng);
+    }
+  }
+  // the populations are scattered after the boundaries are set up, an even
+  // and an odd number of steps end in either of the two population buffers
+  auto const propagate = [&populations](int n_steps) {
+    mpi_lb_scatter_populations(populations);
+    for (int step = 0; step < n_steps; ++step) {
+      mpi_call_all(mpi_lb_propagate_local);
+    }
+    return mpi_lb_gather_populations();
+  };
+  auto const reference_even = propagate(2);
+  auto const reference_odd = propagate(3);
+
+  mpi_call_all(mpi_add_lb_boundaries_local);
+  auto const flags = mpi_lb_gather_boundary_flags();
+  auto const fluid_mass = [&flags](std::vector<Utils::Vector19d> const &pops) {
+    auto mass = 0.;
+    for (std::size_t j = 0; j < pops.size(); ++j) {
+      if (flags[j] == 0) {
+        for (auto const value : pops[j]) {
+          mass += value;
+        }
+      }
+    }
+    return mass;
+  };
+  auto const mass = fluid_mass(populations);
+  for (auto const n_steps : {2, 3}) {
+    auto const result = propagate(n_steps);
+
+    // the populations that reach the boundaries are bounced back into the
+    // fluid
+    BOOST_CHECK_SMALL(fluid_mass(result) - mass, 1e-12 * mass);
+    for (int i = 0; i < 3; ++i) {
+      BOOST_CHECK_NE(LBBoundaries::lbboundaries[i]->get_force().norm(), 0.);
+    }
+
+    // the populations of boundary nodes without links to the fluid are
+    // cleared
+    for (auto const z : {0, 7}) {
+      auto const pop = result[Utils::get_linear_index(3, 2, z, shape)];
+      for (std::size_t i = 0; i < D3Q19::n_vel; ++i) {
+        BOOST_CHECK_SMALL(pop[i] - 0.9 * D3Q19::w[i], 1e-14);
+      }
+    }
+  }
+
+  // removing the boundaries restores the fluid nodes
+  mpi_call_all(mpi_remove_lb_boundaries_local);
+  BOOST_CHECK(propagate(2) == reference_even);
+  BOOST_CHECK(propagate(3) == reference_odd);
+
+  lb_lbfluid_set_lattice_switch(ActiveLB::NONE);
+}
+#endif // LB_BOUNDARIES
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
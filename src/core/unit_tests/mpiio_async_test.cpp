@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_MODULE MPI-IO asynchronous output test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+namespace utf = boost::unit_test;
+
+#include "EspressoSystemStandAlone.hpp"
+#include "MpiCallbacks.hpp"
+#include "bonded_interactions/bonded_interaction_data.hpp"
+#include "bonded_interactions/harmonic.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "io/mpiio/mpiio.hpp"
+#include "particle_data.hpp"
+#include "particle_node.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+static auto const all_fields = Mpiio::MPIIO_OUT_POS | Mpiio::MPIIO_OUT_VEL |
+                               Mpiio::MPIIO_OUT_TYP | Mpiio::MPIIO_OUT_BND;
+
+static void mpi_create_bonds_local() {
+  bonded_ia_params.insert(
+      0, std::make_shared<Bonded_IA_Parameters>(HarmonicBond(1., 1., 0.)));
+}
+
+static void mpi_write_local(std::string const &prefix) {
+  Mpiio::mpi_mpiio_common_write(prefix, all_fields,
+                                cell_structure.local_particles());
+}
+
+static void mpi_write_async_local(std::string const &prefix) {
+  Mpiio::mpi_mpiio_async_write(prefix, all_fields,
+                               cell_structure.local_particles());
+}
+
+static void mpi_flush_local() { Mpiio::mpi_mpiio_async_flush(); }
+
+REGISTER_CALLBACK(mpi_create_bonds_local)
+REGISTER_CALLBACK(mpi_write_local)
+REGISTER_CALLBACK(mpi_write_async_local)
+REGISTER_CALLBACK(mpi_flush_local)
+
+static std::vector<char> read_file(std::string const &fn) {
+  std::ifstream file(fn, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file),
+          std::istreambuf_iterator<char>()};
+}
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_AUTO_TEST_CASE(async_write) {
+  auto const n_part = 10;
+  auto const n_frames = 3;
+  auto const prefix = "mpiio_async_test_" + std::to_string(getpid());
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(10.));
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.4);
+  mpi_call_all(mpi_create_bonds_local);
+
+  for (int pid = 0; pid < n_part; ++pid) {
+    place_particle(pid, {0.9 * pid + 0.1, 9.5 - 0.8 * pid, 0.5 * pid + 0.3});
+    set_particle_type(pid, pid % 3);
+  }
+  add_particle_bond(3, std::vector<int>{0, 4});
+  add_particle_bond(7, std::vector<int>{0, 2});
+
+  // stage more frames than there are staging areas, the particles are
+  // modified while the previous frames are being written
+  for (int frame = 0; frame < n_frames; ++frame) {
+    for (int pid = 0; pid < n_part; ++pid) {
+      set_particle_v(pid, {0.1 * pid, -0.2 * frame, 1. + frame});
+    }
+    auto const suffix = "_" + std::to_string(frame);
+    mpi_call_all(mpi_write_local, prefix + "_sync" + suffix);
+    mpi_call_all(mpi_write_async_local, prefix + "_async" + suffix);
+  }
+  for (int pid = 0; pid < n_part; ++pid) {
+    set_particle_v(pid, {0., 0., 0.});
+  }
+  mpi_call_all(mpi_flush_local);
+  // flushing twice is a no-op
+  mpi_call_all(mpi_flush_local);
+
+  // the asynchronous writer produces the same files
+  for (int frame = 0; frame < n_frames; ++frame) {
+    auto const suffix = "_" + std::to_string(frame);
+    for (auto const ext :
+         {".head", ".pref", ".id", ".pos", ".vel", ".type", ".boff", ".bond"}) {
+      auto const fn_sync = prefix + "_sync" + suffix + ext;
+      auto const fn_async = prefix + "_async" + suffix + ext;
+      auto const ref = read_file(fn_sync);
+      BOOST_CHECK(not ref.empty());
+      BOOST_CHECK(read_file(fn_async) == ref);
+      BOOST_CHECK_EQUAL(std::remove(fn_sync.c_str()), 0);
+      BOOST_CHECK_EQUAL(std::remove(fn_async.c_str()), 0);
+    }
+  }
+  remove_all_particles();
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE MPI-IO particle checkpoint test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+namespace utf = boost::unit_test;
+
+#include "EspressoSystemStandAlone.hpp"
+#include "MpiCallbacks.hpp"
+#include "Particle.hpp"
+#include "bonded_interactions/bonded_interaction_data.hpp"
+#include "bonded_interactions/fene.hpp"
+#include "bonded_interactions/harmonic.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "config.hpp"
+#include "integrate.hpp"
+#include "io/mpiio/mpiio.hpp"
+#include "particle_data.hpp"
+#include "particle_node.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+static void mpi_create_bonds_local() {
+  bonded_ia_params.insert(
+      0, std::make_shared<Bonded_IA_Parameters>(FeneBond(1., 2., 0.)));
+  bonded_ia_params.insert(
+      1, std::make_shared<Bonded_IA_Parameters>(HarmonicBond(1., 1., 0.)));
+}
+
+static void mpi_write_checkpoint_local(std::string const &prefix) {
+  Mpiio::mpi_mpiio_checkpoint_write(prefix, cell_structure.local_particles());
+}
+
+static void mpi_read_checkpoint_local(std::string const &prefix) {
+  Mpiio::mpi_mpiio_checkpoint_read(prefix);
+}
+
+REGISTER_CALLBACK(mpi_create_bonds_local)
+REGISTER_CALLBACK(mpi_write_checkpoint_local)
+REGISTER_CALLBACK(mpi_read_checkpoint_local)
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_AUTO_TEST_CASE(checkpoint_round_trip) {
+  auto const n_part = 10;
+  auto const prefix = "mpiio_checkpoint_test_" + std::to_string(getpid());
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(10.));
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.4);
+  mpi_call_all(mpi_create_bonds_local);
+
+  auto const pos = [](int pid) {
+    return Utils::Vector3d{0.9 * pid + 0.1, 9.5 - 0.8 * pid, 0.5 * pid + 0.3};
+  };
+  auto const vel = [](int pid) {
+    return Utils::Vector3d{0.1 * pid, -0.2 * pid, 1.};
+  };
+
+  for (int pid = 0; pid < n_part; ++pid) {
+    place_particle(pid, pos(pid));
+    set_particle_v(pid, vel(pid));
+    set_particle_type(pid, pid % 3);
+  }
+  add_particle_bond(3, std::vector<int>{0, 4});
+  add_particle_bond(3, std::vector<int>{1, 5});
+  add_particle_bond(7, std::vector<int>{1, 2});
+#ifdef EXTERNAL_FORCES
+  set_particle_ext_force(2, {1., 2., 3.});
+#endif
+#ifdef EXCLUSIONS
+  add_particle_exclusion(8, 9);
+  add_particle_exclusion(8, 1);
+#endif
+
+  mpi_call_all(mpi_write_checkpoint_local, prefix);
+  remove_particle(4);
+  set_particle_v(0, {0., 0., 0.});
+
+  mpi_call_all(mpi_read_checkpoint_local, prefix);
+  /* resort the particles to the ranks they belong to */
+  BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+
+  BOOST_REQUIRE_EQUAL(get_n_part(), n_part);
+  for (int pid = 0; pid < n_part; ++pid) {
+    auto const &p = get_particle_data(pid);
+    BOOST_CHECK_SMALL((p.pos() - pos(pid)).norm(), 1e-12);
+    BOOST_CHECK_EQUAL(p.v(), vel(pid));
+    BOOST_CHECK_EQUAL(p.type(), pid % 3);
+  }
+#ifdef EXTERNAL_FORCES
+  BOOST_CHECK_EQUAL(get_particle_data(2).ext_force(),
+                    Utils::Vector3d({1., 2., 3.}));
+#endif
+
+  auto const bonds_3 = get_particle_bonds(3);
+  BOOST_REQUIRE_EQUAL(bonds_3.size(), 2u);
+  BOOST_CHECK_EQUAL(bonds_3[0].bond_id(), 0);
+  BOOST_CHECK_EQUAL(bonds_3[0].partner_ids()[0], 4);
+  BOOST_CHECK_EQUAL(bonds_3[1].bond_id(), 1);
+  BOOST_CHECK_EQUAL(bonds_3[1].partner_ids()[0], 5);
+  auto const bonds_7 = get_particle_bonds(7);
+  BOOST_REQUIRE_EQUAL(bonds_7.size(), 1u);
+  BOOST_CHECK_EQUAL(bonds_7[0].bond_id(), 1);
+  BOOST_CHECK_EQUAL(bonds_7[0].partner_ids()[0], 2);
+  BOOST_CHECK(get_particle_bonds(0).empty());
+#ifdef EXCLUSIONS
+  auto const &exclusions = get_particle_data(8).exclusions();
+  BOOST_REQUIRE_EQUAL(exclusions.size(), 2u);
+  BOOST_CHECK_EQUAL(exclusions[0], 9);
+  BOOST_CHECK_EQUAL(exclusions[1], 1);
+#endif
+
+  for (auto const suffix : {".chkh", ".part", ".cbnd", ".excl"}) {
+    BOOST_CHECK_EQUAL(std::remove((prefix + suffix).c_str()), 0);
+  }
+  remove_all_particles();
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
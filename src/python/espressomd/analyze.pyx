@@ -106,7 +106,7 @@ class Analysis:
         """
 
         if p1 == 'default' and p2 == 'default':
-            return analyze.mindist(analyze.partCfg(), [], [])
+            return analyze.mindist([], [])
         elif p1 == 'default' or p2 == 'default':
             raise ValueError("Both p1 and p2 have to be specified")
         else:
@@ -120,7 +120,7 @@ class Analysis:
                     raise TypeError(
                         f"Particle types in p2 have to be of type int, got: {repr(p2[i])}")
 
-            return analyze.mindist(analyze.partCfg(), p1, p2)
+            return analyze.mindist(p1, p2)
 
     #
     # Analyze Linear Momentum
@@ -203,8 +203,7 @@ class Analysis:
         utils.check_type_or_throw_except(
             r_catch, 1, float, "r_catch must be a float")
 
-        return analyze.nbhood(
-            analyze.partCfg(), utils.make_Vector3d(pos), r_catch)
+        return analyze.nbhood(utils.make_Vector3d(pos), r_catch)
 
     def pressure(self):
         """
@@ -525,7 +524,7 @@ class Analysis:
         cdef vector[double] wavevectors
         cdef vector[double] intensities
         analyze.calc_structurefactor(
-            analyze.partCfg(), sf_types, sf_order, wavevectors, intensities)
+            sf_types, sf_order, wavevectors, intensities)
 
         return np.vstack([wavevectors, intensities])
 
@@ -591,7 +590,7 @@ class Analysis:
         distribution.resize(r_bins)
 
         analyze.calc_part_distribution(
-            analyze.partCfg(), type_list_a, type_list_b,
+            type_list_a, type_list_b,
             r_min, r_max, r_bins, < bint > log_flag, & low, distribution.data())
 
         np_distribution = utils.create_nparray_from_double_array(
@@ -32,6 +32,20 @@ class CellSystem(ScriptInterfaceHelper):
         Name of the currently active particle decomposition.
     use_verlet_lists : :obj:`bool`
         Whether to use Verlet lists.
+    use_soa : :obj:`bool`
+        Whether to compute the short-range forces on a structure-of-arrays
+        copy of the particle data (see :ref:`Structure-of-arrays force loop`).
+    use_ghost_overlap : :obj:`bool`
+        Whether to communicate the ghost particles with non-blocking MPI
+        calls, overlapping with the force calculation
+        (see :ref:`Overlapping ghost communication`).
+    use_morton_order : :obj:`bool`
+        Whether the cells are traversed along a Morton curve
+        (see :ref:`Memory locality`). Set by the decomposition setters.
+    particle_sort_interval : :obj:`int`
+        Number of particle resorts between two sorts of the particles of
+        each cell along a Morton curve, 0 to disable the sorting
+        (see :ref:`Memory locality`).
     skin : :obj:`float`
         Verlet list skin.
     node_grid : (3,) array_like of :obj:`int`
@@ -115,6 +129,9 @@ class CellSystem(ScriptInterfaceHelper):
         use_verlet_lists : :obj:`bool`, optional
             Activates or deactivates the usage of Verlet lists.
             Defaults to ``True``.
+        use_morton_order : :obj:`bool`, optional
+            Order the cells along a Morton curve instead of row by row.
+            Defaults to ``False``.
 
         """
         self.call_method("initialize", name="regular_decomposition", **kwargs)
@@ -147,10 +164,40 @@ class CellSystem(ScriptInterfaceHelper):
         use_verlet_lists : :obj:`bool`, optional
             Activates or deactivates the usage of Verlet lists.
             Defaults to ``True``.
+        use_morton_order : :obj:`bool`, optional
+            Order the cells along a Morton curve instead of row by row.
+            Defaults to ``False``.
 
         """
         self.call_method("initialize", name="hybrid_decomposition", **kwargs)
 
+    def set_balanced_decomposition(self, **kwargs):
+        """
+        Activate the load-balanced regular decomposition.
+
+        Parameters
+        ----------
+        rebalance_interval : :obj:`int`, optional
+            Number of particle resorts, i.e. Verlet list rebuilds, between
+            two evaluations of the load balance. Defaults to 10.
+        imbalance_threshold : :obj:`float`, optional
+            Ratio of the largest to the mean MPI rank load above which the
+            rank domains are resized. Defaults to 1.1.
+        load_metric : :obj:`str`, optional
+            Estimate of the load of a cell, either ``'pairs'`` (number of
+            particle pairs) or ``'particles'`` (number of particles).
+            Defaults to ``'pairs'``.
+        use_verlet_lists : :obj:`bool`, optional
+            Activates or deactivates the usage of Verlet lists.
+            Defaults to ``True``.
+        use_morton_order : :obj:`bool`, optional
+            Order the cells along a Morton curve instead of row by row.
+            Defaults to ``False``.
+
+        """
+        self.call_method(
+            "initialize", name="balanced_decomposition", **kwargs)
+
     def get_pairs(self, distance, types='all'):
         """
         Get pairs of particles closer than threshold value.
@@ -187,6 +234,7 @@ class CellSystem(ScriptInterfaceHelper):
           if search distance is larger than the box size
         * regular decomposition: the search distance is bounded by half
           the local cell geometry
+        * balanced decomposition: same as the regular decomposition
         * hybrid decomposition: not supported
 
         Parameters
@@ -17,6 +17,7 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #
 import collections
+import contextlib
 import inspect
 import os
 import re
@@ -41,10 +42,15 @@ class Checkpoint:
     checkpoint_path : :obj:`str`, optional
         Path for reading and writing the checkpoint.
         If not given, the current working directory is used.
+    mpiio : :obj:`bool`, optional
+        Write the particles of a registered system in parallel with
+        MPI-IO (see :meth:`espressomd.io.mpiio.Mpiio.write_checkpoint`)
+        instead of pickling them on the head node. The checkpoint can
+        then be loaded on a different number of MPI ranks.
 
     """
 
-    def __init__(self, checkpoint_id=None, checkpoint_path="."):
+    def __init__(self, checkpoint_id=None, checkpoint_path=".", mpiio=False):
         # check if checkpoint_id is valid (only allow a-z A-Z 0-9 _ -)
         if not isinstance(checkpoint_id, str) or bool(
                 re.compile(r"[^a-zA-Z0-9_\-]").search(checkpoint_id)):
@@ -55,6 +61,7 @@ class Checkpoint:
 
         self.checkpoint_objects = []
         self.checkpoint_signals = []
+        self.mpiio = mpiio
         frm = inspect.stack()[1]
         self.calling_module = inspect.getmodule(frm[0])
 
@@ -209,7 +216,8 @@ class Checkpoint:
             self.checkpoint_dir, f"{checkpoint_index}.checkpoint")
 
         tmpname = filename + ".__tmp__"
-        with open(tmpname, "wb") as checkpoint_file:
+        with open(tmpname, "wb") as checkpoint_file, \
+                self.__mpiio_particles(f"{checkpoint_index}.particles"):
             pickle.dump(checkpoint_data, checkpoint_file, -1)
         os.rename(tmpname, filename)
 
@@ -229,7 +237,7 @@ class Checkpoint:
 
         filename = os.path.join(
             self.checkpoint_dir, f"{checkpoint_index}.checkpoint")
-        with open(filename, "rb") as f:
+        with open(filename, "rb") as f, self.__mpiio_particles():
             checkpoint_data = pickle.load(f)
 
         for key in checkpoint_data:
@@ -237,6 +245,31 @@ class Checkpoint:
                 self.calling_module, key, checkpoint_data[key])
             self.checkpoint_objects.append(key)
 
+    @contextlib.contextmanager
+    def __mpiio_particles(self, prefix=None):
+        """
+        Context in which the particles of a system are pickled as a
+        reference to MPI-IO files with the given prefix. Without a prefix,
+        such references are unpickled from the checkpoint directory.
+
+        """
+        import espressomd.particle_data
+        if prefix is not None and not self.mpiio:
+            yield
+            return
+        if prefix is not None:
+            # MPI-IO does not overwrite files
+            for suffix in ("chkh", "part", "cbnd", "excl"):
+                path = os.path.join(self.checkpoint_dir, f"{prefix}.{suffix}")
+                if os.path.isfile(path):
+                    os.remove(path)
+        espressomd.particle_data._mpiio_checkpoint = (
+            self.checkpoint_dir, prefix)
+        try:
+            yield
+        finally:
+            espressomd.particle_data._mpiio_checkpoint = None
+
     def __signal_handler(self, signum, frame):  # pylint: disable=unused-argument
         """
         Will be called when a registered signal was sent.
@@ -231,6 +231,11 @@ class P3M(_P3MBase):
     check_neutrality : :obj:`bool`, optional
         Raise a warning if the system is not electrically neutral when
         set to ``True`` (default).
+    differentiation : :obj:`str`, optional
+        Differentiation scheme of the forces: ``'ik'`` (default) for the
+        differentiation in k-space, ``'ad'`` for the analytical
+        differentiation in real space, or ``'auto'`` to let the tuning
+        pick the fastest scheme (requires ``tune=True``).
 
     """
     _so_name = "Coulomb::CoulombP3M"
@@ -240,6 +245,23 @@ class P3M(_P3MBase):
         if not has_features("P3M"):
             raise NotImplementedError("Feature P3M not compiled in")
 
+    def valid_keys(self):
+        return super().valid_keys() | {"differentiation"}
+
+    def default_params(self):
+        params = super().default_params()
+        params["differentiation"] = "ik"
+        return params
+
+    def validate_params(self, params):
+        super().validate_params(params)
+        if params["differentiation"] not in ("ik", "ad", "auto"):
+            raise ValueError(
+                "P3M differentiation has to be 'ik', 'ad' or 'auto'")
+        if params["differentiation"] == "auto" and not params["tune"]:
+            raise ValueError(
+                "P3M differentiation 'auto' requires tune=True")
+
 
 @script_interface_register
 class P3MGPU(_P3MBase):
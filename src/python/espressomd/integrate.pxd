@@ -34,17 +34,28 @@ cdef extern from "integrate.hpp":
     double get_sim_time()
     void mpi_set_time_step(double time_step) except +
     void mpi_set_time(double time)
+    cbool get_deferred_error_check()
+    int get_n_deferred_error_checks()
+    void mpi_set_deferred_error_check(cbool deferred)
 
 cdef extern from "integrate.hpp" nogil:
     cdef int python_integrate(int n_steps, cbool recalc_forces, int reuse_forces)
     cdef int mpi_steepest_descent(int max_steps)
     cdef void integrate_set_sd() except +
-    cdef void integrate_set_nvt()
+    cdef void integrate_set_nvt(int long_range_interval, cbool monitor_energy) except +
     cdef void integrate_set_steepest_descent(const double f_max, const double gamma,
                                              const double max_displacement) except +
     cdef extern cbool set_py_interrupt
     cdef void integrate_set_bd()
 
+cdef extern from "integrators/respa.hpp":
+    ctypedef struct RespaDiagnostics:
+        int n_long_range_evaluations
+        int n_outer_steps
+        double energy_start
+        double energy_end
+    const RespaDiagnostics & respa_get_diagnostics()
+
 IF NPT:
     cdef extern from "integrate.hpp" nogil:
         cdef void integrate_set_npt_isotropic(double ext_pressure, double piston,
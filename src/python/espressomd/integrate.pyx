@@ -32,7 +32,8 @@ cdef class IntegratorHandle:
     # __getstate__ and __setstate__ define the pickle interaction
     def __getstate__(self):
         return {'integrator': self._integrator, 'time': self.time,
-                'time_step': self.time_step, 'force_cap': self.force_cap}
+                'time_step': self.time_step, 'force_cap': self.force_cap,
+                'deferred_error_check': self.deferred_error_check}
 
     def __setstate__(self, state):
         self._integrator = state['integrator']
@@ -40,6 +41,7 @@ cdef class IntegratorHandle:
         self.time = state['time']
         self.time_step = state['time_step']
         self.force_cap = state['force_cap']
+        self.deferred_error_check = state['deferred_error_check']
 
     def get_state(self):
         """
@@ -69,6 +71,52 @@ cdef class IntegratorHandle:
         def __get__(self):
             return forcecap_get()
 
+    property deferred_error_check:
+        """
+        :obj:`bool`: Check the runtime errors of a time step only at the end
+        of the next time step, without blocking the integration loop.
+
+        """
+
+        def __set__(self, deferred):
+            mpi_set_deferred_error_check(deferred)
+
+        def __get__(self):
+            return get_deferred_error_check()
+
+    property n_deferred_error_checks:
+        """
+        :obj:`int`: Number of runtime error checks of the last integration
+        which did not block the integration loop (read-only).
+
+        """
+
+        def __get__(self):
+            return get_n_deferred_error_checks()
+
+    property respa_diagnostics:
+        """
+        :obj:`dict`: Diagnostics of the multiple time step scheme of
+        :class:`VelocityVerlet` in the last integration (read-only):
+        the number of long-range force evaluations, the number of
+        completed outer time steps and, if the energy is monitored, the
+        total energy at the first and the last outer time step and the
+        average energy drift per outer time step.
+
+        """
+
+        def __get__(self):
+            cdef RespaDiagnostics diagnostics = respa_get_diagnostics()
+            energy_drift = 0.
+            if diagnostics.n_outer_steps > 0:
+                energy_drift = (diagnostics.energy_end -
+                                diagnostics.energy_start) / diagnostics.n_outer_steps
+            return {"n_long_range_evaluations": diagnostics.n_long_range_evaluations,
+                    "n_outer_steps": diagnostics.n_outer_steps,
+                    "energy_start": diagnostics.energy_start,
+                    "energy_end": diagnostics.energy_end,
+                    "energy_drift": energy_drift}
+
     def __init__(self):
         self.set_nvt()
 
@@ -90,21 +138,21 @@ cdef class IntegratorHandle:
         """
         self._integrator = SteepestDescent(*args, **kwargs)
 
-    def set_vv(self):
+    def set_vv(self, *args, **kwargs):
         """
         Set the integration method to velocity Verlet, which is suitable for
         simulations in the NVT ensemble (:class:`VelocityVerlet`).
 
         """
-        self._integrator = VelocityVerlet()
+        self._integrator = VelocityVerlet(*args, **kwargs)
 
-    def set_nvt(self):
+    def set_nvt(self, *args, **kwargs):
         """
         Set the integration method to velocity Verlet, which is suitable for
         simulations in the NVT ensemble (:class:`VelocityVerlet`).
 
         """
-        self._integrator = VelocityVerlet()
+        self._integrator = VelocityVerlet(*args, **kwargs)
 
     def set_isotropic_npt(self, *args, **kwargs):
         """
@@ -307,16 +355,28 @@ cdef class VelocityVerlet(Integrator):
     """
     Velocity Verlet integrator, suitable for simulations in the NVT ensemble.
 
+    Parameters
+    ----------
+    long_range_interval : :obj:`int`, optional
+        Number of time steps per evaluation of the long-range
+        electrostatic and magnetostatic forces. With values larger than 1,
+        these forces are applied as an impulse in a multiple time step
+        scheme (r-RESPA), see :ref:`Multiple time step integration`.
+    monitor_energy : :obj:`bool`, optional
+        Calculate the total energy at the first and the last outer time step
+        of each integration with the multiple time step scheme, see
+        :attr:`~espressomd.integrate.IntegratorHandle.respa_diagnostics`.
+
     """
 
     def default_params(self):
-        return {}
+        return {"long_range_interval": 1, "monitor_energy": False}
 
     def valid_keys(self):
         """All parameters that can be set.
 
         """
-        return set()
+        return {"long_range_interval", "monitor_energy"}
 
     def required_keys(self):
         """Parameters that have to be set.
@@ -328,10 +388,18 @@ cdef class VelocityVerlet(Integrator):
         """Check that parameters are valid.
 
         """
-        pass
+        utils.check_type_or_throw_except(
+            self._params["long_range_interval"], 1, int,
+            "long_range_interval must be an integer")
+        if self._params["long_range_interval"] < 1:
+            raise ValueError("long_range_interval must be positive")
+        utils.check_type_or_throw_except(
+            self._params["monitor_energy"], 1, bool,
+            "monitor_energy must be a boolean")
 
     def _set_params_in_es_core(self):
-        integrate_set_nvt()
+        integrate_set_nvt(self._params["long_range_interval"],
+                          self._params["monitor_energy"])
 
 
 IF NPT:
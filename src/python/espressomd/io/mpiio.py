@@ -28,7 +28,7 @@ class Mpiio(ScriptInterfaceHelper):
     _so_creation_policy = "GLOBAL"
 
     def write(self, prefix=None, positions=False, velocities=False,
-              types=False, bonds=False):
+              types=False, bonds=False, asynchronous=False):
         """MPI-IO write.
 
         Outputs binary data using MPI-IO to several files starting with prefix.
@@ -46,6 +46,12 @@ class Mpiio(ScriptInterfaceHelper):
         .. note::
             Do not read the files on a machine with a different architecture!
 
+        In asynchronous mode, the particle data is copied to a staging area
+        and the files are written in the background while the simulation
+        continues. Up to two frames can be pending; writing a third frame
+        waits for the oldest one to complete. Call :meth:`flush` before
+        reading the files.
+
         Parameters
         ----------
         prefix : :obj:`str`
@@ -58,6 +64,8 @@ class Mpiio(ScriptInterfaceHelper):
             Indicates if types should be dumped.
         bonds : :obj:`bool`, optional
             Indicates if bonds should be dumped.
+        asynchronous : :obj:`bool`, optional
+            Indicates if the files should be written in the background.
 
         Raises
         ------
@@ -72,7 +80,16 @@ class Mpiio(ScriptInterfaceHelper):
             raise ValueError("No output fields chosen.")
 
         self.call_method(
-            "write", prefix=prefix, pos=positions, vel=velocities, typ=types, bond=bonds)
+            "write", prefix=prefix, pos=positions, vel=velocities, typ=types,
+            bond=bonds, asynchronous=asynchronous)
+
+    def flush(self):
+        """Wait for all asynchronous writes to complete.
+
+        After this call, the files written by :meth:`write` in asynchronous
+        mode are complete and closed.
+        """
+        self.call_method("flush")
 
     def read(self, prefix=None, positions=False, velocities=False,
              types=False, bonds=False):
@@ -94,3 +111,52 @@ class Mpiio(ScriptInterfaceHelper):
 
         self.call_method(
             "read", prefix=prefix, pos=positions, vel=velocities, typ=types, bond=bonds)
+
+    def write_checkpoint(self, prefix=None):
+        """MPI-IO checkpoint of the particles.
+
+        Writes the complete state of all particles, including their bonds
+        and exclusions, in parallel to several files starting with prefix.
+        Suffixes are:
+
+        - chkh: Information about the layout of the checkpoint,
+        - part: Particle state: 1 record per particle,
+        - cbnd: Bond information: variable amount of data,
+        - excl: Exclusion information: variable amount of data.
+
+        The particles are not gathered on the head node. The checkpoint
+        can be read back with :meth:`read_checkpoint` on a different number
+        of processes.
+
+        .. note::
+            Do not read the files on a machine with a different architecture
+            or with |es| compiled with a different set of features!
+
+        Parameters
+        ----------
+        prefix : :obj:`str`
+            Common prefix for the filenames.
+
+        Raises
+        ------
+        ValueError
+            If no prefix was given.
+        """
+        if prefix is None:
+            raise ValueError(
+                "Need to supply output prefix via the 'prefix' argument.")
+
+        self.call_method("write_checkpoint", prefix=prefix)
+
+    def read_checkpoint(self, prefix=None):
+        """MPI-IO restart of the particles.
+
+        Replaces all particles by the ones written by
+        :meth:`write_checkpoint`. See the :meth:`write_checkpoint`
+        documentation for details.
+        """
+        if prefix is None:
+            raise ValueError(
+                "Need to supply output prefix via the 'prefix' argument.")
+
+        self.call_method("read_checkpoint", prefix=prefix)
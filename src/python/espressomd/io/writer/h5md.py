@@ -76,6 +76,12 @@ class H5md(ScriptInterfaceHelper):
         list of valid fields. This list defines the H5MD specifications.
         If the file in ``file_path`` already exists but has different
         specifications, an exception is raised.
+    chunk_size : :obj:`int`, optional
+        Number of particles per HDF5 chunk. Defaults to 1000.
+        Only used when creating a new file.
+    compression_level : :obj:`int`, optional
+        Deflate compression level of the datasets, between 0 and 9.
+        Defaults to 0 (no compression). Only used when creating a new file.
 
     Methods
     -------
@@ -108,6 +114,10 @@ class H5md(ScriptInterfaceHelper):
     force_unit: :obj:`str`
     velocity_unit: :obj:`str`
     charge_unit: :obj:`str`
+    chunk_size: :obj:`int`
+        Number of particles per HDF5 chunk.
+    compression_level: :obj:`int`
+        Deflate compression level of the datasets.
 
     """
     _so_name = "ScriptInterface::Writer::H5md"
@@ -141,17 +151,21 @@ class H5md(ScriptInterfaceHelper):
             time_unit=unit_system.time,
             force_unit=unit_system.force,
             velocity_unit=unit_system.velocity,
-            charge_unit=unit_system.charge
+            charge_unit=unit_system.charge,
+            chunk_size=params["chunk_size"],
+            compression_level=params["compression_level"]
         )
 
     def default_params(self):
-        return {"unit_system": UnitSystem(), "fields": "all"}
+        return {"unit_system": UnitSystem(), "fields": "all",
+                "chunk_size": 1000, "compression_level": 0}
 
     def required_keys(self):
         return {"file_path"}
 
     def valid_keys(self):
-        return {"file_path", "unit_system", "fields"}
+        return {"file_path", "unit_system", "fields", "chunk_size",
+                "compression_level"}
 
     def validate_params(self, params):
         """Check validity of given parameters.
@@ -161,3 +175,8 @@ class H5md(ScriptInterfaceHelper):
         for item in params["fields"]:
             utils.check_type_or_throw_except(
                 item, 1, str, "'fields' should be a string or a list of strings")
+        utils.check_type_or_throw_except(
+            params["chunk_size"], 1, int, "'chunk_size' should be an integer")
+        utils.check_type_or_throw_except(
+            params["compression_level"], 1, int,
+            "'compression_level' should be an integer")
@@ -223,6 +223,38 @@ class DipolarDirectSumWithReplicaCpu(MagnetostaticInteraction):
         return {"prefactor", "n_replica"}
 
 
+@script_interface_register
+class DipolarBarnesHutCpu(MagnetostaticInteraction):
+    """
+    Calculate magnetostatic interactions with a Barnes-Hut octree sum.
+    See :ref:`Barnes-Hut octree sum on CPU` for more details.
+
+    If the system has periodic boundaries, the minimum image convention is
+    applied in the respective directions.
+
+    Parameters
+    ----------
+    prefactor : :obj:`float`
+        Magnetostatics prefactor (:math:`\\mu_0/(4\\pi)`)
+    theta : :obj:`float`, optional
+        Opening angle of the octree nodes. The direct sum is recovered
+        for ``theta=0``.
+    leaf_size : :obj:`int`, optional
+        Maximal number of dipoles in a leaf of the octree.
+
+    """
+    _so_name = "Dipoles::DipolarBarnesHut"
+
+    def default_params(self):
+        return {"theta": 0.2, "leaf_size": 8}
+
+    def required_keys(self):
+        return set()
+
+    def valid_keys(self):
+        return {"prefactor", "theta", "leaf_size"}
+
+
 @script_interface_register
 class Scafacos(MagnetostaticInteraction):
 
@@ -157,6 +157,18 @@ cdef extern from "particle_data.hpp":
 
     void remove_all_bonds_to(int part)
 
+    void set_particles_v(const vector[int] & ids, const vector[Vector3d] & values) except +
+    void set_particles_f(const vector[int] & ids, const vector[Vector3d] & values) except +
+    void set_particles_type(const vector[int] & ids, const vector[int] & values) except +
+    void set_particles_mol_id(const vector[int] & ids, const vector[int] & values) except +
+    void set_particles_q(const vector[int] & ids, const vector[double] & values) except +
+    IF MASS:
+        void set_particles_mass(const vector[int] & ids, const vector[double] & values) except +
+    IF DIPOLES:
+        void set_particles_dipm(const vector[int] & ids, const vector[double] & values) except +
+    IF EXTERNAL_FORCES:
+        void set_particles_ext_force(const vector[int] & ids, const vector[Vector3d] & values) except +
+
 cdef extern from "particle_node.hpp":
     void place_particle(int p_id, const Vector3d & pos) except +
 
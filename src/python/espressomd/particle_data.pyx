@@ -29,6 +29,7 @@ from .analyze cimport max_seen_particle_type
 from copy import copy
 import collections
 import functools
+import os
 from .utils import nesting_level, array_locked, is_valid_type, handle_errors
 from .utils cimport make_array_locked, make_const_span, check_type_or_throw_except
 from .utils cimport Vector3i, Vector3d, Vector4d
@@ -1663,6 +1664,13 @@ class ParticleSlice(_ParticleSliceImpl):
         return odict
 
 
+# Directory and file prefix of the MPI-IO checkpoint of the particles, set
+# by :class:`espressomd.checkpointing.Checkpoint` while it pickles or
+# unpickles the system. If set, :class:`ParticleList` is pickled as a
+# reference to the MPI-IO files instead of a dict of all particles.
+_mpiio_checkpoint = None
+
+
 cdef class ParticleList:
     """
     Provides access to the particles.
@@ -1704,8 +1712,18 @@ cdef class ParticleList:
           after the particle was created.
         - :attr:`~ParticleHandle.image_box`, :attr:`~ParticleHandle.node`
 
+        During a checkpoint with MPI-IO, the particles are written in
+        parallel and only the file prefix is pickled.
+
         """
 
+        if _mpiio_checkpoint is not None:
+            import espressomd.io.mpiio
+            directory, prefix = _mpiio_checkpoint
+            espressomd.io.mpiio.Mpiio().write_checkpoint(
+                os.path.join(directory, prefix))
+            return {"mpiio_checkpoint": prefix}
+
         odict = {}
         for p in self:
             pdict = p.to_dict()
@@ -1714,6 +1732,15 @@ cdef class ParticleList:
         return odict
 
     def __setstate__(self, params):
+        if "mpiio_checkpoint" in params:
+            import espressomd.io.mpiio
+            directory = "."
+            if _mpiio_checkpoint is not None:
+                directory = _mpiio_checkpoint[0]
+            espressomd.io.mpiio.Mpiio().read_checkpoint(
+                os.path.join(directory, params["mpiio_checkpoint"]))
+            return
+
         exclusions = collections.OrderedDict()
         for particle_number in params.keys():
             params[particle_number]["id"] = particle_number
@@ -1832,13 +1859,24 @@ Set quat and scalar dipole moment (dipm) instead.")
             first_id = get_maximal_particle_id() + 1
             p_list_dict["id"] = range(first_id, first_id + n_parts)
 
-        # Place the particles
+        # Place the particles, then set the properties which support bulk
+        # updates for all particles at once
+        bulk_properties = {k: v for k, v in p_list_dict.items()
+                           if k in bulk_attributes}
+        if "dip" in p_list_dict:
+            # contradicting attributes are rejected by _place_new_particle
+            bulk_properties.pop("dipm", None)
         for i in range(n_parts):
-            p_dict = {k: v[i] for k, v in p_list_dict.items()}
+            p_dict = {k: v[i] for k, v in p_list_dict.items()
+                      if k not in bulk_properties}
             self._place_new_particle(p_dict)
 
+        particle_slice = self.by_ids(p_list_dict["id"])
+        for k, v in bulk_properties.items():
+            set_slice_bulk(particle_slice, k, v)
+
         # Return slice of added particles
-        return self.by_ids(p_list_dict["id"])
+        return particle_slice
 
     # Iteration over all existing particles
     def __iter__(self):
@@ -2035,6 +2073,86 @@ def set_slice_one_for_each(particle_slice, attribute, values):
         setattr(ParticleHandle(i), attribute, v)
 
 
+# Particle attributes which can be set for many particles at once
+bulk_attributes = {"type", "mol_id", "q", "v", "f"}
+IF MASS:
+    bulk_attributes.add("mass")
+IF DIPOLES:
+    bulk_attributes.add("dipm")
+IF EXTERNAL_FORCES:
+    bulk_attributes.add("ext_force")
+
+
+def set_slice_bulk(particle_slice, attribute, values):
+    """
+    Set a property of all members of particle_slice in a single collective
+    operation, with one entry of values per member. Returns ``False`` if
+    the property cannot be set in bulk.
+
+    """
+    cdef vector[int] ids
+    cdef vector[int] int_values
+    cdef vector[double] double_values
+    cdef vector[Vector3d] vector_values
+
+    if attribute not in bulk_attributes:
+        return False
+
+    for pid in particle_slice.id_selection:
+        ids.push_back(pid)
+
+    if attribute in ("type", "mol_id"):
+        for v in values:
+            if not (is_valid_type(v, int) and v >= 0):
+                raise ValueError(f"{attribute} must be an integer >= 0")
+            int_values.push_back(v)
+        if attribute == "type":
+            set_particles_type(ids, int_values)
+        else:
+            set_particles_mol_id(ids, int_values)
+        return True
+
+    scalar_messages = {"q": "Charge has to be a float."}
+    IF MASS:
+        scalar_messages["mass"] = "Mass has to be 1 float"
+    IF DIPOLES:
+        scalar_messages["dipm"] = "Magnitude of dipole moment has to be 1 float."
+    if attribute in scalar_messages:
+        for v in values:
+            check_type_or_throw_except(
+                v, 1, float, scalar_messages[attribute])
+            double_values.push_back(v)
+        if attribute == "q":
+            set_particles_q(ids, double_values)
+        IF MASS:
+            if attribute == "mass":
+                set_particles_mass(ids, double_values)
+        IF DIPOLES:
+            if attribute == "dipm":
+                set_particles_dipm(ids, double_values)
+        return True
+
+    vector_messages = {"v": "Velocity has to be floats",
+                       "f": "Force has to be floats"}
+    IF EXTERNAL_FORCES:
+        vector_messages["ext_force"] = "External force vector has to be 3 floats."
+    if attribute in vector_messages:
+        for v in values:
+            check_type_or_throw_except(
+                v, 3, float, vector_messages[attribute])
+            vector_values.push_back(make_Vector3d(v))
+        if attribute == "v":
+            set_particles_v(ids, vector_values)
+        elif attribute == "f":
+            set_particles_f(ids, vector_values)
+        IF EXTERNAL_FORCES:
+            if attribute == "ext_force":
+                set_particles_ext_force(ids, vector_values)
+        return True
+
+    return False
+
+
 def _add_particle_slice_properties():
     """
     Automatically add all of ParticleHandle's properties to ParticleSlice.
@@ -2099,9 +2217,14 @@ def _add_particle_slice_properties():
 
             if not target_shape:  # scalar quantity
                 if not np.shape(values):
-                    set_slice_one_for_all(particle_slice, attribute, values)
+                    if not set_slice_bulk(
+                            particle_slice, attribute, N * [values]):
+                        set_slice_one_for_all(
+                            particle_slice, attribute, values)
                 elif np.shape(values)[0] == N:
-                    set_slice_one_for_each(particle_slice, attribute, values)
+                    if not set_slice_bulk(particle_slice, attribute, values):
+                        set_slice_one_for_each(
+                            particle_slice, attribute, values)
                 else:
                     raise Exception(
                         f"Value shape {np.shape(values)} does not broadcast to attribute shape {target_shape}.")
@@ -2110,9 +2233,14 @@ def _add_particle_slice_properties():
 
             else:  # fixed length vector quantity
                 if target_shape == np.shape(values):
-                    set_slice_one_for_all(particle_slice, attribute, values)
+                    if not set_slice_bulk(
+                            particle_slice, attribute, N * [values]):
+                        set_slice_one_for_all(
+                            particle_slice, attribute, values)
                 elif target_shape == tuple(np.shape(values)[1:]) and np.shape(values)[0] == N:
-                    set_slice_one_for_each(particle_slice, attribute, values)
+                    if not set_slice_bulk(particle_slice, attribute, values):
+                        set_slice_one_for_each(
+                            particle_slice, attribute, values)
                 else:
                     raise Exception(
                         f"Value shape {np.shape(values)} does not broadcast to attribute shape {target_shape}.")
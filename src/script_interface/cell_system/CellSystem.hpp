@@ -23,6 +23,7 @@
 #include "script_interface/ScriptInterface.hpp"
 
 #include "core/bonded_interactions/bonded_interaction_data.hpp"
+#include "core/cell_system/BalancedDecomposition.hpp"
 #include "core/cell_system/HybridDecomposition.hpp"
 #include "core/cell_system/RegularDecomposition.hpp"
 #include "core/cells.hpp"
@@ -66,6 +67,16 @@ auto const &get_hybrid_decomposition() {
   return dynamic_cast<HybridDecomposition const &>(
       Utils::as_const(cell_structure).decomposition());
 }
+
+auto const &get_balanced_decomposition() {
+  return dynamic_cast<BalancedDecomposition const &>(
+      Utils::as_const(cell_structure).decomposition());
+}
+
+bool is_balanced_decomposition() {
+  return cell_structure.decomposition_type() ==
+         CellStructureType::CELL_STRUCTURE_BALANCED;
+}
 } // namespace
 
 class CellSystem : public AutoParameters<CellSystem> {
@@ -73,18 +84,47 @@ class CellSystem : public AutoParameters<CellSystem> {
       {CellStructureType::CELL_STRUCTURE_REGULAR, "regular_decomposition"},
       {CellStructureType::CELL_STRUCTURE_NSQUARE, "n_square"},
       {CellStructureType::CELL_STRUCTURE_HYBRID, "hybrid_decomposition"},
+      {CellStructureType::CELL_STRUCTURE_BALANCED, "balanced_decomposition"},
   };
 
   std::unordered_map<std::string, CellStructureType> const cs_name_to_type = {
       {"regular_decomposition", CellStructureType::CELL_STRUCTURE_REGULAR},
       {"n_square", CellStructureType::CELL_STRUCTURE_NSQUARE},
       {"hybrid_decomposition", CellStructureType::CELL_STRUCTURE_HYBRID},
+      {"balanced_decomposition", CellStructureType::CELL_STRUCTURE_BALANCED},
+  };
+
+  std::unordered_map<LoadMetric, std::string> const load_metric_to_name = {
+      {LoadMetric::PARTICLES, "particles"},
+      {LoadMetric::PAIRS, "pairs"},
+  };
+
+  std::unordered_map<std::string, LoadMetric> const load_metric_from_name = {
+      {"particles", LoadMetric::PARTICLES},
+      {"pairs", LoadMetric::PAIRS},
   };
 
 public:
   CellSystem() {
     add_parameters({
         {"use_verlet_lists", cell_structure.use_verlet_list},
+        {"use_soa", cell_structure.use_soa},
+        {"use_ghost_overlap", cell_structure.use_ghost_overlap},
+        {"use_morton_order", AutoParameter::read_only,
+         []() { return cell_structure.use_morton_order; }},
+        {"particle_sort_interval",
+         [this](Variant const &v) {
+           auto const interval = get_value<int>(v);
+           if (interval < 0) {
+             if (context()->is_head_node()) {
+               throw std::domain_error(
+                   "Parameter 'particle_sort_interval' must be >= 0");
+             }
+             throw Exception("");
+           }
+           cell_structure.particle_sort_interval = interval;
+         },
+         []() { return cell_structure.particle_sort_interval; }},
         {"node_grid",
          [this](Variant const &v) {
            context()->parallel_try_catch([&v]() {
@@ -149,6 +189,30 @@ public:
            auto const hd = get_hybrid_decomposition();
            return Variant{hd.get_cutoff_regular()};
          }},
+        {"rebalance_interval", AutoParameter::read_only,
+         []() {
+           if (not is_balanced_decomposition()) {
+             return Variant{none};
+           }
+           auto const &bd = get_balanced_decomposition();
+           return Variant{bd.get_parameters().rebalance_interval};
+         }},
+        {"imbalance_threshold", AutoParameter::read_only,
+         []() {
+           if (not is_balanced_decomposition()) {
+             return Variant{none};
+           }
+           auto const &bd = get_balanced_decomposition();
+           return Variant{bd.get_parameters().imbalance_threshold};
+         }},
+        {"load_metric", AutoParameter::read_only,
+         [this]() {
+           if (not is_balanced_decomposition()) {
+             return Variant{none};
+           }
+           auto const &bd = get_balanced_decomposition();
+           return Variant{load_metric_to_name.at(bd.get_parameters().metric)};
+         }},
         {"max_cut_nonbonded", AutoParameter::read_only,
          maximal_cutoff_nonbonded},
         {"max_cut_bonded", AutoParameter::read_only, maximal_cutoff_bonded},
@@ -197,6 +261,12 @@ public:
             Variant{std::unordered_map<std::string, Variant>{
                 {"regular", hd.count_particles_in_regular()},
                 {"n_square", hd.count_particles_in_n_square()}}};
+      } else if (cs_type == CellStructureType::CELL_STRUCTURE_BALANCED) {
+        auto const &bd = get_balanced_decomposition();
+        state["cell_grid"] = pack_vector(bd.get_cell_grid());
+        state["cell_size"] = Variant{bd.get_cell_size()};
+        state["load_imbalance"] = bd.load_imbalance();
+        state["n_rebalances"] = bd.get_n_rebalances();
       }
       state["verlet_reuse"] = get_verlet_reuse();
       state["n_nodes"] = ::n_nodes;
@@ -295,12 +365,36 @@ private:
                   VariantMap const &params) const {
     auto const verlet = get_value_or<bool>(params, "use_verlet_lists", true);
     cell_structure.use_verlet_list = verlet;
+    cell_structure.use_morton_order =
+        get_value_or<bool>(params, "use_morton_order", false);
     if (cs_type == CellStructureType::CELL_STRUCTURE_HYBRID) {
       auto const cutoff_regular = get_value<double>(params, "cutoff_regular");
       auto const ns_types =
           get_value_or<std::vector<int>>(params, "n_square_types", {});
       auto n_square_types = std::set<int>{ns_types.begin(), ns_types.end()};
       set_hybrid_decomposition(std::move(n_square_types), cutoff_regular);
+    } else if (cs_type == CellStructureType::CELL_STRUCTURE_BALANCED) {
+      LoadBalancingParameters lb_params{};
+      context()->parallel_try_catch([&]() {
+        lb_params.rebalance_interval = get_value_or<int>(
+            params, "rebalance_interval", lb_params.rebalance_interval);
+        lb_params.imbalance_threshold = get_value_or<double>(
+            params, "imbalance_threshold", lb_params.imbalance_threshold);
+        auto const metric = get_value_or<std::string>(params, "load_metric",
+                                                      "pairs");
+        if (lb_params.rebalance_interval < 1) {
+          throw std::domain_error("Parameter 'rebalance_interval' must be > 0");
+        }
+        if (lb_params.imbalance_threshold < 1.) {
+          throw std::domain_error(
+              "Parameter 'imbalance_threshold' must be >= 1");
+        }
+        if (load_metric_from_name.count(metric) == 0) {
+          throw std::invalid_argument("Unknown load metric '" + metric + "'");
+        }
+        lb_params.metric = load_metric_from_name.at(metric);
+      });
+      set_balanced_decomposition(lb_params);
     } else {
       cells_re_init(cs_type);
     }
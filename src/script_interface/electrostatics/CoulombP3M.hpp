@@ -31,6 +31,7 @@
 #include "script_interface/get_value.hpp"
 
 #include <memory>
+#include <stdexcept>
 #include <string>
 
 namespace ScriptInterface {
@@ -38,6 +39,7 @@ namespace Coulomb {
 
 class CoulombP3M : public Actor<CoulombP3M, ::CoulombP3M> {
   bool m_tune;
+  bool m_tune_differentiation;
 
 public:
   CoulombP3M() {
@@ -69,12 +71,33 @@ public:
         {"timings", AutoParameter::read_only,
          [this]() { return actor()->tune_timings; }},
         {"tune", AutoParameter::read_only, [this]() { return m_tune; }},
+        {"differentiation", AutoParameter::read_only,
+         [this]() {
+           if (m_tune_differentiation and not actor()->is_tuned()) {
+             return std::string("auto");
+           }
+           return std::string((actor()->p3m.differentiation ==
+                               P3MDifferentiation::ad)
+                                  ? "ad"
+                                  : "ik");
+         }},
     });
   }
 
   void do_construct(VariantMap const &params) override {
     m_tune = get_value<bool>(params, "tune");
+    auto const differentiation_name =
+        get_value_or<std::string>(params, "differentiation", "ik");
+    m_tune_differentiation = (differentiation_name == "auto");
     context()->parallel_try_catch([&]() {
+      auto differentiation = P3MDifferentiation::ik;
+      if (differentiation_name == "ad") {
+        differentiation = P3MDifferentiation::ad;
+      } else if (differentiation_name != "ik" and
+                 differentiation_name != "auto") {
+        throw std::invalid_argument("Unknown differentiation scheme '" +
+                                    differentiation_name + "'");
+      }
       auto p3m = P3MParameters{get_value<bool>(params, "tune"),
                                get_value<double>(params, "epsilon"),
                                get_value<double>(params, "r_cut"),
@@ -86,7 +109,8 @@ public:
       m_actor = std::make_shared<CoreActorClass>(
           std::move(p3m), get_value<double>(params, "prefactor"),
           get_value<int>(params, "timings"),
-          get_value<bool>(params, "verbose"));
+          get_value<bool>(params, "verbose"), differentiation,
+          m_tune_differentiation);
     });
     set_charge_neutrality_tolerance(params);
   }
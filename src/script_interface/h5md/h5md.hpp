@@ -50,7 +50,10 @@ public:
          {"time_unit", m_h5md, &::Writer::H5md::File::time_unit},
          {"force_unit", m_h5md, &::Writer::H5md::File::force_unit},
          {"velocity_unit", m_h5md, &::Writer::H5md::File::velocity_unit},
-         {"charge_unit", m_h5md, &::Writer::H5md::File::charge_unit}});
+         {"charge_unit", m_h5md, &::Writer::H5md::File::charge_unit},
+         {"chunk_size", m_h5md, &::Writer::H5md::File::chunk_size},
+         {"compression_level", m_h5md,
+          &::Writer::H5md::File::compression_level}});
   };
 
 private:
@@ -62,10 +65,11 @@ private:
     m_h5md = make_shared_from_args<::Writer::H5md::File, std::string,
                                    std::string, std::vector<std::string>,
                                    std::string, std::string, std::string,
-                                   std::string, std::string, std::string>(
+                                   std::string, std::string, std::string, int,
+                                   int>(
         params, "file_path", "script_path", "fields", "mass_unit",
         "length_unit", "time_unit", "force_unit", "velocity_unit",
-        "charge_unit");
+        "charge_unit", "chunk_size", "compression_level");
   }
 
   std::shared_ptr<::Writer::H5md::File> m_h5md;
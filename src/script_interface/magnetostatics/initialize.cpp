@@ -24,6 +24,7 @@
 
 #include "Actor_impl.hpp"
 
+#include "DipolarBarnesHut.hpp"
 #include "DipolarBarnesHutGpu.hpp"
 #include "DipolarDirectSum.hpp"
 #include "DipolarDirectSumGpu.hpp"
@@ -47,6 +48,7 @@ namespace Dipoles {
 void initialize(Utils::Factory<ObjectHandle> *om) {
 #ifdef DIPOLES
   om->register_new<DipolarDirectSum>("Dipoles::DipolarDirectSum");
+  om->register_new<DipolarBarnesHut>("Dipoles::DipolarBarnesHut");
 #ifdef DIPOLAR_DIRECT_SUM
   om->register_new<DipolarDirectSumGpu>("Dipoles::DipolarDirectSumGpu");
 #endif
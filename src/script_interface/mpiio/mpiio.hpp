@@ -41,7 +41,23 @@ public:
   Variant do_call_method(const std::string &name,
                          const VariantMap &parameters) override {
 
+    if (name == "flush") {
+      Mpiio::mpi_mpiio_async_flush();
+      return {};
+    }
+
     auto prefix = get_value<std::string>(parameters.at("prefix"));
+
+    if (name == "write_checkpoint") {
+      Mpiio::mpi_mpiio_checkpoint_write(prefix,
+                                        cell_structure.local_particles());
+      return {};
+    }
+    if (name == "read_checkpoint") {
+      Mpiio::mpi_mpiio_checkpoint_read(prefix);
+      return {};
+    }
+
     auto pos = get_value<bool>(parameters.at("pos"));
     auto vel = get_value<bool>(parameters.at("vel"));
     auto typ = get_value<bool>(parameters.at("typ"));
@@ -52,10 +68,14 @@ public:
                         ((typ) ? Mpiio::MPIIO_OUT_TYP : Mpiio::MPIIO_OUT_NON) |
                         ((bnd) ? Mpiio::MPIIO_OUT_BND : Mpiio::MPIIO_OUT_NON);
 
-    if (name == "write")
-      Mpiio::mpi_mpiio_common_write(prefix, fields,
-                                    cell_structure.local_particles());
-    else if (name == "read")
+    if (name == "write") {
+      if (get_value_or<bool>(parameters, "asynchronous", false))
+        Mpiio::mpi_mpiio_async_write(prefix, fields,
+                                     cell_structure.local_particles());
+      else
+        Mpiio::mpi_mpiio_common_write(prefix, fields,
+                                      cell_structure.local_particles());
+    } else if (name == "read")
       Mpiio::mpi_mpiio_common_read(prefix, fields);
 
     return {};
@@ -21,6 +21,7 @@
 
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <numeric>
 #include <stdexcept>
@@ -83,6 +84,38 @@ template <class T> T upper_triangular(T i, T j, T n) {
   return (n * (n - 1)) / 2 - ((n - i) * (n - i - 1)) / 2 + j;
 }
 
+namespace detail {
+/** Interleave the lower 21 bits of @p x with two zero bits each. */
+inline uint64_t morton_spread_bits(uint64_t x) {
+  x &= 0x1fffffu;
+  x = (x | (x << 32)) & 0x001f00000000ffffu;
+  x = (x | (x << 16)) & 0x001f0000ff0000ffu;
+  x = (x | (x << 8)) & 0x100f00f00f00f00fu;
+  x = (x | (x << 4)) & 0x10c30c30c30c30c3u;
+  x = (x | (x << 2)) & 0x1249249249249249u;
+  return x;
+}
+} // namespace detail
+
+/**
+ * @brief Position of a grid point along a Morton (Z-order) curve.
+ *
+ * Points that are close on the curve are close in space, which makes
+ * the curve a cache-friendly traversal order for 3D grids.
+ *
+ * @param ind Position in the grid, every component in [0, 2^21).
+ * @return    The Morton index, with the bits of the components interleaved.
+ */
+inline uint64_t morton_index(Vector3i const &ind) {
+  assert((ind[0] >= 0) && (ind[0] < (1 << 21)));
+  assert((ind[1] >= 0) && (ind[1] < (1 << 21)));
+  assert((ind[2] >= 0) && (ind[2] < (1 << 21)));
+
+  return detail::morton_spread_bits(static_cast<uint64_t>(ind[0])) |
+         (detail::morton_spread_bits(static_cast<uint64_t>(ind[1])) << 1) |
+         (detail::morton_spread_bits(static_cast<uint64_t>(ind[2])) << 2);
+}
+
 } // namespace Utils
 
 #endif
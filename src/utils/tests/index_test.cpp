@@ -25,6 +25,7 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 
 BOOST_AUTO_TEST_CASE(get_linear_index) {
   using Utils::get_linear_index;
@@ -73,3 +74,45 @@ BOOST_AUTO_TEST_CASE(upper_triangular_test) {
     }
   }
 }
+
+BOOST_AUTO_TEST_CASE(morton_index_test) {
+  using Utils::morton_index;
+
+  /* bit i of component d goes to bit 3 * i + d */
+  auto const reference = [](Utils::Vector3i const &ind) {
+    uint64_t result = 0u;
+    for (int i = 0; i < 21; i++) {
+      for (int d = 0; d < 3; d++) {
+        result |= static_cast<uint64_t>((ind[d] >> i) & 1) << (3 * i + d);
+      }
+    }
+    return result;
+  };
+
+  BOOST_CHECK_EQUAL(morton_index({0, 0, 0}), 0u);
+  BOOST_CHECK_EQUAL(morton_index({1, 0, 0}), 1u);
+  BOOST_CHECK_EQUAL(morton_index({0, 1, 0}), 2u);
+  BOOST_CHECK_EQUAL(morton_index({0, 0, 1}), 4u);
+  BOOST_CHECK_EQUAL(morton_index({1, 1, 1}), 7u);
+  BOOST_CHECK_EQUAL(morton_index({2, 0, 0}), 8u);
+
+  auto const max = (1 << 21) - 1;
+  for (auto const &ind :
+       {Utils::Vector3i{max, 0, 0}, Utils::Vector3i{0, max, 0},
+        Utils::Vector3i{0, 0, max}, Utils::Vector3i{max, max, max},
+        Utils::Vector3i{12345, 678901, 1048577}}) {
+    BOOST_CHECK_EQUAL(morton_index(ind), reference(ind));
+  }
+  BOOST_CHECK_EQUAL(morton_index({max, max, max}), (uint64_t{1} << 63) - 1u);
+
+  /* the curve visits the octants of a cube one after another */
+  Utils::Vector3i ind{};
+  for (ind[0] = 0; ind[0] < 4; ind[0]++) {
+    for (ind[1] = 0; ind[1] < 4; ind[1]++) {
+      for (ind[2] = 0; ind[2] < 4; ind[2]++) {
+        auto const octant = (ind[0] / 2) + 2 * (ind[1] / 2) + 4 * (ind[2] / 2);
+        BOOST_CHECK_EQUAL(morton_index(ind) / 8u, octant);
+      }
+    }
+  }
+}
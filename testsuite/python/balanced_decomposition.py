@@ -0,0 +1,97 @@
+#
+# Copyright (C) 2022 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import unittest as ut
+import unittest_decorators as utx
+import espressomd
+import numpy as np
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES"])
+class BalancedDecomposition(ut.TestCase):
+    system = espressomd.System(box_l=[32.0, 8.0, 8.0])
+    system.time_step = 0.005
+    system.cell_system.skin = 0.2
+    n_nodes = system.cell_system.get_state()["n_nodes"]
+
+    def setUp(self):
+        self.system.cell_system.set_regular_decomposition()
+        self.system.cell_system.node_grid = [self.n_nodes, 1, 1]
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=0.5, cutoff=0.5 * 2**(1. / 6.), shift="auto")
+        # dense region in the left quarter of the box, dilute elsewhere
+        np.random.seed(42)
+        box_l = np.copy(self.system.box_l)
+        dense = np.random.random((600, 3)) * [0.25, 1., 1.] * box_l
+        dilute = np.random.random((200, 3)) * [0.75, 1., 1.] * box_l
+        dilute[:, 0] += 0.25 * box_l[0]
+        self.system.part.add(pos=np.concatenate((dense, dilute)))
+        self.system.integrator.set_steepest_descent(
+            f_max=0., gamma=0.1, max_displacement=0.01)
+        self.system.integrator.run(100)
+        self.system.integrator.set_vv()
+        self.system.thermostat.set_langevin(kT=1., gamma=1., seed=42)
+
+    def tearDown(self):
+        self.system.thermostat.turn_off()
+        self.system.part.clear()
+        self.system.cell_system.set_regular_decomposition()
+
+    def check_balance(self, load_metric):
+        system = self.system
+        system.integrator.run(0, recalc_forces=True)
+        energy_ref = system.analysis.energy()["total"]
+        forces_ref = np.copy(system.part.all().f)
+
+        system.cell_system.set_balanced_decomposition(
+            rebalance_interval=1, imbalance_threshold=1.05,
+            load_metric=load_metric)
+        state = system.cell_system.get_state()
+        self.assertEqual(state["decomposition_type"], "balanced_decomposition")
+        self.assertEqual(state["n_rebalances"], 0)
+        imbalance_ref = state["load_imbalance"]
+        if self.n_nodes > 1:
+            self.assertGreater(imbalance_ref, 1.5)
+
+        # the node domains are adapted on the first resort
+        system.integrator.run(0, recalc_forces=True)
+        np.testing.assert_allclose(
+            system.analysis.energy()["total"], energy_ref, rtol=1e-10)
+        np.testing.assert_allclose(
+            np.copy(system.part.all().f), forces_ref, rtol=1e-8, atol=1e-8)
+        state = system.cell_system.get_state()
+        if self.n_nodes > 1:
+            self.assertEqual(state["n_rebalances"], 1)
+            self.assertLess(state["load_imbalance"], imbalance_ref)
+        else:
+            self.assertEqual(state["n_rebalances"], 0)
+
+        # particles keep moving between the resized domains
+        system.integrator.run(200)
+        self.assertEqual(len(system.part), 800)
+        self.assertEqual(sum(system.cell_system.resort()), 800)
+
+    def test_particles(self):
+        self.check_balance("particles")
+
+    def test_pairs(self):
+        self.check_balance("pairs")
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -30,10 +30,17 @@ class CellSystem(ut.TestCase):
     def test_cell_system(self):
         parameters = {
             "n_square": {"use_verlet_lists": False},
-            "regular_decomposition": {"use_verlet_lists": True},
+            "regular_decomposition": {"use_verlet_lists": True,
+                                      "use_morton_order": True},
             "hybrid_decomposition": {"use_verlet_lists": False,
+                                     "use_morton_order": False,
                                      "n_square_types": [1, 3, 5],
                                      "cutoff_regular": 1.27},
+            "balanced_decomposition": {"use_verlet_lists": True,
+                                       "use_morton_order": True,
+                                       "rebalance_interval": 5,
+                                       "imbalance_threshold": 1.2,
+                                       "load_metric": "particles"},
         }
         for cell_system, params_in in parameters.items():
             setter = getattr(self.system.cell_system, f"set_{cell_system}")
@@ -60,6 +67,9 @@ class CellSystem(ut.TestCase):
         with self.assertRaisesRegex(ValueError, "Parameter 'skin' must be >= 0"):
             system.cell_system.skin = -2.
         self.assertAlmostEqual(system.cell_system.skin, 0.1, delta=1e-12)
+        with self.assertRaisesRegex(ValueError, "Parameter 'particle_sort_interval' must be >= 0"):
+            system.cell_system.particle_sort_interval = -1
+        self.assertEqual(system.cell_system.particle_sort_interval, 0)
 
         node_grid = system.cell_system.node_grid
         with self.assertRaisesRegex(ValueError, "Parameter 'node_grid' must be 3 ints"):
@@ -68,11 +78,22 @@ class CellSystem(ut.TestCase):
         with self.assertRaisesRegex(ValueError, rf"MPI world size {self.n_nodes} incompatible with new node grid \[1, 2, {self.n_nodes}\]"):
             system.cell_system.node_grid = [1, 2, self.n_nodes]
         np.testing.assert_array_equal(system.cell_system.node_grid, node_grid)
+        with self.assertRaisesRegex(ValueError, "Parameter 'rebalance_interval' must be > 0"):
+            system.cell_system.set_balanced_decomposition(rebalance_interval=0)
+        with self.assertRaisesRegex(ValueError, "Parameter 'imbalance_threshold' must be >= 1"):
+            system.cell_system.set_balanced_decomposition(
+                imbalance_threshold=0.9)
+        with self.assertRaisesRegex(ValueError, "Unknown load metric 'time'"):
+            system.cell_system.set_balanced_decomposition(load_metric="time")
 
     def test_node_grid_regular(self):
         self.system.cell_system.set_regular_decomposition()
         self.check_node_grid()
 
+    def test_node_grid_balanced(self):
+        self.system.cell_system.set_balanced_decomposition()
+        self.check_node_grid()
+
     def test_node_grid_hybrid(self):
         self.system.cell_system.set_hybrid_decomposition(
             n_square_types={1}, cutoff_regular=0)
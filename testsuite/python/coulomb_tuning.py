@@ -53,6 +53,20 @@ class CoulombCloudWallTune(ut.TestCase):
             prefactor=1., accuracy=5e-4, tune=True)
         self.compare(actor)
 
+    def test_p3m_cpu_ad(self):
+        actor = espressomd.electrostatics.P3M(
+            prefactor=1., accuracy=5e-4, tune=True, differentiation="ad")
+        self.compare(actor)
+        self.assertEqual(actor.differentiation, "ad")
+
+    def test_p3m_cpu_auto(self):
+        actor = espressomd.electrostatics.P3M(
+            prefactor=1., accuracy=5e-4, tune=True, differentiation="auto")
+        self.assertEqual(actor.differentiation, "auto")
+        self.compare(actor)
+        self.assertTrue(actor.is_tuned)
+        self.assertIn(actor.differentiation, ("ik", "ad"))
+
     @utx.skipIfMissingGPU()
     def test_p3m_gpu(self):
         actor = espressomd.electrostatics.P3MGPU(
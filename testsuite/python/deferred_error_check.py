@@ -0,0 +1,80 @@
+#
+# Copyright (C) 2022 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.interactions
+import numpy as np
+import unittest as ut
+
+
+class DeferredErrorCheck(ut.TestCase):
+
+    """
+    Check that the integration stops one time step later when the runtime
+    errors are checked in the background.
+
+    """
+
+    system = espressomd.System(box_l=[10., 10., 10.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.integrator.deferred_error_check = False
+
+    def run_until_bond_breaks(self, deferred):
+        system = self.system
+        system.integrator.deferred_error_check = deferred
+        self.assertEqual(system.integrator.deferred_error_check, deferred)
+        system.part.clear()
+        system.time = 0.
+        fene = espressomd.interactions.FeneBond(k=0.1, d_r_max=1.5)
+        system.bonded_inter.add(fene)
+        p1 = system.part.add(pos=[4.5, 5., 5.], v=[-1., 0., 0.])
+        p2 = system.part.add(pos=[5.5, 5., 5.], v=[1., 0., 0.])
+        p1.add_bond((fene, p2))
+        # the bond breaks after about 25 time steps
+        with self.assertRaisesRegex(Exception, "bond broken between particles"):
+            system.integrator.run(100)
+        return (int(round(system.time / system.time_step)),
+                system.integrator.n_deferred_error_checks)
+
+    def test_deferred_error_check(self):
+        n_steps_blocking, n_deferred_blocking = self.run_until_bond_breaks(
+            False)
+        n_steps_deferred, n_deferred = self.run_until_bond_breaks(True)
+        self.assertGreater(n_steps_blocking, 10)
+        self.assertEqual(n_deferred_blocking, 0)
+        # the error is only seen at the end of the next time step
+        self.assertEqual(n_steps_deferred, n_steps_blocking + 1)
+        # no reduction is started in the time step which sees the error
+        self.assertEqual(n_deferred, n_steps_deferred - 1)
+
+    def test_no_errors(self):
+        system = self.system
+        p = system.part.add(pos=[1., 2., 3.], v=[1., 0., 0.])
+        system.integrator.deferred_error_check = True
+        system.integrator.run(20)
+        self.assertEqual(system.integrator.n_deferred_error_checks, 20)
+        np.testing.assert_allclose(
+            np.copy(p.pos), [1. + 20 * system.time_step, 2., 3.], atol=1e-12)
+
+
+if __name__ == "__main__":
+    ut.main()
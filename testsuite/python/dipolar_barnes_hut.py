@@ -0,0 +1,119 @@
+#
+# Copyright (C) 2022 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.magnetostatics
+import itertools
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+
+@utx.skipIfMissingFeatures(["DIPOLES"])
+class DipolarBarnesHutCpu(ut.TestCase):
+
+    """
+    Compare the Barnes-Hut octree sum on the CPU to the direct summation
+    in open and partially periodic boundary conditions.
+
+    """
+
+    system = espressomd.System(box_l=[10., 10., 10.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+    n_nodes = system.cell_system.get_state()["n_nodes"]
+
+    def setUp(self):
+        np.random.seed(42)
+        # dipoles on a jittered lattice
+        pos = 1.6 * np.array(list(itertools.product(range(6), repeat=3)))
+        pos += 0.8 + 0.6 * (np.random.random(pos.shape) - 0.5)
+        dip = np.random.normal(size=pos.shape)
+        dip /= np.linalg.norm(dip, axis=1)[:, np.newaxis]
+        self.particles = self.system.part.add(pos=pos, dip=dip)
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.actors.clear()
+        self.system.periodicity = [True, True, True]
+
+    def calc(self, actor):
+        self.system.actors.add(actor)
+        self.system.integrator.run(0, recalc_forces=True)
+        energy = self.system.analysis.energy()["dipolar"]
+        forces = np.copy(self.particles.f)
+        torques = np.copy(self.particles.torque_lab)
+        self.system.actors.clear()
+        return energy, forces, torques
+
+    def check_accuracy(self):
+        BHC = espressomd.magnetostatics.DipolarBarnesHutCpu
+        # a zero opening angle recovers the direct summation
+        ref_e, ref_f, ref_t = self.calc(BHC(prefactor=1.2, theta=0.))
+        if self.n_nodes == 1:
+            dds = espressomd.magnetostatics.DipolarDirectSumCpu(prefactor=1.2)
+            dds_e, dds_f, dds_t = self.calc(dds)
+            self.assertAlmostEqual(ref_e, dds_e, delta=1e-10 * abs(dds_e))
+            np.testing.assert_allclose(ref_f, dds_f, atol=1e-10)
+            np.testing.assert_allclose(ref_t, dds_t, atol=1e-10)
+        # the force error decreases with the opening angle
+        previous_error = np.inf
+        for theta in (0.5, 0.3, 0.2, 0.1):
+            _, f, t = self.calc(BHC(prefactor=1.2, theta=theta))
+            error = np.linalg.norm(f - ref_f) / np.linalg.norm(ref_f)
+            self.assertLess(error, previous_error)
+            previous_error = error
+        self.assertLess(previous_error, 1e-3)
+        np.testing.assert_allclose(t, ref_t, atol=1e-2)
+        # default parameters
+        e, f, _ = self.calc(BHC(prefactor=1.2))
+        self.assertLess(np.linalg.norm(f - ref_f) / np.linalg.norm(ref_f),
+                        1e-2)
+        # the pair energies of the random dipoles largely cancel, hence the
+        # error is compared to the nearest neighbor energy on the lattice
+        energy_scale = 1.2 * len(self.particles) / 1.6**3
+        self.assertAlmostEqual(e, ref_e, delta=1e-3 * energy_scale)
+
+    def test_open_boundaries(self):
+        self.system.periodicity = [False, False, False]
+        self.check_accuracy()
+
+    def test_slab_boundaries(self):
+        self.system.periodicity = [True, True, False]
+        self.check_accuracy()
+
+    def test_non_magnetic_particles(self):
+        BHC = espressomd.magnetostatics.DipolarBarnesHutCpu
+        self.system.periodicity = [False, False, False]
+        energy1, _, _ = self.calc(BHC(prefactor=1.2))
+        self.system.part.add(pos=[5., 5., 5.], dip=[0., 0., 0.])
+        energy2, _, _ = self.calc(BHC(prefactor=1.2))
+        self.assertAlmostEqual(energy1, energy2, delta=1e-12)
+
+    def test_parameters(self):
+        actor = espressomd.magnetostatics.DipolarBarnesHutCpu(
+            prefactor=1.2, theta=0.3, leaf_size=4)
+        self.assertAlmostEqual(actor.theta, 0.3, delta=1e-12)
+        self.assertEqual(actor.leaf_size, 4)
+        actor = espressomd.magnetostatics.DipolarBarnesHutCpu(prefactor=1.2)
+        self.assertAlmostEqual(actor.theta, 0.2, delta=1e-12)
+        self.assertEqual(actor.leaf_size, 8)
+
+
+if __name__ == "__main__":
+    ut.main()
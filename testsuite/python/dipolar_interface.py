@@ -49,6 +49,11 @@ class Test(ut.TestCase):
             system, espressomd.magnetostatics.DipolarDirectSumWithReplicaCpu,
             dict(prefactor=3.4, n_replica=3))
 
+    if espressomd.has_features("DIPOLES"):
+        test_bh_cpu = tests_common.generate_test_for_actor_class(
+            system, espressomd.magnetostatics.DipolarBarnesHutCpu,
+            dict(prefactor=3.4, theta=0.4, leaf_size=4))
+
     if espressomd.has_features(
             "DIPOLAR_DIRECT_SUM") and espressomd.gpu_available():
         test_dds_gpu = tests_common.generate_test_for_actor_class(
@@ -113,6 +118,15 @@ class Test(ut.TestCase):
         energy2 = self.system.analysis.energy()["dipolar"]
         self.assertAlmostEqual(energy1, energy2, delta=1e-12)
 
+    def test_bh_cpu_exceptions(self):
+        BHC = espressomd.magnetostatics.DipolarBarnesHutCpu
+        with self.assertRaisesRegex(ValueError, "Parameter 'prefactor' must be > 0"):
+            BHC(prefactor=-1.)
+        with self.assertRaisesRegex(ValueError, "Parameter 'theta' must be >= 0"):
+            BHC(prefactor=1., theta=-0.1)
+        with self.assertRaisesRegex(ValueError, "Parameter 'leaf_size' must be >= 1"):
+            BHC(prefactor=1., leaf_size=0)
+
     @ut.skipIf(n_nodes != 1, "only runs for 1 MPI rank")
     def test_exceptions_serial(self):
         DDSR = espressomd.magnetostatics.DipolarDirectSumWithReplicaCpu
@@ -178,6 +178,13 @@ class H5mdTests(ut.TestCase):
         # open a file with invalid specifications
         with self.assertRaisesRegex(ValueError, "Unknown field 'lb'"):
             h5md.H5md(file_path=str(temp_file), fields='lb')
+        # invalid chunk size and compression level
+        temp_file = self.temp_path / 'wrong_storage.h5'
+        with self.assertRaisesRegex(ValueError, "Parameter 'chunk_size' must be >= 1"):
+            h5md.H5md(file_path=str(temp_file), chunk_size=0)
+        for level in (-1, 10):
+            with self.assertRaisesRegex(ValueError, "Parameter 'compression_level' must be in the range"):
+                h5md.H5md(file_path=str(temp_file), compression_level=level)
         # check read-only parameters
         for key in self.h5_obj.get_params():
             with self.assertRaisesRegex(RuntimeError, f"Parameter '{key}' is read-only"):
@@ -202,6 +209,33 @@ class H5mdTests(ut.TestCase):
             self.assertIsNone(cur.get('particles/atoms/box/edges/value'))
             self.assertIsNone(cur.get('connectivity/atoms/value'))
 
+    def test_compression(self):
+        # write a compressed trajectory with small chunks
+        temp_file = self.temp_path / 'compression.h5'
+        h5 = espressomd.io.writer.h5md.H5md(
+            file_path=str(temp_file), chunk_size=8, compression_level=4)
+        h5.write()
+        h5.write()
+        h5.flush()
+        h5.close()
+        self.assertEqual(h5.chunk_size, 8)
+        self.assertEqual(h5.compression_level, 4)
+        # check the storage layout and compare to the reference trajectory
+        with h5py.File(temp_file, 'r') as cur:
+            for key in ('position', 'image', 'velocity', 'force',
+                        'id', 'species', 'mass', 'charge'):
+                dset = cur[f'particles/atoms/{key}/value']
+                self.assertEqual(dset.chunks[:2], (1, 8))
+                self.assertEqual(dset.compression, 'gzip')
+                self.assertEqual(dset.compression_opts, 4)
+                self.assertTrue(dset.shuffle)
+                np.testing.assert_allclose(
+                    dset, self.py_file[f'particles/atoms/{key}/value'])
+            dset = cur['connectivity/atoms/value']
+            self.assertEqual(dset.chunks, (1, 8, 2))
+            self.assertEqual(len(dset[1]), N_PART - 1)
+            np.testing.assert_array_equal(dset, self.py_file['connectivity/atoms/value'])
+
     def test_box(self):
         np.testing.assert_allclose(self.py_box, self.box_l)
 
@@ -329,6 +363,8 @@ class H5mdTests(ut.TestCase):
             self.assertEqual(self.h5_params['mass_unit'], 'u')
         self.assertEqual(self.h5_params['force_unit'], 'm u ps-2')
         self.assertEqual(self.h5_params['velocity_unit'], 'm ps-1')
+        self.assertEqual(self.h5_params['chunk_size'], 1000)
+        self.assertEqual(self.h5_params['compression_level'], 0)
 
     def test_static_properties(self):
         # check list of output fields
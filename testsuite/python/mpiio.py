@@ -217,6 +217,72 @@ class MPIIOTest(ut.TestCase):
         mpiio2.read(prefix2, **fields2)
         self.check_sample_system(**fields2)
 
+    def test_mpiio_asynchronous(self):
+        fields = {
+            'types': True,
+            'positions': True,
+            'velocities': True,
+            'bonds': True}
+        prefix = self.generate_prefix(self.id())
+        mpiio = espressomd.io.mpiio.Mpiio()
+
+        # stage more frames than there are staging areas, and modify the
+        # particles while the previous frames are being written
+        self.add_particles()
+        shifts = [0., 0.1, 0.2]
+        for i, shift in enumerate(shifts):
+            self.system.part.all().v = [
+                p.v + shift for p in self.test_mock_particles]
+            mpiio.write(f'{prefix}.{i}', asynchronous=True, **fields)
+        self.system.part.all().v = [0., 0., 0.]
+        mpiio.flush()
+        # flushing twice is a no-op
+        mpiio.flush()
+
+        for i, shift in enumerate(shifts):
+            self.check_files_exist(f'{prefix}.{i}', **fields)
+            self.system.part.clear()
+            mpiio.read(f'{prefix}.{i}', **fields)
+            self.assertEqual(len(self.system.part), npart)
+            for p, q in zip(self.system.part, self.test_mock_particles):
+                np.testing.assert_array_equal(np.copy(p.v), q.v + shift)
+                np.testing.assert_array_equal(np.copy(p.pos), q.pos)
+
+    def test_checkpoint(self):
+        prefix = self.generate_prefix(self.id())
+        mpiio = espressomd.io.mpiio.Mpiio()
+
+        self.add_particles()
+        p0, p1 = self.system.part.by_ids([0, 1])
+        p0.ext_force = [1., 2., 3.]
+        if espressomd.has_features("MASS"):
+            p1.mass = 2.5
+        if espressomd.has_features("ELECTROSTATICS"):
+            p0.q = -1.
+        if espressomd.has_features("EXCLUSIONS"):
+            p0.add_exclusion(1)
+            p0.add_exclusion(2)
+        reference = {p.id: p.to_dict() for p in self.system.part}
+        mpiio.write_checkpoint(prefix)
+        for ext in ("chkh", "part", "cbnd", "excl"):
+            self.assertTrue(os.path.isfile(f"{prefix}.{ext}"))
+
+        self.system.part.clear()
+        mpiio.read_checkpoint(prefix)
+        self.check_sample_system(
+            types=True, positions=True, velocities=True, bonds=True)
+        for pid, ref_state in reference.items():
+            state = self.system.part.by_id(pid).to_dict()
+            for key in ref_state.keys() - {"bonds", "vs_relative"}:
+                np.testing.assert_equal(
+                    np.copy(state[key]), np.copy(ref_state[key]), err_msg=key)
+            if "vs_relative" in ref_state:
+                for value, ref_value in zip(
+                        state["vs_relative"], ref_state["vs_relative"]):
+                    np.testing.assert_equal(
+                        np.copy(value), np.copy(ref_value),
+                        err_msg="vs_relative")
+
     def test_mpiio_exceptions(self):
         mpiio = espressomd.io.mpiio.Mpiio()
         prefix = self.generate_prefix(self.id())
@@ -229,6 +295,10 @@ class MPIIOTest(ut.TestCase):
             mpiio.write(prefix)
         with self.assertRaisesRegex(ValueError, "No output fields chosen."):
             mpiio.read(prefix)
+        with self.assertRaisesRegex(ValueError, msg_prefix):
+            mpiio.write_checkpoint(None)
+        with self.assertRaisesRegex(ValueError, msg_prefix):
+            mpiio.read_checkpoint(None)
 
 
 if __name__ == '__main__':
@@ -22,6 +22,7 @@ import espressomd.io
 
 import unittest as ut
 import os
+import struct
 import tempfile
 
 
@@ -136,6 +137,41 @@ class MPIIOTest(ut.TestCase):
         with self.assertRaisesRegex(RuntimeError, f'Requesting to read fields which were not dumped'):
             mpiio.read(path, types=True, bonds=True)
 
+    @ut.skipIf(n_nodes != 1, "only works on 1 MPI rank")
+    def test_checkpoint_exceptions(self):
+        generator = MPIIOMockGenerator(self.temp_dir.name)
+        mpiio = espressomd.io.mpiio.Mpiio()
+
+        # generate reference data
+        self.system.part.add(pos=[0, 0, 0])
+        path_ref = generator.create()[0]
+        mpiio.write_checkpoint(path_ref)
+        self.system.part.clear()
+
+        # exception when the checkpoint cannot be written
+        path, fn = generator.create('part', read_only=True)
+        with self.assertRaisesRegex(RuntimeError, f'Could not open file "{fn}"'):
+            mpiio.write_checkpoint(path)
+
+        # exception when the layout doesn't exist
+        path, _ = generator.create(
+            'part', 'cbnd', 'excl', read_only=False, from_ref=path_ref)
+        fn = f'{path}.chkh'
+        with self.assertRaisesRegex(RuntimeError, f'Could not open file "{fn}"'):
+            mpiio.read_checkpoint(path)
+
+        # exception when the layout is empty
+        with open(fn, 'wb'):
+            pass
+        with self.assertRaisesRegex(RuntimeError, f'Could not read file "{fn}"'):
+            mpiio.read_checkpoint(path)
+
+        # exception when the layout differs from the one of this build
+        with open(fn, 'wb') as f:
+            f.write(struct.pack('=IQ', 0, 1))
+        with self.assertRaisesRegex(RuntimeError, 'different version or feature set'):
+            mpiio.read_checkpoint(path)
+
 
 if __name__ == '__main__':
     ut.main()
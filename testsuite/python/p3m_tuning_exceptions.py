@@ -243,6 +243,14 @@ class Test(ut.TestCase):
 
         self.check_invalid_params(espressomd.electrostatics.P3M)
 
+        with self.assertRaisesRegex(ValueError, "P3M differentiation has to be 'ik', 'ad' or 'auto'"):
+            espressomd.electrostatics.P3M(
+                **self.get_valid_params('P3M'), differentiation='fd')
+        with self.assertRaisesRegex(ValueError, "P3M differentiation 'auto' requires tune=True"):
+            espressomd.electrostatics.P3M(
+                **self.get_valid_params('P3M'), tune=False,
+                differentiation='auto')
+
         # set up a valid actor
         solver = espressomd.electrostatics.P3M(
             prefactor=2, accuracy=0.1, cao=2, r_cut=3.18, mesh=8)
@@ -415,6 +423,15 @@ class Test(ut.TestCase):
             self.system.actors.add(solver)
             self.system.actors.clear()
 
+        # differentiation schemes without tuning
+        for differentiation in ('ik', 'ad'):
+            solver = espressomd.electrostatics.P3M(
+                **self.get_valid_params('P3M'), tune=False,
+                differentiation=differentiation)
+            self.system.actors.add(solver)
+            self.assertEqual(solver.differentiation, differentiation)
+            self.system.actors.clear()
+
     @utx.skipIfMissingFeatures("DP3M")
     def test_09_no_errors_dp3m_cpu(self):
         self.system.time_step = 0.01
@@ -0,0 +1,125 @@
+#
+# Copyright (C) 2022 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.electrostatics
+import itertools
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+
+@utx.skipIfMissingFeatures(["P3M", "WCA"])
+class Respa(ut.TestCase):
+
+    """
+    Check the multiple time step scheme of the velocity Verlet integrator,
+    which evaluates the long-range forces only every few time steps.
+
+    """
+
+    system = espressomd.System(box_l=[10., 10., 10.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+
+    def setUp(self):
+        system = self.system
+        np.random.seed(42)
+        # ionic crystal with small displacements
+        for i, j, k in itertools.product(range(4), repeat=3):
+            pos = 2.5 * np.array([i, j, k]) + 0.1 * np.random.random(3)
+            q = (-1.)**(i + j + k)
+            system.part.add(pos=pos, q=q, v=0.1 * np.random.random(3) - 0.05)
+        system.non_bonded_inter[0, 0].wca.set_params(epsilon=1., sigma=1.)
+        p3m = espressomd.electrostatics.P3M(
+            prefactor=1., accuracy=1e-4, mesh=[16, 16, 16], cao=5,
+            r_cut=3.0, alpha=0.95, tune=False)
+        system.actors.add(p3m)
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.actors.clear()
+        self.system.thermostat.turn_off()
+        self.system.integrator.set_vv()
+
+    def forces(self, long_range_interval):
+        self.system.integrator.set_vv(long_range_interval=long_range_interval)
+        self.system.integrator.run(0, recalc_forces=True)
+        return np.copy(self.system.part.all().f)
+
+    def test_scaled_long_range_forces(self):
+        # the real-space part of P3M is evaluated in every time step,
+        # the k-space part is scaled with the long-range interval
+        f1 = self.forces(1)
+        f2 = self.forces(2)
+        f3 = self.forces(3)
+        self.assertGreater(np.linalg.norm(f2 - f1), 1e-3)
+        np.testing.assert_allclose(f3, 2. * f2 - f1, atol=1e-10)
+
+    def test_diagnostics(self):
+        system = self.system
+        system.integrator.set_vv(long_range_interval=3)
+        system.integrator.run(10, recalc_forces=True)
+        diagnostics = system.integrator.respa_diagnostics
+        # initial force calculation and time steps 3, 6 and 9
+        self.assertEqual(diagnostics["n_long_range_evaluations"], 4)
+        self.assertEqual(diagnostics["n_outer_steps"], 3)
+        self.assertEqual(diagnostics["energy_start"], 0.)
+        self.assertEqual(diagnostics["energy_drift"], 0.)
+        # the single time step integrator does not record diagnostics
+        system.integrator.set_vv()
+        system.integrator.run(10)
+        diagnostics = system.integrator.respa_diagnostics
+        self.assertEqual(diagnostics["n_long_range_evaluations"], 0)
+        self.assertEqual(diagnostics["n_outer_steps"], 0)
+
+    def test_energy_drift(self):
+        system = self.system
+        system.integrator.set_vv(long_range_interval=4, monitor_energy=True)
+        energy = system.analysis.energy()["total"]
+        system.integrator.run(200)
+        diagnostics = system.integrator.respa_diagnostics
+        self.assertEqual(diagnostics["n_outer_steps"], 50)
+        self.assertAlmostEqual(diagnostics["energy_start"], energy, delta=1e-8)
+        # the integration ends on an outer time step boundary
+        self.assertAlmostEqual(diagnostics["energy_end"],
+                               system.analysis.energy()["total"], delta=1e-8)
+        self.assertAlmostEqual(diagnostics["energy_drift"],
+                               (diagnostics["energy_end"] - energy) / 50.,
+                               delta=1e-10)
+        self.assertLess(abs(diagnostics["energy_end"] - energy),
+                        1e-2 * abs(energy))
+
+    def test_langevin(self):
+        system = self.system
+        system.thermostat.set_langevin(kT=1., gamma=1., seed=42)
+        system.integrator.set_vv(long_range_interval=2)
+        system.integrator.run(20)
+        diagnostics = system.integrator.respa_diagnostics
+        self.assertEqual(diagnostics["n_long_range_evaluations"], 11)
+        self.assertEqual(diagnostics["n_outer_steps"], 10)
+
+    def test_exceptions(self):
+        with self.assertRaisesRegex(ValueError, "long_range_interval must be positive"):
+            self.system.integrator.set_vv(long_range_interval=0)
+        with self.assertRaisesRegex(ValueError, "long_range_interval must be an integer"):
+            self.system.integrator.set_vv(long_range_interval=1.5)
+
+
+if __name__ == "__main__":
+    ut.main()
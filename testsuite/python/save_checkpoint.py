@@ -370,6 +370,12 @@ class TestCheckpoint(ut.TestCase):
             self.assertTrue(lbf_cpt_path.is_file(),
                             "LB checkpoint file not created")
 
+        if 'MPIIO' in modes:
+            for suffix in ("chkh", "part", "cbnd", "excl"):
+                filepath = path_cpt_root / f"0.particles.{suffix}"
+                self.assertTrue(filepath.is_file(),
+                                "MPI-IO particle file not created")
+
     @ut.skipIf(lbf_actor is None, "Skipping test due to missing mode.")
     def test_lb_checkpointing_exceptions(self):
         '''
@@ -290,7 +290,8 @@ class CheckpointTest(ut.TestCase):
             integ['integrator'],
             espressomd.integrate.VelocityVerlet)
         params = integ['integrator'].get_params()
-        self.assertEqual(params, {})
+        self.assertEqual(
+            params, {'long_range_interval': 1, 'monitor_energy': False})
 
     @ut.skipIf('INT' in modes, 'VV integrator not the default')
     def test_integrator_VV(self):
@@ -299,7 +300,8 @@ class CheckpointTest(ut.TestCase):
             integ['integrator'],
             espressomd.integrate.VelocityVerlet)
         params = integ['integrator'].get_params()
-        self.assertEqual(params, {})
+        self.assertEqual(
+            params, {'long_range_interval': 1, 'monitor_energy': False})
 
     @ut.skipIf('INT.BD' not in modes, 'BD integrator not in modes')
     def test_integrator_BD(self):
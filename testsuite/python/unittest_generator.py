@@ -141,4 +141,5 @@ class TestGenerator:
         Generate parameters to instantiate an ESPResSo checkpoint file.
         """
         return {"checkpoint_id": f"checkpoint_{self.test_idx}",
-                "checkpoint_path": str(pathlib.Path(__file__).parent)}
+                "checkpoint_path": str(pathlib.Path(__file__).parent),
+                "mpiio": "MPIIO" in self.get_modes()}